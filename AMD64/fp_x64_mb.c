@@ -0,0 +1,383 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: multi-buffer modular arithmetic for x64 platforms using AVX2 or AVX-512 IFMA
+*
+* Field elements from MB_LANES independent computations are interleaved, one per 64-bit vector lane.
+* Each element is split into MB_NLIMBS limbs of MB_RADIX bits: 32 limbs of 24 bits with AVX2, or
+* 15 limbs of 52 bits with AVX-512 IFMA. Elements are kept with normalized limbs and in the range
+* [0, 2*p751-1]. Montgomery multiplication uses R = 2^(MB_RADIX*MB_NLIMBS), i.e., 2^768 with AVX2
+* and 2^780 with AVX-512 IFMA; vfp2pack751() and vfp2unpack751() convert from/to the usual
+* representation in Montgomery form with R = 2^768.
+*
+*********************************************************************************************/
+
+#include "../SIDH_internal.h"
+
+#if defined(MULTIBUFFER_SUPPORT)
+
+
+#define MB_MASK         (((uint64_t)1 << MB_RADIX) - 1)
+
+#if (SIMD_SUPPORT == AVX512IFMA_SUPPORT)
+
+    #define VADD(a, b)      _mm512_add_epi64((a), (b))
+    #define VSUB(a, b)      _mm512_sub_epi64((a), (b))
+    #define VAND(a, b)      _mm512_and_si512((a), (b))
+    #define VSHR(a, n)      _mm512_srli_epi64((a), (n))
+    #define VSAR(a, n)      _mm512_srai_epi64((a), (n))
+    #define VSIGN(a)        _mm512_srai_epi64((a), 63)
+    #define VSET1(x)        _mm512_set1_epi64((long long)(x))
+    #define VZERO           _mm512_setzero_si512()
+    #define VLOAD(p)        _mm512_loadu_si512((void*)(p))
+    #define VSTORE(p, a)    _mm512_storeu_si512((void*)(p), (a))
+
+// p751, p751+1 and 2*p751 in radix 2^52
+static const uint64_t p751_mb[MB_NLIMBS]   = { 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF,
+                                               0xFFFFFFFFFFFFF, 0x49F878A8EEAFF, 0x7CC76E3EC9685, 0x76DA959B1A13F, 0x84E9867D6EBE8, 0xB5045CB257480,
+                                               0xF97BADC668562, 0x41F71C0E12909, 0x00000006FE5D5 };
+static const uint64_t p751p1_mb[MB_NLIMBS] = { 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000,
+                                               0x0000000000000, 0x49F878A8EEB00, 0x7CC76E3EC9685, 0x76DA959B1A13F, 0x84E9867D6EBE8, 0xB5045CB257480,
+                                               0xF97BADC668562, 0x41F71C0E12909, 0x00000006FE5D5 };
+static const uint64_t p751x2_mb[MB_NLIMBS] = { 0xFFFFFFFFFFFFE, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF, 0xFFFFFFFFFFFFF,
+                                               0xFFFFFFFFFFFFF, 0x93F0F151DD5FF, 0xF98EDC7D92D0A, 0xEDB52B363427E, 0x09D30CFADD7D0, 0x6A08B964AE901,
+                                               0xF2F75B8CD0AC5, 0x83EE381C25213, 0x0000000DFCBAA };
+// Constants 2^792 mod p751 and 2^768 mod p751, used to switch between R = 2^768 and R = 2^780
+static const uint64_t mont_in_mb[MB_NLIMBS]  = { 0x00249AD67C3FF, 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000,
+                                                 0x0000000000000, 0xE822291A2EB00, 0xC397715452356, 0x82A796EA41E7E, 0xC83FB3EDF886E, 0x19B40AAC77043,
+                                                 0xDC309584457DC, 0xD7CA701397670, 0x000000067FAC9 };
+static const uint64_t mont_out_mb[MB_NLIMBS] = { 0x00000000249AD, 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000, 0x0000000000000,
+                                                 0x0000000000000, 0x375C6C6683100, 0xF24D05527B1E4, 0x2E697797BF3F4, 0x89DB7B2AC5C4E, 0xB439D2076956C,
+                                                 0xC7512C7E94CA4, 0xBCE5E210F7926, 0x00000002D5B24 };
+#define p751_ZERO_LIMBS  7                  // Number of "0" limbs in the least significant part of p751+1
+
+#elif (SIMD_SUPPORT == AVX2_SUPPORT)
+
+    #define VADD(a, b)      _mm256_add_epi64((a), (b))
+    #define VSUB(a, b)      _mm256_sub_epi64((a), (b))
+    #define VAND(a, b)      _mm256_and_si256((a), (b))
+    #define VSHR(a, n)      _mm256_srli_epi64((a), (n))
+    #define VSAR(a, n)      _mm256_sub_epi64(_mm256_srli_epi64(_mm256_add_epi64((a), VSET1((uint64_t)1 << 62)), (n)), VSET1((uint64_t)1 << (62-(n))))
+    #define VSIGN(a)        _mm256_cmpgt_epi64(VZERO, (a))
+    #define VSET1(x)        _mm256_set1_epi64x((long long)(x))
+    #define VZERO           _mm256_setzero_si256()
+    #define VLOAD(p)        _mm256_loadu_si256((__m256i*)(p))
+    #define VSTORE(p, a)    _mm256_storeu_si256((__m256i*)(p), (a))
+
+// p751, p751+1 and 2*p751 in radix 2^24
+static const uint64_t p751_mb[MB_NLIMBS]   = { 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
+                                               0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xEEAFFF,
+                                               0xF878A8, 0x968549, 0x76E3EC, 0x13F7CC, 0x959B1A, 0xE876DA, 0x67D6EB, 0x084E98,
+                                               0xB25748, 0xB5045C, 0x668562, 0x97BADC, 0x12909F, 0xF71C0E, 0xE5D541, 0x00006F };
+static const uint64_t p751p1_mb[MB_NLIMBS] = { 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000,
+                                               0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0x000000, 0xEEB000,
+                                               0xF878A8, 0x968549, 0x76E3EC, 0x13F7CC, 0x959B1A, 0xE876DA, 0x67D6EB, 0x084E98,
+                                               0xB25748, 0xB5045C, 0x668562, 0x97BADC, 0x12909F, 0xF71C0E, 0xE5D541, 0x00006F };
+static const uint64_t p751x2_mb[MB_NLIMBS] = { 0xFFFFFE, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF,
+                                               0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xFFFFFF, 0xDD5FFF,
+                                               0xF0F151, 0x2D0A93, 0xEDC7D9, 0x27EF98, 0x2B3634, 0xD0EDB5, 0xCFADD7, 0x109D30,
+                                               0x64AE90, 0x6A08B9, 0xCD0AC5, 0x2F75B8, 0x25213F, 0xEE381C, 0xCBAA83, 0x0000DF };
+#define p751_ZERO_LIMBS  15                 // Number of "0" limbs in the least significant part of p751+1
+
+#endif
+
+
+static __inline void vnormalize(vdigit_t* a)
+{ // Carry propagation, such that all limbs except the most significant one are in [0, 2^MB_RADIX-1].
+  // The most significant limb keeps the sign of the signed value.
+    unsigned int i;
+    vdigit_t mask = VSET1(MB_MASK);
+
+    for (i = 0; i < MB_NLIMBS-1; i++) {
+        a[i+1] = VADD(a[i+1], VSAR(a[i], MB_RADIX));
+        a[i] = VAND(a[i], mask);
+    }
+}
+
+
+static __inline void vcorrection(vdigit_t* a, const uint64_t* modulus)
+{ // Adds modulus to the signed, normalized value a if a is negative.
+    unsigned int i;
+    vdigit_t mask = VSIGN(a[MB_NLIMBS-1]);
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        a[i] = VADD(a[i], VAND(mask, VSET1(modulus[i])));
+    }
+    vnormalize(a);
+}
+
+
+void vfpcopy751(vfelm_t a, vfelm_t c)
+{ // Copy of a multi-buffer field element, c = a
+    unsigned int i;
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = a[i];
+    }
+}
+
+
+void vfpadd751(vfelm_t a, vfelm_t b, vfelm_t c)
+{ // Multi-buffer modular addition, c = a+b mod p751.
+  // Inputs: a, b in [0, 2*p751-1]
+  // Output: c in [0, 2*p751-1]
+    unsigned int i;
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = VSUB(VADD(a[i], b[i]), VSET1(p751x2_mb[i]));
+    }
+    vnormalize(c);
+    vcorrection(c, p751x2_mb);
+}
+
+
+void vfpsub751(vfelm_t a, vfelm_t b, vfelm_t c)
+{ // Multi-buffer modular subtraction, c = a-b mod p751.
+  // Inputs: a, b in [0, 2*p751-1]
+  // Output: c in [0, 2*p751-1]
+    unsigned int i;
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = VSUB(a[i], b[i]);
+    }
+    vnormalize(c);
+    vcorrection(c, p751x2_mb);
+}
+
+
+static __inline void vmp_add(vfelm_t a, vfelm_t b, vfelm_t c)
+{ // Multi-buffer addition without reduction, c = a+b.
+  // Inputs: a, b in [0, 2*p751-1]
+  // Output: c in [0, 4*p751-1]
+    unsigned int i;
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = VADD(a[i], b[i]);
+    }
+    vnormalize(c);
+}
+
+
+static __inline void vmp_subadd(vfelm_t a, vfelm_t b, vfelm_t c)
+{ // Multi-buffer subtraction without reduction, c = a-b+2*p751.
+  // Inputs: a, b in [0, 2*p751-1]
+  // Output: c in [1, 4*p751-1]
+    unsigned int i;
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = VADD(VSUB(a[i], b[i]), VSET1(p751x2_mb[i]));
+    }
+    vnormalize(c);
+}
+
+
+void vfpmul751_mont(vfelm_t a, vfelm_t b, vfelm_t c)
+{ // Multi-buffer field multiplication using Montgomery arithmetic, c = a*b*R^-1 mod p751.
+  // Schoolbook multiplication is followed by a Montgomery reduction that exploits the special form of p751, i.e.,
+  // -p751^-1 = 1 mod 2^MB_RADIX and the least significant p751_ZERO_LIMBS limbs of p751+1 are zero.
+  // Inputs: a, b in [0, 4*p751-1]
+  // Output: c in [0, 2*p751-1]
+    unsigned int i, j;
+    vdigit_t t[2*MB_NLIMBS], q, mask = VSET1(MB_MASK);
+
+    for (i = 0; i < 2*MB_NLIMBS; i++) {
+        t[i] = VZERO;
+    }
+
+#if (SIMD_SUPPORT == AVX512IFMA_SUPPORT)
+    for (i = 0; i < MB_NLIMBS; i++) {
+        for (j = 0; j < MB_NLIMBS; j++) {
+            t[i+j] = _mm512_madd52lo_epu64(t[i+j], a[i], b[j]);
+            t[i+j+1] = _mm512_madd52hi_epu64(t[i+j+1], a[i], b[j]);
+        }
+    }
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        q = VAND(t[i], mask);
+        t[i+1] = VADD(t[i+1], VSHR(t[i], MB_RADIX));
+        for (j = p751_ZERO_LIMBS; j < MB_NLIMBS; j++) {
+            t[i+j] = _mm512_madd52lo_epu64(t[i+j], q, VSET1(p751p1_mb[j]));
+            t[i+j+1] = _mm512_madd52hi_epu64(t[i+j+1], q, VSET1(p751p1_mb[j]));
+        }
+    }
+#elif (SIMD_SUPPORT == AVX2_SUPPORT)
+    for (i = 0; i < MB_NLIMBS; i++) {
+        for (j = 0; j < MB_NLIMBS; j++) {
+            t[i+j] = VADD(t[i+j], _mm256_mul_epu32(a[i], b[j]));
+        }
+    }
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        q = VAND(t[i], mask);
+        t[i+1] = VADD(t[i+1], VSHR(t[i], MB_RADIX));
+        for (j = p751_ZERO_LIMBS; j < MB_NLIMBS; j++) {
+            t[i+j] = VADD(t[i+j], _mm256_mul_epu32(q, VSET1(p751p1_mb[j])));
+        }
+    }
+#endif
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = t[MB_NLIMBS+i];
+    }
+    vnormalize(c);
+}
+
+
+void vfp2copy751(vf2elm_t a, vf2elm_t c)
+{ // Copy of a multi-buffer GF(p751^2) element, c = a
+    vfpcopy751(a[0], c[0]);
+    vfpcopy751(a[1], c[1]);
+}
+
+
+void vfp2add751(vf2elm_t a, vf2elm_t b, vf2elm_t c)
+{ // Multi-buffer GF(p751^2) addition, c = a+b in GF(p751^2)
+    vfpadd751(a[0], b[0], c[0]);
+    vfpadd751(a[1], b[1], c[1]);
+}
+
+
+void vfp2sub751(vf2elm_t a, vf2elm_t b, vf2elm_t c)
+{ // Multi-buffer GF(p751^2) subtraction, c = a-b in GF(p751^2)
+    vfpsub751(a[0], b[0], c[0]);
+    vfpsub751(a[1], b[1], c[1]);
+}
+
+
+void vfp2sqr751_mont(vf2elm_t a, vf2elm_t c)
+{ // Multi-buffer GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2).
+  // Inputs: a = a0+a1*i, where a0, a1 are in [0, 2*p751-1]
+  // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p751-1]
+    vfelm_t t1, t2, t3;
+
+    vmp_add(a[0], a[1], t1);                           // t1 = a0+a1
+    vmp_subadd(a[0], a[1], t2);                        // t2 = a0-a1
+    vmp_add(a[0], a[0], t3);                           // t3 = 2a0
+    vfpmul751_mont(t1, t2, c[0]);                      // c0 = (a0+a1)(a0-a1)
+    vfpmul751_mont(t3, a[1], c[1]);                    // c1 = 2a0*a1
+}
+
+
+void vfp2mul751_mont(vf2elm_t a, vf2elm_t b, vf2elm_t c)
+{ // Multi-buffer GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2).
+  // Inputs: a = a0+a1*i and b = b0+b1*i, where a0, a1, b0, b1 are in [0, 2*p751-1]
+  // Output: c = c0+c1*i, where c0, c1 are in [0, 2*p751-1]
+    vfelm_t t1, t2, tt1, tt2;
+
+    vmp_add(a[0], a[1], t1);                           // t1 = a0+a1
+    vmp_add(b[0], b[1], t2);                           // t2 = b0+b1
+    vfpmul751_mont(a[0], b[0], tt1);                   // tt1 = a0*b0
+    vfpmul751_mont(a[1], b[1], tt2);                   // tt2 = a1*b1
+    vfpmul751_mont(t1, t2, c[1]);                      // c1 = (a0+a1)*(b0+b1)
+    vfpsub751(c[1], tt1, c[1]);                        // c1 = (a0+a1)*(b0+b1) - a0*b0
+    vfpsub751(c[1], tt2, c[1]);                        // c1 = (a0+a1)*(b0+b1) - a0*b0 - a1*b1
+    vfpsub751(tt1, tt2, c[0]);                         // c0 = a0*b0 - a1*b1
+}
+
+
+static void vfppack751(felm_t* a, vfelm_t c)
+{ // Interleaving of MB_LANES field elements a[0],...,a[MB_LANES-1] in [0, p751-1] into the multi-buffer element c
+    unsigned int i, j, bit, word, shift;
+    uint64_t limbs[MB_NLIMBS][MB_LANES], limb;
+
+    for (j = 0; j < MB_LANES; j++) {
+        for (i = 0; i < MB_NLIMBS; i++) {
+            bit = i * MB_RADIX;
+            word = bit / RADIX;
+            shift = bit % RADIX;
+            limb = a[j][word] >> shift;
+            if (shift + MB_RADIX > RADIX && word + 1 < NWORDS_FIELD) {
+                limb |= a[j][word + 1] << (RADIX - shift);
+            }
+            limbs[i][j] = limb & MB_MASK;
+        }
+    }
+    for (i = 0; i < MB_NLIMBS; i++) {
+        c[i] = VLOAD(limbs[i]);
+    }
+}
+
+
+static void vfpunpack751(vfelm_t a, felm_t* c)
+{ // De-interleaving of the multi-buffer element a in [0, p751-1] into MB_LANES field elements c[0],...,c[MB_LANES-1]
+    unsigned int i, j, bit, word, shift;
+    uint64_t limbs[MB_NLIMBS][MB_LANES];
+
+    for (i = 0; i < MB_NLIMBS; i++) {
+        VSTORE(limbs[i], a[i]);
+    }
+    for (j = 0; j < MB_LANES; j++) {
+        fpzero751(c[j]);
+        for (i = 0; i < MB_NLIMBS; i++) {
+            bit = i * MB_RADIX;
+            word = bit / RADIX;
+            shift = bit % RADIX;
+            c[j][word] |= limbs[i][j] << shift;
+            if (shift + MB_RADIX > RADIX && word + 1 < NWORDS_FIELD) {
+                c[j][word + 1] |= limbs[i][j] >> (RADIX - shift);
+            }
+        }
+    }
+    clear_words((void*) limbs, MB_NLIMBS * MB_LANES);
+}
+
+
+void vfp2pack751(f2elm_t* a, vf2elm_t c)
+{ // Interleaving of MB_LANES GF(p751^2) elements a[0],...,a[MB_LANES-1] in Montgomery representation (R = 2^768)
+  // into the multi-buffer element c in multi-buffer Montgomery representation
+    felm_t t[MB_LANES];
+    unsigned int i, j;
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < MB_LANES; j++) {
+            fpcopy751(a[j][i], t[j]);
+        }
+        vfppack751(t, c[i]);
+#if (SIMD_SUPPORT == AVX512IFMA_SUPPORT)
+        {   vfelm_t k;                                 // c = c*2^12, i.e., from R = 2^768 to R = 2^780
+
+            for (j = 0; j < MB_NLIMBS; j++) {
+                k[j] = VSET1(mont_in_mb[j]);
+            }
+            vfpmul751_mont(c[i], k, c[i]);
+        }
+#endif
+    }
+    clear_words((void*) t, MB_LANES * NWORDS_FIELD);
+}
+
+
+void vfp2unpack751(vf2elm_t a, f2elm_t* c)
+{ // De-interleaving of the multi-buffer element a into MB_LANES GF(p751^2) elements c[0],...,c[MB_LANES-1]
+  // in Montgomery representation (R = 2^768), each one in [0, p751-1]
+    felm_t t[MB_LANES];
+    vfelm_t u;
+    unsigned int i, j;
+
+    for (i = 0; i < 2; i++) {
+#if (SIMD_SUPPORT == AVX512IFMA_SUPPORT)
+        for (j = 0; j < MB_NLIMBS; j++) {              // u = a*2^-12, i.e., from R = 2^780 to R = 2^768
+            u[j] = VSET1(mont_out_mb[j]);
+        }
+        vfpmul751_mont(a[i], u, u);
+#else
+        vfpcopy751(a[i], u);
+#endif
+        for (j = 0; j < MB_NLIMBS; j++) {              // Final correction to [0, p751-1]
+            u[j] = VSUB(u[j], VSET1(p751_mb[j]));
+        }
+        vnormalize(u);
+        vcorrection(u, p751_mb);
+        vfpunpack751(u, t);
+        for (j = 0; j < MB_LANES; j++) {
+            fpcopy751(t[j], c[j][i]);
+        }
+    }
+    clear_words((void*) t, MB_LANES * NWORDS_FIELD);
+}
+
+#endif
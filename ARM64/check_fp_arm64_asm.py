@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+# Minimal AArch64 emulator for the instruction subset used by the generated kernels, checked against Python integers.
+# It checks fp_arm64_asm.S and fp_arm64_asm_p503.S as committed, it does not replace running arith_test and kex_test on AArch64.
+# Usage: python3 ARM64/check_fp_arm64_asm.py
+import os, re, random, sys
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from gen_fp_arm64_asm import PARAMS, words
+
+M = 2**64 - 1
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SOURCES = {751: "ARM64/fp_arm64_asm.S", 503: "P503/fp_arm64_asm_p503.S"}
+
+def parse(text):
+    funcs, tables, cur, tab = {}, {}, None, None
+    for line in text.splitlines():
+        line = line.split("//")[0].strip()
+        if not line or line.startswith((".text", ".global", ".section", ".align")):
+            continue
+        if line.endswith(":"):
+            name = line[:-1]
+            if cur is None or tab is not None or name.startswith("p"):
+                pass
+            if re.match(r"p\d+(p1)?_arm64", name):
+                tab = name; tables[tab] = []; cur = None
+            else:
+                cur = name; funcs[cur] = []; tab = None
+            continue
+        if line.startswith(".quad"):
+            tables[tab].append(int(line.split()[1], 16))
+            continue
+        op, _, rest = line.partition(" ")
+        funcs[cur].append((op, rest.strip()))
+    return funcs, tables
+
+class CPU:
+    def __init__(self, tables):
+        self.r = {"x%d" % i: random.getrandbits(64) for i in range(31)}
+        self.r["sp"] = 0x7fff0000
+        self.mem = {}
+        self.C = random.getrandbits(1)
+        self.labels = {}
+        base = 0x100000
+        for name, ws in tables.items():
+            self.labels[name] = base
+            for k, w in enumerate(ws):
+                self.mem[base + 8 * k] = w
+            base += 0x1000
+    def get(self, x):
+        if x == "xzr": return 0
+        if x.startswith("#"): return int(x[1:], 0) & M
+        return self.r[x]
+    def set(self, x, v):
+        if x != "xzr": self.r[x] = v & M
+    def ld(self, a):
+        assert a % 8 == 0, hex(a)
+        return self.mem[a]
+    def st(self, a, v):
+        assert a % 8 == 0
+        self.mem[a] = v & M
+    def addr(self, m):
+        # [base], [base, #off], [base, #off]!, [base], #off
+        post = None
+        mm = re.match(r"\[(\w+)(?:, #(-?\d+))?\](!)?(?:, #(-?\d+))?$", m)
+        base, off, wb, post = mm.group(1), int(mm.group(2) or 0), mm.group(3), mm.group(4)
+        a = self.r[base] + off
+        if wb:
+            self.r[base] = a
+        if post is not None:
+            self.r[base] = self.r[base] + int(post)
+        return a
+    def run(self, code):
+        for op, rest in code:
+            args = [s.strip() for s in re.split(r",(?![^\[]*\])", rest)] if rest else []
+            if op in ("ldp", "stp"):
+                a = self.addr(args[2] + ((", " + args[3]) if len(args) > 3 else ""))
+                if op == "ldp":
+                    self.set(args[0], self.ld(a)); self.set(args[1], self.ld(a + 8))
+                else:
+                    self.st(a, self.get(args[0])); self.st(a + 8, self.get(args[1]))
+            elif op in ("ldr", "str"):
+                a = self.addr(args[1])
+                if op == "ldr": self.set(args[0], self.ld(a))
+                else: self.st(a, self.get(args[0]))
+            elif op == "adrp":
+                self.set(args[0], self.labels[args[1]] & ~0xfff)
+            elif op == "add" and args[2].startswith("#:lo12:"):
+                self.set(args[0], self.get(args[1]) + (self.labels[args[2][7:]] & 0xfff))
+            elif op == "mov":
+                self.set(args[0], self.get(args[1]))
+            elif op in ("add", "adds", "adc", "adcs"):
+                cin = self.C if op.startswith("adc") else 0
+                s = self.get(args[1]) + self.get(args[2]) + cin
+                self.set(args[0], s)
+                if op.endswith("s"): self.C = s >> 64
+            elif op in ("subs", "sbc", "sbcs"):
+                bin_ = 0 if op == "subs" else 1 - self.C
+                d = self.get(args[1]) - self.get(args[2]) - bin_
+                self.set(args[0], d)
+                if op.endswith("s"): self.C = 0 if d < 0 else 1
+            elif op == "and":
+                self.set(args[0], self.get(args[1]) & self.get(args[2]))
+            elif op == "mul":
+                self.set(args[0], self.get(args[1]) * self.get(args[2]))
+            elif op == "umulh":
+                self.set(args[0], (self.get(args[1]) * self.get(args[2])) >> 64)
+            elif op == "ret":
+                return
+            else:
+                raise Exception("unknown " + op)
+
+def put(cpu, addr, x, n):
+    for k, w in enumerate(words(x, n)):
+        cpu.mem[addr + 8 * k] = w
+
+def get(cpu, addr, n):
+    return sum(cpu.mem[addr + 8 * k] << (64 * k) for k in range(n))
+
+CALLEE = ["x%d" % i for i in range(19, 29)] + ["sp"]
+
+def call(funcs, tables, name, args, inputs, n_out, out_addr):
+    cpu = CPU(tables)
+    for addr, x, n in inputs:
+        put(cpu, addr, x, n)
+    for k, a in enumerate(args):
+        cpu.r["x%d" % k] = a
+    before = {r: cpu.r[r] for r in CALLEE}
+    cpu.run(funcs[name])
+    for r in CALLEE:
+        assert cpu.r[r] == before[r], (name, r)
+    return get(cpu, out_addr, n_out)
+
+for bits in (751, 503):
+    P = PARAMS[bits]
+    n, p, R = P["n"], P["p"], 2**P["R"]
+    funcs, tables = parse(open(os.path.join(ROOT, SOURCES[bits])).read())
+    A, B, Cc = 0x10000, 0x20000, 0x30000
+    edge = [0, 1, p - 1, p - 2, p // 2, (p + 1) // 2]
+    for it in range(3000):
+        a = random.choice(edge) if it % 5 == 0 else random.randrange(p)
+        b = random.choice(edge) if it % 7 == 0 else random.randrange(p)
+        assert call(funcs, tables, "fpadd%d_asm" % bits, [A, B, Cc], [(A, a, n), (B, b, n)], n, Cc) == (a + b) % p
+        assert call(funcs, tables, "fpsub%d_asm" % bits, [A, B, Cc], [(A, a, n), (B, b, n)], n, Cc) == (a - b) % p
+        # Aliased output for add/sub
+        assert call(funcs, tables, "fpadd%d_asm" % bits, [A, B, A], [(A, a, n), (B, b, n)], n, A) == (a + b) % p
+        x = random.getrandbits(64 * n) if it % 3 else random.choice([2**(64*n) - 1, 0, p - 1])
+        y = random.getrandbits(64 * n) if it % 3 else random.choice([2**(64*n) - 1, 0, p - 1])
+        assert call(funcs, tables, "mul%d_asm" % bits, [A, B, Cc], [(A, x, n), (B, y, n)], 2 * n, Cc) == x * y
+        ma = a * b
+        if it % 11 == 0:
+            ma = random.choice([p * R - 1, (p - 1) * (p - 1), 0, p * (R - 1)])
+        r = call(funcs, tables, "rdc%d_asm" % bits, [A, Cc], [(A, ma, 2 * n)], n, Cc)
+        assert r == ma * pow(R, -1, p) % p, (bits, it)
+        assert r < p
+    print(bits, "OK")
@@ -0,0 +1,108 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: modular arithmetic optimized for 64-bit ARM (AArch64) platforms
+*
+*********************************************************************************************/
+
+#include "../SIDH_internal.h"
+
+
+// Global constants
+extern const uint64_t p751[NWORDS_FIELD];
+extern const uint64_t p751p1[NWORDS_FIELD];
+
+// Field arithmetic backend of this implementation, see fp_get_arithmetic()
+static const FieldArithmetic fp_arithmetic_arm64 = { ARITHMETIC_ARM64, fpadd751_asm, fpsub751_asm, mp_mul_comba, mp_sqr_comba, rdc751_asm, fp2mul751_mont_default, fp2sqr751_mont_default };
+
+
+CRYPTO_STATUS fp_get_arithmetic(ARITHMETIC_ID id, const FieldArithmetic** arithmetic)
+{ // Set "arithmetic" to the kernel table of the backend "id". Only the AArch64 backend is available in this implementation.
+
+    if (arithmetic == NULL || id >= ARITHMETIC_END_OF_LIST) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (id != ARITHMETIC_DEFAULT && id != ARITHMETIC_ARM64) {
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    *arithmetic = &fp_arithmetic_arm64;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+__inline void fpneg751(digit_t* a)
+{ // Modular negation, a = -a mod p751.
+  // Input/output: a in [0, p751-1]
+    unsigned int i, borrow = 0;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        SUBC(borrow, ((digit_t*) p751)[i], a[i], borrow, a[i]);
+    }
+}
+
+
+void fpdiv2_751(digit_t* a, digit_t* c)
+{ // Modular division by two, c = a/2 mod p751.
+  // Input : a in [0, p751-1]
+  // Output: c in [0, p751-1]
+    unsigned int i, carry = 0;
+    digit_t mask;
+
+    mask = 0 - (digit_t)(a[0] & 1);    // If a is odd compute a+p751
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(carry, a[i], ((digit_t*) p751)[i] & mask, carry, c[i]);
+    }
+
+    mp_shiftr1(c, NWORDS_FIELD);
+}
+
+
+void mp_mul_comba(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords)
+{ // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = NWORDS_FIELD.
+
+    UNREFERENCED_PARAMETER(nwords);
+
+    mul751_asm(a, b, c);
+}
+
+
+void mp_sqr_comba(digit_t* a, digit_t* c, unsigned int nwords)
+{ // Multiprecision comba squaring, c = a^2, where lng(a) = nwords.
+  // The cross products a[i]*a[j], i < j, of each column are computed once and their sum is doubled.
+    unsigned int i, j, k;
+    digit_t t = 0, u = 0, v = 0, ct, cu, cv, carry, UV[2];
+
+    for (k = 0; k < 2*nwords-1; k++) {
+        ct = 0; cu = 0; cv = 0;
+        i = (k < nwords) ? 0 : k-nwords+1;
+        for (j = k-i; i < j; i++, j--) {
+            MUL(a[i], a[j], UV+1, UV[0]);
+            ADDC(0, UV[0], cv, carry, cv);
+            ADDC(carry, UV[1], cu, carry, cu);
+            ct += carry;
+        }
+        ct = (ct << 1) | (cu >> (RADIX-1));
+        cu = (cu << 1) | (cv >> (RADIX-1));
+        cv <<= 1;
+        if ((k & 1) == 0) {
+            MUL(a[k/2], a[k/2], UV+1, UV[0]);
+            ADDC(0, UV[0], cv, carry, cv);
+            ADDC(carry, UV[1], cu, carry, cu);
+            ct += carry;
+        }
+        ADDC(0, cv, v, carry, v);
+        ADDC(carry, cu, u, carry, u);
+        t += ct + carry;
+        c[k] = v;
+        v = u;
+        u = t;
+        t = 0;
+    }
+    c[2*nwords-1] = v;
+}
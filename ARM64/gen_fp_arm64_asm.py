@@ -0,0 +1,251 @@
+#!/usr/bin/env python3
+# Generates the AArch64 field arithmetic kernels for p751 and p503: fpadd, fpsub, mul (comba) and rdc (comba, exploiting the zero words of p+1)
+# Usage: python3 ARM64/gen_fp_arm64_asm.py 751 > ARM64/fp_arm64_asm.S
+#        python3 ARM64/gen_fp_arm64_asm.py 503 > P503/fp_arm64_asm_p503.S
+import sys
+
+PARAMS = {
+    751: dict(n=12, zw=5, p=2**372 * 3**239 - 1, R=768),
+    503: dict(n=8, zw=3, p=2**250 * 3**159 - 1, R=512),
+}
+
+def words(x, n):
+    return [(x >> (64 * i)) & (2**64 - 1) for i in range(n)]
+
+class Asm:
+    def __init__(self):
+        self.lines = []
+    def __call__(self, op, *args):
+        self.lines.append("  %-6s %s" % (op, ", ".join(args)))
+    def raw(self, s):
+        self.lines.append(s)
+
+def mem(base, off):
+    return "[%s, #%d]" % (base, off) if off else "[%s]" % base
+
+def save_regs(A, regs):
+    # regs: callee-saved registers, even count
+    if not regs:
+        return
+    size = 8 * len(regs)
+    A("stp", regs[0], regs[1], "[sp, #-%d]!" % size)
+    for k in range(2, len(regs), 2):
+        A("stp", regs[k], regs[k + 1], "[sp, #%d]" % (8 * k))
+
+def restore_regs(A, regs):
+    if not regs:
+        return
+    size = 8 * len(regs)
+    for k in range(2, len(regs), 2):
+        A("ldp", regs[k], regs[k + 1], "[sp, #%d]" % (8 * k))
+    A("ldp", regs[0], regs[1], "[sp], #%d" % size)
+
+def load_table(A, reg, label):
+    A("adrp", reg, label)
+    A("add", reg, reg, "#:lo12:%s" % label)
+
+def gen_fpadd(bits, A, sub=False):
+    n, zw = PARAMS[bits]["n"], PARAMS[bits]["zw"]
+    c = ["x%d" % (3 + i) for i in range(n)]
+    for i in range(0, n, 2):
+        A("ldp", c[i], c[i + 1], mem("x0", 8 * i))
+    op0, op = ("subs", "sbcs") if sub else ("adds", "adcs")
+    for i in range(0, n, 2):
+        A("ldp", "x15", "x16", mem("x1", 8 * i))
+        A(op0 if i == 0 else op, c[i], c[i], "x15")
+        A(op, c[i + 1], c[i + 1], "x16")
+    if not sub:
+        # c = c - p751, the p751_ZERO_WORDS least significant words of p751 are all ones
+        A("mov", "x15", "#-1")
+        for i in range(zw):
+            A("subs" if i == 0 else "sbcs", c[i], c[i], "x15")
+        load_table(A, "x17", "p%d_arm64" % bits)
+        for i in range(zw, n):
+            A("ldr", "x15", mem("x17", 8 * (i - zw)))
+            A("sbcs", c[i], c[i], "x15")
+    A("sbc", "x1", "xzr", "xzr")                   # mask = 0 - borrow
+    if sub:
+        load_table(A, "x17", "p%d_arm64" % bits)
+    # c = c + (p751 & mask)
+    for i in range(zw):
+        A("adds" if i == 0 else "adcs", c[i], c[i], "x1")
+    for i in range(zw, n):
+        A("ldr", "x15", mem("x17", 8 * (i - zw)))
+        A("and", "x15", "x15", "x1")
+        A("adcs", c[i], c[i], "x15")
+    for i in range(0, n, 2):
+        A("stp", c[i], c[i + 1], mem("x2", 8 * i))
+    A("ret")
+
+def gen_mul(bits, A):
+    n = PARAMS[bits]["n"]
+    a = ["x%d" % (3 + i) for i in range(n)]              # x3..x14 for n = 12
+    extra = ["x15", "x16", "x17", "x19", "x20", "x21"]
+    bj, lo, hi = extra[0], extra[1], extra[2]
+    acc = extra[3:6]
+    saved = ["x19", "x20", "x21", "x22"]               # x22 keeps the stack 16-byte aligned
+    save_regs(A, saved)
+    for i in range(0, n, 2):
+        A("ldp", a[i], a[i + 1], mem("x0", 8 * i))
+    v, u, t = acc
+    for k in range(2 * n - 1):
+        js = range(max(0, k - n + 1), min(k, n - 1) + 1)
+        for idx, i in enumerate(js):
+            j = k - i
+            A("ldr", bj, mem("x1", 8 * j))
+            if k == 0:
+                A("mul", v, a[i], bj)
+                A("umulh", u, a[i], bj)
+                A("mov", t, "xzr")
+                continue
+            A("mul", lo, a[i], bj)
+            A("umulh", hi, a[i], bj)
+            A("adds", v, v, lo)
+            A("adcs", u, u, hi)
+            A("adc", t, t, "xzr")
+        A("str", v, mem("x2", 8 * k))
+        v, u, t = u, t, v
+        if k < 2 * n - 2:
+            A("mov", t, "xzr")
+    A("str", v, mem("x2", 8 * (2 * n - 1)))
+    restore_regs(A, saved)
+    A("ret")
+
+def gen_rdc(bits, A):
+    n, zw = PARAMS[bits]["n"], PARAMS[bits]["zw"]
+    np1 = n - zw                                       # Number of nonzero words of p751 + 1
+    regs = ["x%d" % r for r in range(2, 18)] + ["x%d" % r for r in range(19, 29)]
+    saved = ["x%d" % r for r in range(19, 29)]
+    p1 = regs[-np1:]                                   # p1[k] holds word zw+k of p751 + 1
+    pool = regs[:-np1]
+    lo, hi = pool.pop(), pool.pop()
+    v, u, t = pool.pop(), pool.pop(), pool.pop()
+    body = A
+    A = Asm()
+    load_table(A, lo, "p%dp1_arm64" % bits)
+    for k in range(0, np1 - 1, 2):
+        A("ldp", p1[k], p1[k + 1], mem(lo, 8 * k))
+    if np1 % 2:
+        A("ldr", p1[np1 - 1], mem(lo, 8 * (np1 - 1)))
+    z = [None] * n
+    A("mov", v, "xzr"); A("mov", u, "xzr"); A("mov", t, "xzr")
+    for i in range(2 * n - 1):
+        for j in range(0 if i < n else i - n + 1, n):
+            if j + zw > i:
+                break
+            A("mul", lo, z[j], p1[i - j - zw])
+            A("umulh", hi, z[j], p1[i - j - zw])
+            A("adds", v, v, lo)
+            A("adcs", u, u, hi)
+            A("adc", t, t, "xzr")
+        A("ldr", lo, mem("x0", 8 * i))
+        A("adds", v, v, lo)
+        A("adcs", u, u, "xzr")
+        A("adc", t, t, "xzr")
+        slot = i if i < n else i - n
+        old = z[slot]
+        z[slot] = v
+        if old is not None:
+            pool.append(old)
+        v, u = u, t
+        t = pool.pop(0)
+        if i < 2 * n - 2:
+            A("mov", t, "xzr")
+    A("ldr", lo, mem("x0", 8 * (2 * n - 1)))
+    A("add", z[n - 1], v, lo)
+    # Final, constant-time subtraction: z = z - p751, mask = 0 - borrow, z = z + (p751 & mask)
+    load_table(A, lo, "p%d_arm64" % bits)
+    for k in range(0, np1 - 1, 2):
+        A("ldp", p1[k], p1[k + 1], mem(lo, 8 * k))
+    if np1 % 2:
+        A("ldr", p1[np1 - 1], mem(lo, 8 * (np1 - 1)))
+    A("mov", hi, "#-1")
+    for i in range(n):
+        src = hi if i < zw else p1[i - zw]
+        A("subs" if i == 0 else "sbcs", z[i], z[i], src)
+    A("sbc", lo, "xzr", "xzr")
+    for k in range(np1):
+        A("and", p1[k], p1[k], lo)
+    for i in range(n):
+        src = lo if i < zw else p1[i - zw]
+        A("adds" if i == 0 else "adcs", z[i], z[i], src)
+    for i in range(0, n, 2):
+        A("stp", z[i], z[i + 1], mem("x1", 8 * i))
+    text = " ".join(A.lines).replace(",", " ").split()
+    used = [r for r in ["x%d" % r for r in range(19, 29)] if r in text]
+    if len(used) % 2:
+        used.append("x%d" % (int(used[-1][1:]) + 1))
+    save_regs(body, used)
+    body.lines += A.lines
+    restore_regs(body, used)
+    body("ret")
+
+def header_comment(A, title, op, notes=()):
+    A.raw("//***********************************************************************")
+    A.raw("//  " + title)
+    for s in notes:
+        A.raw("//  " + s)
+    A.raw("//  Operation: " + op)
+    A.raw("//*********************************************************************** ")
+
+def generate(bits):
+    P = PARAMS[bits]
+    n, zw, p = P["n"], P["zw"], P["p"]
+    A = Asm()
+    fld = "" if bits == 751 else "over GF(p503) "
+    A.raw("//*******************************************************************************************")
+    A.raw("// SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key ")
+    A.raw("//       exchange providing 128 bits of quantum security and 192 bits of classical security.")
+    A.raw("//")
+    A.raw("//    Copyright (c) Microsoft Corporation. All rights reserved.")
+    A.raw("//")
+    A.raw("//")
+    A.raw("// Abstract: field arithmetic %sin ARMv8 (AArch64) assembly for Linux " % fld)
+    A.raw("//")
+    A.raw("//*******************************************************************************************  ")
+    A.raw("")
+    A.raw("// Parameters are passed in x0, x1 and x2. Registers x19-x28 are callee-saved.")
+    A.raw("")
+    A.raw("")
+    A.raw(".text")
+    header_comment(A, "Field addition", "c [x2] = a [x0] + b [x1]")
+    A.raw(".global fpadd%d_asm" % bits)
+    A.raw("fpadd%d_asm:" % bits)
+    gen_fpadd(bits, A)
+    A.raw("")
+    A.raw("")
+    header_comment(A, "Field subtraction", "c [x2] = a [x0] - b [x1]")
+    A.raw(".global fpsub%d_asm" % bits)
+    A.raw("fpsub%d_asm:" % bits)
+    gen_fpadd(bits, A, sub=True)
+    A.raw("")
+    A.raw("")
+    header_comment(A, "Integer multiplication", "c [x2] = a [x0] * b [x1]",
+                   ["Based on comba method, with MUL/UMULH for the low and high halves", "of the 64x64-bit products"])
+    A.raw("//  NOTE: a=c or b=c are not allowed")
+    A.lines[-2], A.lines[-1] = A.lines[-1], A.lines[-2]
+    A.raw(".global mul%d_asm" % bits)
+    A.raw("mul%d_asm:" % bits)
+    gen_mul(bits, A)
+    A.raw("")
+    A.raw("")
+    header_comment(A, "Montgomery reduction", "c [x1] = a [x0]",
+                   ["Based on comba method, skipping the products by the %d zero words" % zw, "of p%d + 1" % bits])
+    A.raw(".global rdc%d_asm" % bits)
+    A.raw("rdc%d_asm:" % bits)
+    gen_rdc(bits, A)
+    A.raw("")
+    A.raw("")
+    A.raw(".section .rodata")
+    A.raw(".align 3")
+    A.raw("p%d_arm64:                          // Words %d to %d of p%d, the lower ones are all ones" % (bits, zw, n - 1, bits))
+    for w in words(p, n)[zw:]:
+        A.raw("  .quad  0x%016X" % w)
+    A.raw("p%dp1_arm64:                        // Nonzero words of p%d + 1" % (bits, bits))
+    for w in words(p + 1, n)[zw:]:
+        A.raw("  .quad  0x%016X" % w)
+    return "\n".join(A.lines) + "\n"
+
+if __name__ == "__main__":
+    bits = int(sys.argv[1])
+    sys.stdout.write(generate(bits))
@@ -0,0 +1,83 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key 
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: supersingular elliptic curve isogeny parameters of SIDHp503
+*
+*********************************************************************************************/  
+
+#define _P503_
+#include "../SIDH_internal.h"
+
+
+// The encoding of field elements, elements over Z_order, elements over GF(p^2) and elliptic curve points is that of SIDHp751, 
+// see SIDH.c.
+
+//
+// Curve isogeny system "SIDHp503". Base curve: Montgomery curve By^2 = Cx^3 + Ax^2 + Cx defined over GF(p503^2), where A=0, B=1 and C=1
+//
+
+CurveIsogenyStaticData CurveIsogeny_SIDHp503 = {
+    "SIDHp503", 512, 256,         // Curve isogeny system ID, smallest multiple of 32 larger than the prime bitlength and smallest multiple of 32 larger than the order bitlength
+    503,                          // Bitlength of the prime 
+    // Prime p503 = 2^250*3^159-1
+    { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xABFFFFFFFFFFFFFF, 0x13085BDA2211E7A0, 0x1B9BF6C87B7E7DAF, 
+      0x6045C6BDDA77A4D0, 0x004066F541811E1E },
+    // Base curve parameter "A"
+    { 0 },
+    // Base curve parameter "C"
+    { 1 },
+    // Order bitlength for Alice
+    250,
+    // Order of Alice's subgroup
+    { 0x0, 0x0, 0x0, 0x0400000000000000 }, 
+    // Order bitlength for Bob
+    253,
+    // Power of Bob's subgroup order
+    159,
+    // Order of Bob's subgroup
+    { 0xC216F6888479E82B, 0xE6FDB21EDF9F6BC4, 0x1171AF769DE93406, 0x1019BD5060478798 },    
+    // Alice's generator PA = (XPA,YPA), where XPA and YPA are defined over GF(p503)
+    { 0x86E55C45E3BB46B1, 0x5273EC980981325D, 0xAD61A14B60DB2612, 0x2D6E60A62FD62417, 0x9858CADEFAE382E4, 0x3D3BBBF399137BD3, 
+      0xDAF32EEFFD618BD9, 0x00097453912E12F3, 0xFCC4B7FCA49C229D, 0x5AFEFD58CE172DF2, 0x7B5A530FDB03D127, 0x3DF6BFFBF20B5EA5, 
+      0xC08E3CAF88FBF7AF, 0x08BC7FDFCB3C4EBB, 0x681A5DE6B46E8198, 0x0036B08F00DC51A4 },
+    // Bob's generator PB = (XPB,YPB), where XPB and YPB are defined over GF(p503)
+    { 0x0A23B4B3787EF08F, 0x7E39B6997F70023E, 0x106BDF745894C14D, 0xB2CD1A12089C2ECE, 0xDF55CAF4B6E01903, 0xA971CDF3EC61E009, 
+      0xC47779AFFD696A88, 0x001E7D6EBCEEC9CF, 0x4AAE61CCCEFF1F26, 0xD47064F05C06DC5D, 0x96BBB4AD50FC7C8A, 0x01929FAEC5DAEB0D, 
+      0xD631C1CDF90E08E6, 0x79E842FBC355071F, 0x75FBDA11DA19725F, 0x002EC0AAEF9FBBDD },
+    // BigMont is not defined for SIDHp503
+    0,
+    { 0 },
+    // Montgomery constant Montgomery_R2 = (2^512)^2 mod p503
+    { 0x5289A0CF641D011F, 0x9B88257189FED2B9, 0xA3B365D58DC8F17A, 0x5BC57AB6EFF168EC, 0x9E51998BD84D4423, 0xBF8999CBAC3B5695, 
+      0x46E9127BCE14CDB6, 0x003F6CFCE8B81771 },
+    // Montgomery constant -p503^-1 mod 2^512
+    { 0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0xAC00000000000000, 0x13085BDA2211E7A0, 0x1B9BF6C87B7E7DAF, 
+      0x6045C6BDDA77A4D0, 0x73D066F541811E1E },
+    // Value one in Montgomery representation
+    { 0x00000000000003F9, 0x0000000000000000, 0x0000000000000000, 0xB400000000000000, 0x63CB1A6EA6DED2B4, 0x51689D8D667EB37D, 
+      0x8ACD77C71AB24142, 0x0026FBAEC60F5953 }
+};
+
+
+// Fixed parameters for isogeny tree computation, optimal strategies for the cost ratios of SIDH-Magma/optimalstrategies.mag
+
+const unsigned int splits_Alice[MAX_Alice] = {
+ 0, 1, 1, 2, 2, 2, 3, 4, 4, 4, 4, 5, 5, 6, 7, 8, 8, 8, 8, 8, 9, 9, 9, 9,
+10, 11, 12, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 17, 17, 17, 17, 17, 17, 17, 18, 19, 20, 21,
+21, 21, 21, 21, 22, 23, 24, 25, 26, 27, 27, 28, 29, 30, 31, 32, 32, 32, 32, 32, 32, 32, 33, 33,
+33, 33, 33, 33, 33, 33, 33, 33, 33, 34, 35, 36, 37, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38, 38,
+39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 48, 48, 48, 48, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57,
+58, 58, 59, 60 };
+
+const unsigned int splits_Bob[MAX_Bob] = {
+ 0, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4, 5, 5, 5, 6, 7, 7, 7, 7, 8, 9, 9, 9, 9,
+ 9, 10, 11, 12, 12, 12, 12, 12, 13, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16, 17, 18, 19, 20,
+21, 21, 21, 21, 21, 21, 22, 22, 22, 22, 22, 23, 24, 25, 26, 27, 28, 28, 28, 28, 28, 28, 28, 28,
+28, 28, 28, 28, 29, 30, 31, 32, 33, 33, 34, 35, 36, 37, 37, 37, 37, 37, 37, 37, 38, 38, 38, 38,
+38, 38, 38, 38, 38, 38, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 48, 49, 49, 49, 49, 49, 49,
+49, 49, 49, 49, 49, 49, 49, 49, 49, 49, 50, 51, 52, 53, 54, 55, 55, 55, 55, 55, 55, 56, 57, 58,
+59, 60, 61, 62, 63, 64, 65, 65, 65, 65, 65, 65, 65, 65, 66 };
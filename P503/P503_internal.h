@@ -0,0 +1,234 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key 
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: field sizes and symbol names of the library sources compiled for SIDHp503
+*
+*********************************************************************************************/  
+
+#ifndef __P503_INTERNAL_H__
+#define __P503_INTERNAL_H__
+
+
+// The field-dependent sources are compiled a second time with _P503_ defined (see the wrappers in this directory), which 
+// specializes the field arithmetic to GF(p503), p503 = 2^250*3^159-1, at compile time. This header is included before SIDH.h: 
+// it fixes the sizes from which the element types are derived, and renames every external symbol of these sources, so that 
+// both fields are linked in the same library. Names that refer to the field replace 751 with 503, the others get a "_p503" suffix.
+// The public functions compiled for SIDHp751 hand the operations on SIDHp503 curves to the renamed ones, see FIELD_DISPATCH.
+
+
+// Field and order sizes
+
+#define NBITS_FIELD           503
+#define NBITS_ORDER           256
+#define p751_ZERO_WORDS       (250/RADIX)          // Number of "0" digits in the least significant part of p503 + 1
+
+// Fixed parameters for isogeny tree computation
+#define MAX_INT_POINTS_ALICE  SIDHp503_STRATEGY_POINTS_ALICE
+#define MAX_INT_POINTS_BOB    SIDHp503_STRATEGY_POINTS_BOB
+#define MAX_Alice             SIDHp503_STRATEGY_LEAVES_ALICE
+#define MAX_Bob               SIDHp503_STRATEGY_LEAVES_BOB
+
+// Subgroup orders oA = 2^250 and oB = 3^159, and masks of the last random byte of the private keys (see random_mod_order())
+#define OALICE_BITS           250
+#define OBOB_EXPON            159
+#define MASK_ALICE            0x01
+#define MASK_BOB              0x07
+
+
+// Parameters and field constants, P503/P503.c
+
+#define splits_Alice                     splits_Alice_p503
+#define splits_Bob                       splits_Bob_p503
+#define Border_div3                      Border_div3_p503
+#define Montgomery_R2                    Montgomery_R2_p503
+#define p751                             p503
+#define p751p1                           p503p1
+
+// Field arithmetic backends, generic/fp_generic.c, P503/fp_x64_p503.c and P503/fp_x64_asm_p503.S
+
+#define fp_select_arithmetic             fp_select_arithmetic_p503
+#define fp_get_arithmetic                fp_get_arithmetic_p503
+#define is_adx_supported                 is_adx_supported_p503
+#define digit_x_digit                    digit_x_digit_p503
+#define mp_mul_schoolbook                mp_mul_schoolbook_p503
+#define mp_mul_comba                     mp_mul_comba_p503
+#define mp_sqr_comba                     mp_sqr_comba_p503
+#define fpadd751_generic                 fpadd503_generic
+#define fpsub751_generic                 fpsub503_generic
+#define rdc751_generic                   rdc503_generic
+#define fpadd751_x64                     fpadd503_x64
+#define fpsub751_x64                     fpsub503_x64
+#define rdc751_x64                       rdc503_x64
+#define fpadd751_asm                     fpadd503_asm
+#define fpsub751_asm                     fpsub503_asm
+#define mul751_asm                       mul503_asm
+#define sqr751_asm                       sqr503_asm
+#define rdc751_asm                       rdc503_asm
+#define mul751_adx                       mul503_adx
+#define rdc751_adx                       rdc503_adx
+#define fp2mul751_asm                    fp2mul503_asm
+#define fp2sqr751_asm                    fp2sqr503_asm
+#define fp2mul751_adx                    fp2mul503_adx
+#define fp2sqr751_adx                    fp2sqr503_adx
+#define fpneg751                         fpneg503
+#define fpdiv2_751                       fpdiv2_503
+
+// Field and GF(p^2) arithmetic, fpx.c
+
+#define copy_words                       copy_words_p503
+#define mp_add                           mp_add_p503
+#define mp_sub                           mp_sub_p503
+#define mp_mul                           mp_mul_p503
+#define mp_sqr                           mp_sqr_p503
+#define mp_shiftl1                       mp_shiftl1_p503
+#define mp_shiftr1                       mp_shiftr1_p503
+#define rdc_mont                         rdc_mont_p503
+#define to_mont                          to_mont_p503
+#define from_mont                        from_mont_p503
+#define to_fp2mont                       to_fp2mont_p503
+#define from_fp2mont                     from_fp2mont_p503
+#define fpcopy751                        fpcopy503
+#define fpzero751                        fpzero503
+#define fpadd751                         fpadd503
+#define fpsub751                         fpsub503
+#define fpmul751_mont                    fpmul503_mont
+#define fpsqr751_mont                    fpsqr503_mont
+#define fpinv751_mont                    fpinv503_mont
+#define fpinv751_mont_fermat             fpinv503_mont_fermat
+#define fpinv751_mont_safegcd            fpinv503_mont_safegcd
+#define fpsqrt751_mont                   fpsqrt503_mont
+#define fpequal751_non_constant_time     fpequal503_non_constant_time
+#define fp2copy751                       fp2copy503
+#define fp2zero751                       fp2zero503
+#define fp2neg751                        fp2neg503
+#define fp2add751                        fp2add503
+#define fp2sub751                        fp2sub503
+#define fp2div2_751                      fp2div2_503
+#define fp2sqr751_mont                   fp2sqr503_mont
+#define fp2sqr751_mont_default           fp2sqr503_mont_default
+#define fp2mul751_mont                   fp2mul503_mont
+#define fp2mul751_mont_default           fp2mul503_mont_default
+#define fp2inv751_mont                   fp2inv503_mont
+#define fp2sqrt751_mont                  fp2sqrt503_mont
+#define fp2equal751_non_constant_time    fp2equal503_non_constant_time
+#define mp_dfadd751                      mp_dfadd503
+#define mp_dfsub751                      mp_dfsub503
+#define fp2mul751_unreduced              fp2mul503_unreduced
+#define fp2dfadd751                      fp2dfadd503
+#define fp2dfsub751                      fp2dfsub503
+#define fp2rdc751                        fp2rdc503
+#define select_f2elm                     select_f2elm_p503
+#define swap_points                      swap_points_p503
+#define swap_points_basefield            swap_points_basefield_p503
+
+// Elliptic curve and isogeny functions, ec_isogeny.c
+
+#define j_inv                            j_inv_p503
+#define j_inv_checked                    j_inv_checked_p503
+#define j_inv_fraction                   j_inv_fraction_p503
+#define xDBLADD                          xDBLADD_p503
+#define xDBL                             xDBL_p503
+#define xDBLe                            xDBLe_p503
+#define xDBLe_collect                    xDBLe_collect_p503
+#define xADD                             xADD_p503
+#define xDBL_basefield                   xDBL_basefield_p503
+#define xDBLADD_basefield                xDBLADD_basefield_p503
+#define ladder                           ladder_p503
+#define secret_pt                        secret_pt_p503
+#define jDBL_basefield                   jDBL_basefield_p503
+#define jADD_basefield                   jADD_basefield_p503
+#define fixed_base_table                 fixed_base_table_p503
+#define secret_pt_fixed_base             secret_pt_fixed_base_p503
+#define ladder_3_pt                      ladder_3_pt_p503
+#define ladder_3_pt_init                 ladder_3_pt_init_p503
+#define ladder_3_pt_steps                ladder_3_pt_steps_p503
+#define get_4_isog                       get_4_isog_p503
+#define eval_4_isog                      eval_4_isog_p503
+#define first_4_isog                     first_4_isog_p503
+#define get_A24_tpl                      get_A24_tpl_p503
+#define get_A_tpl                        get_A_tpl_p503
+#define xTPL                             xTPL_p503
+#define xTPLe                            xTPLe_p503
+#define xTPLe_A24                        xTPLe_A24_p503
+#define xTPLe_collect                    xTPLe_collect_p503
+#define get_3_isog                       get_3_isog_p503
+#define eval_3_isog                      eval_3_isog_p503
+#define inv_4_way                        inv_4_way_p503
+#define inv_n_way                        inv_n_way_p503
+#define distort_and_diff                 distort_and_diff_p503
+#define BigMont_ladder                   BigMont_ladder_p503
+#define BigMont_KeyGeneration            BigMont_KeyGeneration_p503
+#define BigMont_SecretAgreement_batch    BigMont_SecretAgreement_batch_p503
+
+// Key exchange and validation, kex.c, kex_step.c and validate.c
+
+#define keygen_precompute                keygen_precompute_p503
+#define KeyGeneration_A                  KeyGeneration_A_p503
+#define KeyGeneration_B                  KeyGeneration_B_p503
+#define KeyGeneration_A_setup            KeyGeneration_A_setup_p503
+#define KeyGeneration_B_setup            KeyGeneration_B_setup_p503
+#define KeyGeneration_A_batch            KeyGeneration_A_batch_p503
+#define KeyGeneration_B_batch            KeyGeneration_B_batch_p503
+#define SecretAgreement_A                SecretAgreement_A_p503
+#define SecretAgreement_B                SecretAgreement_B_p503
+#define SecretAgreement_A_setup          SecretAgreement_A_setup_p503
+#define SecretAgreement_B_setup          SecretAgreement_B_setup_p503
+#define SecretAgreement_A_isogeny        SecretAgreement_A_isogeny_p503
+#define SecretAgreement_B_isogeny        SecretAgreement_B_isogeny_p503
+#define SecretAgreement_A_validated      SecretAgreement_A_validated_p503
+#define SecretAgreement_B_validated      SecretAgreement_B_validated_p503
+#define SecretAgreement_A_batch          SecretAgreement_A_batch_p503
+#define SecretAgreement_B_batch          SecretAgreement_B_batch_p503
+#define SecretAgreement_A_batch_status   SecretAgreement_A_batch_status_p503
+#define SecretAgreement_B_batch_status   SecretAgreement_B_batch_status_p503
+#define KeyGeneration_A_ws               KeyGeneration_A_ws_p503
+#define KeyGeneration_B_ws               KeyGeneration_B_ws_p503
+#define SecretAgreement_A_ws             SecretAgreement_A_ws_p503
+#define SecretAgreement_B_ws             SecretAgreement_B_ws_p503
+#define KeyGeneration_A_tagged           KeyGeneration_A_tagged_p503
+#define KeyGeneration_B_tagged           KeyGeneration_B_tagged_p503
+#define SecretAgreement_A_tagged         SecretAgreement_A_tagged_p503
+#define SecretAgreement_B_tagged         SecretAgreement_B_tagged_p503
+#define PublicKey_set_format             PublicKey_set_format_p503
+#define tagged_pk_format                 tagged_pk_format_p503
+#define SIDH_kex_start                   SIDH_kex_start_p503
+#define SIDH_kex_step                    SIDH_kex_step_p503
+#define SIDH_kex_free                    SIDH_kex_free_p503
+#define Validate_PKA                     Validate_PKA_p503
+#define Validate_PKB                     Validate_PKB_p503
+#define Validate_PKA_ws                  Validate_PKA_ws_p503
+#define Validate_PKB_ws                  Validate_PKB_ws_p503
+#define Validate_PKA_tagged              Validate_PKA_tagged_p503
+#define Validate_PKB_tagged              Validate_PKB_tagged_p503
+#define validate_PKA_mont                validate_PKA_mont_p503
+#define validate_PKB_mont                validate_PKB_mont_p503
+#define random_fp2                       random_fp2_p503
+
+// Setup, strategies and thread teams, SIDH_setup.c, strategy.c and threads.c
+
+#define SIDH_curve_allocate              SIDH_curve_allocate_p503
+#define SIDH_curve_initialize            SIDH_curve_initialize_p503
+#define SIDH_curve_free                  SIDH_curve_free_p503
+#define SIDH_set_arithmetic              SIDH_set_arithmetic_p503
+#define SIDH_set_fixed_base_window       SIDH_set_fixed_base_window_p503
+#define SIDH_set_threads                 SIDH_set_threads_p503
+#define SIDH_get_error_message           SIDH_get_error_message_p503
+#define SIDH_compute_strategy            SIDH_compute_strategy_p503
+#define SIDH_set_strategy                SIDH_set_strategy_p503
+#define SIDH_tune_strategies             SIDH_tune_strategies_p503
+#define is_CurveIsogenyStruct_null       is_CurveIsogenyStruct_null_p503
+#define random_mod_order                 random_mod_order_p503
+#define random_BigMont_mod_order         random_BigMont_mod_order_p503
+#define clear_words                      clear_words_p503
+#define thread_team_create               thread_team_create_p503
+#define thread_team_free                 thread_team_free_p503
+#define thread_team_acquire              thread_team_acquire_p503
+#define thread_team_eval                 thread_team_eval_p503
+#define thread_team_release              thread_team_release_p503
+
+
+#endif
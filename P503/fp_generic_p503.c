@@ -0,0 +1,13 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key 
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: portable modular arithmetic, generic/fp_generic.c, compiled for GF(p503)
+*
+*********************************************************************************************/
+
+#define _P503_
+#include "../generic/fp_generic.c"
@@ -0,0 +1,303 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key 
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: modular arithmetic over GF(p503) optimized for x64 platforms
+*
+*********************************************************************************************/
+
+#define _P503_
+#include "../SIDH_internal.h"
+#if (OS_TARGET == OS_LINUX)
+    #include <cpuid.h>
+#endif
+
+
+// Global constants
+extern const uint64_t p751[NWORDS_FIELD];
+extern const uint64_t p751p1[NWORDS_FIELD]; 
+
+// GF(p503^2) multiplication and squaring: the fused assembly kernels with the "ASM" option, the C functions over the GF(p503) kernels otherwise
+#if defined(ASM_SUPPORT)
+    #define fp2mul751_x64       fp2mul751_asm
+    #define fp2sqr751_x64       fp2sqr751_asm
+    #define fp2mul751_x64_adx   fp2mul751_adx
+    #define fp2sqr751_x64_adx   fp2sqr751_adx
+#else
+    #define fp2mul751_x64       fp2mul751_mont_default
+    #define fp2sqr751_x64       fp2sqr751_mont_default
+    #define fp2mul751_x64_adx   fp2mul751_mont_default
+    #define fp2sqr751_x64_adx   fp2sqr751_mont_default
+#endif
+
+// Field arithmetic backends of this implementation, see fp_get_arithmetic()
+static const FieldArithmetic fp_arithmetic_x64 = { ARITHMETIC_X64, fpadd751_x64, fpsub751_x64, mp_mul_comba, mp_sqr_comba, rdc751_x64, fp2mul751_x64, fp2sqr751_x64 };
+
+
+bool is_adx_supported(void)
+{ // Checks whether the processor supports the BMI2 (MULX) and ADX (ADCX/ADOX) instruction set extensions
+#if (OS_TARGET == OS_LINUX)
+    unsigned int eax, ebx, ecx, edx;
+
+    if (__get_cpuid_max(0, NULL) < 7) {
+        return false;
+    }
+    __cpuid_count(7, 0, eax, ebx, ecx, edx);
+    return ((ebx >> 8) & 1) && ((ebx >> 19) & 1);    // BMI2 is bit 8 and ADX is bit 19 of EBX
+#else
+    return false;
+#endif
+}
+
+
+#if (OS_TARGET == OS_LINUX)
+
+static void mp_mul_adx(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords)
+{ // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = NWORDS_FIELD, using the BMI2 and ADX instructions
+    
+    UNREFERENCED_PARAMETER(nwords);
+
+    mul751_adx(a, b, c);
+}
+
+static const FieldArithmetic fp_arithmetic_x64_adx = { ARITHMETIC_X64_ADX, fpadd751_x64, fpsub751_x64, mp_mul_adx, mp_sqr_comba, rdc751_adx, fp2mul751_x64_adx, fp2sqr751_x64_adx };
+
+#endif
+
+
+CRYPTO_STATUS fp_get_arithmetic(ARITHMETIC_ID id, const FieldArithmetic** arithmetic)
+{ // Set "arithmetic" to the kernel table of the backend "id".
+  // ARITHMETIC_DEFAULT selects the BMI2/ADX kernels whenever the processor supports them.
+
+    if (arithmetic == NULL || id >= ARITHMETIC_END_OF_LIST) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (id == ARITHMETIC_DEFAULT) {
+        id = is_adx_supported() ? ARITHMETIC_X64_ADX : ARITHMETIC_X64;
+    }
+
+    if (id == ARITHMETIC_X64) {
+        *arithmetic = &fp_arithmetic_x64;
+#if (OS_TARGET == OS_LINUX)
+    } else if (id == ARITHMETIC_X64_ADX && is_adx_supported()) {
+        *arithmetic = &fp_arithmetic_x64_adx;
+#endif
+    } else {
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    return CRYPTO_SUCCESS;
+}
+
+
+void fpadd751_x64(digit_t* a, digit_t* b, digit_t* c)
+{ // Modular addition, c = a+b mod p503.
+  // Inputs: a, b in [0, p503-1] 
+  // Output: c in [0, p503-1] 
+    
+#if (OS_TARGET == OS_WIN)
+    unsigned int i, carry = 0;
+    digit_t mask;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(carry, a[i], b[i], carry, c[i]); 
+    }
+
+    carry = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        SUBC(carry, c[i], ((digit_t*) p751)[i], carry, c[i]); 
+    }
+    mask = 0 - (digit_t)carry;
+
+    carry = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(carry, c[i], ((digit_t*) p751)[i] & mask, carry, c[i]); 
+    } 
+    
+#elif (OS_TARGET == OS_LINUX)                 
+    
+    fpadd751_asm(a, b, c);    
+
+#endif
+} 
+
+
+void fpsub751_x64(digit_t* a, digit_t* b, digit_t* c)
+{ // Modular subtraction, c = a-b mod p503.
+  // Inputs: a, b in [0, p503-1] 
+  // Output: c in [0, p503-1] 
+    
+#if (OS_TARGET == OS_WIN)
+    unsigned int i, borrow = 0;
+    digit_t mask;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        SUBC(borrow, a[i], b[i], borrow, c[i]); 
+    }
+    mask = 0 - (digit_t)borrow;
+
+    borrow = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(borrow, c[i], ((digit_t*) p751)[i] & mask, borrow, c[i]); 
+    }
+    
+#elif (OS_TARGET == OS_LINUX)                 
+    
+    fpsub751_asm(a, b, c);    
+
+#endif
+}
+
+
+__inline void fpneg751(digit_t* a)
+{ // Modular negation, a = -a mod p503.
+  // Input/output: a in [0, p503-1] 
+    unsigned int i, borrow = 0;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        SUBC(borrow, ((digit_t*) p751)[i], a[i], borrow, a[i]); 
+    }
+}
+
+
+void fpdiv2_751(digit_t* a, digit_t* c)
+{ // Modular division by two, c = a/2 mod p503.
+  // Input : a in [0, p503-1] 
+  // Output: c in [0, p503-1] 
+    unsigned int i, carry = 0;
+    digit_t mask;
+        
+    mask = 0 - (digit_t)(a[0] & 1);    // If a is odd compute a+p503
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        ADDC(carry, a[i], ((digit_t*) p751)[i] & mask, carry, c[i]); 
+    }
+
+    mp_shiftr1(c, NWORDS_FIELD);
+} 
+
+
+void mp_mul_comba(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords)
+{ // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = nwords.
+        
+#if (OS_TARGET == OS_WIN)
+    unsigned int i, j, carry = 0;
+    digit_t t = 0, u = 0, v = 0, UV[2];
+    
+    for (i = 0; i < 2*nwords-1; i++) {
+        for (j = (i < nwords) ? 0 : i-nwords+1; j <= i && j < nwords; j++) {
+            MUL(a[j], b[i - j], UV+1, UV[0]); 
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        c[i] = v;
+        v = u; 
+        u = t;
+        t = 0;
+    }
+    c[(2 * nwords) - 1] = v; 
+
+#elif (OS_TARGET == OS_LINUX)
+    
+    UNREFERENCED_PARAMETER(nwords);
+
+    mul751_asm(a, b, c);
+
+#endif
+}
+
+
+void mp_sqr_comba(digit_t* a, digit_t* c, unsigned int nwords)
+{ // Multiprecision comba squaring, c = a^2, where lng(a) = nwords.
+  // The cross products a[i]*a[j], i < j, of each column are computed once and their sum is doubled.
+
+#if (OS_TARGET == OS_WIN)
+    unsigned int i, j, k, carry = 0;
+    digit_t t = 0, u = 0, v = 0, ct, cu, cv, UV[2];
+
+    for (k = 0; k < 2*nwords-1; k++) {
+        ct = 0; cu = 0; cv = 0;
+        i = (k < nwords) ? 0 : k-nwords+1;
+        for (j = k-i; i < j; i++, j--) {
+            MUL(a[i], a[j], UV+1, UV[0]);
+            ADDC(0, UV[0], cv, carry, cv);
+            ADDC(carry, UV[1], cu, carry, cu);
+            ct += carry;
+        }
+        ct = (ct << 1) | (cu >> (RADIX-1));
+        cu = (cu << 1) | (cv >> (RADIX-1));
+        cv <<= 1;
+        if ((k & 1) == 0) {
+            MUL(a[k/2], a[k/2], UV+1, UV[0]);
+            ADDC(0, UV[0], cv, carry, cv);
+            ADDC(carry, UV[1], cu, carry, cu);
+            ct += carry;
+        }
+        ADDC(0, cv, v, carry, v);
+        ADDC(carry, cu, u, carry, u);
+        t += ct + carry;
+        c[k] = v;
+        v = u;
+        u = t;
+        t = 0;
+    }
+    c[2*nwords-1] = v;
+
+#elif (OS_TARGET == OS_LINUX)
+    
+    UNREFERENCED_PARAMETER(nwords);
+
+    sqr751_asm(a, c);
+
+#endif
+}
+
+
+void rdc751_x64(dfelm_t ma, felm_t mc)
+{ // Optimized Montgomery reduction using comba and exploiting the special form of the prime p503.
+  // mc = ma*mb*R^-1 mod p503, where ma,mb,mc in [0, p503-1] and R = 2^512.
+  // ma and mb are assumed to be in Montgomery representation.
+        
+#if (OS_TARGET == OS_WIN)
+    unsigned int i, j, carry;
+    digit_t mask, UV[2], t = 0, u = 0, v = 0, z[NWORDS_FIELD] = {0};
+
+    for (i = 0; i < 2*NWORDS_FIELD-1; i++) {
+        for (j = (i < NWORDS_FIELD) ? 0 : i-NWORDS_FIELD+1; j < NWORDS_FIELD && j + p751_ZERO_WORDS <= i; j++) {
+            MUL(z[j], ((digit_t*) p751p1)[i - j], UV+1, UV[0]);    // The p751_ZERO_WORDS least significant words of p503+1 are zero
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
+        }
+        ADDC(0, v, ma[i], carry, v); 
+        ADDC(carry, u, 0, carry, u); 
+        t += carry; 
+        if (i < NWORDS_FIELD) {
+            z[i] = v;
+        } else {
+            z[i-NWORDS_FIELD] = v;
+        }
+        v = u;
+        u = t;
+        t = 0;
+    }
+    ADDC(0, v, ma[2*NWORDS_FIELD-1], carry, z[NWORDS_FIELD-1]); 
+
+    // Final, constant-time subtraction     
+    carry = mp_sub(z, (digit_t*) &p751, mc, NWORDS_FIELD);     // (carry, mc) = z - p503
+    mask = 0 - (digit_t)carry;                                // if mc < 0 then mask = 0xFF..F, else if mc >= 0 then mask = 0x00..0
+
+    carry = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {                      // mc = mc + (mask & p503)
+        ADDC(carry, mc[i], ((digit_t*) p751)[i] & mask, carry, mc[i]);
+    }
+    
+#elif (OS_TARGET == OS_LINUX)                 
+    
+    rdc751_asm(ma, mc);    
+
+#endif
+}
@@ -60,28 +60,34 @@ extern "C" {
 #define TARGET_AMD64        1
 #define TARGET_x86          2
 #define TARGET_ARM          3
+#define TARGET_ARM64        4
+#define TARGET_GENERIC64    5
 
 #if defined(_AMD64_)
     #define TARGET TARGET_AMD64
     #define RADIX           64
     typedef uint64_t        digit_t;        // Unsigned 64-bit digit
     typedef int64_t         sdigit_t;       // Signed 64-bit digit
-    #define NWORDS_FIELD    12              // Number of words of a 751-bit field element
-    #define p751_ZERO_WORDS 5               // Number of "0" digits in the least significant part of p751 - 1     
 #elif defined(_X86_)
     #define TARGET TARGET_x86
     #define RADIX           32
     typedef uint32_t        digit_t;        // Unsigned 32-bit digit
     typedef int32_t         sdigit_t;       // Signed 32-bit digit
-    #define NWORDS_FIELD    24 
-    #define p751_ZERO_WORDS 11
 #elif defined(_ARM_)
     #define TARGET TARGET_ARM
     #define RADIX           32
     typedef uint32_t        digit_t;        // Unsigned 32-bit digit
     typedef int32_t         sdigit_t;       // Signed 32-bit digit
-    #define NWORDS_FIELD    24
-    #define p751_ZERO_WORDS 11
+#elif defined(_ARM64_)
+    #define TARGET TARGET_ARM64
+    #define RADIX           64
+    typedef uint64_t        digit_t;        // Unsigned 64-bit digit
+    typedef int64_t         sdigit_t;       // Signed 64-bit digit
+#elif defined(_GENERIC64_)                 // Other 64-bit platforms, e.g., POWER and RISC-V, supported by the portable implementation
+    #define TARGET TARGET_GENERIC64
+    #define RADIX           64
+    typedef uint64_t        digit_t;        // Unsigned 64-bit digit
+    typedef int64_t         sdigit_t;       // Signed 64-bit digit
 #else
     #error -- "Unsupported ARCHITECTURE"
 #endif
@@ -94,8 +100,11 @@ extern "C" {
 #define NO_SIMD_SUPPORT 0
 #define AVX_SUPPORT     1
 #define AVX2_SUPPORT    2
+#define AVX512IFMA_SUPPORT  3
 
-#if defined(_AVX2_)
+#if defined(_AVX512IFMA_)
+    #define SIMD_SUPPORT AVX512IFMA_SUPPORT // AVX-512 IFMA support selection 
+#elif defined(_AVX2_)
     #define SIMD_SUPPORT AVX2_SUPPORT       // AVX2 support selection 
 #elif defined(_AVX_)
     #define SIMD_SUPPORT AVX_SUPPORT        // AVX support selection 
@@ -111,6 +120,59 @@ extern "C" {
     #define GENERIC_IMPLEMENTATION
 #endif
 
+#if defined(_THREADS_)                      // Selection of the parallel isogeny tree traversal using POSIX threads
+    #define THREADS_SUPPORT
+#endif
+
+#define SIDH_MAX_THREADS    8               // Max. number of threads per isogeny tree traversal, see SIDH_set_threads()
+
+#if defined(_TRACE_)                        // Selection of the trace points, see SIDH_set_trace()
+    #define TRACE_SUPPORT
+#endif
+
+#if defined(_LOW_MEMORY_)                   // Selection of the low-memory mode, which bounds the points stored by the traversals and the inversion table
+    #define LOW_MEMORY_SUPPORT
+#endif
+
+// Max. number of points stored by the isogeny tree traversals in the low-memory mode, for both trees and both parameter sets.
+// Each stored point is a projective point (X:Z), i.e., 2 GF(p^2) elements or 384 bytes for SIDHp751.
+#if !defined(LOW_MEMORY_POINTS)
+    #define LOW_MEMORY_POINTS   6
+#endif
+
+// Number of leaves of Alice's and Bob's isogeny trees, and max. number of points stored by their traversals, for SIDHp751 (see SIDH_set_strategy()).
+#define SIDH_STRATEGY_LEAVES_ALICE  185
+#define SIDH_STRATEGY_LEAVES_BOB    239
+// The same for SIDHp503, whose trees are smaller
+#define SIDHp503_STRATEGY_LEAVES_ALICE  124
+#define SIDHp503_STRATEGY_LEAVES_BOB    159
+#if defined(LOW_MEMORY_SUPPORT)
+    #define SIDH_STRATEGY_POINTS_ALICE      LOW_MEMORY_POINTS
+    #define SIDH_STRATEGY_POINTS_BOB        LOW_MEMORY_POINTS
+    #define SIDHp503_STRATEGY_POINTS_ALICE  LOW_MEMORY_POINTS
+    #define SIDHp503_STRATEGY_POINTS_BOB    LOW_MEMORY_POINTS
+#else
+    #define SIDH_STRATEGY_POINTS_ALICE      8
+    #define SIDH_STRATEGY_POINTS_BOB        10
+    #define SIDHp503_STRATEGY_POINTS_ALICE  7
+    #define SIDHp503_STRATEGY_POINTS_BOB    9
+#endif
+
+// Selection of the built-in DRBG as the source of random values of the curve isogeny structures set up by SIDH_curve_initialize() (see SIDH_set_drbg())
+#if defined(_DRBG_)
+    #define DRBG_DEFAULT        true
+#else
+    #define DRBG_DEFAULT        false
+#endif
+
+// Window width of the fixed-base tables built by SIDH_curve_initialize() to speed up key generation (see SIDH_set_fixed_base_window()).
+// Wider windows take more memory and fewer point additions: about 290KB, 385KB, 580KB, 925KB and 1.5MB for widths 2 to 6, respectively, 
+// half of which is taken by the table of BigMont's generator and the rest by those of PA and PB.
+// Width 0 disables the tables, in which case key generation uses the Montgomery ladder.
+#if !defined(FIXED_BASE_WINDOW)
+    #define FIXED_BASE_WINDOW   4
+#endif
+
 
 // Unsupported configurations
                          
@@ -126,18 +188,55 @@ extern "C" {
     #error -- "Unsupported configuration"
 #endif
 
-#if (TARGET != TARGET_AMD64) && !defined(GENERIC_IMPLEMENTATION)
+#if (SIMD_SUPPORT != NO_SIMD_SUPPORT) && (TARGET != TARGET_AMD64)
+    #error -- "Unsupported configuration"
+#endif
+
+#if (TARGET != TARGET_AMD64) && (TARGET != TARGET_ARM64) && !defined(GENERIC_IMPLEMENTATION)
+    #error -- "Unsupported configuration"
+#endif
+
+#if (TARGET == TARGET_ARM64) && (OS_TARGET != OS_LINUX) && !defined(GENERIC_IMPLEMENTATION)
+    #error -- "Unsupported configuration"
+#endif
+
+#if (TARGET == TARGET_ARM64) && !defined(ASM_SUPPORT) && !defined(GENERIC_IMPLEMENTATION)
+    #error -- "Unsupported configuration"
+#endif
+
+#if defined(THREADS_SUPPORT) && (OS_TARGET != OS_LINUX)
+    #error -- "Unsupported configuration"
+#endif
+
+#if defined(SIDH_OPCOUNT) && (OS_TARGET != OS_LINUX)
+    #error -- "Unsupported configuration"
+#endif
+
+#if (FIXED_BASE_WINDOW != 0) && ((FIXED_BASE_WINDOW < 2) || (FIXED_BASE_WINDOW > 6))
+    #error -- "Unsupported configuration"
+#endif
+
+#if defined(LOW_MEMORY_SUPPORT) && ((LOW_MEMORY_POINTS < 1) || (LOW_MEMORY_POINTS > 7))
+    #error -- "Unsupported configuration"
+#endif
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)     // Keys and random values are read as little-endian digits
     #error -- "Unsupported configuration"
 #endif
 
 
 // Extended datatype support
  
-#if defined(GENERIC_IMPLEMENTATION)                       
+#if defined(GENERIC_IMPLEMENTATION) && (RADIX == 64) && defined(__SIZEOF_INT128__) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+    #define UINT128_SUPPORT                 // Native 128-bit integers for the digit operations of the portable implementation
+    typedef unsigned uint128_t __attribute__((mode(TI))); 
+    typedef signed sint128_t __attribute__((mode(TI))); 
+#elif defined(GENERIC_IMPLEMENTATION)                       
     typedef uint64_t uint128_t[2];
-#elif (TARGET == TARGET_AMD64 && OS_TARGET == OS_LINUX) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
+#elif ((TARGET == TARGET_AMD64 || TARGET == TARGET_ARM64) && OS_TARGET == OS_LINUX) && (COMPILER == COMPILER_GCC || COMPILER == COMPILER_CLANG)
     #define UINT128_SUPPORT
     typedef unsigned uint128_t __attribute__((mode(TI))); 
+    typedef signed sint128_t __attribute__((mode(TI))); 
 #elif (TARGET == TARGET_AMD64) && (OS_TARGET == OS_WIN && COMPILER == COMPILER_VC)
     #define SCALAR_INTRIN_SUPPORT   
     typedef uint64_t uint128_t[2];
@@ -148,13 +247,19 @@ extern "C" {
 
 // Basic constants
 
-#define NBITS_FIELD     751  
+// The field and order sizes are those of SIDHp751, except in the library sources compiled for another parameter set, whose 
+// internal header predefines them (see P503/P503_internal.h). The MAX* sizes of the public structures are the same for all sets.
+#if !defined(NBITS_FIELD)
+    #define NBITS_FIELD     751  
+    #define NBITS_ORDER     384
+    #define p751_ZERO_WORDS (372/RADIX)                     // Number of "0" digits in the least significant part of p751 + 1
+#endif
+#define NWORDS_FIELD    ((NBITS_FIELD+RADIX-1)/RADIX)       // Number of words of a field element
 #define MAXBITS_FIELD   768                
 #define MAXWORDS_FIELD  ((MAXBITS_FIELD+RADIX-1)/RADIX)     // Max. number of words to represent field elements
-#define NWORDS64_FIELD  ((NBITS_FIELD+63)/64)               // Number of 64-bit words of a 751-bit field element 
-#define NBITS_ORDER     384
+#define NWORDS64_FIELD  ((NBITS_FIELD+63)/64)               // Number of 64-bit words of a field element 
 #define NWORDS_ORDER    ((NBITS_ORDER+RADIX-1)/RADIX)       // Number of words of oA and oB, where oA and oB are the subgroup orders of Alice and Bob, resp.
-#define MAXBITS_ORDER   NBITS_ORDER                         
+#define MAXBITS_ORDER   384                         
 #define MAXWORDS_ORDER  ((MAXBITS_ORDER+RADIX-1)/RADIX)     // Max. number of words to represent elements in [1, oA-1] or [1, oB].
   
 // Basic constants for elliptic curve BigMont
@@ -163,6 +268,7 @@ extern "C" {
 #define BIGMONT_MAXBITS_ORDER   768  
 #define BIGMONT_NWORDS_ORDER    ((BIGMONT_NBITS_ORDER+RADIX-1)/RADIX)       // Number of words of BigMont's subgroup order.
 #define BIGMONT_MAXWORDS_ORDER  ((BIGMONT_MAXBITS_ORDER+RADIX-1)/RADIX)     // Max. number of words to represent elements in [1, BigMont_order].
+#define BIGMONT_GENERATOR_X     3                                           // x-coordinate of the generator of BigMont's subgroup used by BigMont_KeyGeneration()
    
 
 // Definitions of the error-handling type and error codes
@@ -203,10 +309,96 @@ typedef enum {
 typedef CRYPTO_STATUS (*RandomBytes)(unsigned int nbytes, unsigned char* random_array);
 
 
-// Definition of type for curve isogeny system identifiers. Currently valid value is "SIDHp751" (see SIDH.h)
+// Definition of type for curve isogeny system identifiers. Currently valid values are "SIDHp751" and "SIDHp503" (see SIDH.h)
 typedef char CurveIsogeny_ID[10];
 
 
+// Definition of the field arithmetic backend identifiers (see SIDH_set_arithmetic())
+
+typedef enum {
+    ARITHMETIC_DEFAULT,                      // Fastest backend supported by the processor
+    ARITHMETIC_GENERIC,                      // Portable C implementation, available when GENERIC_IMPLEMENTATION is enabled
+    ARITHMETIC_X64,                          // x64 implementation, using the baseline x64 assembly in Linux
+    ARITHMETIC_X64_ADX,                      // x64 assembly using the BMI2 and ADX instructions (MULX/ADCX/ADOX), Linux only
+    ARITHMETIC_ARM64,                        // AArch64 assembly using the MUL/UMULH instructions, Linux only, available when ASM_SUPPORT is enabled
+    ARITHMETIC_END_OF_LIST
+} ARITHMETIC_ID;
+
+
+// Field arithmetic backend: table of the kernels through which the key exchange, validation and isogeny functions 
+// perform the arithmetic over GF(p751) and GF(p751^2). Elements of GF(p751^2) are passed as two consecutive field elements
+typedef struct
+{
+    ARITHMETIC_ID    Id;                                                                   // Backend identifier
+    void (*fpadd)(digit_t* a, digit_t* b, digit_t* c);                                     // Modular addition, c = a+b mod p751
+    void (*fpsub)(digit_t* a, digit_t* b, digit_t* c);                                     // Modular subtraction, c = a-b mod p751
+    void (*mp_mul)(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords);               // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords
+    void (*mp_sqr)(digit_t* a, digit_t* c, unsigned int nwords);                           // Multiprecision squaring, c = a^2, where lng(a) = nwords
+    void (*rdc_mont)(digit_t* ma, digit_t* mc);                                            // Montgomery reduction, mc = ma*R^-1 mod p751
+    void (*fp2mul)(digit_t a[2][NWORDS_FIELD], digit_t b[2][NWORDS_FIELD], digit_t c[2][NWORDS_FIELD]);  // GF(p751^2) multiplication, c = a*b
+    void (*fp2sqr)(digit_t a[2][NWORDS_FIELD], digit_t c[2][NWORDS_FIELD]);               // GF(p751^2) squaring, c = a^2
+} FieldArithmetic, *PFieldArithmetic;
+
+
+// Operation counters, available when the library is built with SIDH_OPCOUNT (see SIDH_opcount_get())
+
+typedef enum {
+    OPCOUNT_MP_MUL,                          // Multiprecision multiplications, including those of fpmul751_mont() and fpsqr751_mont()
+    OPCOUNT_RDC,                             // Montgomery reductions
+    OPCOUNT_FPADD,                           // Modular additions
+    OPCOUNT_FPSUB,                           // Modular subtractions
+    OPCOUNT_FPINV,                           // Field inversions
+    OPCOUNT_FP2MUL,                          // GF(p751^2) multiplications
+    OPCOUNT_FP2SQR,                          // GF(p751^2) squarings
+    OPCOUNT_END_OF_LIST
+} OPCOUNT_OP;
+
+typedef enum {
+    OPCOUNT_PHASE_OTHER,                     // Everything not listed below, e.g., private key sampling and public key validation
+    OPCOUNT_PHASE_SCALAR_MULT,               // Kernel point computation, secret_pt() or ladder_3_pt()
+    OPCOUNT_PHASE_TRAVERSAL,                 // Isogeny tree traversal, including the first 4-isogeny
+    OPCOUNT_PHASE_NORMALIZATION,             // Final inversions and conversions of the public keys
+    OPCOUNT_PHASE_JINV,                      // j-invariant of the shared curve
+    OPCOUNT_PHASE_END_OF_LIST
+} OPCOUNT_PHASE;
+
+typedef struct
+{
+    uint64_t         count[OPCOUNT_PHASE_END_OF_LIST][OPCOUNT_END_OF_LIST];   // Number of calls to each operation in each phase
+} OpCounters;
+
+
+
+// Trace points, available when the library is built with TRACE_SUPPORT (see SIDH_set_trace())
+
+typedef enum {
+    SIDH_TRACE_KEYGEN_A,                     // KeyGeneration_A()
+    SIDH_TRACE_KEYGEN_B,                     // KeyGeneration_B()
+    SIDH_TRACE_SHARED_A,                     // SecretAgreement_A()
+    SIDH_TRACE_SHARED_B,                     // SecretAgreement_B()
+    SIDH_TRACE_VALIDATE_A,                   // Validate_PKA()
+    SIDH_TRACE_VALIDATE_B,                   // Validate_PKB()
+    SIDH_TRACE_BIGMONT_LADDER,               // BigMont_ladder()
+    SIDH_TRACE_OPERATION_END_OF_LIST
+} SIDH_TRACE_OPERATION;
+
+typedef enum {
+    SIDH_TRACE_BEGIN,                        // Start of an operation, arg = SIDH_TRACE_OPERATION
+    SIDH_TRACE_SCALAR_MULT,                  // End of the kernel point computation, secret_pt() or ladder_3_pt(), or of BigMont's ladder
+    SIDH_TRACE_ROW,                          // End of a row of the isogeny tree traversal, arg = row in [1, number of leaves - 1]
+    SIDH_TRACE_TRAVERSAL,                    // End of the isogeny tree traversal, including the last isogeny
+    SIDH_TRACE_NORMALIZATION,                // End of the final inversion inv_4_way() and conversions of the public key
+    SIDH_TRACE_JINV,                         // End of the j-invariant j_inv() of the shared curve
+    SIDH_TRACE_VALIDATION_STEP,              // End of an iteration of the public key validation loop, arg = iteration
+    SIDH_TRACE_END,                          // End of an operation, arg = SIDH_TRACE_OPERATION
+    SIDH_TRACE_END_OF_LIST
+} SIDH_TRACE_POINT;
+
+// Trace callback, called on the thread that reaches trace point "Point" with its argument "arg" and a timestamp in processor cycles
+// (time stamp counter on x64, virtual counter on ARM64, nanoseconds elsewhere)
+typedef void (*SIDH_TraceCallback)(void* Context, SIDH_TRACE_POINT Point, unsigned int arg, uint64_t cycles);
+
+
 // Supersingular elliptic curve isogeny structures:
 
 // This data struct contains the static curve isogeny data
@@ -257,6 +449,19 @@ typedef struct
     digit_t*         Montgomery_pp;                          // Montgomery constant -p^-1 mod 2^W, using a suitable value W
     digit_t*         Montgomery_one;                         // Value one in Montgomery representation
     RandomBytes      RandomBytesFunction;                    // Function providing random bytes to generate nonces or secret keys
+    bool             DRBG;                                   // Set if random bytes are drawn from the per-thread DRBG seeded by RandomBytesFunction, see SIDH_set_drbg()
+    FieldArithmetic  Arithmetic;                             // Field arithmetic backend of the process, recorded by SIDH_curve_initialize() and SIDH_set_arithmetic()
+    unsigned int     FixedBaseWindow;                        // Window width of the fixed-base tables, 0 if key generation uses the Montgomery ladder
+    digit_t*         PA_table;                               // Fixed-base table of odd multiples of PA, see SIDH_set_fixed_base_window()
+    digit_t*         PB_table;                               // Fixed-base table of odd multiples of PB, see SIDH_set_fixed_base_window()
+    digit_t*         BigMont_table;                          // Fixed-base table of odd multiples of BigMont's generator (SIDHp751 only)
+    unsigned int*    StrategyAlice;                          // Splits of the optimal strategy for Alice's isogeny tree, see SIDH_set_strategy()
+    unsigned int*    StrategyBob;                            // Splits of the optimal strategy for Bob's isogeny tree, see SIDH_set_strategy()
+    void*            KeyGenPrecomp;                          // Generators and torsion images used by key generation, computed by SIDH_curve_initialize()
+    OpCounters*      OpCounts;                               // Operation counters of the operations on this structure, only with SIDH_OPCOUNT
+    SIDH_TraceCallback TraceCallback;                        // Callback of the trace points reached by the operations on this structure, see SIDH_set_trace()
+    void*            TraceContext;                           // First argument of TraceCallback
+    void*            ThreadTeam;                             // Worker threads of the parallel isogeny tree traversal, see SIDH_set_threads()
 } CurveIsogenyStruct, *PCurveIsogenyStruct;
 
 
@@ -265,6 +470,11 @@ typedef struct
 // "SIDHp751", base curve: supersingular elliptic curve E: y^2 = x^3 + x
 extern CurveIsogenyStaticData CurveIsogeny_SIDHp751;
 
+// "SIDHp503", base curve: supersingular elliptic curve E: y^2 = x^3 + x over GF(p503^2), where p503 = 2^250*3^159-1.
+// A faster, lower-security parameter set with keys and shared secrets encoded in 64-octet field elements. Public key compression 
+// and BigMont are only supported with SIDHp751, and the multi-buffer backends are not used for SIDHp503.
+extern CurveIsogenyStaticData CurveIsogeny_SIDHp503;
+
 
 /******************** Function prototypes ***********************/
 /*************** Setup/initialization functions *****************/ 
@@ -280,6 +490,75 @@ CRYPTO_STATUS SIDH_curve_initialize(PCurveIsogenyStruct pCurveIsogeny, RandomByt
 // Free memory for curve isogeny structure
 void SIDH_curve_free(PCurveIsogenyStruct pCurveIsogeny);
 
+// Select the field arithmetic backend "Arithmetic" and record it in pCurveIsogeny. ARITHMETIC_DEFAULT selects the fastest 
+// backend supported by the processor, which is the choice made by SIDH_curve_initialize(). 
+// The backend is used process-wide, i.e., by the operations on every curve isogeny structure, and is selected only once: the 
+// first call (or the first field operation) fixes it, so that threads always share one immutable set of kernels. To use another 
+// backend, call this function on an allocated structure before any SIDH_curve_initialize(). Later calls only record the backend 
+// in use and return CRYPTO_ERROR_INVALID_PARAMETER if "Arithmetic" asks for a different one. Returns CRYPTO_ERROR_NOT_IMPLEMENTED 
+// if the backend is not available in this build or on this processor.
+CRYPTO_STATUS SIDH_set_arithmetic(PCurveIsogenyStruct pCurveIsogeny, ARITHMETIC_ID Arithmetic);
+
+// Rebuild the fixed-base tables used by key generation, including BigMont_KeyGeneration(), with window width "window" in [2, 6], which trades memory for speed. 
+// SIDH_curve_initialize() builds them with width FIXED_BASE_WINDOW. Width 0 frees the tables and key generation falls back 
+// to the Montgomery ladder. Returns CRYPTO_ERROR_NO_MEMORY if the tables cannot be allocated, leaving the tables disabled.
+CRYPTO_STATUS SIDH_set_fixed_base_window(PCurveIsogenyStruct pCurveIsogeny, unsigned int window);
+
+// Draw the random values of private keys and public key validation on pCurveIsogeny from a built-in DRBG (enable = true) instead of calling 
+// its RandomBytesFunction each time. Each thread has its own DRBG, a ChaCha20 keystream with fast key erasure that is seeded with 32 bytes 
+// from RandomBytesFunction, refilled 1KB at a time and reseeded after 1MB of output, in a forked child process and when it is used with 
+// another RandomBytesFunction. SIDH_curve_initialize() enables it if the library was built with the DRBG option (DRBG_DEFAULT).
+CRYPTO_STATUS SIDH_set_drbg(PCurveIsogenyStruct pCurveIsogeny, bool enable);
+
+// Wipe the DRBG state of the calling thread, e.g., before the thread exits. The DRBG is reseeded on its next use.
+void SIDH_drbg_clear(void);
+
+// Set the number of threads "nthreads" in [1, SIDH_MAX_THREADS] that compute each isogeny tree traversal of the key generation and 
+// shared secret functions, to reduce the latency of a single operation on otherwise idle cores. nthreads-1 worker threads are 
+// started and kept until the next call or SIDH_curve_free(); the calling thread takes part in the traversal. The default, 1, 
+// computes the traversals serially. The workers are used by one operation at a time: operations running concurrently on the same 
+// structure fall back to the serial traversal. This function must not be called while other threads run SIDH operations on pCurveIsogeny.
+// Returns CRYPTO_ERROR_NOT_IMPLEMENTED if nthreads > 1 and the library was built without thread support (see the THREADS option).
+CRYPTO_STATUS SIDH_set_threads(PCurveIsogenyStruct pCurveIsogeny, unsigned int nthreads);
+
+// Compute the splits of an optimal strategy for Alice's (AliceOrBob = ALICE) or Bob's isogeny tree on pCurveIsogeny, given the relative costs 
+// "cost_mul" of a scalar multiplication by 4 (resp. 3) and "cost_eval" of a 4-isogeny (resp. 3-isogeny) evaluation. The traversal stores at 
+// most "max_points" points, in [1, SIDH_STRATEGY_POINTS_ALICE] (resp. SIDH_STRATEGY_POINTS_BOB) for SIDHp751. The output "splits" has one 
+// entry per leaf of the tree, i.e., SIDH_STRATEGY_LEAVES_ALICE (resp. SIDH_STRATEGY_LEAVES_BOB) entries for SIDHp751 (see the SIDHp503_STRATEGY_* 
+// sizes for SIDHp503), and it can be installed with SIDH_set_strategy() or stored as a table.
+CRYPTO_STATUS SIDH_compute_strategy(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, unsigned int cost_mul, unsigned int cost_eval, unsigned int max_points, unsigned int* splits);
+
+// Install the strategy "splits" computed by SIDH_compute_strategy() for Alice's or Bob's isogeny tree traversals on pCurveIsogeny. 
+// SIDH_curve_initialize() installs the precomputed strategies for the costs of the x64 implementation. Returns 
+// CRYPTO_ERROR_INVALID_PARAMETER if "splits" is not a valid strategy or if its traversal stores too many points.
+// This function must not be called while other threads run SIDH operations on pCurveIsogeny.
+CRYPTO_STATUS SIDH_set_strategy(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, const unsigned int* splits);
+
+// Measure the costs of the scalar multiplications and isogeny evaluations with the field arithmetic in use on this processor, and 
+// install the optimal strategies for them on pCurveIsogeny. The measured costs are returned in costs[0..3] if "costs" is not NULL, in 
+// nanoseconds: 4-multiplication, 4-isogeny evaluation, 3-multiplication and 3-isogeny evaluation. It takes about a tenth of a second.
+// This function must not be called while other threads run SIDH operations on pCurveIsogeny.
+CRYPTO_STATUS SIDH_tune_strategies(PCurveIsogenyStruct pCurveIsogeny, unsigned int* costs);
+
+// Copy the operation counters of the operations run on pCurveIsogeny, or of the operations run by the calling thread if pCurveIsogeny 
+// is NULL, to Counters. Counts include nested calls, e.g., fpinv751_mont() also counts its multiplications, and the split of the 
+// GF(p751^2) operations into GF(p751) operations depends on the field arithmetic backend. Operations of the multi-buffer backends 
+// are not counted. Returns CRYPTO_ERROR_NOT_IMPLEMENTED if the library was built without SIDH_OPCOUNT (see the OPCOUNT option).
+CRYPTO_STATUS SIDH_opcount_get(PCurveIsogenyStruct pCurveIsogeny, OpCounters* Counters);
+
+// Reset the operation counters of pCurveIsogeny, or of the calling thread if pCurveIsogeny is NULL
+CRYPTO_STATUS SIDH_opcount_reset(PCurveIsogenyStruct pCurveIsogeny);
+
+// Register the callback "Callback", called with "Context" at every trace point reached by the operations on pCurveIsogeny, or remove it 
+// if Callback is NULL. Operations begin and end with SIDH_TRACE_BEGIN and SIDH_TRACE_END; the inner trace points are also reached by 
+// the functions sharing the same steps, e.g., the batched functions. SecretAgreement_A_validated() and SecretAgreement_B_validated() 
+// report a validation (SIDH_TRACE_VALIDATE_B or _A) followed by a shared secret (SIDH_TRACE_SHARED_A or _B), the latter only if the 
+// public key is valid. With TRACE_SUPPORT, every trace point also fires 
+// the Linux USDT probe sidh:trace(point, arg, cycles) if <sys/sdt.h> is available, whether a callback is registered or not. Without 
+// TRACE_SUPPORT the trace points are compiled out and this function returns CRYPTO_ERROR_NOT_IMPLEMENTED (see the TRACE option).
+// This function must not be called while other threads run SIDH operations on pCurveIsogeny.
+CRYPTO_STATUS SIDH_set_trace(PCurveIsogenyStruct pCurveIsogeny, SIDH_TraceCallback Callback, void* Context);
+
 // Output error/success message for a given CRYPTO_STATUS
 const char* SIDH_get_error_message(CRYPTO_STATUS Status);
 
@@ -322,6 +601,8 @@ CRYPTO_STATUS Validate_PKB(unsigned char* pPublicKeyB, bool* valid, PCurveIsogen
 // Inputs: Alice's pPrivateKeyA is an even integer in the range [2, oA-2], where oA = 2^372 (i.e., 372 bits in total). 
 //         Bob's pPublicKeyB consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
 // Output: a shared secret pSharedSecretA that consists of one element in GF(p751^2), i.e., 1502 bits in total. 
+//         If the shared curve has a zero j-invariant denominator (e.g., from a crafted public key), the secret is zeroed and 
+//         CRYPTO_ERROR_SHARED_KEY is returned, as in SecretAgreement_A_batch().
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
 CRYPTO_STATUS SecretAgreement_A(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, PCurveIsogenyStruct CurveIsogeny);
 
@@ -330,9 +611,300 @@ CRYPTO_STATUS SecretAgreement_A(unsigned char* pPrivateKeyA, unsigned char* pPub
 // Inputs: Bob's pPrivateKeyB is an integer in the range [1, oB-1], where oA = 3^239 (i.e., 379 bits in total). 
 //         Alice's pPublicKeyA consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
 // Output: a shared secret pSharedSecretB that consists of one element in GF(p751^2), i.e., 1502 bits in total. 
+//         If the shared curve has a zero j-invariant denominator (e.g., from a crafted public key), the secret is zeroed and 
+//         CRYPTO_ERROR_SHARED_KEY is returned, as in SecretAgreement_B_batch().
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
 CRYPTO_STATUS SecretAgreement_B(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
 
+// Alice's shared secret generation with validation of Bob's public key
+// It sets valid = true and produces pSharedSecretA as SecretAgreement_A() if pPublicKeyB passes Validate_PKB(). Otherwise, it sets
+// valid = false and zeroes pSharedSecretA. Both computations share the conversion and checks of the public key.
+CRYPTO_STATUS SecretAgreement_A_validated(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's shared secret generation with validation of Alice's public key
+// It sets valid = true and produces pSharedSecretB as SecretAgreement_B() if pPublicKeyA passes Validate_PKA(). Otherwise, it sets
+// valid = false and zeroes pSharedSecretB. Both computations share the conversion and checks of the public key.
+CRYPTO_STATUS SecretAgreement_B_validated(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+
+/******************* Batched key exchange API *******************/ 
+
+// Alice's batched key-pair generation
+// It produces nkeys private keys pPrivateKeysA and computes the corresponding public keys pPublicKeysA, all stored back to back 
+// using the same encodings as KeyGeneration_A() (i.e., nkeys*48 and nkeys*768 bytes, resp.). The final inversions of the nkeys
+// key pairs are shared through one simultaneous inversion.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS KeyGeneration_A_batch(unsigned char* pPrivateKeysA, unsigned char* pPublicKeysA, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's batched key-pair generation
+// It produces nkeys private keys pPrivateKeysB and computes the corresponding public keys pPublicKeysB, all stored back to back 
+// using the same encodings as KeyGeneration_B() (i.e., nkeys*48 and nkeys*768 bytes, resp.). The final inversions of the nkeys
+// key pairs are shared through one simultaneous inversion.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS KeyGeneration_B_batch(unsigned char* pPrivateKeysB, unsigned char* pPublicKeysB, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's batched shared secret generation
+// It produces nkeys shared secrets pSharedSecretsA, where the i-th secret is computed from the i-th private key in pPrivateKeysA 
+// and the i-th public key in pPublicKeysB. Keys and secrets are stored back to back using the same encodings as SecretAgreement_A()
+// (i.e., nkeys*48, nkeys*768 and nkeys*192 bytes, resp.). The inversions of the nkeys j-invariants are shared through one 
+// simultaneous inversion. If the shared curve of an entry has a zero j-invariant denominator (e.g., from a crafted public key), 
+// that secret is zeroed and CRYPTO_ERROR_SHARED_KEY is returned; the other nkeys-1 secrets are still computed correctly.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS SecretAgreement_A_batch(unsigned char* pPrivateKeysA, unsigned char* pPublicKeysB, unsigned char* pSharedSecretsA, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's batched shared secret generation
+// It produces nkeys shared secrets pSharedSecretsB, where the i-th secret is computed from the i-th private key in pPrivateKeysB 
+// and the i-th public key in pPublicKeysA. Keys and secrets are stored back to back using the same encodings as SecretAgreement_B()
+// (i.e., nkeys*48, nkeys*768 and nkeys*192 bytes, resp.). The inversions of the nkeys j-invariants are shared through one 
+// simultaneous inversion. If the shared curve of an entry has a zero j-invariant denominator (e.g., from a crafted public key), 
+// that secret is zeroed and CRYPTO_ERROR_SHARED_KEY is returned; the other nkeys-1 secrets are still computed correctly.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS SecretAgreement_B_batch(unsigned char* pPrivateKeysB, unsigned char* pPublicKeysA, unsigned char* pSharedSecretsB, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+
+// Batched shared secret generation with one status per secret, for Alice and Bob resp.
+// They work as SecretAgreement_A_batch() and SecretAgreement_B_batch(), and also set pStatuses[i] (nkeys entries) to the status of 
+// the i-th secret, so that a failing entry can be told apart from the others. A NULL pStatuses is ignored.
+CRYPTO_STATUS SecretAgreement_A_batch_status(unsigned char* pPrivateKeysA, unsigned char* pPublicKeysB, unsigned char* pSharedSecretsA, CRYPTO_STATUS* pStatuses, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_batch_status(unsigned char* pPrivateKeysB, unsigned char* pPublicKeysA, unsigned char* pSharedSecretsB, CRYPTO_STATUS* pStatuses, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+
+/****************** Public key compression API ******************/ 
+
+// Sizes in bytes of compressed public keys
+#define SIDH_COMPRESSED_PKA_BYTES    333
+#define SIDH_COMPRESSED_PKB_BYTES    330
+
+// Alice's public key compression
+// It produces a compressed public key pCompressedPKA from Alice's public key pPublicKeyA. The compressed key consists of Alice's curve
+// coefficient in GF(p751^2), the coordinates of her two points in a basis of the 3^239-torsion that is recomputed from the curve, 
+// normalized to three elements in Z_oB, and one flag octet, i.e., 333 bytes in total.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS PublicKeyCompression_A(unsigned char* pPublicKeyA, unsigned char* pCompressedPKA, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's public key compression
+// It produces a compressed public key pCompressedPKB from Bob's public key pPublicKeyB. The compressed key consists of Bob's curve
+// coefficient in GF(p751^2), the coordinates of his two points in a basis of the 2^372-torsion that is recomputed from the curve, 
+// normalized to three elements in Z_oA, and one flag octet, i.e., 330 bytes in total.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS PublicKeyCompression_B(unsigned char* pPublicKeyB, unsigned char* pCompressedPKB, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's shared secret generation from Bob's compressed public key
+// It produces the same shared secret as SecretAgreement_A() using her secret key pPrivateKeyA and Bob's compressed public key pCompressedPKB.
+// Compressed public keys are not validated, see Validate_PKB().
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS SecretAgreement_Compression_A(unsigned char* pPrivateKeyA, unsigned char* pCompressedPKB, unsigned char* pSharedSecretA, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's shared secret generation from Alice's compressed public key
+// It produces the same shared secret as SecretAgreement_B() using his secret key pPrivateKeyB and Alice's compressed public key pCompressedPKA.
+// Compressed public keys are not validated, see Validate_PKA().
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS SecretAgreement_Compression_B(unsigned char* pPrivateKeyB, unsigned char* pCompressedPKA, unsigned char* pSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
+
+/*********************** Key pool API **************************/ 
+
+#define SIDH_KEYPOOL_MAX_CAPACITY    1024    // Max. number of key pairs held by a key pool
+
+typedef struct keypool* PKeyPool;
+
+// Create a pool of ephemeral key pairs for Alice (AliceOrBob = ALICE) or Bob (AliceOrBob = BOB) in pKeyPool. A background thread 
+// fills the pool with up to "capacity" key pairs, a power of 2 in [2, SIDH_KEYPOOL_MAX_CAPACITY], and sleeps once it is full until 
+// fewer than "low_watermark" key pairs remain. Key pairs are generated with KeyGeneration_A() or KeyGeneration_B() on CurveIsogeny, 
+// so its RandomBytesFunction must be safe to call from several threads, and CurveIsogeny must not be freed before the pool.
+// Returns CRYPTO_ERROR_NOT_IMPLEMENTED if the library was built without thread support (see the THREADS option).
+CRYPTO_STATUS SIDH_keypool_create(PCurveIsogenyStruct CurveIsogeny, unsigned int AliceOrBob, unsigned int capacity, unsigned int low_watermark, PKeyPool* pKeyPool);
+
+// Take a key pair from the pool, encoded as in KeyGeneration_A() or KeyGeneration_B(). Each key pair is handed out once and wiped from 
+// the pool. Any number of threads can take key pairs concurrently without locking; if the pool is empty, the key pair is generated 
+// by the calling thread. If the background thread failed to generate a key pair, the next call returns its error without taking 
+// a key pair, and the background thread resumes filling the pool.
+CRYPTO_STATUS SIDH_keypool_take(PKeyPool KeyPool, unsigned char* pPrivateKey, unsigned char* pPublicKey);
+
+// Number of key pairs ready in the pool
+unsigned int SIDH_keypool_available(PKeyPool KeyPool);
+
+// Stop the background thread, wipe the remaining key pairs and free the pool
+void SIDH_keypool_free(PKeyPool KeyPool);
+
+/*********************** Step-wise key exchange API **************************/
+
+// Key exchange operations computed in slices of bounded work by SIDH_kex_step()
+typedef enum {
+    SIDH_KEX_KEYGEN_A,                       // Alice's key-pair generation, as KeyGeneration_A()
+    SIDH_KEX_KEYGEN_B,                       // Bob's key-pair generation, as KeyGeneration_B()
+    SIDH_KEX_SHARED_A,                       // Alice's shared secret generation, as SecretAgreement_A()
+    SIDH_KEX_SHARED_B,                       // Bob's shared secret generation, as SecretAgreement_B()
+    SIDH_KEX_END_OF_LIST
+} SIDH_KEX_OPERATION;
+
+typedef struct kexstep* PKexStep;
+
+// Create in pKexStep the state of the key exchange operation "Operation" on CurveIsogeny, without computing it. Key generation writes 
+// the key pair to pPrivateKey and pPublicKey, and the shared secret generation reads the private key pPrivateKey and the other party's 
+// public key pPublicKey during this call and writes the shared secret to pSharedSecret. Keys and secrets use the encodings of the 
+// corresponding functions. The output buffers must remain valid until the operation is done. CurveIsogeny must not be freed or 
+// reconfigured before the state.
+CRYPTO_STATUS SIDH_kex_start(PCurveIsogenyStruct CurveIsogeny, SIDH_KEX_OPERATION Operation, unsigned char* pPrivateKey, unsigned char* pPublicKey, unsigned char* pSharedSecret, PKexStep* pKexStep);
+
+// Advance the operation by about "budget" work units, where a unit is about the cost of one point quadrupling (a few microseconds for 
+// SIDHp751), and set done = true once the outputs are written. Each call performs at least one indivisible part: the scalar multiplication 
+// of key generation costs about 50 units with the fixed-base tables (see SIDH_set_fixed_base_window()) and the final inversion about 40; 
+// the rest of the operation is split at the granularity of single units. A complete operation takes a few thousand units, the same work 
+// as the monolithic function but computed on the calling thread only. Errors, including the CRYPTO_ERROR_SHARED_KEY of SecretAgreement_A() 
+// for a crafted public key, are returned by this call and the next ones.
+// Many operations can be interleaved on one thread, e.g., by an event loop that runs one slice of each pending handshake in turn.
+CRYPTO_STATUS SIDH_kex_step(PKexStep KexStep, unsigned int budget, bool* done);
+
+// Wipe and free the state of the operation, done or not
+void SIDH_kex_free(PKexStep KexStep);
+
+/*********************** Key exchange API with caller-provided workspaces **************************/
+
+// Size in bytes of a workspace, for SIDHp751 and SIDHp503
+#define SIDH_WORKSPACE_POINTS    ((SIDH_STRATEGY_POINTS_ALICE > SIDH_STRATEGY_POINTS_BOB) ? SIDH_STRATEGY_POINTS_ALICE : SIDH_STRATEGY_POINTS_BOB)
+#define SIDH_WORKSPACE_BYTES     (2*192*(10 + SIDH_WORKSPACE_POINTS) + 8*SIDH_WORKSPACE_POINTS)
+
+// Allocate a workspace of SIDH_WORKSPACE_BYTES bytes aligned on a cache line, returns NULL if there is no memory available
+void* SIDH_workspace_allocate(void);
+
+// Wipe and free a workspace
+void SIDH_workspace_free(void* Workspace);
+
+// The following functions compute the same outputs as the functions without the "_ws" suffix, keeping all their intermediate values 
+// in "Workspace", a buffer of SIDH_WORKSPACE_BYTES bytes, preferably aligned on a cache line (see SIDH_workspace_allocate()). The part 
+// of the workspace in use is wiped once at the end of each call, instead of wiping every intermediate value separately. If Workspace 
+// is NULL, a workspace owned by the calling thread is used. A workspace must not be used by two calls at the same time.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS KeyGeneration_A_ws(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyA, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS KeyGeneration_B_ws(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyB, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS SecretAgreement_A_ws(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS SecretAgreement_B_ws(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+
+// Public keys are not secret, the workspace of the validation functions is not wiped
+CRYPTO_STATUS Validate_PKA_ws(unsigned char* pPublicKeyA, bool* valid, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS Validate_PKB_ws(unsigned char* pPublicKeyB, bool* valid, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+
+/*********************** Tagged public key API **************************/
+
+// Formats of a tagged public key, given by its last octet
+#define SIDH_PK_FORMAT_STANDARD      0x00    // Elements in standard representation, the encoding of KeyGeneration_A() and KeyGeneration_B()
+#define SIDH_PK_FORMAT_MONTGOMERY    0x01    // Elements a*R mod p in Montgomery representation, with R = 2^768 (SIDHp751) or 2^512 (SIDHp503)
+
+// Sizes in bytes of tagged public keys
+#define SIDH_TAGGED_PK_BYTES        (768 + 1)
+#define SIDHp503_TAGGED_PK_BYTES    (512 + 1)
+
+// A tagged public key is a public key followed by one format octet. In the Montgomery format, the key is output and consumed in the 
+// representation used internally, which saves the 8 conversions in GF(p) on each side of the exchange. A tagged key in the standard 
+// format starts with the 768 (resp. 512) octets of the untagged encoding, so peers without support for the Montgomery format can use it. 
+// The elements of a key in the Montgomery format must be fully reduced modulo p, otherwise CRYPTO_ERROR_INVALID_PARAMETER is returned, 
+// as for an unknown format octet.
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+CRYPTO_STATUS KeyGeneration_A_tagged(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyA, unsigned char format, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS KeyGeneration_B_tagged(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyB, unsigned char format, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS SecretAgreement_A_tagged(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS SecretAgreement_B_tagged(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS Validate_PKA_tagged(unsigned char* pPublicKeyA, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+
+CRYPTO_STATUS Validate_PKB_tagged(unsigned char* pPublicKeyB, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+
+// Convert a tagged public key of Alice or Bob to the given format in place, e.g., before sending it to a peer that only supports the standard format
+CRYPTO_STATUS PublicKey_set_format(unsigned char* pPublicKey, unsigned char format, PCurveIsogenyStruct CurveIsogeny);
+
+/*********************** Job engine API **************************/
+
+#define SIDH_ENGINE_MAX_WORKERS    64        // Max. number of worker threads of a job engine
+
+// Key exchange operations run by a job engine
+typedef enum {
+    SIDH_JOB_KEYGEN_A,                       // Alice's key-pair generation, as KeyGeneration_A()
+    SIDH_JOB_KEYGEN_B,                       // Bob's key-pair generation, as KeyGeneration_B()
+    SIDH_JOB_VALIDATE_A,                     // Validation of Alice's public key, as Validate_PKA()
+    SIDH_JOB_VALIDATE_B,                     // Validation of Bob's public key, as Validate_PKB()
+    SIDH_JOB_SHARED_A,                       // Alice's shared secret generation, as SecretAgreement_A()
+    SIDH_JOB_SHARED_B,                       // Bob's shared secret generation, as SecretAgreement_B()
+    SIDH_JOB_END_OF_LIST
+} SIDH_JOB_TYPE;
+
+typedef struct jobengine* PJobEngine;
+typedef struct sidh_job SIDH_job, *PSIDHJob;
+
+// Completion callback of a job, called on a worker thread once the outputs and Status are written
+typedef void (*SIDH_JobCallback)(PSIDHJob Job);
+
+// Job owned by the caller, which must keep it and its buffers valid until the callback is called. Keys and secrets use the encodings 
+// of the functions listed in SIDH_JOB_TYPE; validation jobs only use pPublicKey.
+struct sidh_job {
+    SIDH_JOB_TYPE    Type;
+    unsigned char*   pPrivateKey;                            // Output of key generation, input of the shared secret generation
+    unsigned char*   pPublicKey;                             // Output of key generation, input of the other jobs
+    unsigned char*   pSharedSecret;                          // Output of the shared secret generation
+    SIDH_JobCallback Callback;
+    void*            Context;                                // Not used by the engine
+    CRYPTO_STATUS    Status;                                 // Output: result of the operation
+    bool             valid;                                  // Output of validation jobs
+    PJobEngine       Engine;                                 // Internal fields, set by SIDH_engine_submit()
+    PSIDHJob         next;
+    uint64_t         SubmitTime;
+};
+
+// Counters of a job engine, see SIDH_engine_get_stats()
+typedef struct {
+    uint64_t         submitted;                              // Number of jobs submitted
+    uint64_t         completed;                              // Number of jobs completed
+    uint64_t         stolen;                                 // Number of jobs run by a worker other than the one they were queued to
+    uint64_t         batches;                                // Number of multi-buffer batches of coalesced jobs
+    unsigned int     queued;                                 // Number of jobs waiting in the queues (queue depth)
+    unsigned int     max_queued;                             // Max. queue depth observed
+    uint64_t         latency_total_ns;                       // Sum of the times from submission to completion, in nanoseconds
+    uint64_t         latency_max_ns;                         // Max. time from submission to completion, in nanoseconds
+} SIDH_engine_stats;
+
+// Create in pEngine a job engine with "nworkers" threads in [1, SIDH_ENGINE_MAX_WORKERS]. Each worker has its own curve isogeny 
+// structure initialized from CurveData and RandomBytesFunction, which must be safe to call from several threads, so each one holds its 
+// own fixed-base tables (see SIDH_set_fixed_base_window()). If "pin" is true, the i-th worker is pinned to the i-th processor available 
+// to the process, wrapping around. Jobs are queued round-robin to the workers, and idle workers steal jobs from the queues of the others. 
+// With the multi-buffer backends (see the SIMD option), a worker coalesces up to 4 (AVX2) or 8 (AVX-512 IFMA) queued key generation or 
+// shared secret jobs of the same type into one call of the batched functions, for SIDHp751 only.
+// Returns CRYPTO_ERROR_NOT_IMPLEMENTED if the library was built without thread support (see the THREADS option).
+CRYPTO_STATUS SIDH_engine_create(PCurveIsogenyStaticData CurveData, RandomBytes RandomBytesFunction, unsigned int nworkers, bool pin, PJobEngine* pEngine);
+
+// Queue the job "Job", whose callback is called on a worker thread when it is done. Errors of the operation are reported in Job->Status; 
+// this call only fails on invalid jobs. It can be called from any thread, including from the callbacks.
+CRYPTO_STATUS SIDH_engine_submit(PJobEngine Engine, PSIDHJob Job);
+
+// Read the counters of the engine
+void SIDH_engine_get_stats(PJobEngine Engine, SIDH_engine_stats* stats);
+
+// Complete the queued jobs, stop the workers and free the engine. No jobs may be submitted during or after this call, except from callbacks.
+void SIDH_engine_free(PJobEngine Engine);
+
+/*********************** Validated public key cache API **************************/
+
+#define SIDH_PKCACHE_MAX_CAPACITY    65536    // Max. number of public keys held by a cache
+
+typedef struct pkcache* PPublicKeyCache;
+
+// Create in pCache a cache of up to "capacity" public keys of CurveIsogeny, in [1, SIDH_PKCACHE_MAX_CAPACITY], that passed validation.
+// Each entry takes one public key (768 bytes for SIDHp751). CurveIsogeny must not be freed before the cache.
+CRYPTO_STATUS SIDH_pkcache_create(PCurveIsogenyStruct CurveIsogeny, unsigned int capacity, PPublicKeyCache* pCache);
+
+// Validate Alice's (AliceOrBob = ALICE) or Bob's (AliceOrBob = BOB) public key as Validate_PKA() or Validate_PKB(). Keys found in
+// the cache are reported valid without running the validation; keys that pass it are added, evicting the least recently used one
+// when the cache is full. With the THREADS option, several threads can use the same cache; otherwise calls must not overlap.
+CRYPTO_STATUS SIDH_pkcache_validate(PPublicKeyCache Cache, unsigned int AliceOrBob, unsigned char* pPublicKey, bool* valid);
+
+// Number of lookups that found the key (hits) and that ran the validation (misses), and number of cached keys (entries)
+void SIDH_pkcache_stats(PPublicKeyCache Cache, uint64_t* hits, uint64_t* misses, unsigned int* entries);
+
+// Free the cache
+void SIDH_pkcache_free(PPublicKeyCache Cache);
+
 /*********************** Scalar multiplication API using BigMont ***********************/ 
 
 // BigMont's scalar multiplication using the Montgomery ladder
@@ -342,6 +914,21 @@ CRYPTO_STATUS SecretAgreement_B(unsigned char* pPrivateKeyB, unsigned char* pPub
 // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
 CRYPTO_STATUS BigMont_ladder(unsigned char* x, digit_t* m, unsigned char* xout, PCurveIsogenyStruct CurveIsogeny);
 
+// BigMont's key generation
+// It produces a private key pPrivateKey in [1, BigMont_order-1], encoded in BIGMONT_MAXWORDS_ORDER digits, and the public key pPublicKey, 
+// the affine x-coordinate of pPrivateKey*G where G is the point with x-coordinate BIGMONT_GENERATOR_X, encoded in NWORDS_FIELD digits. 
+// The scalar multiplication uses the constant-time fixed-base table of G built by SIDH_set_fixed_base_window(), or the Montgomery ladder 
+// if the tables are disabled. 
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize(). Only SIDHp751 is supported.
+CRYPTO_STATUS BigMont_KeyGeneration(unsigned char* pPrivateKey, unsigned char* pPublicKey, PCurveIsogenyStruct CurveIsogeny);
+
+// BigMont's shared secret computation for a batch of nkeys sessions
+// The i-th shared secret in pSharedSecrets is the affine x-coordinate of k*P, where k is the i-th private key in pPrivateKeys and x(P) 
+// is the i-th public key in pPublicKeys, i.e., BigMont_ladder(x(P), k). Keys and secrets are stored back to back with the encodings of 
+// BigMont_KeyGeneration(). The conversions of the results to affine coordinates share a single field inversion. 
+// CurveIsogeny must be set up in advance using SIDH_curve_initialize(). Only SIDHp751 is supported.
+CRYPTO_STATUS BigMont_SecretAgreement_batch(unsigned char* pPrivateKeys, unsigned char* pPublicKeys, unsigned char* pSharedSecrets, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+
 
 // Encoding of keys for isogeny system "SIDHp751" (wire format):
 // ------------------------------------------------------------
@@ -355,6 +942,11 @@ CRYPTO_STATUS BigMont_ladder(unsigned char* x, digit_t* m, unsigned char* xout,
 // endian format. 
 // Shared keys pSharedSecretA and pSharedSecretB consist of one element in GF(p751^2). In the key exchange API, they are encoded in 192 octets in little
 // endian format. 
+//
+// Encoding of keys for isogeny system "SIDHp503" (wire format):
+// ------------------------------------------------------------
+// The encodings are the same with 64-octet elements over GF(p503) and 32-octet elements over Z_oA and Z_oB, where oA = 2^250 and oB = 3^159: 
+// private keys are encoded in 32 octets, public keys in 512 octets and shared keys in 128 octets.
 
 
 #ifdef __cplusplus
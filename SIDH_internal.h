@@ -19,6 +19,9 @@ extern "C" {
 #endif
 
 
+#if defined(_P503_)
+    #include "P503/P503_internal.h"     // Field sizes and symbol names of the sources compiled for SIDHp503
+#endif
 #include "SIDH.h"   
     
 
@@ -26,11 +29,19 @@ extern "C" {
 
 #define ALICE                 0
 #define BOB                   1 
-#define MAX_INT_POINTS_ALICE  8      
+#if !defined(_P503_)
 // Fixed parameters for isogeny tree computation    
-#define MAX_INT_POINTS_BOB    10 
-#define MAX_Alice             185   
-#define MAX_Bob               239
+#define MAX_INT_POINTS_ALICE  SIDH_STRATEGY_POINTS_ALICE
+#define MAX_INT_POINTS_BOB    SIDH_STRATEGY_POINTS_BOB
+#define MAX_Alice             SIDH_STRATEGY_LEAVES_ALICE
+#define MAX_Bob               SIDH_STRATEGY_LEAVES_BOB
+// Subgroup orders oA = 2^OALICE_BITS and oB = 3^OBOB_EXPON, and masks of the last random byte of the private keys (see random_mod_order())
+#define OALICE_BITS           372
+#define OBOB_EXPON            239
+#define MASK_ALICE            0x07
+#define MASK_BOB              0x03
+#endif
+#define MAX_INT_POINTS        ((MAX_INT_POINTS_ALICE > MAX_INT_POINTS_BOB) ? MAX_INT_POINTS_ALICE : MAX_INT_POINTS_BOB)
    
 
 // SIDH's basic element definitions and point representations
@@ -38,6 +49,7 @@ extern "C" {
 typedef digit_t felm_t[NWORDS_FIELD];                             // Datatype for representing 751-bit field elements (768-bit max.)
 typedef digit_t dfelm_t[2*NWORDS_FIELD];                          // Datatype for representing double-precision 2x751-bit field elements (2x768-bit max.) 
 typedef felm_t  f2elm_t[2];                                       // Datatype for representing quadratic extension field elements GF(p751^2)
+typedef dfelm_t df2elm_t[2];                                      // Datatype for representing double-precision (unreduced) GF(p751^2) elements
 typedef f2elm_t publickey_t[4];                                   // Datatype for representing public keys equivalent to four GF(p751^2) elements
         
 typedef struct { f2elm_t x; f2elm_t y; } point_affine;            // Point representation in affine coordinates on Montgomery curve.
@@ -51,6 +63,61 @@ typedef point_basefield_affine point_basefield_t[1];
         
 typedef struct { felm_t X; felm_t Z; } point_basefield_proj;      // Point representation in projective XZ Montgomery coordinates over the base field.
 typedef point_basefield_proj point_basefield_proj_t[1]; 
+        
+typedef struct { felm_t X; felm_t Y; felm_t Z; } point_basefield_jac; // Point representation in Jacobian coordinates (X/Z^2,Y/Z^3) on E: y^2=x^3+x over the base field.
+typedef point_basefield_jac point_basefield_jac_t[1]; 
+
+typedef struct {                                                  // Fixed inputs of key generation, in Montgomery representation, see keygen_precompute().
+    point_basefield_t PA, PB;                                     // Alice's and Bob's generators
+    point_proj_t      phiPB, phiQB, phiDB;                        // Bob's generators PB, QB and QB-PB mapped through Alice's first 4-isogeny
+    point_proj_t      PAx, QAx, DAx;                              // Alice's generators PA, QA and QA-PA in projective XZ coordinates
+    f2elm_t           A, C;                                       // Base curve parameters
+    felm_t            BigMont_A24;                                // BigMont's A24 = (A+2)/4, only for SIDHp751
+    felm_t            BigMont_A3, BigMont_a;                      // A/3 and a = 1-A^2/3 of BigMont's short Weierstrass form y^2=X^3+a*X+b, X = x+A/3
+    point_basefield_t BigMont_G;                                  // BigMont's generator (BIGMONT_GENERATOR_X+A/3, y) in the short Weierstrass form
+} keygen_precomp;
+
+typedef struct {                                                  // State of the three-point ladder, see ladder_3_pt_init() and ladder_3_pt_steps().
+    point_proj_t      U, V, W;                                    // Ladder points, W = P+[m]Q at the end
+    f2elm_t           A24;                                        // Curve constant (A+2)/4
+    digit_t           scalar[NWORDS_ORDER];                       // Scalar m, shifted left as its bits are processed
+    unsigned int      nbits;                                      // Number of bits left to process
+} ladder_3_pt_state;
+
+typedef struct {                                                  // Scratch space of one key exchange operation, wiped once at its end, see the "_ws" functions.
+    f2elm_t           A, C, jinv;                                 // Curve (A:C) and shared j-invariant
+    f2elm_t           PK[4];                                      // Public key under validation, in Montgomery representation
+    f2elm_t           coeff[5];                                   // Coefficients of the last 4-isogeny
+    point_proj_t      R, phiP, phiQ, phiD;                        // Kernel point and images of the other party's generators
+    point_proj_t      pts[MAX_INT_POINTS];                        // Intermediate points of the isogeny tree traversal
+    unsigned int      pts_index[MAX_INT_POINTS];                  // and their indices in the strategy
+} kex_workspace;
+
+
+// Multi-buffer element definitions: MB_LANES independent field elements interleaved in vectors of MB_LANES 64-bit lanes
+
+#if (TARGET == TARGET_AMD64) && ((SIMD_SUPPORT == AVX2_SUPPORT) || (SIMD_SUPPORT == AVX512IFMA_SUPPORT)) && !defined(_P503_)
+    #define MULTIBUFFER_SUPPORT
+    #include <immintrin.h>
+
+#if (SIMD_SUPPORT == AVX512IFMA_SUPPORT)
+    #define MB_LANES              8                               // Number of interleaved computations
+    #define MB_RADIX              52                              // Number of bits per limb
+    #define MB_NLIMBS             15                              // Number of limbs per field element
+    typedef __m512i vdigit_t;
+#else
+    #define MB_LANES              4
+    #define MB_RADIX              24
+    #define MB_NLIMBS             32
+    typedef __m256i vdigit_t;
+#endif
+
+typedef vdigit_t vfelm_t[MB_NLIMBS];                              // Datatype for representing MB_LANES field elements
+typedef vfelm_t  vf2elm_t[2];                                     // Datatype for representing MB_LANES GF(p751^2) elements
+        
+typedef struct { vf2elm_t X; vf2elm_t Z; } vpoint_proj;           // MB_LANES points in projective XZ Montgomery coordinates.
+typedef vpoint_proj vpoint_proj_t[1]; 
+#endif
     
 
 // Macro definitions
@@ -58,10 +125,35 @@ typedef point_basefield_proj point_basefield_proj_t[1];
 #define NBITS_TO_NBYTES(nbits)      (((nbits)+7)/8)                                          // Conversion macro from number of bits to number of bytes
 #define NBITS_TO_NWORDS(nbits)      (((nbits)+(sizeof(digit_t)*8)-1)/(sizeof(digit_t)*8))    // Conversion macro from number of bits to number of computer words
 #define NBYTES_TO_NWORDS(nbytes)    (((nbytes)+sizeof(digit_t)-1)/sizeof(digit_t))           // Conversion macro from number of bytes to number of computer words
+#define FIXED_BASE_NWINDOWS(nbits, w)   (((nbits)+(w)-1)/(w))                                // Number of windows of width w in the fixed-base table for nbits-bit scalars
 
 // Macro to avoid compiler warnings when detecting unreferenced parameters
 #define UNREFERENCED_PARAMETER(PAR) (PAR)
 
+// The public functions compiled for SIDHp751 hand the operations on the curves of another parameter set to the functions compiled 
+// for it, e.g., FIELD_DISPATCH(CurveIsogeny->pbits, KeyGeneration_A_p503(...)) returns the result of the SIDHp503 key generation
+#if defined(_P503_)
+    #define FIELD_DISPATCH(pbits, call)
+#else
+    #define FIELD_DISPATCH(pbits, call)     if ((pbits) == 503) { return call; }
+#endif
+
+// Operation counting, see SIDH_opcount_get()
+#if defined(SIDH_OPCOUNT)
+    #define OPCOUNT(op)                          opcount_add(op)
+    #define OPCOUNT_PHASE(CurveIsogeny, phase)   opcount_set_phase((CurveIsogeny)->OpCounts, phase)
+#else
+    #define OPCOUNT(op)
+    #define OPCOUNT_PHASE(CurveIsogeny, phase)
+#endif
+
+// Trace points, see SIDH_set_trace()
+#if defined(TRACE_SUPPORT)
+    #define TRACE(CurveIsogeny, point, arg)      trace_point(CurveIsogeny, point, arg)
+#else
+    #define TRACE(CurveIsogeny, point, arg)
+#endif
+
 
 /********************** Constant-time unsigned comparisons ***********************/
 
@@ -85,7 +177,7 @@ static __inline unsigned int is_digit_lessthan_ct(digit_t x, digit_t y)
 
 /********************** Macros for platform-dependent operations **********************/
 
-#if defined(GENERIC_IMPLEMENTATION)
+#if defined(GENERIC_IMPLEMENTATION) && !defined(UINT128_SUPPORT)
 
 // Digit multiplication
 #define MUL(multiplier, multiplicand, hi, lo)                                                     \
@@ -180,7 +272,7 @@ static __inline unsigned int is_digit_lessthan_ct(digit_t x, digit_t y)
       MUL128(multiplier, multiplicand, product);                       \
       ADC128(addend, product, carry, result); }   
 
-#elif (TARGET == TARGET_AMD64 && OS_TARGET == OS_LINUX)
+#elif defined(UINT128_SUPPORT)
 
 // Digit multiplication
 #define MUL(multiplier, multiplicand, hi, lo)                                                     \
@@ -221,13 +313,6 @@ static __inline unsigned int is_digit_lessthan_ct(digit_t x, digit_t y)
 #define CT_LT(x, y) CT_GT(y, x)
 #define CT_LE(x, y) CT_GE(y, x)
 
-// Multiprecision multiplication selection
-#if (TARGET == TARGET_AMD64)
-    #define mp_mul_comba         mp_mul
-#else
-    #define mp_mul_schoolbook    mp_mul
-#endif
-
 
 
 /**************** Function prototypes ****************/
@@ -257,6 +342,37 @@ void mp_mul_schoolbook(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords);
 // Multiprecision comba multiply, c = a*b, where lng(a) = lng(b) = nwords.
 void mp_mul_comba(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords);
 
+// Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords, using the selected field arithmetic backend
+void mp_mul(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords);
+
+// Multiprecision comba squaring, c = a^2, where lng(a) = nwords.
+void mp_sqr_comba(digit_t* a, digit_t* c, unsigned int nwords);
+
+// Multiprecision squaring, c = a^2, where lng(a) = nwords, using the selected field arithmetic backend
+void mp_sqr(digit_t* a, digit_t* c, unsigned int nwords);
+
+/************ Field arithmetic backends **************/
+
+// Set "arithmetic" to the kernel table of the backend "id".
+// Returns CRYPTO_ERROR_NOT_IMPLEMENTED if the backend is not available in this build or on this processor
+CRYPTO_STATUS fp_get_arithmetic(ARITHMETIC_ID id, const FieldArithmetic** arithmetic);
+
+// Fix the field arithmetic backend of the process to "id" on the first call, and set "arithmetic" to the backend in use.
+// The selection cannot be changed afterwards, see SIDH_set_arithmetic()
+CRYPTO_STATUS fp_select_arithmetic(ARITHMETIC_ID id, const FieldArithmetic** arithmetic);
+
+// GF(p751) addition and subtraction kernels, shared by all the backends of a build
+#if defined(GENERIC_IMPLEMENTATION)
+    #define fpadd751_kernel    fpadd751_generic
+    #define fpsub751_kernel    fpsub751_generic
+#elif (TARGET == TARGET_AMD64)
+    #define fpadd751_kernel    fpadd751_x64
+    #define fpsub751_kernel    fpsub751_x64
+#elif (TARGET == TARGET_ARM64)
+    #define fpadd751_kernel    fpadd751_asm
+    #define fpsub751_kernel    fpsub751_asm
+#endif
+
 /************ Field arithmetic functions *************/
 
 // Copy of a field element, c = a
@@ -268,10 +384,14 @@ void fpzero751(felm_t a);
 // Modular addition, c = a+b mod p751
 extern void fpadd751(digit_t* a, digit_t* b, digit_t* c);
 extern void fpadd751_asm(digit_t* a, digit_t* b, digit_t* c);
+void fpadd751_x64(digit_t* a, digit_t* b, digit_t* c);
+void fpadd751_generic(digit_t* a, digit_t* b, digit_t* c);
 
 // Modular subtraction, c = a-b mod p751
 extern void fpsub751(digit_t* a, digit_t* b, digit_t* c);
 extern void fpsub751_asm(digit_t* a, digit_t* b, digit_t* c);
+void fpsub751_x64(digit_t* a, digit_t* b, digit_t* c);
+void fpsub751_generic(digit_t* a, digit_t* b, digit_t* c);
 
 // Modular negation, a = -a mod p751        
 extern void fpneg751(digit_t* a);  
@@ -280,12 +400,28 @@ extern void fpneg751(digit_t* a);
 void fpdiv2_751(digit_t* a, digit_t* c);
 
 // 751-bit Montgomery reduction, c = a mod p
-void rdc_mont(digit_t* a, digit_t* c);
+void rdc_mont(dfelm_t ma, felm_t mc);
+void rdc751_x64(dfelm_t ma, felm_t mc);
+void rdc751_generic(dfelm_t ma, felm_t mc);
             
 // Field multiplication using Montgomery arithmetic, c = a*b*R^-1 mod p751, where R=2^768
 void fpmul751_mont(felm_t a, felm_t b, felm_t c);
 void mul751_asm(felm_t a, felm_t b, dfelm_t c);
-void rdc751_asm(dfelm_t ma, dfelm_t mc);
+void sqr751_asm(felm_t a, dfelm_t c);
+void rdc751_asm(dfelm_t ma, felm_t mc);
+
+// Integer multiplication and Montgomery reduction using the BMI2 and ADX instructions (MULX/ADCX/ADOX)
+void mul751_adx(felm_t a, felm_t b, dfelm_t c);
+void rdc751_adx(dfelm_t ma, felm_t mc);
+
+// Fused GF(p751^2) multiplication and squaring in x64 assembly, over the baseline and the BMI2/ADX kernels, resp. (see the "ASM" option)
+void fp2mul751_asm(f2elm_t a, f2elm_t b, f2elm_t c);
+void fp2sqr751_asm(f2elm_t a, f2elm_t c);
+void fp2mul751_adx(f2elm_t a, f2elm_t b, f2elm_t c);
+void fp2sqr751_adx(f2elm_t a, f2elm_t c);
+
+// Checks whether the processor supports the BMI2 and ADX instructions
+bool is_adx_supported(void);
    
 // Field squaring using Montgomery arithmetic, c = a*b*R^-1 mod p751, where R=2^768
 void fpsqr751_mont(felm_t ma, felm_t mc);
@@ -298,6 +434,14 @@ void from_mont(felm_t ma, felm_t c);
 
 // Field inversion, a = a^-1 in GF(p751)
 void fpinv751_mont(felm_t a);
+void fpinv751_mont_fermat(felm_t a);
+void fpinv751_mont_safegcd(felm_t a);
+
+// Square root candidate, c = a^((p751+1)/4) in GF(p751), such that c^2 = a iff a is a square
+void fpsqrt751_mont(felm_t a, felm_t c);
+
+// Comparison of GF(p751) elements, not constant time
+bool fpequal751_non_constant_time(felm_t a, felm_t b);
 
 /************ GF(p^2) arithmetic functions *************/
     
@@ -321,9 +465,30 @@ void fp2div2_751(f2elm_t a, f2elm_t c);
             
 // GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2)
 void fp2sqr751_mont(f2elm_t a, f2elm_t c);
+void fp2sqr751_mont_default(f2elm_t a, f2elm_t c);
  
 // GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2)
 void fp2mul751_mont(f2elm_t a, f2elm_t b, f2elm_t c);
+void fp2mul751_mont_default(f2elm_t a, f2elm_t b, f2elm_t c);
+
+/********* Lazy-reduction GF(p751^2) functions *********/
+/* Double-precision values are integers in [0, p751*2^768) congruent, after a Montgomery reduction, to the intended result */
+
+// Double-precision addition modulo p751*2^768, c = a+b, where a, b, c in [0, p751*2^768)
+void mp_dfadd751(dfelm_t a, dfelm_t b, dfelm_t c);
+
+// Double-precision subtraction modulo p751*2^768, c = a-b, where a, b, c in [0, p751*2^768)
+void mp_dfsub751(dfelm_t a, dfelm_t b, dfelm_t c);
+
+// GF(p751^2) multiplication without reduction, c = a*b, where a, b in [0, p751-1] and c in [0, p751*2^768)
+void fp2mul751_unreduced(f2elm_t a, f2elm_t b, df2elm_t c);
+
+// GF(p751^2) double-precision addition and subtraction without reduction, c = a+b and c = a-b
+void fp2dfadd751(df2elm_t a, df2elm_t b, df2elm_t c);
+void fp2dfsub751(df2elm_t a, df2elm_t b, df2elm_t c);
+
+// GF(p751^2) Montgomery reduction, c = a*R^-1 in GF(p751^2)
+void fp2rdc751(df2elm_t a, f2elm_t c);
     
 // Conversion of a GF(p751^2) element to Montgomery representation
 void to_fp2mont(f2elm_t a, f2elm_t mc);
@@ -334,6 +499,12 @@ void from_fp2mont(f2elm_t ma, f2elm_t c);
 // GF(p751^2) inversion using Montgomery arithmetic, a = (a0-i*a1)/(a0^2+a1^2)
 void fp2inv751_mont(f2elm_t a);
 
+// Comparison of GF(p751^2) elements, not constant time
+bool fp2equal751_non_constant_time(f2elm_t a, f2elm_t b);
+
+// GF(p751^2) square root, c = sqrt(a). Returns false if a is not a square. Not constant time
+bool fp2sqrt751_mont(f2elm_t a, f2elm_t c);
+
 // Select either x or y depending on value of option 
 void select_f2elm(f2elm_t x, f2elm_t y, f2elm_t z, digit_t option);
 
@@ -351,6 +522,12 @@ void swap_points(point_proj_t P, point_proj_t Q, digit_t option);
 // Computes the j-invariant of a Montgomery curve with projective constant.
 void j_inv(f2elm_t A, f2elm_t C, f2elm_t jinv);
 
+// Computes the j-invariant as j_inv(), returning false and jinv = 0 if its denominator is zero (singular curve).
+bool j_inv_checked(f2elm_t A, f2elm_t C, f2elm_t jinv);
+
+// Computes the j-invariant of a Montgomery curve with projective constant as a fraction jnum/jden.
+void j_inv_fraction(f2elm_t A, f2elm_t C, f2elm_t jnum, f2elm_t jden);
+
 // Simultaneous doubling and differential addition.
 void xDBLADD(point_proj_t P, point_proj_t Q, f2elm_t xPQ, f2elm_t A24);
 
@@ -378,9 +555,27 @@ void ladder(felm_t x, digit_t* m, point_basefield_proj_t P, point_basefield_proj
 // Computes key generation entirely in the base field
 CRYPTO_STATUS secret_pt(point_basefield_t P, digit_t* m, unsigned int AliceOrBob, point_proj_t R, PCurveIsogenyStruct CurveIsogeny);
 
+// Doubling of a point in Jacobian coordinates on E: y^2=x^3+x over the base field.
+void jDBL_basefield(point_basefield_jac_t P, point_basefield_jac_t Q);
+
+// Mixed addition of a point in Jacobian coordinates and an affine point on E: y^2=x^3+x over the base field.
+void jADD_basefield(point_basefield_jac_t P, point_basefield_t Q, point_basefield_jac_t R);
+
+// Builds the fixed-base table of odd multiples of P used by secret_pt_fixed_base() (a = NULL) and BigMont_KeyGeneration() (a = BigMont_a).
+CRYPTO_STATUS fixed_base_table(point_basefield_t P, felm_t a, unsigned int nwindows, unsigned int w, digit_t* table, PCurveIsogenyStruct CurveIsogeny);
+
+// Computes key generation entirely in the base field using the fixed-base tables.
+CRYPTO_STATUS secret_pt_fixed_base(point_basefield_t P, digit_t* m, unsigned int AliceOrBob, point_proj_t R, PCurveIsogenyStruct CurveIsogeny);
+
 // Computes P+[m]Q via x-only arithmetic.
 CRYPTO_STATUS ladder_3_pt(f2elm_t xP, f2elm_t xQ, f2elm_t xPQ, digit_t* m, unsigned int AliceOrBob, point_proj_t W, f2elm_t A, PCurveIsogenyStruct CurveIsogeny);
 
+// Initializes the state of the three-point ladder that computes P+[m]Q, to be advanced by ladder_3_pt_steps().
+CRYPTO_STATUS ladder_3_pt_init(f2elm_t xP, f2elm_t xQ, digit_t* m, unsigned int AliceOrBob, f2elm_t A, ladder_3_pt_state* state, PCurveIsogenyStruct CurveIsogeny);
+
+// Processes the next nsteps bits of the three-point ladder, or the remaining ones if there are fewer.
+void ladder_3_pt_steps(f2elm_t xP, f2elm_t xQ, f2elm_t xPQ, ladder_3_pt_state* state, unsigned int nsteps);
+
 // Computes the corresponding 4-isogeny of a projective Montgomery point (X4:Z4) of order 4.
 void get_4_isog(point_proj_t P, f2elm_t A, f2elm_t C, f2elm_t* coeff);
 
@@ -390,27 +585,224 @@ void eval_4_isog(point_proj_t P, f2elm_t* coeff);
 // Computes first 4-isogeny computed by Alice.
 void first_4_isog(point_proj_t P, f2elm_t A, f2elm_t Aout, f2elm_t Cout, PCurveIsogenyStruct CurveIsogeny);
 
-// Tripling of a Montgomery point in projective coordinates (X:Z).
-void xTPL(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C);
+// Computes the projective constants A24minus = A-2C and A24plus = A+2C used by xTPL() and get_3_isog().
+void get_A24_tpl(f2elm_t A, f2elm_t C, f2elm_t A24minus, f2elm_t A24plus);
+
+// Recovers the Montgomery curve constant A/C from the projective constants A24minus and A24plus.
+void get_A_tpl(f2elm_t A24minus, f2elm_t A24plus, f2elm_t A, f2elm_t C);
+
+// Tripling of a Montgomery point in projective coordinates (X:Z), given the curve constants A24minus = A-2C and A24plus = A+2C.
+void xTPL(point_proj_t P, point_proj_t Q, f2elm_t A24minus, f2elm_t A24plus);
 
 // Computes [3^e](X:Z) on Montgomery curve with projective constant via e repeated triplings.
 void xTPLe(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C, int e);
 
+// Computes [3^e](X:Z) via e repeated triplings, given the curve constants A24minus = A-2C and A24plus = A+2C.
+void xTPLe_A24(point_proj_t P, point_proj_t Q, f2elm_t A24minus, f2elm_t A24plus, int e);
+
 // Computes [3^e](X:Z) on Montgomery curve with projective constant via e repeated triplings and collects a few intermediate multiples.    
 void xTPLe_collect(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C, unsigned int left_bound, const unsigned int right_bound, const unsigned int* col, point_proj_t* pts, unsigned int* pts_index, unsigned int *npts);
 
 // Computes the corresponding 3-isogeny of a projective Montgomery point (X3:Z3) of order 3.
-void get_3_isog(point_proj_t P, f2elm_t A, f2elm_t C);
+// The codomain is given by its curve constants A24minus = A-2C and A24plus = A+2C, and the isogeny by 2 coefficients.
+void get_3_isog(point_proj_t P, f2elm_t A24minus, f2elm_t A24plus, f2elm_t* coeff);
 
-// Computes the 3-isogeny R=phi(X:Z), given projective point (X3:Z3) of order 3 on a Montgomery curve and a point P = (X:Z).
-void eval_3_isog(point_proj_t P, point_proj_t Q);
+// Evaluates the 3-isogeny with the coefficients computed by get_3_isog() at the point Q = (X:Z)
+void eval_3_isog(point_proj_t Q, f2elm_t* coeff);
 
 // 4-way simultaneous inversion
 void inv_4_way(f2elm_t z1, f2elm_t z2, f2elm_t z3, f2elm_t z4);
 
+// n-way simultaneous inversion using scratch space t for n elements
+void inv_n_way(f2elm_t* z, f2elm_t* t, unsigned int n);
+
 // Computing the point D = (x(Q-P),z(Q-P))
 void distort_and_diff(felm_t xP, point_proj_t d, PCurveIsogenyStruct CurveIsogeny);
 
+/************ Key exchange functions *************/
+
+// Computes the fixed inputs of Alice's and Bob's key generation and stores them in CurveIsogeny->KeyGenPrecomp
+CRYPTO_STATUS keygen_precompute(PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's key-pair generation up to the isogeny tree traversal
+CRYPTO_STATUS KeyGeneration_A_setup(unsigned char* pPrivateKeyA, f2elm_t A, f2elm_t C, point_proj_t R, point_proj_t phiP, point_proj_t phiQ, point_proj_t phiD, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's key-pair generation up to the isogeny tree traversal
+CRYPTO_STATUS KeyGeneration_B_setup(unsigned char* pPrivateKeyB, f2elm_t A, f2elm_t C, point_proj_t R, point_proj_t phiP, point_proj_t phiQ, point_proj_t phiD, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's shared secret generation up to the isogeny tree traversal
+CRYPTO_STATUS SecretAgreement_A_setup(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, f2elm_t A, f2elm_t C, point_proj_t R, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's shared secret generation up to the isogeny tree traversal
+CRYPTO_STATUS SecretAgreement_B_setup(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, f2elm_t A, f2elm_t C, point_proj_t R, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's validation of Alice's public key PKA, given in Montgomery representation
+CRYPTO_STATUS validate_PKA_mont(f2elm_t* PKA, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's validation of Bob's public key PKB, given in Montgomery representation
+CRYPTO_STATUS validate_PKB_mont(f2elm_t* PKB, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+
+// Alice's isogeny tree traversal in the shared secret generation, from the kernel point R to the shared curve (A:C)
+void SecretAgreement_A_isogeny(f2elm_t A, f2elm_t C, point_proj_t R, PCurveIsogenyStruct CurveIsogeny);
+
+// Bob's isogeny tree traversal in the shared secret generation, from the kernel point R to the shared curve (A:C)
+void SecretAgreement_B_isogeny(f2elm_t A, f2elm_t C, point_proj_t R, PCurveIsogenyStruct CurveIsogeny);
+
+// Reads the format octet of a tagged public key, sets montgomery = true for the Montgomery format after checking that its elements are reduced
+CRYPTO_STATUS tagged_pk_format(unsigned char* pPublicKey, bool* montgomery, PCurveIsogenyStruct CurveIsogeny);
+
+/************ Random values *************/
+
+// Outputs nbytes random bytes from the DRBG of the calling thread or from the RandomBytesFunction of pCurveIsogeny, see SIDH_set_drbg()
+CRYPTO_STATUS random_bytes(unsigned int nbytes, unsigned char* random_array, PCurveIsogenyStruct pCurveIsogeny);
+
+/************ Workspaces *************/
+
+#if (OS_TARGET == OS_WIN)
+    #define THREAD_LOCAL    __declspec(thread)
+#else
+    #define THREAD_LOCAL    __thread
+#endif
+
+// Returns the workspace of the calling thread, SIDH_WORKSPACE_BYTES bytes aligned on a cache line
+void* workspace_thread(void);
+
+/************ Operation counters *************/
+
+#if defined(SIDH_OPCOUNT)
+
+// Counts one call to "op" in the current phase of the calling thread
+void opcount_add(OPCOUNT_OP op);
+
+// Sets the current phase of the calling thread, whose operations are also counted in "Counters" if it is not NULL
+void opcount_set_phase(OpCounters* Counters, OPCOUNT_PHASE phase);
+
+// Stops counting the operations of the calling thread in "Counters"
+void opcount_detach(OpCounters* Counters);
+
+#endif
+
+/************ Trace points *************/
+
+#if defined(TRACE_SUPPORT)
+
+// Fires the USDT probe of trace point "point" and calls the trace callback of CurveIsogeny, if any, with a cycle timestamp
+void trace_point(PCurveIsogenyStruct CurveIsogeny, SIDH_TRACE_POINT point, unsigned int arg);
+
+#endif
+
+/************ Thread team for the parallel isogeny tree traversal *************/
+
+typedef struct thread_team* PThreadTeam;
+
+// Creates a team of nthreads-1 worker threads, in addition to the calling thread
+CRYPTO_STATUS thread_team_create(unsigned int nthreads, PThreadTeam* pteam);
+
+// Stops the worker threads and frees the team
+void thread_team_free(PThreadTeam team);
+
+// Takes ownership of the thread team of CurveIsogeny for one isogeny tree traversal, returns NULL if there is none available
+PThreadTeam thread_team_acquire(PCurveIsogenyStruct CurveIsogeny);
+
+// Hands the evaluation of the isogeny of degree 3 or 4 at points[0],...,points[npoints-1] to the workers and returns immediately
+void thread_team_eval(PThreadTeam team, unsigned int degree, f2elm_t* coeff, point_proj** points, unsigned int npoints);
+
+// Waits for the last job and gives up the ownership of the team
+void thread_team_release(PThreadTeam team);
+
+#if !defined(_P503_)
+
+/************ Functions compiled for SIDHp503, see FIELD_DISPATCH *************/
+
+CRYPTO_STATUS SIDH_curve_initialize_p503(PCurveIsogenyStruct pCurveIsogeny, RandomBytes RandomBytesFunction, PCurveIsogenyStaticData pCurveIsogenyData);
+void SIDH_curve_free_p503(PCurveIsogenyStruct pCurveIsogeny);
+CRYPTO_STATUS SIDH_set_arithmetic_p503(PCurveIsogenyStruct pCurveIsogeny, ARITHMETIC_ID Arithmetic);
+CRYPTO_STATUS SIDH_set_fixed_base_window_p503(PCurveIsogenyStruct pCurveIsogeny, unsigned int window);
+CRYPTO_STATUS SIDH_set_threads_p503(PCurveIsogenyStruct pCurveIsogeny, unsigned int nthreads);
+CRYPTO_STATUS SIDH_compute_strategy_p503(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, unsigned int cost_mul, unsigned int cost_eval, unsigned int max_points, unsigned int* splits);
+CRYPTO_STATUS SIDH_set_strategy_p503(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, const unsigned int* splits);
+CRYPTO_STATUS SIDH_tune_strategies_p503(PCurveIsogenyStruct pCurveIsogeny, unsigned int* costs);
+CRYPTO_STATUS random_mod_order_p503(digit_t* random_digits, unsigned int AliceOrBob, PCurveIsogenyStruct pCurveIsogeny);
+CRYPTO_STATUS KeyGeneration_A_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyA, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_B_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyB, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS Validate_PKA_p503(unsigned char* pPublicKeyA, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS Validate_PKB_p503(unsigned char* pPublicKeyB, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_A_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_A_validated_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_validated_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_A_batch_p503(unsigned char* pPrivateKeysA, unsigned char* pPublicKeysA, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_B_batch_p503(unsigned char* pPrivateKeysB, unsigned char* pPublicKeysB, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_A_batch_p503(unsigned char* pPrivateKeysA, unsigned char* pPublicKeysB, unsigned char* pSharedSecretsA, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_batch_p503(unsigned char* pPrivateKeysB, unsigned char* pPublicKeysA, unsigned char* pSharedSecretsB, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_A_batch_status_p503(unsigned char* pPrivateKeysA, unsigned char* pPublicKeysB, unsigned char* pSharedSecretsA, CRYPTO_STATUS* pStatuses, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_batch_status_p503(unsigned char* pPrivateKeysB, unsigned char* pPublicKeysA, unsigned char* pSharedSecretsB, CRYPTO_STATUS* pStatuses, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_A_ws_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyA, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_B_ws_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyB, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_A_ws_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_ws_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS Validate_PKA_ws_p503(unsigned char* pPublicKeyA, bool* valid, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS Validate_PKB_ws_p503(unsigned char* pPublicKeyB, bool* valid, void* Workspace, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_A_tagged_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyA, unsigned char format, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS KeyGeneration_B_tagged_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyB, unsigned char format, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_A_tagged_p503(unsigned char* pPrivateKeyA, unsigned char* pPublicKeyB, unsigned char* pSharedSecretA, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SecretAgreement_B_tagged_p503(unsigned char* pPrivateKeyB, unsigned char* pPublicKeyA, unsigned char* pSharedSecretB, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS Validate_PKA_tagged_p503(unsigned char* pPublicKeyA, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS Validate_PKB_tagged_p503(unsigned char* pPublicKeyB, bool* valid, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS PublicKey_set_format_p503(unsigned char* pPublicKey, unsigned char format, PCurveIsogenyStruct CurveIsogeny);
+CRYPTO_STATUS SIDH_kex_start_p503(PCurveIsogenyStruct CurveIsogeny, SIDH_KEX_OPERATION Operation, unsigned char* pPrivateKey, unsigned char* pPublicKey, unsigned char* pSharedSecret, PKexStep* pKexStep);
+CRYPTO_STATUS SIDH_kex_step_p503(PKexStep KexStep, unsigned int budget, bool* done);
+void SIDH_kex_free_p503(PKexStep KexStep);
+
+#endif
+
+#if defined(MULTIBUFFER_SUPPORT)
+
+/************ Multi-buffer field arithmetic functions *************/
+
+// Copy of a multi-buffer field element, c = a
+void vfpcopy751(vfelm_t a, vfelm_t c);
+
+// Multi-buffer modular addition, c = a+b mod p751
+void vfpadd751(vfelm_t a, vfelm_t b, vfelm_t c);
+
+// Multi-buffer modular subtraction, c = a-b mod p751
+void vfpsub751(vfelm_t a, vfelm_t b, vfelm_t c);
+
+// Multi-buffer field multiplication using Montgomery arithmetic, c = a*b*R^-1 mod p751, where R=2^(MB_RADIX*MB_NLIMBS)
+void vfpmul751_mont(vfelm_t a, vfelm_t b, vfelm_t c);
+
+// Copy of a multi-buffer GF(p751^2) element, c = a
+void vfp2copy751(vf2elm_t a, vf2elm_t c);
+
+// Multi-buffer GF(p751^2) addition, c = a+b in GF(p751^2)
+void vfp2add751(vf2elm_t a, vf2elm_t b, vf2elm_t c);
+
+// Multi-buffer GF(p751^2) subtraction, c = a-b in GF(p751^2)
+void vfp2sub751(vf2elm_t a, vf2elm_t b, vf2elm_t c);
+
+// Multi-buffer GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2)
+void vfp2sqr751_mont(vf2elm_t a, vf2elm_t c);
+
+// Multi-buffer GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2)
+void vfp2mul751_mont(vf2elm_t a, vf2elm_t b, vf2elm_t c);
+
+// Interleaving of MB_LANES GF(p751^2) elements in Montgomery representation into a multi-buffer element
+void vfp2pack751(f2elm_t* a, vf2elm_t c);
+
+// De-interleaving of a multi-buffer element into MB_LANES GF(p751^2) elements in Montgomery representation
+void vfp2unpack751(vf2elm_t a, f2elm_t* c);
+
+/************ Multi-buffer key exchange functions *************/
+
+// Key-pair generation for up to MB_LANES keys running in parallel up to the final normalization
+CRYPTO_STATUS KeyGeneration_projective_mb(unsigned char* pPrivateKeys, unsigned int nlanes, unsigned int AliceOrBob, f2elm_t* A, f2elm_t* X, f2elm_t* Z, PCurveIsogenyStruct CurveIsogeny);
+
+// Shared secret generation for up to MB_LANES secrets running in parallel up to the j-invariant computation
+CRYPTO_STATUS SecretAgreement_projective_mb(unsigned char* pPrivateKeys, unsigned char* pPublicKeys, unsigned int nlanes, unsigned int AliceOrBob, f2elm_t* A, f2elm_t* C, PCurveIsogenyStruct CurveIsogeny);
+
+#endif
+
 
 #ifdef __cplusplus
 }
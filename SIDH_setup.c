@@ -12,6 +12,16 @@
 #include "SIDH_internal.h"
 #include <malloc.h>
 
+extern const unsigned int splits_Alice[MAX_Alice];
+extern const unsigned int splits_Bob[MAX_Bob];
+
+// Relative costs of the scalar multiplications by 4 and 3 and of the 4- and 3-isogeny evaluations for which the precomputed 
+// strategies are optimal (see SIDH-Magma/optimalstrategies.mag)
+#define STRATEGY_COST_MUL_4     258
+#define STRATEGY_COST_EVAL_4    228
+#define STRATEGY_COST_MUL_3     278
+#define STRATEGY_COST_EVAL_3    170
+
 
 /**
  * Initialize curve isogeny structure pCurveIsogeny with static data extracted from pCurveIsogenyData.
@@ -23,10 +33,12 @@ CRYPTO_STATUS SIDH_curve_initialize(
     PCurveIsogenyStaticData pCurveIsogenyData
 ) {
     unsigned int i, pwords, owords;
+    CRYPTO_STATUS Status;
 
-    if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || pCurveIsogenyData == NULL) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    FIELD_DISPATCH(pCurveIsogenyData->pbits, SIDH_curve_initialize_p503(pCurveIsogeny, RandomBytesFunction, pCurveIsogenyData));
     
     // Copy 8-character identifier:
     for (i = 0; i < 8; i++) {
@@ -40,6 +52,7 @@ CRYPTO_STATUS SIDH_curve_initialize(
     pCurveIsogeny->eB = pCurveIsogenyData->eB;
     pCurveIsogeny->BigMont_A24 = pCurveIsogenyData->BigMont_A24;
     pCurveIsogeny->RandomBytesFunction = RandomBytesFunction;
+    pCurveIsogeny->DRBG = DRBG_DEFAULT;
 
     pwords = (pCurveIsogeny->pwordbits + RADIX - 1) / RADIX;
     owords = (pCurveIsogeny->owordbits + RADIX - 1) / RADIX;
@@ -54,8 +67,36 @@ CRYPTO_STATUS SIDH_curve_initialize(
     copy_words((digit_t*)pCurveIsogenyData->Montgomery_R2, pCurveIsogeny->Montgomery_R2, pwords);
     copy_words((digit_t*)pCurveIsogenyData->Montgomery_pp, pCurveIsogeny->Montgomery_pp, pwords);
     copy_words((digit_t*)pCurveIsogenyData->Montgomery_one, pCurveIsogeny->Montgomery_one, pwords);
-    
-    return CRYPTO_SUCCESS;
+#if defined(LOW_MEMORY_SUPPORT)
+    // Optimal strategies for the same costs as the precomputed ones among those that store at most LOW_MEMORY_POINTS points
+    Status = SIDH_compute_strategy(pCurveIsogeny, ALICE, STRATEGY_COST_MUL_4, STRATEGY_COST_EVAL_4, MAX_INT_POINTS_ALICE, pCurveIsogeny->StrategyAlice);
+    if (Status == CRYPTO_SUCCESS) {
+        Status = SIDH_compute_strategy(pCurveIsogeny, BOB, STRATEGY_COST_MUL_3, STRATEGY_COST_EVAL_3, MAX_INT_POINTS_BOB, pCurveIsogeny->StrategyBob);
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+#else
+    for (i = 0; i < MAX_Alice; i++) {
+        pCurveIsogeny->StrategyAlice[i] = splits_Alice[i];    // Precomputed strategies, see SIDH_tune_strategies() for strategies tuned to the host
+    }
+    for (i = 0; i < MAX_Bob; i++) {
+        pCurveIsogeny->StrategyBob[i] = splits_Bob[i];
+    }
+#endif
+
+    Status = SIDH_set_arithmetic(pCurveIsogeny, ARITHMETIC_DEFAULT);   // Select the fastest field arithmetic supported by the processor
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    OPCOUNT_PHASE(pCurveIsogeny, OPCOUNT_PHASE_OTHER);
+    Status = keygen_precompute(pCurveIsogeny);                          // Compute the fixed inputs of key generation
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    return SIDH_set_fixed_base_window(pCurveIsogeny, FIXED_BASE_WINDOW);   // Build the fixed-base tables for key generation
 }
 
 
@@ -81,6 +122,11 @@ PCurveIsogenyStruct SIDH_curve_allocate(PCurveIsogenyStaticData CurveData)
     pCurveIsogeny->Montgomery_R2 = (digit_t*) calloc(1, pbytes);
     pCurveIsogeny->Montgomery_pp = (digit_t*) calloc(1, pbytes);
     pCurveIsogeny->Montgomery_one = (digit_t*) calloc(1, pbytes);
+    pCurveIsogeny->StrategyAlice = (unsigned int*) calloc(MAX_Alice, sizeof(unsigned int));
+    pCurveIsogeny->StrategyBob = (unsigned int*) calloc(MAX_Bob, sizeof(unsigned int));
+#if defined(SIDH_OPCOUNT)
+    pCurveIsogeny->OpCounts = (OpCounters*) calloc(1, sizeof(OpCounters));
+#endif
 
     if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
         return NULL;
@@ -94,6 +140,12 @@ PCurveIsogenyStruct SIDH_curve_allocate(PCurveIsogenyStaticData CurveData)
  */
 void SIDH_curve_free(PCurveIsogenyStruct pCurveIsogeny)
 {
+#if !defined(_P503_)
+    if (pCurveIsogeny != NULL && pCurveIsogeny->pbits == 503) {
+        SIDH_curve_free_p503(pCurveIsogeny);    // The thread team and the precomputed inputs have the layout of the SIDHp503 sources
+        return;
+    }
+#endif
     if (pCurveIsogeny != NULL)
     {
         if (pCurveIsogeny->prime != NULL) {
@@ -129,11 +181,178 @@ void SIDH_curve_free(PCurveIsogenyStruct pCurveIsogeny)
         if (pCurveIsogeny->Montgomery_one != NULL) {
              free(pCurveIsogeny->Montgomery_one);
         }
+        if (pCurveIsogeny->PA_table != NULL) {
+             free(pCurveIsogeny->PA_table);
+        }
+        if (pCurveIsogeny->PB_table != NULL) {
+             free(pCurveIsogeny->PB_table);
+        }
+        if (pCurveIsogeny->BigMont_table != NULL) {
+             free(pCurveIsogeny->BigMont_table);
+        }
+        if (pCurveIsogeny->StrategyAlice != NULL) {
+             free(pCurveIsogeny->StrategyAlice);
+        }
+        if (pCurveIsogeny->StrategyBob != NULL) {
+             free(pCurveIsogeny->StrategyBob);
+        }
+        if (pCurveIsogeny->KeyGenPrecomp != NULL) {
+             free(pCurveIsogeny->KeyGenPrecomp);
+        }
+        thread_team_free((PThreadTeam)pCurveIsogeny->ThreadTeam);
+#if defined(SIDH_OPCOUNT)
+        if (pCurveIsogeny->OpCounts != NULL) {
+             opcount_detach(pCurveIsogeny->OpCounts);
+             free(pCurveIsogeny->OpCounts);
+        }
+#endif
         free(pCurveIsogeny);
     }
 }
 
 
+CRYPTO_STATUS SIDH_set_arithmetic(PCurveIsogenyStruct pCurveIsogeny, ARITHMETIC_ID Arithmetic)
+{ // Select the field arithmetic backend "Arithmetic" for the process, if not selected yet, and record it in pCurveIsogeny
+    const FieldArithmetic* arithmetic = NULL;
+    CRYPTO_STATUS Status;
+
+    if (pCurveIsogeny == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, SIDH_set_arithmetic_p503(pCurveIsogeny, Arithmetic));
+
+    Status = fp_select_arithmetic(Arithmetic, &arithmetic);
+    if (arithmetic != NULL) {
+        pCurveIsogeny->Arithmetic = *arithmetic;
+    }
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SIDH_set_fixed_base_window(PCurveIsogenyStruct pCurveIsogeny, unsigned int window)
+{ // Build the fixed-base tables of PA and PB, and of BigMont's generator for SIDHp751, with window width "window" and record them in pCurveIsogeny
+    unsigned int nwindowsA, nwindowsB, nentries;
+    point_basefield_t P;
+#if !defined(_P503_)
+    keygen_precomp* Precomp = (keygen_precomp*)pCurveIsogeny->KeyGenPrecomp;
+    unsigned int nwindowsM;
+#endif
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || (window != 0 && (window < 2 || window > 6))) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, SIDH_set_fixed_base_window_p503(pCurveIsogeny, window));
+
+    // Remove the current tables, so that key generation uses the Montgomery ladder until the new ones are ready
+    pCurveIsogeny->FixedBaseWindow = 0;
+    if (pCurveIsogeny->PA_table != NULL) {
+        free(pCurveIsogeny->PA_table);
+        pCurveIsogeny->PA_table = NULL;
+    }
+    if (pCurveIsogeny->PB_table != NULL) {
+        free(pCurveIsogeny->PB_table);
+        pCurveIsogeny->PB_table = NULL;
+    }
+#if !defined(_P503_)
+    if (pCurveIsogeny->BigMont_table != NULL) {
+        free(pCurveIsogeny->BigMont_table);
+        pCurveIsogeny->BigMont_table = NULL;
+    }
+#endif
+    if (window == 0) {
+        return CRYPTO_SUCCESS;
+    }
+
+    nentries = 1 << (window - 1);
+    nwindowsA = FIXED_BASE_NWINDOWS(pCurveIsogeny->oAbits, window);
+    nwindowsB = FIXED_BASE_NWINDOWS(pCurveIsogeny->oBbits + 1, window);
+    pCurveIsogeny->PA_table = (digit_t*) calloc(nwindowsA*nentries, 2*NWORDS_FIELD*sizeof(digit_t));
+    pCurveIsogeny->PB_table = (digit_t*) calloc(nwindowsB*nentries, 2*NWORDS_FIELD*sizeof(digit_t));
+    if (pCurveIsogeny->PA_table == NULL || pCurveIsogeny->PB_table == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    // Conversion of the generators to Montgomery representation
+    to_mont((digit_t*)pCurveIsogeny->PA, P->x);
+    to_mont(((digit_t*)pCurveIsogeny->PA) + NWORDS_FIELD, P->y);
+    Status = fixed_base_table(P, NULL, nwindowsA, window, pCurveIsogeny->PA_table, pCurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    to_mont((digit_t*)pCurveIsogeny->PB, P->x);
+    to_mont(((digit_t*)pCurveIsogeny->PB) + NWORDS_FIELD, P->y);
+    Status = fixed_base_table(P, NULL, nwindowsB, window, pCurveIsogeny->PB_table, pCurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+#if !defined(_P503_)
+    // BigMont's generator, in the short Weierstrass form computed by keygen_precompute(). Scalars get one extra bit when made odd
+    if (Precomp != NULL) {
+        nwindowsM = FIXED_BASE_NWINDOWS(BIGMONT_NBITS_ORDER + 1, window);
+        pCurveIsogeny->BigMont_table = (digit_t*) calloc(nwindowsM*nentries, 2*NWORDS_FIELD*sizeof(digit_t));
+        if (pCurveIsogeny->BigMont_table == NULL) {
+            Status = CRYPTO_ERROR_NO_MEMORY;
+            goto cleanup;
+        }
+        Status = fixed_base_table(Precomp->BigMont_G, Precomp->BigMont_a, nwindowsM, window, pCurveIsogeny->BigMont_table, pCurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+    }
+#endif
+    pCurveIsogeny->FixedBaseWindow = window;
+
+    return CRYPTO_SUCCESS;
+
+cleanup:
+    if (pCurveIsogeny->PA_table != NULL) {
+        free(pCurveIsogeny->PA_table);
+        pCurveIsogeny->PA_table = NULL;
+    }
+    if (pCurveIsogeny->PB_table != NULL) {
+        free(pCurveIsogeny->PB_table);
+        pCurveIsogeny->PB_table = NULL;
+    }
+#if !defined(_P503_)
+    if (pCurveIsogeny->BigMont_table != NULL) {
+        free(pCurveIsogeny->BigMont_table);
+        pCurveIsogeny->BigMont_table = NULL;
+    }
+#endif
+    return Status;
+}
+
+
+CRYPTO_STATUS SIDH_set_threads(PCurveIsogenyStruct pCurveIsogeny, unsigned int nthreads)
+{ // Set the number of threads that compute each isogeny tree traversal and start the worker threads
+    PThreadTeam team = NULL;
+    CRYPTO_STATUS Status;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || nthreads < 1 || nthreads > SIDH_MAX_THREADS) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, SIDH_set_threads_p503(pCurveIsogeny, nthreads));
+
+    thread_team_free((PThreadTeam)pCurveIsogeny->ThreadTeam);
+    pCurveIsogeny->ThreadTeam = NULL;
+    if (nthreads == 1) {
+        return CRYPTO_SUCCESS;
+    }
+
+    Status = thread_team_create(nthreads, &team);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    pCurveIsogeny->ThreadTeam = (void*)team;
+
+    return CRYPTO_SUCCESS;
+}
+
+
 /**
  * Check if curve isogeny structure is NULL
  */
@@ -152,7 +371,9 @@ bool is_CurveIsogenyStruct_null(PCurveIsogenyStruct pCurveIsogeny)
         pCurveIsogeny->BigMont_order == NULL ||
         pCurveIsogeny->Montgomery_R2 == NULL ||
         pCurveIsogeny->Montgomery_pp == NULL || 
-        pCurveIsogeny->Montgomery_one == NULL
+        pCurveIsogeny->Montgomery_one == NULL ||
+        pCurveIsogeny->StrategyAlice == NULL ||
+        pCurveIsogeny->StrategyBob == NULL
     ) {
         return true;
     }
@@ -189,6 +410,7 @@ const char* SIDH_get_error_message(CRYPTO_STATUS Status)
 };
 
 
+#if !defined(_P503_)
 const uint64_t Border_div3[NWORDS_ORDER] = {
     0xEDCD718A828384F9,
     0x733B35BFD4427A14,
@@ -197,6 +419,14 @@ const uint64_t Border_div3[NWORDS_ORDER] = {
     0xB858A87E8F4222C7,
     0x254C9C6B525EAF5
 }; 
+#else
+const uint64_t Border_div3[NWORDS_ORDER] = {
+    0xEB5CFCD82C28A2B9,
+    0x4CFF3B5F9FDFCE96,
+    0xB07B3A7CDF4DBC02,
+    0x055DE9C5756D2D32
+}; 
+#endif
 
 
 /**
@@ -227,15 +457,16 @@ CRYPTO_STATUS random_mod_order(
     ) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, random_mod_order_p503(random_digits, AliceOrBob, pCurveIsogeny));
 
-    clear_words((void*)random_digits, MAXWORDS_ORDER);     
+    clear_words((void*)random_digits, NWORDS_ORDER);     
     t1[0] = 2;
     if (AliceOrBob == ALICE) {
         // Number of random bytes to be requested:
         nbytes = (pCurveIsogeny->oAbits + 7)/8;
         nwords = NBITS_TO_NWORDS(pCurveIsogeny->oAbits);
         // Value for masking last random byte:
-        mask = 0x07;
+        mask = MASK_ALICE;
         copy_words(pCurveIsogeny->Aorder, order2, nwords);
         // order/2:
         mp_shiftr1(order2, nwords);        
@@ -245,7 +476,7 @@ CRYPTO_STATUS random_mod_order(
         nbytes = (pCurveIsogeny->oBbits + 7)/8;                    
         nwords = NBITS_TO_NWORDS(pCurveIsogeny->oBbits);
         // Value for masking last random byte:
-        mask = 0x03;
+        mask = MASK_BOB;
         // order2 = order/3-2:
         mp_sub((digit_t*)Border_div3, t1, order2, nwords);
     }
@@ -256,9 +487,10 @@ CRYPTO_STATUS random_mod_order(
         if (ntry > 100) {
             return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
         }
-        Status = (pCurveIsogeny->RandomBytesFunction)(
+        Status = random_bytes(
             nbytes,
-            (unsigned char*)random_digits
+            (unsigned char*)random_digits,
+            pCurveIsogeny
         );
         if (Status != CRYPTO_SUCCESS) {
             return Status;
@@ -306,6 +538,9 @@ CRYPTO_STATUS random_BigMont_mod_order(
     if (random_digits == NULL || is_CurveIsogenyStruct_null(pCurveIsogeny)) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
+    if (pCurveIsogeny->pbits != 751) {               // BigMont is only defined for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
 
     clear_words((void*)random_digits, BIGMONT_MAXWORDS_ORDER);     
     t1[0] = 2;
@@ -321,7 +556,7 @@ CRYPTO_STATUS random_BigMont_mod_order(
         if (ntry > 100) {
             return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
         }
-        Status = (pCurveIsogeny->RandomBytesFunction)(nbytes, (unsigned char*)random_digits);
+        Status = random_bytes(nbytes, (unsigned char*)random_digits, pCurveIsogeny);
         if (Status != CRYPTO_SUCCESS) {
             return Status;
         }
@@ -0,0 +1,1048 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: public key compression and shared secret generation from compressed public keys
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <malloc.h>
+#include <string.h>
+
+extern const uint64_t p751[NWORDS_FIELD];
+extern const uint64_t Border_div3[NWORDS_ORDER];
+
+// Maximum number of candidate x-coordinates tried when generating a torsion basis
+#define MAX_BASIS_ATTEMPTS    256
+
+
+// Arithmetic modulo the order 2^eA or 3^eB of a torsion subgroup. Elements modulo 2^eA are kept in standard representation,
+// elements modulo 3^eB in Montgomery representation with respect to 2^(RADIX*NWORDS_ORDER). All operations are constant time.
+typedef struct {
+    unsigned int ell;                     // 2 or 3
+    unsigned int e;                       // Power of ell in the order
+    unsigned int nbits;                   // Bitlength of the order
+    digit_t order[NWORDS_ORDER];          // Order ell^e
+    digit_t exponent[NWORDS_ORDER];       // Inversion exponent ell^(e-1)*(ell-1)-1 (ell = 3)
+    digit_t R2[NWORDS_ORDER];             // Montgomery constant 2^(2*RADIX*NWORDS_ORDER) mod order (ell = 3)
+    digit_t one[NWORDS_ORDER];            // Value one in the internal representation
+    digit_t minv;                         // Montgomery constant -order^-1 mod 2^RADIX (ell = 3)
+} scalar_ring_t;
+
+
+static void mp_mul_order(digit_t* a, digit_t* b, digit_t* c)
+{ // Multiprecision schoolbook multiply, c = a*b, where lng(a) = lng(b) = NWORDS_ORDER
+    unsigned int i, j, carry;
+    digit_t u, v, UV[2];
+
+    for (i = 0; i < 2*NWORDS_ORDER; i++) c[i] = 0;
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        u = 0;
+        for (j = 0; j < NWORDS_ORDER; j++) {
+            MUL(a[i], b[j], UV + 1, UV[0]);
+            ADDC(0, UV[0], u, carry, v);
+            u = UV[1] + carry;
+            ADDC(0, c[i + j], v, carry, v);
+            u = u + carry;
+            c[i + j] = v;
+        }
+        c[NWORDS_ORDER + i] = u;
+    }
+}
+
+
+static void truncate_order(digit_t* a, unsigned int nbits)
+{ // Reduction modulo 2^nbits, a = a mod 2^nbits, where lng(a) = NWORDS_ORDER
+    unsigned int i;
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        if (i*RADIX >= nbits) {
+            a[i] = 0;
+        } else if ((i + 1)*RADIX > nbits) {
+            a[i] &= ((digit_t)1 << (nbits - i*RADIX)) - 1;
+        }
+    }
+}
+
+
+static void select_order(digit_t* x, digit_t* y, digit_t* z, digit_t option)
+{ // Select either x or y depending on value of option, z = x if option = 0, z = y if option = 0xFF...FF
+    unsigned int i;
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        z[i] = x[i] ^ (option & (x[i] ^ y[i]));
+    }
+}
+
+
+static void swap_order(digit_t* x, digit_t* y, digit_t option)
+{ // Swap x and y if option = 0xFF...FF
+    digit_t temp;
+    unsigned int i;
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        temp = option & (x[i] ^ y[i]);
+        x[i] = temp ^ x[i];
+        y[i] = temp ^ y[i];
+    }
+}
+
+
+static void montmul_order(digit_t* a, digit_t* b, digit_t* c, scalar_ring_t* ring)
+{ // Montgomery multiplication modulo the order, c = a*b*2^(-RADIX*NWORDS_ORDER) mod order, where a < 2^(RADIX*NWORDS_ORDER), b < order
+    unsigned int i, j, carry;
+    digit_t t[2*NWORDS_ORDER], r[NWORDS_ORDER], u, w, v, UV[2];
+    digit_t mask;
+
+    mp_mul_order(a, b, t);
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        u = t[i] * ring->minv;
+        w = 0;
+        for (j = 0; j < NWORDS_ORDER; j++) {
+            MUL(u, ring->order[j], UV + 1, UV[0]);
+            ADDC(0, UV[0], w, carry, v);
+            UV[1] += carry;
+            ADDC(0, t[i + j], v, carry, t[i + j]);
+            w = UV[1] + carry;
+        }
+        for (j = i + NWORDS_ORDER; j < 2*NWORDS_ORDER; j++) {
+            ADDC(0, t[j], w, carry, t[j]);
+            w = (digit_t)carry;
+        }
+    }
+
+    // Final correction to [0, order-1]
+    mask = 0 - (digit_t)mp_sub(&t[NWORDS_ORDER], ring->order, r, NWORDS_ORDER);
+    select_order(r, &t[NWORDS_ORDER], c, mask);
+    clear_words((void*) t, 2*NWORDS_ORDER);
+}
+
+
+static void scalar_ring_init(scalar_ring_t* ring, unsigned int AliceOrBob, PCurveIsogenyStruct CurveIsogeny)
+{ // Set up the arithmetic modulo Alice's order 2^eA (AliceOrBob = ALICE) or Bob's order 3^eB (AliceOrBob = BOB)
+    digit_t t[NWORDS_ORDER] = {0};
+    unsigned int i;
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        ring->one[i] = 0;
+        ring->R2[i] = 0;
+    }
+    ring->one[0] = 1;
+    ring->minv = 0;
+
+    if (AliceOrBob == ALICE) {
+        ring->ell = 2;
+        ring->e = CurveIsogeny->oAbits;
+        ring->nbits = CurveIsogeny->oAbits + 1;
+        copy_words(CurveIsogeny->Aorder, ring->order, NWORDS_ORDER);
+        return;
+    }
+
+    ring->ell = 3;
+    ring->e = CurveIsogeny->eB;
+    ring->nbits = CurveIsogeny->oBbits;
+    copy_words(CurveIsogeny->Border, ring->order, NWORDS_ORDER);
+
+    // exponent = 2*3^(eB-1)-1, such that a^exponent = a^-1
+    mp_add((digit_t*)Border_div3, (digit_t*)Border_div3, ring->exponent, NWORDS_ORDER);
+    t[0] = 1;
+    mp_sub(ring->exponent, t, ring->exponent, NWORDS_ORDER);
+
+    // minv = -order^-1 mod 2^RADIX via Newton iteration
+    ring->minv = ring->order[0];
+    for (i = 0; i < 6; i++) {
+        ring->minv *= 2 - ring->order[0]*ring->minv;
+    }
+    ring->minv = 0 - ring->minv;
+
+    // R2 = 2^(2*RADIX*NWORDS_ORDER) mod order via repeated modular doublings
+    ring->R2[0] = 1;
+    for (i = 0; i < 2*RADIX*NWORDS_ORDER; i++) {
+        mp_add(ring->R2, ring->R2, ring->R2, NWORDS_ORDER);
+        if (mp_sub(ring->R2, ring->order, t, NWORDS_ORDER) == 0) {
+            copy_words(t, ring->R2, NWORDS_ORDER);
+        }
+    }
+    montmul_order(ring->one, ring->R2, ring->one, ring);
+}
+
+
+static void scalar_to_ring(digit_t* a, digit_t* c, scalar_ring_t* ring)
+{ // Conversion of an integer a in [0, order-1] to the internal representation
+    if (ring->ell == 2) {
+        copy_words(a, c, NWORDS_ORDER);
+        truncate_order(c, ring->e);
+    } else {
+        montmul_order(a, ring->R2, c, ring);
+    }
+}
+
+
+static void scalar_from_ring(digit_t* a, digit_t* c, scalar_ring_t* ring)
+{ // Conversion from the internal representation to an integer in [0, order-1]
+    digit_t one[NWORDS_ORDER] = {0};
+
+    if (ring->ell == 2) {
+        copy_words(a, c, NWORDS_ORDER);
+    } else {
+        one[0] = 1;
+        montmul_order(a, one, c, ring);
+    }
+}
+
+
+static void scalar_add(digit_t* a, digit_t* b, digit_t* c, scalar_ring_t* ring)
+{ // Modular addition, c = a+b mod order
+    digit_t r[NWORDS_ORDER], mask;
+
+    mp_add(a, b, c, NWORDS_ORDER);
+    if (ring->ell == 2) {
+        truncate_order(c, ring->e);
+    } else {
+        mask = 0 - (digit_t)mp_sub(c, ring->order, r, NWORDS_ORDER);
+        select_order(r, c, c, mask);
+    }
+}
+
+
+static void scalar_mul(digit_t* a, digit_t* b, digit_t* c, scalar_ring_t* ring)
+{ // Modular multiplication, c = a*b mod order
+    digit_t t[2*NWORDS_ORDER];
+
+    if (ring->ell == 2) {
+        mp_mul_order(a, b, t);
+        copy_words(t, c, NWORDS_ORDER);
+        truncate_order(c, ring->e);
+        clear_words((void*) t, 2*NWORDS_ORDER);
+    } else {
+        montmul_order(a, b, c, ring);
+    }
+}
+
+
+static void scalar_inv(digit_t* a, digit_t* c, scalar_ring_t* ring)
+{ // Modular inversion, c = a^-1 mod order, where a is a unit
+    digit_t t[NWORDS_ORDER], x[NWORDS_ORDER], two[NWORDS_ORDER] = {0};
+    int i;
+
+    if (ring->ell == 2) {
+        // Newton iteration x = x*(2-a*x), starting from a^-1 = a mod 2^3
+        copy_words(a, x, NWORDS_ORDER);
+        two[0] = 2;
+        for (i = 3; i < (int)ring->e; i *= 2) {
+            scalar_mul(a, x, t, ring);
+            mp_sub(two, t, t, NWORDS_ORDER);
+            scalar_mul(x, t, x, ring);
+        }
+    } else {
+        // Fermat-Euler exponentiation with the public exponent 2*3^(eB-1)-1
+        copy_words(ring->one, x, NWORDS_ORDER);
+        for (i = ring->nbits - 1; i >= 0; i--) {
+            montmul_order(x, x, x, ring);
+            if ((ring->exponent[i / RADIX] >> (i % RADIX)) & 1) {
+                montmul_order(x, a, x, ring);
+            }
+        }
+    }
+    copy_words(x, c, NWORDS_ORDER);
+    clear_words((void*) x, NWORDS_ORDER);
+    clear_words((void*) t, NWORDS_ORDER);
+}
+
+
+static digit_t scalar_is_unit(digit_t* a, scalar_ring_t* ring)
+{ // Is a a unit modulo the order? Returns 0xFF...FF if true, 0 otherwise
+  // Modulo 3^eB, 2^(RADIX*NWORDS_ORDER) = 1 mod 3, so the residue mod 3 can be read off the Montgomery representation.
+    unsigned int i, k;
+    digit_t s = 0, q;
+
+    if (ring->ell == 2) {
+        return 0 - (a[0] & 1);
+    }
+
+    for (i = 0; i < NWORDS_ORDER; i++) {                // 2^16 = 1 mod 3
+        for (k = 0; k < RADIX; k += 16) {
+            s += (a[i] >> k) & 0xFFFF;
+        }
+    }
+    s = (s & 0xFFFF) + (s >> 16);
+    s = (s & 0xFFFF) + (s >> 16);                       // s < 2^17
+    q = (s * 43691) >> 17;                              // q = floor(s/3)
+    s = s - 3*q;
+
+    return 0 - (digit_t)is_digit_nonzero_ct(s);
+}
+
+
+static bool scalar_is_unit_public(digit_t* a, scalar_ring_t* ring)
+{
+    return (scalar_is_unit(a, ring) != 0);
+}
+
+
+/***********************************************/
+/************ Torsion basis generation *********/
+
+static void curve_rhs(f2elm_t x, f2elm_t A, f2elm_t one, f2elm_t f)
+{ // Right-hand side of the Montgomery curve y^2 = x^3+A*x^2+x, f = x*((x+A)*x+1)
+    f2elm_t t;
+
+    fp2add751(x, A, t);
+    fp2mul751_mont(t, x, t);
+    fp2add751(t, one, t);
+    fp2mul751_mont(t, x, f);
+}
+
+
+static bool is_square_fp2(f2elm_t a)
+{ // Is a a square in GF(p751^2)? Not constant time
+    felm_t n, s, t;
+
+    fpsqr751_mont(a[0], n);
+    fpsqr751_mont(a[1], t);
+    fpadd751(n, t, n);
+    fpsqrt751_mont(n, s);
+    fpsqr751_mont(s, t);
+    return fpequal751_non_constant_time(t, n);
+}
+
+
+static CRYPTO_STATUS generate_torsion_basis(
+    f2elm_t A,
+    unsigned int AliceOrBob,
+    point_t R1,
+    point_t R2,
+    f2elm_t xR12,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Deterministic generation of a basis {R1, R2} of the 2^eA-torsion (AliceOrBob = ALICE) or the 3^eB-torsion (AliceOrBob = BOB)
+  // of the curve y^2 = x^3+A*x^2+x, together with xR12 = x(R1-R2). Candidates are the points with x-coordinate k+i, k = 1, 2, ...
+  // Both sides of a key exchange compute the same basis from the curve coefficient A. Inputs and outputs are in Montgomery
+  // representation. Not constant time, only to be used with public values.
+    unsigned int attempts, npoints = 0;
+    point_proj_t S, T, T1;
+    point_t R[2];
+    f2elm_t x, f, C = {0}, one = {0}, t0, t1;
+
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, one[0]);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, C[0]);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, x[0]);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, x[1]);
+
+    for (attempts = 0; attempts < MAX_BASIS_ATTEMPTS && npoints < 2; attempts++) {
+        if (attempts > 0) {
+            fpadd751(x[0], one[0], x[0]);
+        }
+        curve_rhs(x, A, one, f);
+        if (!is_square_fp2(f)) {
+            continue;
+        }
+
+        // Clearing the cofactor and checking that the point has full order
+        fp2copy751(x, S->X);
+        fp2copy751(one, S->Z);
+        if (AliceOrBob == ALICE) {
+            xTPLe(S, S, A, C, (int)CurveIsogeny->eB);
+            xDBLe(S, T, A, C, (int)CurveIsogeny->oAbits - 1);
+        } else {
+            xDBLe(S, S, A, C, (int)CurveIsogeny->oAbits);
+            xTPLe(S, T, A, C, (int)CurveIsogeny->eB - 1);
+        }
+        fp2zero751(t0);
+        if (fp2equal751_non_constant_time(T->Z, t0)) {
+            continue;
+        }
+        if (npoints == 1) {                                 // The points of order ell must be distinct projectively, and not opposite
+            fp2mul751_mont(T->X, T1->Z, t0);
+            fp2mul751_mont(T1->X, T->Z, t1);
+            if (fp2equal751_non_constant_time(t0, t1)) {
+                continue;
+            }
+        } else {
+            fp2copy751(T->X, T1->X);
+            fp2copy751(T->Z, T1->Z);
+        }
+
+        fp2inv751_mont(S->Z);
+        fp2mul751_mont(S->X, S->Z, R[npoints]->x);
+        curve_rhs(R[npoints]->x, A, one, f);
+        if (!fp2sqrt751_mont(f, R[npoints]->y)) {
+            return CRYPTO_ERROR;
+        }
+        npoints++;
+    }
+    if (npoints < 2) {
+        return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
+    }
+
+    // x(R1-R2) = ((y1+y2)/(x1-x2))^2-A-x1-x2
+    fp2sub751(R[0]->x, R[1]->x, t0);
+    fp2inv751_mont(t0);
+    fp2add751(R[0]->y, R[1]->y, t1);
+    fp2mul751_mont(t1, t0, t1);
+    fp2sqr751_mont(t1, t1);
+    fp2sub751(t1, A, t1);
+    fp2sub751(t1, R[0]->x, t1);
+    fp2sub751(t1, R[1]->x, xR12);
+
+    fp2copy751(R[0]->x, R1->x); fp2copy751(R[0]->y, R1->y);
+    fp2copy751(R[1]->x, R2->x); fp2copy751(R[1]->y, R2->y);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+/***********************************************/
+/************** Weil pairing *******************/
+
+static void miller_loop(
+    point_t P,
+    f2elm_t A,
+    digit_t* order,
+    unsigned int nbits,
+    point_t* Q,
+    unsigned int nQ,
+    f2elm_t* fnum,
+    f2elm_t* fden,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Miller loop computing f_{n,P}(Q[k]) = fnum[k]/fden[k], k = 0,...,nQ-1, where n = order has bitlength nbits and P has order n exactly,
+  // on the curve y^2 = x^3+A*x^2+x. The lines are normalized, so that e_n(P,Q) = (-1)^n*f_{n,P}(Q)/f_{n,Q}(P).
+  // The point T = [i]P is kept in projective coordinates (X:Y:Z). Not constant time, only to be used with public values.
+    f2elm_t X, Y, Z, X2, Y2, Z2, N, D, W, DZ, t0, t1, t2, l, v;
+    unsigned int k, bit;
+    int i;
+
+    fp2copy751(P->x, X);
+    fp2copy751(P->y, Y);
+    fp2zero751(Z);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, Z[0]);
+    for (k = 0; k < nQ; k++) {
+        fp2copy751(Z, fnum[k]);
+        fp2copy751(Z, fden[k]);
+    }
+
+    for (i = nbits - 2; i >= 0; i--) {
+        bit = (unsigned int)((order[i / RADIX] >> (i % RADIX)) & 1);
+
+        if (i == 0 && bit == 0) {
+            // Last doubling for n = 2^e: T has order 2 and the tangent line x-xT is vertical
+            for (k = 0; k < nQ; k++) {
+                fp2mul751_mont(Q[k]->x, Z, t0);
+                fp2sub751(t0, X, t0);
+                fp2sqr751_mont(fnum[k], fnum[k]);
+                fp2mul751_mont(fnum[k], t0, fnum[k]);
+                fp2sqr751_mont(fden[k], fden[k]);
+                fp2mul751_mont(fden[k], Z, fden[k]);
+            }
+            break;
+        }
+
+        // Doubling step, the tangent at T has slope N/D
+        fp2sqr751_mont(X, t0);                      // t0 = X^2
+        fp2add751(t0, t0, N);
+        fp2add751(N, t0, N);                        // N = 3*X^2
+        fp2mul751_mont(A, Z, t1);                   // t1 = A*Z
+        fp2mul751_mont(t1, X, t2);
+        fp2add751(N, t2, N);
+        fp2add751(N, t2, N);                        // N = 3*X^2+2*A*X*Z
+        fp2sqr751_mont(Z, t2);
+        fp2add751(N, t2, N);                        // N = 3*X^2+2*A*X*Z+Z^2
+        fp2mul751_mont(Y, Z, D);
+        fp2add751(D, D, D);                         // D = 2*Y*Z
+        fp2add751(t1, X, t1);
+        fp2add751(t1, X, t1);                       // t1 = A*Z+2*X
+        fp2sqr751_mont(D, t2);                      // t2 = D^2
+        fp2mul751_mont(t1, t2, t1);
+        fp2sqr751_mont(N, W);
+        fp2mul751_mont(W, Z, W);
+        fp2sub751(W, t1, W);                        // W = N^2*Z-(A*Z+2*X)*D^2
+        fp2mul751_mont(W, D, X2);                   // X2 = W*D
+        fp2mul751_mont(X, t2, t0);
+        fp2sub751(t0, W, t0);
+        fp2mul751_mont(N, t0, Y2);
+        fp2mul751_mont(t2, D, t2);                  // t2 = D^3
+        fp2mul751_mont(Y, t2, t0);
+        fp2sub751(Y2, t0, Y2);                      // Y2 = N*(X*D^2-W)-Y*D^3
+        fp2mul751_mont(t2, Z, Z2);                  // Z2 = D^3*Z
+        fp2mul751_mont(D, Z, DZ);
+
+        for (k = 0; k < nQ; k++) {
+            fp2mul751_mont(Q[k]->y, Z, t0);
+            fp2sub751(t0, Y, t0);
+            fp2mul751_mont(D, t0, l);
+            fp2mul751_mont(Q[k]->x, Z, t0);
+            fp2sub751(t0, X, t0);
+            fp2mul751_mont(N, t0, t0);
+            fp2sub751(l, t0, l);                    // l = D*(yQ*Z-Y)-N*(xQ*Z-X)
+            fp2mul751_mont(Q[k]->x, Z2, v);
+            fp2sub751(v, X2, v);                    // v = xQ*Z2-X2
+            fp2sqr751_mont(fnum[k], fnum[k]);
+            fp2mul751_mont(l, Z2, l);
+            fp2mul751_mont(fnum[k], l, fnum[k]);
+            fp2sqr751_mont(fden[k], fden[k]);
+            fp2mul751_mont(v, DZ, v);
+            fp2mul751_mont(fden[k], v, fden[k]);
+        }
+        fp2copy751(X2, X);
+        fp2copy751(Y2, Y);
+        fp2copy751(Z2, Z);
+
+        if (bit == 1) {
+            if (i == 0) {
+                // Last addition for odd n: T = -P and the line x-xP is vertical
+                for (k = 0; k < nQ; k++) {
+                    fp2sub751(Q[k]->x, P->x, t0);
+                    fp2mul751_mont(fnum[k], t0, fnum[k]);
+                }
+                break;
+            }
+
+            // Addition step, the line through T and P has slope N/D
+            fp2mul751_mont(P->y, Z, t0);
+            fp2sub751(Y, t0, N);                    // N = Y-yP*Z
+            fp2mul751_mont(P->x, Z, t1);            // t1 = xP*Z
+            fp2sub751(X, t1, D);                    // D = X-xP*Z
+            fp2sqr751_mont(D, t2);                  // t2 = D^2
+            fp2mul751_mont(A, Z, t0);
+            fp2add751(t0, X, t0);
+            fp2add751(t0, t1, t0);
+            fp2mul751_mont(t0, t2, t0);
+            fp2sqr751_mont(N, W);
+            fp2mul751_mont(W, Z, W);
+            fp2sub751(W, t0, W);                    // W = N^2*Z-D^2*(A*Z+X+xP*Z)
+            fp2mul751_mont(W, D, X2);               // X2 = W*D
+            fp2mul751_mont(t1, t2, t0);
+            fp2sub751(t0, W, t0);
+            fp2mul751_mont(N, t0, Y2);
+            fp2mul751_mont(t2, D, t2);
+            fp2mul751_mont(t2, Z, Z2);              // Z2 = D^3*Z
+            fp2mul751_mont(P->y, Z2, t0);
+            fp2sub751(Y2, t0, Y2);                  // Y2 = N*(xP*D^2*Z-W)-yP*D^3*Z
+
+            for (k = 0; k < nQ; k++) {
+                fp2sub751(Q[k]->y, P->y, t0);
+                fp2mul751_mont(D, t0, l);
+                fp2sub751(Q[k]->x, P->x, t0);
+                fp2mul751_mont(N, t0, t0);
+                fp2sub751(l, t0, l);                // l = D*(yQ-yP)-N*(xQ-xP)
+                fp2mul751_mont(Q[k]->x, Z2, v);
+                fp2sub751(v, X2, v);                // v = xQ*Z2-X2
+                fp2mul751_mont(l, Z2, l);
+                fp2mul751_mont(fnum[k], l, fnum[k]);
+                fp2mul751_mont(v, D, v);
+                fp2mul751_mont(fden[k], v, fden[k]);
+            }
+            fp2copy751(X2, X);
+            fp2copy751(Y2, Y);
+            fp2copy751(Z2, Z);
+        }
+    }
+}
+
+
+/***********************************************/
+/********** Discrete logarithms ****************/
+
+static void fp2mul751_conj(f2elm_t a, f2elm_t b, f2elm_t c)
+{ // c = a*conj(b). For b of norm 1, conj(b) = b^-1
+    f2elm_t t;
+    felm_t zero = {0};
+
+    fpcopy751(b[0], t[0]);
+    fpsub751(zero, b[1], t[1]);
+    fp2mul751_mont(a, t, c);
+}
+
+
+static void fp2pow_ell(f2elm_t a, f2elm_t c, unsigned int ell, unsigned int n)
+{ // c = a^(ell^n), ell = 2 or 3
+    f2elm_t t;
+    unsigned int i;
+
+    fp2copy751(a, c);
+    for (i = 0; i < n; i++) {
+        if (ell == 2) {
+            fp2sqr751_mont(c, c);
+        } else {
+            fp2sqr751_mont(c, t);
+            fp2mul751_mont(c, t, c);
+        }
+    }
+}
+
+
+static bool dlog_recursive(
+    f2elm_t h,
+    unsigned int n,
+    unsigned int k,
+    scalar_ring_t* ring,
+    f2elm_t* table,
+    f2elm_t* table2,
+    unsigned char* digits
+) { // Pohlig-Hellman discrete logarithm in the subgroup generated by table[k] = g^(ell^k), which has order ell^n with k+n = e.
+  // It outputs the n base-ell digits of log h to the base table[k], following a balanced divide-and-conquer strategy that
+  // costs O(n*log(n)) multiplications. table2[j] = table[j]^2 for ell = 3. Returns false if h is not in the subgroup.
+    unsigned int i, n1 = n / 2, n2 = n - n1;
+    f2elm_t t;
+
+    if (n == 1) {
+        if (fp2equal751_non_constant_time(h, table[ring->e])) {     // table[e] = 1
+            digits[0] = 0;
+        } else if (fp2equal751_non_constant_time(h, table[ring->e - 1])) {
+            digits[0] = 1;
+        } else if (ring->ell == 3 && fp2equal751_non_constant_time(h, table2[ring->e - 1])) {
+            digits[0] = 2;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    fp2pow_ell(h, t, ring->ell, n2);                // Low digits from h^(ell^n2), in the subgroup of order ell^n1
+    if (!dlog_recursive(t, n1, k + n2, ring, table, table2, digits)) {
+        return false;
+    }
+
+    fp2copy751(h, t);                               // High digits from h*g^-(low digits), in the subgroup of order ell^n2
+    for (i = 0; i < n1; i++) {
+        if (digits[i] == 1) {
+            fp2mul751_conj(t, table[k + i], t);
+        } else if (digits[i] == 2) {
+            fp2mul751_conj(t, table2[k + i], t);
+        }
+    }
+    return dlog_recursive(t, n2, k + n1, ring, table, table2, digits + n1);
+}
+
+
+static bool dlog(f2elm_t h, scalar_ring_t* ring, f2elm_t* table, f2elm_t* table2, unsigned char* digits, digit_t* x)
+{ // Discrete logarithm x = log h mod ell^e to the base table[0], using the scratch space digits of e bytes
+    digit_t t[NWORDS_ORDER];
+    unsigned int j;
+    int i;
+
+    if (!dlog_recursive(h, ring->e, 0, ring, table, table2, digits)) {
+        return false;
+    }
+
+    for (i = 0; i < NWORDS_ORDER; i++) {
+        x[i] = 0;
+    }
+    for (i = ring->e - 1; i >= 0; i--) {            // Horner's rule x = x*ell+digit
+        copy_words(x, t, NWORDS_ORDER);
+        mp_add(x, x, x, NWORDS_ORDER);
+        if (ring->ell == 3) {
+            mp_add(x, t, x, NWORDS_ORDER);
+        }
+        for (j = 0; j < NWORDS_ORDER; j++) {
+            t[j] = 0;
+        }
+        t[0] = (digit_t)digits[i];
+        mp_add(x, t, x, NWORDS_ORDER);
+    }
+    return true;
+}
+
+
+/***********************************************/
+/*********** Public key compression ************/
+
+static CRYPTO_STATUS decode_public_key(
+    unsigned char* pPublicKey,
+    f2elm_t A,
+    point_t P,
+    point_t Q,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Recover the affine points P and Q from a public key {A, x(P), x(Q), x(P-Q)}, converted to Montgomery representation.
+  // The sign of y(Q) is fixed by x(P-Q). Not constant time, only to be used with public values.
+    publickey_t* PublicKey = (publickey_t*)pPublicKey;
+    f2elm_t xPQ, f, one = {0}, t0, t1;
+    unsigned int i;
+
+    to_fp2mont(((f2elm_t*) PublicKey)[0], A);
+    to_fp2mont(((f2elm_t*) PublicKey)[1], P->x);
+    to_fp2mont(((f2elm_t*) PublicKey)[2], Q->x);
+    to_fp2mont(((f2elm_t*) PublicKey)[3], xPQ);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, one[0]);
+
+    curve_rhs(P->x, A, one, f);
+    if (!fp2sqrt751_mont(f, P->y)) {
+        return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+    }
+    curve_rhs(Q->x, A, one, f);
+    if (!fp2sqrt751_mont(f, Q->y)) {
+        return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+    }
+
+    fp2sub751(P->x, Q->x, t0);
+    fp2inv751_mont(t0);
+    for (i = 0; i < 2; i++) {
+        // x(P-Q) = ((yP+yQ)/(xP-xQ))^2-A-xP-xQ
+        fp2add751(P->y, Q->y, t1);
+        fp2mul751_mont(t1, t0, t1);
+        fp2sqr751_mont(t1, t1);
+        fp2sub751(t1, A, t1);
+        fp2sub751(t1, P->x, t1);
+        fp2sub751(t1, Q->x, t1);
+        if (fp2equal751_non_constant_time(t1, xPQ)) {
+            return CRYPTO_SUCCESS;
+        }
+        fp2zero751(t1);
+        fp2sub751(t1, Q->y, Q->y);
+    }
+
+    return CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+}
+
+
+static CRYPTO_STATUS PublicKeyCompression(
+    unsigned char* pPublicKey,
+    unsigned char* pCompressedPK,
+    unsigned int AliceOrBob,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Compression of a public key whose points lie in the 2^eA-torsion (AliceOrBob = ALICE) or the 3^eB-torsion (AliceOrBob = BOB)
+  // The points P and Q of the public key are written as P = a0*R1+b0*R2 and Q = a1*R1+b1*R2 in the deterministic basis {R1, R2},
+  // where the coefficients are discrete logarithms of Weil pairings to the base e(R1,R2): a0 = log e(P,R2), b0 = log e(R1,P), etc.
+  // Only the ratios of the coefficients are needed to recover the kernel of the shared isogeny, so they are normalized by a0, or by
+  // b0 if a0 is not a unit.
+    unsigned int pbytes = (CurveIsogeny->pbits + 7)/8, sbytes, e, i;
+    unsigned int ell = (AliceOrBob == ALICE) ? 2 : 3;
+    point_t R1, R2, P, Q, pts[3];
+    f2elm_t A, xR12, fnum[4][3], fden[4][3], g[5], ginv[5], *table = NULL, *table2 = NULL;
+    f2elm_t zero = {0}, one = {0};
+    unsigned char* digits = NULL;
+    digit_t a0[NWORDS_ORDER], b0[NWORDS_ORDER], a1[NWORDS_ORDER], b1[NWORDS_ORDER], inv[NWORDS_ORDER], c[3][NWORDS_ORDER];
+    digit_t* order;
+    unsigned char flag = 0;
+    scalar_ring_t ring;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;
+
+    scalar_ring_init(&ring, AliceOrBob, CurveIsogeny);
+    order = ring.order;
+    e = ring.e;
+    sbytes = (CurveIsogeny->oAbits + 7)/8;
+    if (AliceOrBob == BOB) {
+        sbytes = (CurveIsogeny->oBbits + 7)/8;
+    }
+
+    Status = decode_public_key(pPublicKey, A, P, Q, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = generate_torsion_basis(A, AliceOrBob, R1, R2, xR12, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    // Miller loops for the Weil pairings e(R1,R2), e(P,R2), e(R1,P), e(Q,R2) and e(R1,Q)
+    fp2copy751(R2->x, pts[0]->x); fp2copy751(R2->y, pts[0]->y);
+    fp2copy751(P->x, pts[1]->x); fp2copy751(P->y, pts[1]->y);
+    fp2copy751(Q->x, pts[2]->x); fp2copy751(Q->y, pts[2]->y);
+    miller_loop(R1, A, order, ring.nbits, pts, 3, fnum[0], fden[0], CurveIsogeny);                 // f_R1 at R2, P, Q
+    fp2copy751(R1->x, pts[0]->x); fp2copy751(R1->y, pts[0]->y);
+    miller_loop(R2, A, order, ring.nbits, pts, 3, fnum[1], fden[1], CurveIsogeny);                 // f_R2 at R1, P, Q
+    fp2copy751(R2->x, pts[1]->x); fp2copy751(R2->y, pts[1]->y);
+    miller_loop(P, A, order, ring.nbits, pts, 2, fnum[2], fden[2], CurveIsogeny);                  // f_P at R1, R2
+    miller_loop(Q, A, order, ring.nbits, pts, 2, fnum[3], fden[3], CurveIsogeny);                  // f_Q at R1, R2
+
+    // e(U,V) = (-1)^n*f_U(V)/f_V(U), with n even for ell = 2 and odd for ell = 3
+    fp2mul751_mont(fnum[0][0], fden[1][0], g[0]); fp2mul751_mont(fden[0][0], fnum[1][0], ginv[0]);  // e(R1,R2)
+    fp2mul751_mont(fnum[2][1], fden[1][1], g[1]); fp2mul751_mont(fden[2][1], fnum[1][1], ginv[1]);  // e(P,R2)
+    fp2mul751_mont(fnum[0][1], fden[2][0], g[2]); fp2mul751_mont(fden[0][1], fnum[2][0], ginv[2]);  // e(R1,P)
+    fp2mul751_mont(fnum[3][1], fden[1][2], g[3]); fp2mul751_mont(fden[3][1], fnum[1][2], ginv[3]);  // e(Q,R2)
+    fp2mul751_mont(fnum[0][2], fden[3][0], g[4]); fp2mul751_mont(fden[0][2], fnum[3][0], ginv[4]);  // e(R1,Q)
+    for (i = 0; i < 5; i++) {
+        if (fp2equal751_non_constant_time(g[i], zero) || fp2equal751_non_constant_time(ginv[i], zero)) {
+            return CRYPTO_ERROR;                                                                    // Degenerate evaluation
+        }
+    }
+    inv_n_way(ginv, fnum[0], 5);
+    for (i = 0; i < 5; i++) {
+        fp2mul751_mont(g[i], ginv[i], g[i]);
+        if (ell == 3) {
+            fp2sub751(zero, g[i], g[i]);
+        }
+    }
+
+    // Table of powers g^(ell^j), j = 0,...,e, of the generator g = e(R1,R2), plus their squares for ell = 3
+    table = (f2elm_t*)calloc(e + 1, sizeof(f2elm_t));
+    table2 = (f2elm_t*)calloc(e + 1, sizeof(f2elm_t));
+    digits = (unsigned char*)calloc(e, sizeof(unsigned char));
+    if (table == NULL || table2 == NULL || digits == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    fp2copy751(g[0], table[0]);
+    for (i = 1; i <= e; i++) {
+        fp2pow_ell(table[i - 1], table[i], ell, 1);
+    }
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, one[0]);
+    if (!fp2equal751_non_constant_time(table[e], one) || fp2equal751_non_constant_time(table[e - 1], one)) {
+        Status = CRYPTO_ERROR;                                                                      // e(R1,R2) must have order ell^e
+        goto cleanup;
+    }
+    if (ell == 3) {
+        for (i = 0; i <= e; i++) {
+            fp2sqr751_mont(table[i], table2[i]);
+        }
+    }
+
+    if (!dlog(g[1], &ring, table, table2, digits, a0) || !dlog(g[2], &ring, table, table2, digits, b0) ||
+        !dlog(g[3], &ring, table, table2, digits, a1) || !dlog(g[4], &ring, table, table2, digits, b1)) {
+        Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+        goto cleanup;
+    }
+
+    // Normalization of the coefficients
+    scalar_to_ring(a0, a0, &ring);
+    scalar_to_ring(b0, b0, &ring);
+    scalar_to_ring(a1, a1, &ring);
+    scalar_to_ring(b1, b1, &ring);
+    if (scalar_is_unit_public(a0, &ring)) {
+        scalar_inv(a0, inv, &ring);
+        scalar_mul(b0, inv, c[0], &ring);
+    } else if (scalar_is_unit_public(b0, &ring)) {
+        flag = 1;
+        scalar_inv(b0, inv, &ring);
+        scalar_mul(a0, inv, c[0], &ring);
+    } else {
+        Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;                                                // P does not have full order
+        goto cleanup;
+    }
+    scalar_mul(a1, inv, c[1], &ring);
+    scalar_mul(b1, inv, c[2], &ring);
+
+    // Encoding {A, c0, c1, c2, flag}
+    from_fp2mont(A, A);
+    memcpy(pCompressedPK, A[0], pbytes);
+    memcpy(pCompressedPK + pbytes, A[1], pbytes);
+    for (i = 0; i < 3; i++) {
+        scalar_from_ring(c[i], c[i], &ring);
+        memcpy(pCompressedPK + 2*pbytes + i*sbytes, c[i], sbytes);
+    }
+    pCompressedPK[2*pbytes + 3*sbytes] = flag;
+    Status = CRYPTO_SUCCESS;
+
+cleanup:
+    if (table != NULL) {
+        free(table);
+    }
+    if (table2 != NULL) {
+        free(table2);
+    }
+    if (digits != NULL) {
+        free(digits);
+    }
+
+    return Status;
+}
+
+
+CRYPTO_STATUS PublicKeyCompression_A(unsigned char* pPublicKeyA, unsigned char* pCompressedPKA, PCurveIsogenyStruct CurveIsogeny)
+{ // Alice's public key compression
+  // It produces a compressed public key pCompressedPKA from Alice's public key pPublicKeyA.
+  // The compressed key consists of Alice's curve coefficient in GF(p751^2), three elements in Z_oB and a flag octet, i.e., 333 bytes in total.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    if (pPublicKeyA == NULL || pCompressedPKA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    if (CurveIsogeny->pbits != NBITS_FIELD) {        // Compression is only implemented for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    return PublicKeyCompression(pPublicKeyA, pCompressedPKA, BOB, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS PublicKeyCompression_B(unsigned char* pPublicKeyB, unsigned char* pCompressedPKB, PCurveIsogenyStruct CurveIsogeny)
+{ // Bob's public key compression
+  // It produces a compressed public key pCompressedPKB from Bob's public key pPublicKeyB.
+  // The compressed key consists of Bob's curve coefficient in GF(p751^2), three elements in Z_oA and a flag octet, i.e., 330 bytes in total.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    if (pPublicKeyB == NULL || pCompressedPKB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    if (CurveIsogeny->pbits != NBITS_FIELD) {        // Compression is only implemented for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    return PublicKeyCompression(pPublicKeyB, pCompressedPKB, ALICE, CurveIsogeny);
+}
+
+
+/***********************************************/
+/**** Shared secrets from compressed keys ******/
+
+static CRYPTO_STATUS SecretAgreement_Compression(
+    unsigned char* pPrivateKey,
+    unsigned char* pCompressedPK,
+    unsigned char* pSharedSecret,
+    unsigned int AliceOrBob,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Shared secret generation from a compressed public key, computed by Alice (AliceOrBob = ALICE) or Bob (AliceOrBob = BOB)
+  // The kernel point of the shared isogeny, P+sk*Q = (a0+sk*a1)*R1+(b0+sk*b1)*R2, is obtained directly from the deterministic
+  // basis {R1, R2} and the normalized coefficients of the compressed key as R1+t*R2, or R2+t*R1 if the coefficient of R1 is not
+  // a unit, through one 3-point ladder. The scalar arithmetic and the point selection are constant time.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    unsigned int pbytes = (CurveIsogeny->pbits + 7)/8, sbytes, i;
+    point_t R1, R2;
+    point_proj_t R;
+    f2elm_t A, C = {0}, xR12, jinv;
+    felm_t t = {0};
+    digit_t sk[NWORDS_ORDER] = {0}, c[3][NWORDS_ORDER] = {0}, alpha[NWORDS_ORDER], beta[NWORDS_ORDER], mask, temp;
+    unsigned char flag;
+    scalar_ring_t ring;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;
+
+    scalar_ring_init(&ring, AliceOrBob, CurveIsogeny);
+    sbytes = (CurveIsogeny->oAbits + 7)/8;
+    if (AliceOrBob == BOB) {
+        sbytes = (CurveIsogeny->oBbits + 7)/8;
+    }
+
+    // Decoding and checking the compressed key {A, c0, c1, c2, flag}
+    fp2zero751(A);
+    memcpy(A[0], pCompressedPK, pbytes);
+    memcpy(A[1], pCompressedPK + pbytes, pbytes);
+    for (i = 0; i < 3; i++) {
+        memcpy(c[i], pCompressedPK + 2*pbytes + i*sbytes, sbytes);
+        if (mp_sub(c[i], ring.order, alpha, NWORDS_ORDER) == 0) {
+            return CRYPTO_ERROR_INVALID_PARAMETER;
+        }
+    }
+    flag = pCompressedPK[2*pbytes + 3*sbytes];
+    if (flag > 1 || mp_sub(A[0], (digit_t*)p751, t, NWORDS_FIELD) == 0 || mp_sub(A[1], (digit_t*)p751, t, NWORDS_FIELD) == 0) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    to_fp2mont(A, A);
+
+    Status = generate_torsion_basis(A, AliceOrBob, R1, R2, xR12, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    // Coefficients alpha*R1+beta*R2 of the kernel, where (alpha, beta) = (1+sk*c1, c0+sk*c2) if flag = 0, and (c0+sk*c1, 1+sk*c2) otherwise
+    copy_words((digit_t*)pPrivateKey, sk, NWORDS_ORDER);
+    scalar_to_ring(sk, sk, &ring);
+    for (i = 0; i < 3; i++) {
+        scalar_to_ring(c[i], c[i], &ring);
+    }
+    scalar_mul(sk, c[1], alpha, &ring);
+    scalar_mul(sk, c[2], beta, &ring);
+    if (flag == 0) {
+        scalar_add(alpha, ring.one, alpha, &ring);
+        scalar_add(beta, c[0], beta, &ring);
+    } else {
+        scalar_add(alpha, c[0], alpha, &ring);
+        scalar_add(beta, ring.one, beta, &ring);
+    }
+
+    // If alpha is not a unit then swap the roles of R1 and R2, so that the kernel is generated by R1+(beta/alpha)*R2
+    mask = ~scalar_is_unit(alpha, &ring);
+    swap_order(alpha, beta, mask);
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        temp = mask & (R1->x[0][i] ^ R2->x[0][i]);
+        R1->x[0][i] ^= temp;
+        R2->x[0][i] ^= temp;
+        temp = mask & (R1->x[1][i] ^ R2->x[1][i]);
+        R1->x[1][i] ^= temp;
+        R2->x[1][i] ^= temp;
+    }
+    scalar_inv(alpha, alpha, &ring);
+    scalar_mul(beta, alpha, beta, &ring);
+    scalar_from_ring(beta, t, &ring);
+
+    fpcopy751(CurveIsogeny->C, C[0]);
+    to_mont(C[0], C[0]);
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_SCALAR_MULT);
+    Status = ladder_3_pt(R1->x, R2->x, xR12, t, AliceOrBob, R, A, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_TRAVERSAL);
+    if (AliceOrBob == ALICE) {
+        first_4_isog(R, A, A, C, CurveIsogeny);
+        SecretAgreement_A_isogeny(A, C, R, CurveIsogeny);
+    } else {
+        SecretAgreement_B_isogeny(A, C, R, CurveIsogeny);
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+    if (!j_inv_checked(A, C, jinv)) {               // Singular shared curve, the secret is zeroed as in SecretAgreement_A()
+        Status = CRYPTO_ERROR_SHARED_KEY;
+    }
+    from_fp2mont(jinv, (felm_t*) pSharedSecret);    // Converting back to standard representation
+
+cleanup:
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    clear_words((void*) sk, NWORDS_ORDER);
+    clear_words((void*) alpha, NWORDS_ORDER);
+    clear_words((void*) beta, NWORDS_ORDER);
+    clear_words((void*) c, 3*NWORDS_ORDER);
+    clear_words((void*) t, NWORDS_FIELD);
+    clear_words((void*) R, 2*2*pwords);
+    clear_words((void*) R1, 2*2*pwords);
+    clear_words((void*) R2, 2*2*pwords);
+    clear_words((void*) A, 2*pwords);
+    clear_words((void*) C, 2*pwords);
+    clear_words((void*) jinv, 2*pwords);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_Compression_A(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pCompressedPKB,
+    unsigned char* pSharedSecretA,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation from Bob's compressed public key
+  // It produces a shared secret key pSharedSecretA using her secret key pPrivateKeyA and Bob's compressed public key pCompressedPKB
+  // Inputs: Alice's pPrivateKeyA is an even integer in the range [2, oA-2], where oA = 2^372 (i.e., 372 bits in total).
+  //         Bob's pCompressedPKB is the output of PublicKeyCompression_B(), i.e., 330 bytes in total.
+  // Output: a shared secret pSharedSecretA that consists of one element in GF(p751^2), i.e., 1502 bits in total.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    if (pPrivateKeyA == NULL || pCompressedPKB == NULL || pSharedSecretA == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    if (CurveIsogeny->pbits != NBITS_FIELD) {        // Compression is only implemented for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    return SecretAgreement_Compression(pPrivateKeyA, pCompressedPKB, pSharedSecretA, ALICE, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS SecretAgreement_Compression_B(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pCompressedPKA,
+    unsigned char* pSharedSecretB,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation from Alice's compressed public key
+  // It produces a shared secret key pSharedSecretB using his secret key pPrivateKeyB and Alice's compressed public key pCompressedPKA
+  // Inputs: Bob's pPrivateKeyB is an integer in the range [1, oB-1], where oB = 3^239 (i.e., 379 bits in total).
+  //         Alice's pCompressedPKA is the output of PublicKeyCompression_A(), i.e., 333 bytes in total.
+  // Output: a shared secret pSharedSecretB that consists of one element in GF(p751^2), i.e., 1502 bits in total.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    if (pPrivateKeyB == NULL || pCompressedPKA == NULL || pSharedSecretB == NULL || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    if (CurveIsogeny->pbits != NBITS_FIELD) {        // Compression is only implemented for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    return SecretAgreement_Compression(pPrivateKeyB, pCompressedPKA, pSharedSecretB, BOB, CurveIsogeny);
+}
@@ -0,0 +1,186 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: per-thread buffered DRBG based on ChaCha20 with fast key erasure
+*
+* Each thread keeps a 256-bit ChaCha20 key seeded from the RandomBytesFunction of the curve
+* isogeny structure. A refill computes DRBG_BLOCKS keystream blocks, replaces the key by the
+* first 32 bytes of them and hands out the rest, wiping every byte as it is used, so that a
+* compromise of the state does not reveal past outputs.
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <string.h>
+#if (OS_TARGET == OS_LINUX)
+    #include <unistd.h>
+#endif
+
+#define DRBG_BLOCKS          16                          // ChaCha20 blocks computed per refill
+#define DRBG_BUFFER_BYTES    (64*DRBG_BLOCKS)
+#define DRBG_KEY_BYTES       32
+#define DRBG_RESEED_BYTES    (1 << 20)                   // Output bytes between two reseeds from the RandomBytesFunction
+
+typedef struct {
+    uint32_t         key[DRBG_KEY_BYTES/4];
+    unsigned char    buffer[DRBG_BUFFER_BYTES];          // The last "available" bytes are unused outputs, the rest are zero
+    unsigned int     available;
+    unsigned int     generated;                          // Output bytes since the last reseed
+    RandomBytes      source;                             // Function that seeded the key, NULL if not seeded
+#if (OS_TARGET == OS_LINUX)
+    pid_t            pid;                                // Process that seeded the key, a forked child reseeds
+#endif
+} drbg_state;
+
+static THREAD_LOCAL drbg_state drbg;
+
+#define ROTL32(x, n)    (((x) << (n)) | ((x) >> (32 - (n))))
+#define QUARTERROUND(a, b, c, d)                          \
+    a += b; d ^= a; d = ROTL32(d, 16);                    \
+    c += d; b ^= c; b = ROTL32(b, 12);                    \
+    a += b; d ^= a; d = ROTL32(d, 8);                     \
+    c += d; b ^= c; b = ROTL32(b, 7);
+
+
+static void chacha20_block(const uint32_t* key, uint32_t counter, unsigned char* out)
+{ // ChaCha20 block function (RFC 7539) with a zero nonce, out = 64 bytes of keystream block "counter"
+    uint32_t x[16], in[16];
+    unsigned int i;
+
+    in[0] = 0x61707865; in[1] = 0x3320646e; in[2] = 0x79622d32; in[3] = 0x6b206574;
+    for (i = 0; i < 8; i++) {
+        in[4 + i] = key[i];
+    }
+    in[12] = counter;
+    in[13] = in[14] = in[15] = 0;
+    for (i = 0; i < 16; i++) {
+        x[i] = in[i];
+    }
+
+    for (i = 0; i < 10; i++) {
+        QUARTERROUND(x[0], x[4], x[8], x[12]);
+        QUARTERROUND(x[1], x[5], x[9], x[13]);
+        QUARTERROUND(x[2], x[6], x[10], x[14]);
+        QUARTERROUND(x[3], x[7], x[11], x[15]);
+        QUARTERROUND(x[0], x[5], x[10], x[15]);
+        QUARTERROUND(x[1], x[6], x[11], x[12]);
+        QUARTERROUND(x[2], x[7], x[8], x[13]);
+        QUARTERROUND(x[3], x[4], x[9], x[14]);
+    }
+
+    for (i = 0; i < 16; i++) {                          // Little-endian output
+        x[i] += in[i];
+        out[4*i] = (unsigned char)x[i];
+        out[4*i + 1] = (unsigned char)(x[i] >> 8);
+        out[4*i + 2] = (unsigned char)(x[i] >> 16);
+        out[4*i + 3] = (unsigned char)(x[i] >> 24);
+    }
+    clear_words((void*)x, NBYTES_TO_NWORDS(sizeof(x)));
+    clear_words((void*)in, NBYTES_TO_NWORDS(sizeof(in)));
+}
+
+
+static void drbg_refill(void)
+{ // Computes a buffer of keystream, takes its first 32 bytes as the next key and wipes them from the buffer
+    unsigned int i;
+
+    for (i = 0; i < DRBG_BLOCKS; i++) {
+        chacha20_block(drbg.key, i, drbg.buffer + 64*i);
+    }
+    for (i = 0; i < DRBG_KEY_BYTES/4; i++) {
+        drbg.key[i] = (uint32_t)drbg.buffer[4*i] | ((uint32_t)drbg.buffer[4*i + 1] << 8) |
+                      ((uint32_t)drbg.buffer[4*i + 2] << 16) | ((uint32_t)drbg.buffer[4*i + 3] << 24);
+    }
+    clear_words((void*)drbg.buffer, NBYTES_TO_NWORDS(DRBG_KEY_BYTES));
+    drbg.available = DRBG_BUFFER_BYTES - DRBG_KEY_BYTES;
+}
+
+
+static CRYPTO_STATUS drbg_reseed(RandomBytes source)
+{ // Mixes 32 fresh bytes from "source" into the key and drops the buffered outputs
+    uint32_t seed[DRBG_KEY_BYTES/4];
+    unsigned int i;
+    CRYPTO_STATUS Status;
+
+    Status = source(DRBG_KEY_BYTES, (unsigned char*)seed);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    for (i = 0; i < DRBG_KEY_BYTES/4; i++) {
+        drbg.key[i] ^= seed[i];
+    }
+    clear_words((void*)seed, NBYTES_TO_NWORDS(sizeof(seed)));
+    clear_words((void*)drbg.buffer, NBYTES_TO_NWORDS(DRBG_BUFFER_BYTES));
+    drbg.available = 0;
+    drbg.generated = 0;
+    drbg.source = source;
+#if (OS_TARGET == OS_LINUX)
+    drbg.pid = getpid();
+#endif
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS random_bytes(unsigned int nbytes, unsigned char* random_array, PCurveIsogenyStruct pCurveIsogeny)
+{ // Outputs nbytes random bytes from the DRBG of the calling thread if it is enabled on pCurveIsogeny, or from its RandomBytesFunction otherwise
+    unsigned int n;
+    unsigned char* out;
+    CRYPTO_STATUS Status;
+
+    if (!pCurveIsogeny->DRBG) {
+        return (pCurveIsogeny->RandomBytesFunction)(nbytes, random_array);
+    }
+
+    if (drbg.source != pCurveIsogeny->RandomBytesFunction || drbg.generated >= DRBG_RESEED_BYTES
+#if (OS_TARGET == OS_LINUX)
+        || drbg.pid != getpid()
+#endif
+        ) {
+        Status = drbg_reseed(pCurveIsogeny->RandomBytesFunction);
+        if (Status != CRYPTO_SUCCESS) {
+            return Status;
+        }
+    }
+
+    while (nbytes > 0) {
+        if (drbg.available == 0) {
+            drbg_refill();
+        }
+        n = (nbytes < drbg.available) ? nbytes : drbg.available;
+        out = drbg.buffer + DRBG_BUFFER_BYTES - drbg.available;
+        memcpy(random_array, out, n);
+        memset(out, 0, n);                               // Fast key erasure: outputs are not kept
+        drbg.available -= n;
+        drbg.generated += n;
+        random_array += n;
+        nbytes -= n;
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_set_drbg(PCurveIsogenyStruct pCurveIsogeny, bool enable)
+{ // Draws the random values of the operations on pCurveIsogeny from the per-thread DRBG (enable = true) or from its RandomBytesFunction
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    pCurveIsogeny->DRBG = enable;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+void SIDH_drbg_clear(void)
+{ // Wipes the DRBG state of the calling thread, which is reseeded on its next use
+    volatile unsigned char* state = (volatile unsigned char*)&drbg;
+    unsigned int i;
+
+    for (i = 0; i < sizeof(drbg); i++) {
+        state[i] = 0;
+    }
+}
@@ -10,33 +10,67 @@
 *********************************************************************************************/ 
 
 #include "SIDH_internal.h"
+#include <malloc.h>
+
+
+void j_inv_fraction(f2elm_t A, f2elm_t C, f2elm_t jnum, f2elm_t jden)
+{ // Computes the j-invariant of a Montgomery curve with projective constant as a fraction, leaving the inversion to the caller.
+  // Input: A,C in GF(p^2).
+  // Output: jnum = 256*(A^2-3*C^2)^3 and jden = C^4*(A^2-4*C^2), such that j = jnum/jden (see j_inv()).
+    f2elm_t t1;
+    
+    fp2sqr751_mont(A, jden);                           // jden = A^2        
+    fp2sqr751_mont(C, t1);                             // t1 = C^2
+    fp2add751(t1, t1, jnum);                           // jnum = t1+t1
+    fp2sub751(jden, jnum, jnum);                       // jnum = jden-jnum
+    fp2sub751(jnum, t1, jnum);                         // jnum = jnum-t1
+    fp2sub751(jnum, t1, jden);                         // jden = jnum-t1
+    fp2sqr751_mont(t1, t1);                            // t1 = t1^2
+    fp2mul751_mont(jden, t1, jden);                    // jden = jden*t1
+    fp2add751(jnum, jnum, jnum);                       // jnum = jnum+jnum
+    fp2add751(jnum, jnum, jnum);                       // jnum = jnum+jnum
+    fp2sqr751_mont(jnum, t1);                          // t1 = jnum^2
+    fp2mul751_mont(jnum, t1, jnum);                    // jnum = jnum*t1
+    fp2add751(jnum, jnum, jnum);                       // jnum = jnum+jnum
+    fp2add751(jnum, jnum, jnum);                       // jnum = jnum+jnum
+}
 
 
 void j_inv(f2elm_t A, f2elm_t C, f2elm_t jinv)
 { // Computes the j-invariant of a Montgomery curve with projective constant.
   // Input: A,C in GF(p^2).
   // Output: j=256*(A^2-3*C^2)^3/(C^4*(A^2-4*C^2)), which is j-invariant of Montgomery curve B*y^2=x^3+(A/C)*x^2+x or (equivalently) j-invariant of B'*y^2=C*x^3+A*x^2+C*x.
-    f2elm_t t0, t1;
+    f2elm_t t0;
     
-    fp2sqr751_mont(A, jinv);                           // jinv = A^2        
-    fp2sqr751_mont(C, t1);                             // t1 = C^2
-    fp2add751(t1, t1, t0);                             // t0 = t1+t1
-    fp2sub751(jinv, t0, t0);                           // t0 = jinv-t0
-    fp2sub751(t0, t1, t0);                             // t0 = t0-t1
-    fp2sub751(t0, t1, jinv);                           // jinv = t0-t1
-    fp2sqr751_mont(t1, t1);                            // t1 = t1^2
-    fp2mul751_mont(jinv, t1, jinv);                    // jinv = jinv*t1
-    fp2add751(t0, t0, t0);                             // t0 = t0+t0
-    fp2add751(t0, t0, t0);                             // t0 = t0+t0
-    fp2sqr751_mont(t0, t1);                            // t1 = t0^2
-    fp2mul751_mont(t0, t1, t0);                        // t0 = t0*t1
-    fp2add751(t0, t0, t0);                             // t0 = t0+t0
-    fp2add751(t0, t0, t0);                             // t0 = t0+t0
+    j_inv_fraction(A, C, t0, jinv);                    // jinv = t0/jinv
     fp2inv751_mont(jinv);                              // jinv = 1/jinv 
     fp2mul751_mont(jinv, t0, jinv);                    // jinv = t0*jinv
 }
 
 
+bool j_inv_checked(f2elm_t A, f2elm_t C, f2elm_t jinv)
+{ // Computes the j-invariant of a Montgomery curve with projective constant as j_inv(), checking its denominator in constant time.
+  // Output: jinv as in j_inv(). Returns false and jinv = 0 if the denominator C^4*(A^2-4*C^2) is zero, i.e., if the curve is singular, 
+  //         which only a malformed public key can produce. This is the check of the batched shared secret functions.
+    f2elm_t t0;
+    digit_t z = 0, mask;
+    unsigned int i;
+    
+    j_inv_fraction(A, C, t0, jinv);                    // jinv = t0/jinv
+    for (i = 0; i < 2*NWORDS_FIELD; i++) {
+        z |= ((digit_t*)jinv)[i];
+    }
+    mask = 0 - (digit_t)is_digit_zero_ct(z);           // mask = 0xFF...FF if the denominator is zero
+    fp2inv751_mont(jinv);                              // jinv = 1/jinv 
+    fp2mul751_mont(jinv, t0, jinv);                    // jinv = t0*jinv
+    for (i = 0; i < 2*NWORDS_FIELD; i++) {
+        ((digit_t*)jinv)[i] &= ~mask;
+    }
+    clear_words((void*)t0, 2*NWORDS_FIELD);
+    return (mask == 0);
+}
+
+
 void xDBLADD(point_proj_t P, point_proj_t Q, f2elm_t xPQ, f2elm_t A24)
 { // Simultaneous doubling and differential addition.
   // Input: projective Montgomery points P=(XP:ZP) and Q=(XQ:ZQ) such that xP=XP/ZP and xQ=XQ/ZQ, affine difference xPQ=x(P-Q) and Montgomery curve constant A24=(A+2)/4.
@@ -233,11 +267,15 @@ CRYPTO_STATUS BigMont_ladder(
   // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
     point_basefield_proj_t P1, P2;
     digit_t scalar[BIGMONT_NWORDS_ORDER];
-    felm_t X, A24 = {0};
+    felm_t X;
+    keygen_precomp* Precomp = (keygen_precomp*)CurveIsogeny->KeyGenPrecomp;
 
-    A24[0] = (digit_t)CurveIsogeny->BigMont_A24; 
-    to_mont(A24, A24);                               // Conversion to Montgomery representation
-    to_mont((digit_t*)x, X);
+    if (CurveIsogeny->pbits != 751) {               // BigMont is only defined for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_BIGMONT_LADDER);
+
+    to_mont((digit_t*)x, X);                         // Conversion to Montgomery representation
     
     copy_words(m, scalar, BIGMONT_NWORDS_ORDER);
     ladder(
@@ -245,15 +283,17 @@ CRYPTO_STATUS BigMont_ladder(
         scalar,
         P1,
         P2,
-        A24,
+        Precomp->BigMont_A24,
         BIGMONT_NBITS_ORDER,
         BIGMONT_MAXBITS_ORDER,
         CurveIsogeny
     );
+    TRACE(CurveIsogeny, SIDH_TRACE_SCALAR_MULT, 0);
 
     fpinv751_mont(P1->Z);
     fpmul751_mont(P1->X, P1->Z, (digit_t*)xout);
     from_mont((digit_t*)xout, (digit_t*)xout);       // Conversion to standard representation
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_BIGMONT_LADDER);
 
     return CRYPTO_SUCCESS;
 }
@@ -279,6 +319,10 @@ CRYPTO_STATUS secret_pt(
     felm_t t0, t1, t2, A24 = {0};
     digit_t *RX0 = (digit_t*)R->X[0], *RX1 = (digit_t*)R->X[1], *RZ0 = (digit_t*)R->Z[0], *RZ1 = (digit_t*)R->Z[1];
 
+    if (CurveIsogeny->FixedBaseWindow != 0) {      // Use the fixed-base tables built by SIDH_set_fixed_base_window(), if available
+        return secret_pt_fixed_base(P, m, AliceOrBob, R, CurveIsogeny);
+    }
+
     fpcopy751(P->x, Q->x);                         // Q = (-XP,YP)
     fpcopy751(P->y, Q->y);
     fpneg751(Q->x);
@@ -336,55 +380,607 @@ CRYPTO_STATUS secret_pt(
 }
 
 
-CRYPTO_STATUS ladder_3_pt(
+void jDBL_basefield(point_basefield_jac_t P, point_basefield_jac_t Q)
+{ // Doubling of a point in Jacobian coordinates on E: y^2=x^3+x over the base field.
+  // Input: P = (X:Y:Z), which represents the affine point (X/Z^2,Y/Z^3), not of order 2.
+  // Output: Q = 2*P = (X2:Y2:Z2). P and Q can be the same point.
+    felm_t t0, t1, t2, t3;
+
+    fpsqr751_mont(P->X, t0);                           // t0 = X^2
+    fpsqr751_mont(P->Z, t1);                           // t1 = Z^2
+    fpsqr751_mont(t1, t1);                             // t1 = Z^4
+    fpadd751(t0, t1, t1);                              // t1 = X^2+Z^4
+    fpadd751(t0, t0, t0);                              // t0 = 2*X^2
+    fpadd751(t0, t1, t0);                              // t0 = M = 3*X^2+Z^4
+    fpsqr751_mont(P->Y, t1);                           // t1 = Y^2
+    fpmul751_mont(P->Y, P->Z, Q->Z);                   // Z2 = Y*Z
+    fpadd751(Q->Z, Q->Z, Q->Z);                        // Z2 = 2*Y*Z
+    fpmul751_mont(P->X, t1, t2);                       // t2 = X*Y^2
+    fpadd751(t2, t2, t2);                              // t2 = 2*X*Y^2
+    fpadd751(t2, t2, t2);                              // t2 = S = 4*X*Y^2
+    fpsqr751_mont(t1, t1);                             // t1 = Y^4
+    fpadd751(t1, t1, t1);                              // t1 = 2*Y^4
+    fpadd751(t1, t1, t1);                              // t1 = 4*Y^4
+    fpadd751(t1, t1, t1);                              // t1 = 8*Y^4
+    fpsqr751_mont(t0, t3);                             // t3 = M^2
+    fpsub751(t3, t2, t3);                              // t3 = M^2-S
+    fpsub751(t3, t2, Q->X);                            // X2 = M^2-2*S
+    fpsub751(t2, Q->X, t2);                            // t2 = S-X2
+    fpmul751_mont(t0, t2, t2);                         // t2 = M*(S-X2)
+    fpsub751(t2, t1, Q->Y);                            // Y2 = M*(S-X2)-8*Y^4
+}
+
+
+void jADD_basefield(point_basefield_jac_t P, point_basefield_t Q, point_basefield_jac_t R)
+{ // Mixed addition of a point in Jacobian coordinates and an affine point on E: y^2=x^3+x over the base field.
+  // Input: P = (X:Y:Z), which represents the affine point (X/Z^2,Y/Z^3), and Q = (x,y), with P != Q and P != -Q.
+  // Output: R = P+Q = (X3:Y3:Z3). P and R can be the same point.
+  //         If P = Q then Z3 = 0, which the callers use to detect the doubling case.
+    felm_t t0, t1, t2, t3;
+
+    fpsqr751_mont(P->Z, t0);                           // t0 = Z^2
+    fpmul751_mont(Q->x, t0, t1);                       // t1 = x*Z^2
+    fpmul751_mont(P->Z, t0, t0);                       // t0 = Z^3
+    fpmul751_mont(Q->y, t0, t0);                       // t0 = y*Z^3
+    fpsub751(t1, P->X, t1);                            // t1 = H = x*Z^2-X
+    fpsub751(t0, P->Y, t0);                            // t0 = r = y*Z^3-Y
+    fpmul751_mont(P->Z, t1, R->Z);                     // Z3 = Z*H
+    fpsqr751_mont(t1, t2);                             // t2 = H^2
+    fpmul751_mont(t1, t2, t1);                         // t1 = H^3
+    fpmul751_mont(P->X, t2, t2);                       // t2 = V = X*H^2
+    fpsqr751_mont(t0, t3);                             // t3 = r^2
+    fpsub751(t3, t1, t3);                              // t3 = r^2-H^3
+    fpsub751(t3, t2, t3);                              // t3 = r^2-H^3-V
+    fpsub751(t3, t2, t3);                              // t3 = X3 = r^2-H^3-2*V
+    fpmul751_mont(P->Y, t1, t1);                       // t1 = Y*H^3
+    fpsub751(t2, t3, t2);                              // t2 = V-X3
+    fpmul751_mont(t0, t2, t2);                         // t2 = r*(V-X3)
+    fpsub751(t2, t1, R->Y);                            // Y3 = r*(V-X3)-Y*H^3
+    fpcopy751(t3, R->X);
+}
+
+
+static void jDBL_basefield_weierstrass(point_basefield_jac_t P, felm_t a, point_basefield_jac_t Q)
+{ // Doubling of a point in Jacobian coordinates on the short Weierstrass curve y^2=x^3+a*x+b over the base field.
+  // Input: P = (X:Y:Z), not of order 2, and the curve coefficient a in Montgomery representation.
+  // Output: Q = 2*P = (X2:Y2:Z2). P and Q can be the same point.
+    felm_t t0, t1, t2, t3;
+
+    fpsqr751_mont(P->X, t0);                           // t0 = X^2
+    fpsqr751_mont(P->Z, t1);                           // t1 = Z^2
+    fpsqr751_mont(t1, t1);                             // t1 = Z^4
+    fpmul751_mont(a, t1, t1);                          // t1 = a*Z^4
+    fpadd751(t0, t1, t1);                              // t1 = X^2+a*Z^4
+    fpadd751(t0, t0, t0);                              // t0 = 2*X^2
+    fpadd751(t0, t1, t0);                              // t0 = M = 3*X^2+a*Z^4
+    fpsqr751_mont(P->Y, t1);                           // t1 = Y^2
+    fpmul751_mont(P->Y, P->Z, Q->Z);                   // Z2 = Y*Z
+    fpadd751(Q->Z, Q->Z, Q->Z);                        // Z2 = 2*Y*Z
+    fpmul751_mont(P->X, t1, t2);                       // t2 = X*Y^2
+    fpadd751(t2, t2, t2);                              // t2 = 2*X*Y^2
+    fpadd751(t2, t2, t2);                              // t2 = S = 4*X*Y^2
+    fpsqr751_mont(t1, t1);                             // t1 = Y^4
+    fpadd751(t1, t1, t1);                              // t1 = 2*Y^4
+    fpadd751(t1, t1, t1);                              // t1 = 4*Y^4
+    fpadd751(t1, t1, t1);                              // t1 = 8*Y^4
+    fpsqr751_mont(t0, t3);                             // t3 = M^2
+    fpsub751(t3, t2, t3);                              // t3 = M^2-S
+    fpsub751(t3, t2, Q->X);                            // X2 = M^2-2*S
+    fpsub751(t2, Q->X, t2);                            // t2 = S-X2
+    fpmul751_mont(t0, t2, t2);                         // t2 = M*(S-X2)
+    fpsub751(t2, t1, Q->Y);                            // Y2 = M*(S-X2)-8*Y^4
+}
+
+
+static void jDBL_basefield_curve(point_basefield_jac_t P, felm_t a, point_basefield_jac_t Q)
+{ // Doubling Q = 2*P on E: y^2=x^3+x if a is NULL, and on the short Weierstrass curve y^2=x^3+a*x+b otherwise
+    if (a == NULL) {
+        jDBL_basefield(P, Q);
+    } else {
+        jDBL_basefield_weierstrass(P, a, Q);
+    }
+}
+
+
+static void jADD_basefield_safe(point_basefield_jac_t P, point_basefield_t Q, felm_t a, point_basefield_jac_t R)
+{ // Mixed addition R = P+Q that also handles the doubling case P = Q in constant time, with P != -Q.
+  // The points are on E: y^2=x^3+x if a is NULL, and on the short Weierstrass curve y^2=x^3+a*x+b otherwise.
+    point_basefield_jac_t D;
+    digit_t mask, z = 0;
+    unsigned int i;
+
+    jDBL_basefield_curve(P, a, D);
+    jADD_basefield(P, Q, R);
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        z |= R->Z[i];
+    }
+    mask = 0 - (digit_t)is_digit_zero_ct(z);           // mask = 0xFF...FF if P = Q
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        R->X[i] = (mask & (R->X[i] ^ D->X[i])) ^ R->X[i];
+        R->Y[i] = (mask & (R->Y[i] ^ D->Y[i])) ^ R->Y[i];
+        R->Z[i] = (mask & (R->Z[i] ^ D->Z[i])) ^ R->Z[i];
+    }
+}
+
+
+static void normalize_jac_basefield(point_basefield_jac_t* P, felm_t* t, unsigned int npoints)
+{ // Converts the points P[0],...,P[npoints-1] to affine coordinates (x,y) = (X,Y), sharing a single inversion. 
+  // t is temporary storage for npoints field elements.
+    felm_t inv, zinv, z2;
+    int i;
+
+    fpcopy751(P[0]->Z, t[0]);
+    for (i = 1; i < (int)npoints; i++) {
+        fpmul751_mont(t[i-1], P[i]->Z, t[i]);          // t[i] = Z0*...*Zi
+    }
+    fpcopy751(t[i-1], inv);
+    fpinv751_mont(inv);                                // inv = 1/(Z0*...*Z(npoints-1))
+    for (i = (int)npoints-1; i >= 0; i--) {
+        if (i > 0) {
+            fpmul751_mont(inv, t[i-1], zinv);          // zinv = 1/Zi
+            fpmul751_mont(inv, P[i]->Z, inv);          // inv = 1/(Z0*...*Z(i-1))
+        } else {
+            fpcopy751(inv, zinv);
+        }
+        fpsqr751_mont(zinv, z2);
+        fpmul751_mont(P[i]->X, z2, P[i]->X);           // x = X/Z^2
+        fpmul751_mont(z2, zinv, z2);
+        fpmul751_mont(P[i]->Y, z2, P[i]->Y);           // y = Y/Z^3
+        fpcopy751(zinv, P[i]->Z);
+    }
+}
+
+
+CRYPTO_STATUS fixed_base_table(
+    point_basefield_t P,
+    felm_t a,
+    unsigned int nwindows,
+    unsigned int w,
+    digit_t* table,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Builds the fixed-base table of odd multiples of P used by secret_pt_fixed_base() and BigMont_KeyGeneration().
+  // Input:  the affine point P = (x,y) on E: y^2=x^3+x over the base field if a is NULL, or on the short Weierstrass curve 
+  //         y^2=x^3+a*x+b otherwise, in Montgomery representation, nwindows windows of width w in [2, 6].
+  // Output: table[j*2^(w-1)+k] = (2*k+1)*2^(w*j)*P in affine coordinates, for j = 0,...,nwindows-1 and k = 0,...,2^(w-1)-1.
+  //         Each entry is stored as x followed by y. The whole table costs two inversions.
+    unsigned int i, j, k, nentries = 1 << (w - 1);
+    point_basefield_jac_t *pts, J;
+    point_basefield_t D;
+    felm_t *t;
+    digit_t *entry;
+
+    pts = (point_basefield_jac_t*)calloc(nwindows*nentries, sizeof(point_basefield_jac_t));
+    t = (felm_t*)calloc(nwindows*nentries, sizeof(felm_t));
+    if (pts == NULL || t == NULL) {
+        if (pts != NULL) free(pts);
+        if (t != NULL) free(t);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+
+    // First pass: B_j = 2^(w*j)*P and 2*B_j, for j = 0,...,nwindows-1
+    fpcopy751(P->x, J->X);
+    fpcopy751(P->y, J->Y);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, J->Z);
+    for (j = 0; j < nwindows; j++) {
+        copy_words((digit_t*)J, (digit_t*)pts[2*j], 3*NWORDS_FIELD);
+        jDBL_basefield_curve(J, a, J);
+        copy_words((digit_t*)J, (digit_t*)pts[2*j+1], 3*NWORDS_FIELD);
+        if (j < nwindows - 1) {
+            for (i = 1; i < w; i++) {
+                jDBL_basefield_curve(J, a, J);
+            }
+        }
+    }
+    normalize_jac_basefield(pts, t, 2*nwindows);
+    for (j = 0; j < nwindows; j++) {                   // Entry 0 of window j gets B_j, entry 1 temporarily holds 2*B_j
+        entry = table + j*nentries*2*NWORDS_FIELD;
+        copy_words((digit_t*)pts[2*j], entry, 2*NWORDS_FIELD);
+        copy_words((digit_t*)pts[2*j+1], entry + 2*NWORDS_FIELD, 2*NWORDS_FIELD);
+    }
+
+    // Second pass: (2*k+1)*B_j = B_j+k*(2*B_j), for k = 1,...,2^(w-1)-1
+    for (j = 0; j < nwindows; j++) {
+        entry = table + j*nentries*2*NWORDS_FIELD;
+        fpcopy751(entry + 2*NWORDS_FIELD, D->x);
+        fpcopy751(entry + 3*NWORDS_FIELD, D->y);
+        fpcopy751(entry, J->X);
+        fpcopy751(entry + NWORDS_FIELD, J->Y);
+        fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, J->Z);
+        for (k = 1; k < nentries; k++) {
+            jADD_basefield(J, D, J);
+            copy_words((digit_t*)J, (digit_t*)pts[j*(nentries-1)+k-1], 3*NWORDS_FIELD);
+        }
+    }
+    normalize_jac_basefield(pts, t, nwindows*(nentries-1));
+    for (j = 0; j < nwindows; j++) {
+        entry = table + j*nentries*2*NWORDS_FIELD;
+        for (k = 1; k < nentries; k++) {
+            copy_words((digit_t*)pts[j*(nentries-1)+k-1], entry + 2*k*NWORDS_FIELD, 2*NWORDS_FIELD);
+        }
+    }
+
+    free(pts);
+    free(t);
+    return CRYPTO_SUCCESS;
+}
+
+
+static digit_t scalar_bits(digit_t* k, unsigned int nwords, unsigned int pos, unsigned int nbits)
+{ // Returns the nbits < RADIX bits of the nwords-word scalar k starting at bit position pos. The positions are public.
+    unsigned int word = pos / RADIX, shift = pos % RADIX;
+    digit_t bits = k[word] >> shift;
+
+    if (shift + nbits > RADIX && word + 1 < nwords) {
+        bits |= k[word+1] << (RADIX - shift);
+    }
+    return bits & (((digit_t)1 << nbits) - 1);
+}
+
+
+static void fixed_base_lookup(digit_t* table, unsigned int nentries, digit_t index, digit_t sign, point_basefield_t T)
+{ // Constant-time lookup of the point T = table[index] among the nentries affine points of a window, negated if sign = 0xFF...FF.
+    felm_t t = {0};
+    digit_t mask;
+    unsigned int i, k;
+
+    fpzero751(T->x);
+    fpzero751(T->y);
+    for (k = 0; k < nentries; k++) {
+        mask = 0 - (digit_t)is_digit_zero_ct((digit_t)k ^ index);
+        for (i = 0; i < NWORDS_FIELD; i++) {
+            T->x[i] |= mask & table[2*k*NWORDS_FIELD + i];
+            T->y[i] |= mask & table[(2*k+1)*NWORDS_FIELD + i];
+        }
+    }
+    fpsub751(t, T->y, t);                              // t = -y
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        T->y[i] = (sign & (T->y[i] ^ t[i])) ^ T->y[i];
+    }
+}
+
+
+static void fixed_base_comb(
+    digit_t* scalar,
+    unsigned int nwords,
+    unsigned int nbits,
+    unsigned int w,
+    digit_t* table,
+    felm_t a,
+    point_basefield_jac_t S,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Constant-time fixed-base comb S = [scalar]P over the table of odd multiples of P built by fixed_base_table() with window width w.
+  // The odd nwords-word scalar has at most nbits bits, with 2^(w*(FIXED_BASE_NWINDOWS(nbits,w)-1)) smaller than the order of P. 
+  // Odd scalar = sum of d_j*2^(w*j), with odd digits d_j in [-(2^w-1), 2^w-1] given by ((scalar >> w*j) | 1) mod 2^(w+1) - 2^w and 
+  // the last digit (scalar >> w*(nwindows-1)) | 1 > 0. The partial sums are smaller than the order of P in absolute value, 
+  // so that only the last addition can hit the doubling case
+    unsigned int j, nwindows = FIXED_BASE_NWINDOWS(nbits, w), nentries = 1 << (w - 1);
+    digit_t digit, sign;
+    point_basefield_t T;
+
+    for (j = 0; j < nwindows; j++) {
+        digit = scalar_bits(scalar, nwords, j*w, w + 1) | 1;
+        if (j == nwindows - 1) {
+            digit |= (digit_t)1 << w;
+        }
+        sign = (digit >> w) - 1;                       // sign = 0xFF...FF if the digit is negative
+        digit = ((digit >> 1) ^ (sign & (nentries - 1))) & (nentries - 1);
+        fixed_base_lookup(table + j*nentries*2*NWORDS_FIELD, nentries, digit, sign, T);   // T = d_j*2^(w*j)*P
+
+        if (j == 0) {
+            fpcopy751(T->x, S->X);
+            fpcopy751(T->y, S->Y);
+            fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, S->Z);
+        } else if (j < nwindows - 1) {
+            jADD_basefield(S, T, S);
+        } else {
+            jADD_basefield_safe(S, T, a, S);
+        }
+    }
+    clear_words((void*)T, 2*NWORDS_FIELD);
+}
+
+
+CRYPTO_STATUS secret_pt_fixed_base(
+    point_basefield_t P,
+    digit_t* m,
+    unsigned int AliceOrBob,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Computes key generation entirely in the base field using the fixed-base tables.
+  // Since Q = (-x,y*i) = tau(P) for the distortion map tau(x,y) = (-x,y*i), [m]Q = tau([m]P), where [m]P is computed with 
+  // a constant-time fixed-base comb over the table of odd multiples of P, using a regular recoding of m into signed odd digits.
+  // Input:  The scalar m, point P = (x,y) on E in the base field subgroup, which must be the generator PA (if AliceOrBob = ALICE)
+  //         or PB (if AliceOrBob = BOB) in Montgomery representation.
+  // Output: R = (RX0+RX1*i)/RZ0 (the x-coordinate of P+[m]Q).
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int i, nbits, w = CurveIsogeny->FixedBaseWindow;
+    digit_t scalar[NWORDS_ORDER], t[NWORDS_ORDER] = {0}, mask, *table;
+    point_basefield_jac_t S, U;
+    point_basefield_t T;
+    felm_t t0, t1, t2;
+    digit_t *x = (digit_t*)P->x, *y = (digit_t*)P->y;
+    digit_t *RX0 = (digit_t*)R->X[0], *RX1 = (digit_t*)R->X[1], *RZ0 = (digit_t*)R->Z[0], *RZ1 = (digit_t*)R->Z[1];
+
+    if (AliceOrBob == ALICE) {
+        nbits = CurveIsogeny->oAbits;
+        table = CurveIsogeny->PA_table;
+    } else if (AliceOrBob == BOB) {
+        nbits = CurveIsogeny->oBbits + 1;              // Bob's odd scalar can be as large as 2*oB
+        table = CurveIsogeny->PB_table;
+    } else {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (w == 0 || table == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    // The recoding needs an odd scalar: if m is even, Alice uses m+1 and subtracts P at the end, and Bob uses m+oB, since oB is odd
+    copy_words(m, scalar, NWORDS_ORDER);
+    mask = 0 - (1 ^ (scalar[0] & 1));                  // mask = 0xFF...FF if m is even
+    if (AliceOrBob == ALICE) {
+        t[0] = mask & 1;
+    } else {
+        for (i = 0; i < NWORDS_ORDER; i++) {
+            t[i] = mask & CurveIsogeny->Border[i];
+        }
+    }
+    mp_add(scalar, t, scalar, NWORDS_ORDER);
+
+    fixed_base_comb(scalar, NWORDS_ORDER, nbits, w, table, NULL, S, CurveIsogeny);
+
+    // Alice's correction S = S-P for even m
+    fpcopy751(x, T->x);
+    fpzero751(T->y);
+    fpsub751(T->y, y, T->y);
+    jADD_basefield_safe(S, T, NULL, U);
+    mask &= 0 - (digit_t)(AliceOrBob == ALICE);
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        S->X[i] = (mask & (S->X[i] ^ U->X[i])) ^ S->X[i];
+        S->Y[i] = (mask & (S->Y[i] ^ U->Y[i])) ^ S->Y[i];
+        S->Z[i] = (mask & (S->Z[i] ^ U->Z[i])) ^ S->Z[i];
+    }
+
+    // With S = [m]P = (X:Y:Z), [m]Q = (-X/Z^2,Y/Z^3*i) and H = X+x*Z^2, the x-coordinate of P+[m]Q is given by
+    //RX0 := (y*Z^3)^2 - Y^2 + (X-x*Z^2)*H^2;
+    //RX1 := -2*y*Z^3*Y;
+    //RZ0 := Z^2*H^2;
+
+    fpsqr751_mont(S->Z, t0);                           // t0 = Z^2
+    fpmul751_mont(x, t0, t1);                          // t1 = x*Z^2
+    fpmul751_mont(S->Z, t0, t2);                       // t2 = Z^3
+    fpmul751_mont(y, t2, t2);                          // t2 = y*Z^3
+    fpadd751(S->X, t1, RZ0);                           // RZ0 = H
+    fpsub751(S->X, t1, t1);                            // t1 = X-x*Z^2
+    fpsqr751_mont(RZ0, RZ0);                           // RZ0 = H^2
+    fpmul751_mont(t1, RZ0, t1);                        // t1 = (X-x*Z^2)*H^2
+    fpmul751_mont(t0, RZ0, RZ0);                       // RZ0 = Z^2*H^2
+    fpmul751_mont(t2, S->Y, RX1);                      // RX1 = y*Z^3*Y
+    fpsqr751_mont(t2, t2);                             // t2 = (y*Z^3)^2
+    fpsqr751_mont(S->Y, t0);                           // t0 = Y^2
+    fpsub751(t2, t0, RX0);
+    fpadd751(RX0, t1, RX0);                            // RX0 = (y*Z^3)^2-Y^2+(X-x*Z^2)*H^2
+    fpadd751(RX1, RX1, RX1);
+    fpzero751(t0);
+    fpsub751(t0, RX1, RX1);                            // RX1 = -2*y*Z^3*Y
+    fpzero751(RZ1);
+
+    clear_words((void*)scalar, NWORDS_ORDER);
+    clear_words((void*)S, 3*NWORDS_FIELD);
+    clear_words((void*)U, 3*NWORDS_FIELD);
+    clear_words((void*)T, 2*NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS BigMont_KeyGeneration(unsigned char* pPrivateKey, unsigned char* pPublicKey, PCurveIsogenyStruct CurveIsogeny)
+{ // BigMont's key generation
+  // It produces a private key pPrivateKey in [1, BigMont_order-1] and computes the public key pPublicKey, the affine x-coordinate of 
+  // pPrivateKey*G, where G = (BIGMONT_GENERATOR_X,y). If the fixed-base tables are enabled, pPrivateKey*G is computed with a constant-time 
+  // fixed-base comb in the short Weierstrass form y^2 = X^3+a*X+b of BigMont, with X = x+A/3. Otherwise, it uses the Montgomery ladder.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int i, w = CurveIsogeny->FixedBaseWindow;
+    digit_t scalar[BIGMONT_MAXWORDS_ORDER], t[BIGMONT_MAXWORDS_ORDER], mask, *PrivateKey = (digit_t*)pPrivateKey, *PublicKey = (digit_t*)pPublicKey;
+    digit_t x[NWORDS_FIELD] = {0};
+    keygen_precomp* Precomp = (keygen_precomp*)CurveIsogeny->KeyGenPrecomp;
+    point_basefield_jac_t S;
+    felm_t t0;
+    CRYPTO_STATUS Status;
+
+    if (CurveIsogeny->pbits != 751) {                  // BigMont is only defined for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    Status = random_BigMont_mod_order(PrivateKey, CurveIsogeny);    // Get a random private key in [1, BigMont_order-1]
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    if (w == 0 || CurveIsogeny->BigMont_table == NULL) {
+        x[0] = BIGMONT_GENERATOR_X;
+        return BigMont_ladder((unsigned char*)x, PrivateKey, pPublicKey, CurveIsogeny);
+    }
+
+    // The recoding needs an odd scalar: if the private key is even, use pPrivateKey+BigMont_order instead, since BigMont_order is odd
+    copy_words(PrivateKey, scalar, BIGMONT_MAXWORDS_ORDER);
+    mask = 0 - (1 ^ (scalar[0] & 1));                  // mask = 0xFF...FF if the private key is even
+    for (i = 0; i < BIGMONT_MAXWORDS_ORDER; i++) {
+        t[i] = mask & CurveIsogeny->BigMont_order[i];
+    }
+    mp_add(scalar, t, scalar, BIGMONT_MAXWORDS_ORDER);
+
+    fixed_base_comb(scalar, BIGMONT_MAXWORDS_ORDER, BIGMONT_NBITS_ORDER + 1, w, CurveIsogeny->BigMont_table, Precomp->BigMont_a, S, CurveIsogeny);
+
+    // x = X/Z^2-A/3
+    fpinv751_mont(S->Z);
+    fpsqr751_mont(S->Z, t0);
+    fpmul751_mont(S->X, t0, t0);
+    fpsub751(t0, Precomp->BigMont_A3, t0);
+    from_mont(t0, PublicKey);                          // Conversion to standard representation
+
+    clear_words((void*)scalar, BIGMONT_MAXWORDS_ORDER);
+    clear_words((void*)t, BIGMONT_MAXWORDS_ORDER);
+    clear_words((void*)S, 3*NWORDS_FIELD);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+static void fpinv_n_way(felm_t* z, felm_t* t, unsigned int n)
+{ // n-way simultaneous inversion in GF(p751) using Montgomery's trick
+  // Input:  z[0],...,z[n-1], all different from zero, and scratch space t for n elements in GF(p751)
+  // Output: 1/z[0],...,1/z[n-1] (override inputs).
+    unsigned int i;
+    felm_t t0, t1;
+
+    fpcopy751(z[0], t[0]);
+    for (i = 1; i < n; i++) {
+        fpmul751_mont(t[i-1], z[i], t[i]);            // t[i] = z[0]*...*z[i]
+    }
+    fpcopy751(t[n-1], t0);
+    fpinv751_mont(t0);                                 // t0 = 1/(z[0]*...*z[n-1])
+    for (i = n-1; i > 0; i--) {
+        fpmul751_mont(t0, t[i-1], t1);                 // t1 = 1/z[i]
+        fpmul751_mont(t0, z[i], t0);                   // t0 = 1/(z[0]*...*z[i-1])
+        fpcopy751(t1, z[i]);
+    }
+    fpcopy751(t0, z[0]);                               // z[0] = 1/z[0]
+}
+
+
+CRYPTO_STATUS BigMont_SecretAgreement_batch(unsigned char* pPrivateKeys, unsigned char* pPublicKeys, unsigned char* pSharedSecrets, unsigned int nkeys, PCurveIsogenyStruct CurveIsogeny)
+{ // BigMont's shared secret computation for nkeys sessions
+  // The i-th shared secret is the affine x-coordinate of k*P, where k is the i-th private key and x(P) the i-th public key, 
+  // as computed by BigMont_ladder(). The Montgomery ladders run one after the other and the nkeys conversions to affine 
+  // coordinates share one inversion. Results at infinity, e.g., from points of order 2, are encoded as 0.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int i, j;
+    digit_t scalar[BIGMONT_NWORDS_ORDER], z, mask;
+    keygen_precomp* Precomp = (keygen_precomp*)CurveIsogeny->KeyGenPrecomp;
+    point_basefield_proj_t P1, P2;
+    felm_t *X = NULL, *Z = NULL, *t = NULL, x;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    if (pPrivateKeys == NULL || pPublicKeys == NULL || pSharedSecrets == NULL || nkeys == 0 || is_CurveIsogenyStruct_null(CurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (CurveIsogeny->pbits != 751) {                  // BigMont is only defined for SIDHp751
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    X = (felm_t*) calloc(nkeys, sizeof(felm_t));
+    Z = (felm_t*) calloc(nkeys, sizeof(felm_t));
+    t = (felm_t*) calloc(nkeys, sizeof(felm_t));
+    if (X == NULL || Z == NULL || t == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    for (i = 0; i < nkeys; i++) {
+        to_mont((digit_t*)(pPublicKeys + i*NWORDS_FIELD*sizeof(digit_t)), x);
+        copy_words((digit_t*)(pPrivateKeys + i*BIGMONT_MAXWORDS_ORDER*sizeof(digit_t)), scalar, BIGMONT_NWORDS_ORDER);
+        ladder(x, scalar, P1, P2, Precomp->BigMont_A24, BIGMONT_NBITS_ORDER, BIGMONT_MAXBITS_ORDER, CurveIsogeny);
+
+        // Replace a result at infinity (X:0) by (0:1) to keep the product of the Z's invertible
+        z = 0;
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            z |= P1->Z[j];
+        }
+        mask = 0 - (digit_t)is_digit_zero_ct(z);       // mask = 0xFF...FF if Z = 0
+        for (j = 0; j < NWORDS_FIELD; j++) {
+            X[i][j] = ~mask & P1->X[j];
+            Z[i][j] = (mask & (P1->Z[j] ^ ((digit_t*)CurveIsogeny->Montgomery_one)[j])) ^ P1->Z[j];
+        }
+    }
+
+    fpinv_n_way(Z, t, nkeys);
+
+    for (i = 0; i < nkeys; i++) {
+        digit_t* SharedSecret = (digit_t*)(pSharedSecrets + i*NWORDS_FIELD*sizeof(digit_t));
+
+        fpmul751_mont(X[i], Z[i], SharedSecret);
+        from_mont(SharedSecret, SharedSecret);         // Conversion to standard representation
+    }
+
+cleanup:
+    clear_words((void*)scalar, BIGMONT_NWORDS_ORDER);
+    clear_words((void*)P1, 2*NWORDS_FIELD);
+    clear_words((void*)P2, 2*NWORDS_FIELD);
+    if (X != NULL) {
+        clear_words((void*)X, nkeys*NWORDS_FIELD);
+        free(X);
+    }
+    if (Z != NULL) {
+        clear_words((void*)Z, nkeys*NWORDS_FIELD);
+        free(Z);
+    }
+    if (t != NULL) {
+        clear_words((void*)t, nkeys*NWORDS_FIELD);
+        free(t);
+    }
+
+    return Status;
+}
+
+CRYPTO_STATUS ladder_3_pt_init(
     f2elm_t xP,
     f2elm_t xQ,
-    f2elm_t xPQ,
     digit_t* m,
     unsigned int AliceOrBob,
-    point_proj_t W,
     f2elm_t A,
+    ladder_3_pt_state* state,
     PCurveIsogenyStruct CurveIsogeny
-) { // Computes P+[m]Q via x-only arithmetic. Algorithm by De Feo, Jao and Plut.
-  // Input:  three affine points xP,xQ,xPQ and Montgomery constant A.
-  // Output: projective Montgomery x-coordinates of x(P+[m]Q)=WX/WZ
-    point_proj_t U = {0}, V = {0};
-    f2elm_t A24, A24num, constant1 = {0}, constant2;
-    felm_t temp_scalar;
-    unsigned int bit = 0, nbits, fullbits = CurveIsogeny->owordbits;
-    digit_t mask;
+) { // Initializes the state of the three-point ladder that computes P+[m]Q, see ladder_3_pt().
+  // Input:  affine points xP and xQ, scalar m and Montgomery constant A.
+  // Output: the state with the points (1:0), (xQ:1) and (xP:1), and the nbits bits of m to be processed.
+    f2elm_t constant = {0};
+    unsigned int fullbits = CurveIsogeny->owordbits;
     int i;
 
     if (AliceOrBob == ALICE) {
-        nbits = CurveIsogeny->oAbits;
+        state->nbits = CurveIsogeny->oAbits;
     } else if (AliceOrBob == BOB) {
-        nbits = CurveIsogeny->oBbits;
+        state->nbits = CurveIsogeny->oBbits;
     } else {
         return CRYPTO_ERROR_INVALID_PARAMETER;
     }
    
-    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, constant1[0]);
-    fp2add751(constant1, constant1, constant1);                  // constant = 2
-    fp2add751(A, constant1, A24num);
-    fp2div2_751(A24num, A24);  
-    fp2div2_751(A24, A24);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, constant[0]);
+    fp2add751(constant, constant, constant);                     // constant = 2
+    fp2add751(A, constant, state->A24);
+    fp2div2_751(state->A24, state->A24);  
+    fp2div2_751(state->A24, state->A24);
     
     // Initializing with the points (1:0), (xQ:1) and (xP:1)
-    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)U->X);
-    fp2copy751(xQ, V->X);
-    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)V->Z);
-    fp2copy751(xP, W->X);
-    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)W->Z);
-    fpzero751(W->Z[1]);
-    fpcopy751(m, temp_scalar);
+    fp2zero751(state->U->X); fp2zero751(state->U->Z);
+    fp2zero751(state->V->Z); fp2zero751(state->W->Z);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)state->U->X);
+    fp2copy751(xQ, state->V->X);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)state->V->Z);
+    fp2copy751(xP, state->W->X);
+    fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, (digit_t*)state->W->Z);
+    copy_words(m, state->scalar, NWORDS_ORDER);
     
-    for (i = fullbits-nbits; i > 0; i--) {
-        mp_shiftl1(temp_scalar, NWORDS_ORDER);
+    for (i = fullbits-state->nbits; i > 0; i--) {
+        mp_shiftl1(state->scalar, NWORDS_ORDER);
     }
-    
-    for (i = nbits; i > 0; i--) {
-        bit = (unsigned int)(temp_scalar[NWORDS_ORDER - 1] >> (RADIX - 1));
-        mp_shiftl1(temp_scalar, NWORDS_ORDER);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+void ladder_3_pt_steps(f2elm_t xP, f2elm_t xQ, f2elm_t xPQ, ladder_3_pt_state* state, unsigned int nsteps)
+{ // Processes the next min(nsteps, state->nbits) bits of the three-point ladder initialized by ladder_3_pt_init().
+  // Input:  the affine points xP, xQ and xPQ given to ladder_3_pt().
+  // Output: once state->nbits = 0, state->W holds the projective Montgomery x-coordinates of P+[m]Q.
+    point_proj* U = state->U, *V = state->V, *W = state->W;
+    f2elm_t constant1, constant2;
+    unsigned int bit = 0;
+    digit_t mask;
+
+    for (; nsteps > 0 && state->nbits > 0; nsteps--, state->nbits--) {
+        bit = (unsigned int)(state->scalar[NWORDS_ORDER - 1] >> (RADIX - 1));
+        mp_shiftl1(state->scalar, NWORDS_ORDER);
         mask = 0 - (digit_t)bit;
 
         swap_points(W, U, mask);
@@ -392,11 +988,36 @@ CRYPTO_STATUS ladder_3_pt(
         select_f2elm(xP, xQ, constant1, mask);
         select_f2elm(xQ, xPQ, constant2, mask);
         xADD(W, U, constant1);                     // If bit=0 then W <- W+U, U <- 2*U and V <- U+V, 
-        xDBLADD(U, V, constant2, A24);             // else if bit=1 then U <- U+V, V <- 2*V and W <- V+W
+        xDBLADD(U, V, constant2, state->A24);      // else if bit=1 then U <- U+V, V <- 2*V and W <- V+W
         swap_points(U, V, mask);
         swap_points(W, U, mask);
     }
+}
+
 
+CRYPTO_STATUS ladder_3_pt(
+    f2elm_t xP,
+    f2elm_t xQ,
+    f2elm_t xPQ,
+    digit_t* m,
+    unsigned int AliceOrBob,
+    point_proj_t W,
+    f2elm_t A,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Computes P+[m]Q via x-only arithmetic. Algorithm by De Feo, Jao and Plut.
+  // Input:  three affine points xP,xQ,xPQ and Montgomery constant A.
+  // Output: projective Montgomery x-coordinates of x(P+[m]Q)=WX/WZ
+    ladder_3_pt_state state;
+    CRYPTO_STATUS Status;
+
+    Status = ladder_3_pt_init(xP, xQ, m, AliceOrBob, A, &state, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    ladder_3_pt_steps(xP, xQ, xPQ, &state, state.nbits);
+    copy_words((digit_t*)state.W, (digit_t*)W, 2*2*NWORDS_FIELD);
+
+    clear_words((void*)&state, sizeof(ladder_3_pt_state)/sizeof(digit_t));
     return CRYPTO_SUCCESS;
 }
 
@@ -428,11 +1049,13 @@ void eval_4_isog(point_proj_t P, f2elm_t* coeff)
   // by the 5 coefficients in coeff (computed in the function four_isogeny_from_projective_kernel()).
   // Inputs: the coefficients defining the isogeny, and the projective point P = (X:Z).
   // Output: the projective point P = phi(P) = (X:Z) in the codomain. 
-    f2elm_t t0, t1;
+    f2elm_t t0;
+    df2elm_t tt0, tt1;
 
-    fp2mul751_mont(P->X, coeff[0], P->X);              // X = coeff[0]*X
-    fp2mul751_mont(P->Z, coeff[1], t0);                // t0 = coeff[1]*Z
-    fp2sub751(P->X, t0, P->X);                         // X = X-t0
+    fp2mul751_unreduced(P->X, coeff[0], tt0);          // tt0 = coeff[0]*X
+    fp2mul751_unreduced(P->Z, coeff[1], tt1);          // tt1 = coeff[1]*Z
+    fp2dfsub751(tt0, tt1, tt0);                        // tt0 = coeff[0]*X-coeff[1]*Z
+    fp2rdc751(tt0, P->X);                              // X = coeff[0]*X-coeff[1]*Z, with a single reduction
     fp2mul751_mont(P->Z, coeff[2], P->Z);              // Z = coeff[2]*Z
     fp2sub751(P->X, P->Z, t0);                         // t0 = X-Z
     fp2mul751_mont(P->Z, P->X, P->Z);                  // Z = X*Z
@@ -442,9 +1065,10 @@ void eval_4_isog(point_proj_t P, f2elm_t* coeff)
     fp2add751(P->Z, t0, P->X);                         // X = t0+Z
     fp2mul751_mont(P->Z, t0, P->Z);                    // Z = t0*Z
     fp2mul751_mont(P->Z, coeff[4], P->Z);              // Z = coeff[4]*Z
-    fp2mul751_mont(t0, coeff[4], t0);                  // t0 = t0*coeff[4]
-    fp2mul751_mont(P->X, coeff[3], t1);                // t1 = X*coeff[3]
-    fp2sub751(t0, t1, t0);                             // t0 = t0-t1
+    fp2mul751_unreduced(t0, coeff[4], tt0);            // tt0 = t0*coeff[4]
+    fp2mul751_unreduced(P->X, coeff[3], tt1);          // tt1 = X*coeff[3]
+    fp2dfsub751(tt0, tt1, tt0);                        // tt0 = t0*coeff[4]-X*coeff[3]
+    fp2rdc751(tt0, t0);                                // t0 = t0*coeff[4]-X*coeff[3], with a single reduction
     fp2mul751_mont(P->X, t0, P->X);                    // X = X*t0
 }
 
@@ -475,40 +1099,58 @@ void first_4_isog(point_proj_t P, f2elm_t A, f2elm_t Aout, f2elm_t Cout, PCurveI
 }
 
 
-void xTPL(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C)
+void get_A24_tpl(f2elm_t A, f2elm_t C, f2elm_t A24minus, f2elm_t A24plus)
+{ // Computes the projective constants used by xTPL() and get_3_isog() from the Montgomery curve constant A/C.
+  // Input:  projective Montgomery curve constant A/C.
+  // Output: A24minus = A-2C and A24plus = A+2C. A24minus can be A and A24plus can be C.
+    f2elm_t t0;
+
+    fp2add751(C, C, t0);                               // t0 = 2C
+    fp2add751(A, t0, A24plus);                         // A24plus = A+2C
+    fp2sub751(A, t0, A24minus);                        // A24minus = A-2C
+}
+
+
+void get_A_tpl(f2elm_t A24minus, f2elm_t A24plus, f2elm_t A, f2elm_t C)
+{ // Recovers the Montgomery curve constant A/C from the projective constants of get_A24_tpl() or get_3_isog().
+  // Input:  A24minus = A-2C and A24plus = A+2C.
+  // Output: projective Montgomery curve constant A/C = 2*(A24plus+A24minus)/(A24plus-A24minus). A can be A24minus and C can be A24plus.
+    f2elm_t t0;
+
+    fp2add751(A24plus, A24minus, t0);                  // t0 = A24plus+A24minus = 2A
+    fp2sub751(A24plus, A24minus, C);                   // C = A24plus-A24minus = 4C
+    fp2add751(t0, t0, A);                              // A = 4A
+}
+
+
+void xTPL(point_proj_t P, point_proj_t Q, f2elm_t A24minus, f2elm_t A24plus)
 { // Tripling of a Montgomery point in projective coordinates (X:Z).
-  // Input: projective Montgomery x-coordinates P = (X:Z), where x=X/Z and Montgomery curve constant A4=4*A.
+  // Input: projective Montgomery x-coordinates P = (X:Z), where x=X/Z and projective curve constants A24minus = A-2C and A24plus = A+2C.
   // Output: projective Montgomery x-coordinates Q = 3*P = (X3:Z3).
-    f2elm_t t0, t1, t2, t3, t4, t5;
+    f2elm_t t0, t1, t2, t3, t4, t5, t6;
     
-    fp2add751(P->X, P->Z, t2);                         // t2 = X+Z
-    fp2sqr751_mont(P->X, t0);                          // t0 = X^2
-    fp2sqr751_mont(P->Z, t1);                          // t1 = Z^2
-    fp2sqr751_mont(t2, t2);                            // t2 = (X+Z)^2
-    fp2mul751_mont(t0, C, t3);                         // t3 = C*X^2
-    fp2sub751(t2, t0, t2);                             // t2 = (X+Z)^2-X^2
-    fp2mul751_mont(t1, C, t4);                         // t4 = C*Z^2
-    fp2sub751(t2, t1, t2);                             // t2 = 2XZ = (X+Z)^2-X^2-Z^2
-    fp2add751(t3, t4, t5);                             // t5 = C*X^2+C*Z^2
-    fp2mul751_mont(t2, A, t2);                         // t2 = 2AXZ
-    fp2add751(t3, t3, t3);                             // t3 = 2C*X^2 
-    fp2add751(t4, t4, t4);                             // t4 = 2C*Z^2
-    fp2add751(t3, t2, t3);                             // t3 = 2C*X^2+2AXZ
-    fp2add751(t4, t2, t4);                             // t4 = 2C*Z^2+2AXZ
-    fp2add751(t3, t5, t3);                             // t3 = 2C*X^2+2AXZ + C*X^2+C*Z^2
-    fp2add751(t4, t5, t4);                             // t4 = 2C*Z^2+2AXZ + C*X^2+C*Z^2
-    fp2sub751(t0, t1, t2);                             // t2 = X^2-Z^2
-    fp2add751(t0, t0, t0);                             // t0 = 2X^2
-    fp2add751(t1, t1, t1);                             // t1 = 2Z^2
-    fp2mul751_mont(t2, t5, t2);                        // t2 = (X^2-Z^2)(C*X^2+C*Z^2)
-    fp2mul751_mont(t1, t3, t1);                        // t1 = 2Z^2*[2C*X^2+2AXZ+C*X^2+C*Z^2]
-    fp2mul751_mont(t0, t4, t0);                        // t0 = 2X^2*[2C*Z^2+2AXZ+C*X^2+C*Z^2]
-    fp2sub751(t1, t2, t1);                             // t1 = 2Z^2*[2C*X^2+2AXZ+C*X^2+C*Z^2] - (X^2-Z^2)(C*X^2+C*Z^2)
-    fp2add751(t0, t2, t0);                             // t0 = 2X^2*[2C*Z^2+2AXZ+C*X^2+C*Z^2] + (X^2-Z^2)(C*X^2+C*Z^2)
-    fp2sqr751_mont(t1, t1);                            // t1 = [2Z^2*[2C*X^2+2AXZ+C*X^2+C*Z^2] - (X^2-Z^2)(C*X^2+C*Z^2)]^2
-    fp2sqr751_mont(t0, t0);                            // t0 = [2X^2*[2C*Z^2+2AXZ+C*X^2+C*Z^2] + (X^2-Z^2)(C*X^2+C*Z^2)]^2
-    fp2mul751_mont(P->X, t1, Q->X);                    // X3 = X*[2Z^2*[2C*X^2+2AXZ+C*X^2+C*Z^2] - (X^2-Z^2)(C*X^2+C*Z^2)]^2
-    fp2mul751_mont(P->Z, t0, Q->Z);                    // Z3 = Z*[2X^2*[2C*Z^2+2AXZ+C*X^2+C*Z^2] + (X^2-Z^2)(C*X^2+C*Z^2)]^2
+    fp2sub751(P->X, P->Z, t0);                         // t0 = X-Z
+    fp2sqr751_mont(t0, t2);                            // t2 = (X-Z)^2
+    fp2add751(P->X, P->Z, t1);                         // t1 = X+Z
+    fp2sqr751_mont(t1, t3);                            // t3 = (X+Z)^2
+    fp2add751(t0, t1, t4);                             // t4 = 2X
+    fp2sub751(t1, t0, t0);                             // t0 = 2Z
+    fp2sqr751_mont(t4, t1);                            // t1 = 4X^2
+    fp2sub751(t1, t3, t1);                             // t1 = 4X^2-(X+Z)^2
+    fp2sub751(t1, t2, t1);                             // t1 = 4X^2-(X+Z)^2-(X-Z)^2 = 2(X^2-Z^2)
+    fp2mul751_mont(t3, A24plus, t5);                   // t5 = A24plus*(X+Z)^2
+    fp2mul751_mont(t3, t5, t3);                        // t3 = A24plus*(X+Z)^4
+    fp2mul751_mont(A24minus, t2, t6);                  // t6 = A24minus*(X-Z)^2
+    fp2mul751_mont(t2, t6, t2);                        // t2 = A24minus*(X-Z)^4
+    fp2sub751(t2, t3, t3);                             // t3 = A24minus*(X-Z)^4-A24plus*(X+Z)^4
+    fp2sub751(t5, t6, t2);                             // t2 = A24plus*(X+Z)^2-A24minus*(X-Z)^2
+    fp2mul751_mont(t1, t2, t1);                        // t1 = 2(X^2-Z^2)*[A24plus*(X+Z)^2-A24minus*(X-Z)^2]
+    fp2add751(t3, t1, t2);                             // t2 = t3+t1
+    fp2sqr751_mont(t2, t2);                            // t2 = (t3+t1)^2
+    fp2mul751_mont(t4, t2, Q->X);                      // X3 = 2X*(t3+t1)^2
+    fp2sub751(t3, t1, t1);                             // t1 = t3-t1
+    fp2sqr751_mont(t1, t1);                            // t1 = (t3-t1)^2
+    fp2mul751_mont(t0, t1, Q->Z);                      // Z3 = 2Z*(t3-t1)^2
 }
 
 
@@ -516,55 +1158,72 @@ void xTPLe(point_proj_t P, point_proj_t Q, f2elm_t A, f2elm_t C, int e)
 { // Computes [3^e](X:Z) on Montgomery curve with projective constant via e repeated triplings.
   // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and Montgomery curve constant A/C.
   // Output: projective Montgomery x-coordinates P <- (3^e)*P.
+    f2elm_t A24minus, A24plus;
+
+    get_A24_tpl(A, C, A24minus, A24plus);
+    xTPLe_A24(P, Q, A24minus, A24plus, e);
+}
+
+
+void xTPLe_A24(point_proj_t P, point_proj_t Q, f2elm_t A24minus, f2elm_t A24plus, int e)
+{ // Computes [3^e](X:Z) via e repeated triplings, given the projective curve constants of get_A24_tpl() or get_3_isog().
+  // Input: projective Montgomery x-coordinates P = (XP:ZP), such that xP=XP/ZP and curve constants A24minus = A-2C and A24plus = A+2C.
+  // Output: projective Montgomery x-coordinates Q <- (3^e)*P.
     int i;
       
     copy_words((digit_t*)P, (digit_t*)Q, 2 * 2 * NWORDS_FIELD);
 
     for (i = 0; i < e; i++) {
-        xTPL(Q, Q, A, C);
+        xTPL(Q, Q, A24minus, A24plus);
     }
 }
 
 
-void get_3_isog(point_proj_t P, f2elm_t A, f2elm_t C)
+void get_3_isog(point_proj_t P, f2elm_t A24minus, f2elm_t A24plus, f2elm_t* coeff)
 { // Computes the corresponding 3-isogeny of a projective Montgomery point (X3:Z3) of order 3.
   // Input:  projective point of order three P = (X3:Z3).
-  // Output: the 3-isogenous Montgomery curve with projective coefficient A/C. 
-    f2elm_t t0, t1;
+  // Output: the 3-isogenous Montgomery curve, given by its projective constants A24minus = A-2C and A24plus = A+2C 
+  //         as used by xTPL(), and the 2 coefficients that are used to evaluate the isogeny at a point in eval_3_isog().
+    f2elm_t t0, t1, t2, t3, t4;
+
+    fp2sub751(P->X, P->Z, coeff[0]);                   // coeff[0] = X3-Z3
+    fp2sqr751_mont(coeff[0], t0);                      // t0 = (X3-Z3)^2
+    fp2add751(P->X, P->Z, coeff[1]);                   // coeff[1] = X3+Z3
+    fp2sqr751_mont(coeff[1], t1);                      // t1 = (X3+Z3)^2
+    fp2add751(t0, t1, t2);                             // t2 = (X3+Z3)^2+(X3-Z3)^2
+    fp2add751(coeff[0], coeff[1], t3);                 // t3 = 2X3
+    fp2sqr751_mont(t3, t3);                            // t3 = 4X3^2
+    fp2sub751(t3, t2, t3);                             // t3 = 4X3^2-(X3+Z3)^2-(X3-Z3)^2
+    fp2add751(t1, t3, t2);                             // t2 = 4X3^2-(X3-Z3)^2
+    fp2add751(t3, t0, t3);                             // t3 = 4X3^2-(X3+Z3)^2
+    fp2add751(t0, t3, t4);                             // t4 = 4X3^2-(X3+Z3)^2+(X3-Z3)^2
+    fp2add751(t4, t4, t4);                             // t4 = 2*[4X3^2-(X3+Z3)^2+(X3-Z3)^2]
+    fp2add751(t1, t4, t4);                             // t4 = 8X3^2-(X3+Z3)^2+2(X3-Z3)^2
+    fp2mul751_mont(t2, t4, A24minus);                  // A24minus = [4X3^2-(X3-Z3)^2]*[8X3^2-(X3+Z3)^2+2(X3-Z3)^2]
+    fp2add751(t1, t2, t4);                             // t4 = 4X3^2+(X3+Z3)^2-(X3-Z3)^2
+    fp2add751(t4, t4, t4);                             // t4 = 2*[4X3^2+(X3+Z3)^2-(X3-Z3)^2]
+    fp2add751(t0, t4, t4);                             // t4 = 8X3^2+2(X3+Z3)^2-(X3-Z3)^2
+    fp2mul751_mont(t3, t4, A24plus);                   // A24plus = [4X3^2-(X3+Z3)^2]*[8X3^2+2(X3+Z3)^2-(X3-Z3)^2]
+}
+
 
-    fp2sqr751_mont(P->X, t0);                          // t0 = X^2
-    fp2add751(t0, t0, t1);                             // t1 = 2*t0
-    fp2add751(t0, t1, t0);                             // t0 = t0+t1
-    fp2sqr751_mont(P->Z, t1);                          // t1 = Z^2
-    fp2sqr751_mont(t1, A);                             // A = t1^2
-    fp2add751(t1, t1, t1);                             // t1 = 2*t1
-    fp2add751(t1, t1, C);                              // C = 2*t1
-    fp2sub751(t0, t1, t1);                             // t1 = t0-t1
-    fp2mul751_mont(t0, t1, t1);                        // t1 = t0*t1
-    fp2sub751(A, t1, A);                               // A = A-t1 
-    fp2sub751(A, t1, A);                               // A = A-t1 
-    fp2sub751(A, t1, A);                               // A = A-t1     
-    fp2mul751_mont(P->X, P->Z, t1);                    // t1 = X*Z    
-    fp2mul751_mont(C, t1, C);                          // C = C*t1
-}
-
-
-void eval_3_isog(point_proj_t P, point_proj_t Q)
-{ // Computes the 3-isogeny R=phi(X:Z), given projective point (X3:Z3) of order 3 on a Montgomery curve and a point P = (X:Z).
-  // Inputs: projective points P = (X3:Z3) and Q = (X:Z).
-  // Output: the projective point R = phi(Q) = (XX:ZZ). 
+void eval_3_isog(point_proj_t Q, f2elm_t* coeff)
+{ // Evaluates the isogeny at the point (X:Z) in the domain of the isogeny, given a 3-isogeny phi defined 
+  // by the 2 coefficients in coeff (computed in the function get_3_isog()).
+  // Inputs: the coefficients defining the isogeny, and the projective point Q = (X:Z).
+  // Output: the projective point Q = phi(Q) = (X:Z) in the codomain. 
     f2elm_t t0, t1, t2;
 
-    fp2mul751_mont(P->X, Q->X, t0);                  // t0 = X3*X
-    fp2mul751_mont(P->Z, Q->X, t1);                  // t1 = Z3*X
-    fp2mul751_mont(P->Z, Q->Z, t2);                  // t2 = Z3*Z
-    fp2sub751(t0, t2, t0);                           // t0 = X3*X-Z3*Z          
-    fp2mul751_mont(P->X, Q->Z, t2);                  // t2 = X3*Z
-    fp2sub751(t1, t2, t1);                           // t1 = Z3*X-X3*Z
-    fp2sqr751_mont(t0, t0);                          // t0 = (X3*X-Z3*Z)^2
-    fp2sqr751_mont(t1, t1);                          // t1 = (Z3*X-X3*Z)^2
-    fp2mul751_mont(Q->X, t0, Q->X);                  // X = X*(X3*X-Z3*Z)^2        
-    fp2mul751_mont(Q->Z, t1, Q->Z);                  // Z = Z*(Z3*X-X3*Z)^2
+    fp2add751(Q->X, Q->Z, t0);                       // t0 = X+Z
+    fp2sub751(Q->X, Q->Z, t1);                       // t1 = X-Z
+    fp2mul751_mont(t0, coeff[0], t0);                // t0 = coeff[0]*(X+Z)
+    fp2mul751_mont(t1, coeff[1], t1);                // t1 = coeff[1]*(X-Z)
+    fp2add751(t0, t1, t2);                           // t2 = coeff[0]*(X+Z)+coeff[1]*(X-Z)
+    fp2sub751(t1, t0, t0);                           // t0 = coeff[1]*(X-Z)-coeff[0]*(X+Z)
+    fp2sqr751_mont(t2, t2);                          // t2 = [coeff[0]*(X+Z)+coeff[1]*(X-Z)]^2
+    fp2sqr751_mont(t0, t0);                          // t0 = [coeff[1]*(X-Z)-coeff[0]*(X+Z)]^2
+    fp2mul751_mont(Q->X, t2, Q->X);                  // X = X*[coeff[0]*(X+Z)+coeff[1]*(X-Z)]^2
+    fp2mul751_mont(Q->Z, t0, Q->Z);                  // Z = Z*[coeff[1]*(X-Z)-coeff[0]*(X+Z)]^2
 }
 
 
@@ -589,6 +1248,29 @@ void inv_4_way(f2elm_t z1, f2elm_t z2, f2elm_t z3, f2elm_t z4)
 }
 
 
+void inv_n_way(f2elm_t* z, f2elm_t* t, unsigned int n)
+{ // n-way simultaneous inversion using Montgomery's trick
+  // Input:  z[0],...,z[n-1], all different from zero, and scratch space t for n elements in GF(p751^2)
+  // Output: 1/z[0],...,1/z[n-1] (override inputs).
+  // The cost is one inversion plus 3*(n-1) multiplications in GF(p751^2).
+    unsigned int i;
+    f2elm_t t0, t1;
+
+    fp2copy751(z[0], t[0]);
+    for (i = 1; i < n; i++) {
+        fp2mul751_mont(t[i-1], z[i], t[i]);          // t[i] = z[0]*...*z[i]
+    }
+    fp2copy751(t[n-1], t0);
+    fp2inv751_mont(t0);                              // t0 = 1/(z[0]*...*z[n-1])
+    for (i = n-1; i > 0; i--) {
+        fp2mul751_mont(t0, t[i-1], t1);              // t1 = 1/z[i]
+        fp2mul751_mont(t0, z[i], t0);                // t0 = 1/(z[0]*...*z[i-1])
+        fp2copy751(t1, z[i]);
+    }
+    fp2copy751(t0, z[0]);                            // z[0] = 1/z[0]
+}
+
+
 void distort_and_diff(felm_t xP, point_proj_t D, PCurveIsogenyStruct CurveIsogeny)
 { // Computing the point (x(Q-P),z(Q-P))
   // Input:  coordinate xP of point P=(xP,yP)
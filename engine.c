@@ -0,0 +1,466 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: asynchronous job engine running key exchange operations on a work-stealing thread pool
+*
+*********************************************************************************************/
+
+#if defined(__LINUX__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE                                  // For pthread_setaffinity_np()
+#endif
+#include "SIDH_internal.h"
+#include <malloc.h>
+#if defined(THREADS_SUPPORT)
+    #include <pthread.h>
+    #include <sched.h>
+    #include <time.h>
+#endif
+
+
+#if defined(THREADS_SUPPORT)
+
+#if defined(MULTIBUFFER_SUPPORT)
+    #define ENGINE_MAX_BATCH    MB_LANES                 // Queued jobs of the same type are coalesced into one multi-buffer batch
+#else
+    #define ENGINE_MAX_BATCH    1
+#endif
+
+// Jobs are submitted round-robin to the workers' queues. Each worker runs the jobs of its own queue in submission order and, when
+// it runs out of them, steals from the queues of the others. Idle workers block on "wakeup" until "queued" becomes nonzero.
+typedef struct {
+    pthread_mutex_t  lock;
+    PSIDHJob         head;                               // Jobs linked through their "next" field
+    PSIDHJob         tail;
+} job_queue;
+
+typedef struct {
+    PJobEngine       Engine;
+    unsigned int     id;
+    pthread_t        thread;
+    PCurveIsogenyStruct CurveIsogeny;                    // Curve isogeny structure of this worker
+    job_queue        queue;
+    unsigned char*   scratch;                            // Contiguous keys and secrets of a batch, only with multi-buffer support
+} engine_worker;
+
+struct jobengine {
+    unsigned int     nworkers;
+    unsigned int     next;                               // Queue that receives the next submitted job
+    unsigned int     queued;                             // Number of jobs waiting in the queues
+    unsigned int     sleepers;                           // Number of workers blocked on "wakeup"
+    unsigned int     quit;
+    pthread_mutex_t  lock;
+    pthread_cond_t   wakeup;
+    unsigned int     pbytes, obytes;                     // Sizes of a field element and a private key
+    SIDH_engine_stats stats;                             // Updated atomically
+    engine_worker    workers[1];                         // "nworkers" entries
+};
+
+
+static uint64_t engine_clock(void)
+{ // Monotonic time in nanoseconds
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec*1000000000 + (uint64_t)time.tv_nsec;
+}
+
+
+static unsigned int engine_dequeue(job_queue* queue, PSIDHJob* jobs, unsigned int max)
+{ // Takes the first job of the queue and up to max-1 more of the same type that can be batched with it. Returns the number of jobs taken.
+    PSIDHJob job, prev;
+    unsigned int n = 0;
+
+    pthread_mutex_lock(&queue->lock);
+    job = queue->head;
+    if (job != NULL) {
+        queue->head = job->next;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+        jobs[n++] = job;
+        if (job->Type != SIDH_JOB_VALIDATE_A && job->Type != SIDH_JOB_VALIDATE_B) {
+            for (prev = NULL, job = queue->head; job != NULL && n < max; job = job->next) {
+                if (job->Type != jobs[0]->Type) {
+                    prev = job;
+                    continue;
+                }
+                jobs[n++] = job;
+                if (prev == NULL) {
+                    queue->head = job->next;
+                } else {
+                    prev->next = job->next;
+                }
+                if (queue->tail == job) {
+                    queue->tail = prev;
+                }
+            }
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    if (n != 0) {
+        __atomic_sub_fetch(&jobs[0]->Engine->queued, n, __ATOMIC_SEQ_CST);
+    }
+    return n;
+}
+
+
+static void engine_run(engine_worker* worker, PSIDHJob* jobs, unsigned int njobs)
+{ // Runs a group of jobs of the same type and completes them
+    PJobEngine Engine = worker->Engine;
+    PCurveIsogenyStruct CurveIsogeny = worker->CurveIsogeny;
+    PSIDHJob job = jobs[0];
+    uint64_t latency, now;
+    unsigned int i;
+
+#if defined(MULTIBUFFER_SUPPORT)
+    if (njobs > 1 && CurveIsogeny->pbits == 751) {       // The multi-buffer backends are only used for SIDHp751
+        CRYPTO_STATUS Status = CRYPTO_SUCCESS, Statuses[ENGINE_MAX_BATCH];
+        unsigned int obytes = Engine->obytes, pkbytes = 4*2*Engine->pbytes, ssbytes = 2*Engine->pbytes;
+        unsigned char *PrivateKeys = worker->scratch, *PublicKeys = PrivateKeys + ENGINE_MAX_BATCH*obytes;
+        unsigned char *SharedSecrets = PublicKeys + ENGINE_MAX_BATCH*pkbytes;
+
+        if (job->Type == SIDH_JOB_KEYGEN_A || job->Type == SIDH_JOB_KEYGEN_B) {
+            if (job->Type == SIDH_JOB_KEYGEN_A) {
+                Status = KeyGeneration_A_batch(PrivateKeys, PublicKeys, njobs, CurveIsogeny);
+            } else {
+                Status = KeyGeneration_B_batch(PrivateKeys, PublicKeys, njobs, CurveIsogeny);
+            }
+            for (i = 0; i < njobs; i++) {
+                if (Status == CRYPTO_SUCCESS) {
+                    copy_words((digit_t*)(PrivateKeys + i*obytes), (digit_t*)jobs[i]->pPrivateKey, NBYTES_TO_NWORDS(obytes));
+                    copy_words((digit_t*)(PublicKeys + i*pkbytes), (digit_t*)jobs[i]->pPublicKey, NBYTES_TO_NWORDS(pkbytes));
+                }
+                jobs[i]->Status = Status;
+            }
+        } else {
+            for (i = 0; i < njobs; i++) {
+                copy_words((digit_t*)jobs[i]->pPrivateKey, (digit_t*)(PrivateKeys + i*obytes), NBYTES_TO_NWORDS(obytes));
+                copy_words((digit_t*)jobs[i]->pPublicKey, (digit_t*)(PublicKeys + i*pkbytes), NBYTES_TO_NWORDS(pkbytes));
+            }
+            // The jobs may come from different clients, so each one gets the status of its own secret
+            if (job->Type == SIDH_JOB_SHARED_A) {
+                Status = SecretAgreement_A_batch_status(PrivateKeys, PublicKeys, SharedSecrets, Statuses, njobs, CurveIsogeny);
+            } else {
+                Status = SecretAgreement_B_batch_status(PrivateKeys, PublicKeys, SharedSecrets, Statuses, njobs, CurveIsogeny);
+            }
+            for (i = 0; i < njobs; i++) {
+                if (Status == CRYPTO_SUCCESS || Status == CRYPTO_ERROR_SHARED_KEY) {    // A failed secret is delivered zeroed
+                    copy_words((digit_t*)(SharedSecrets + i*ssbytes), (digit_t*)jobs[i]->pSharedSecret, NBYTES_TO_NWORDS(ssbytes));
+                } else {
+                    Statuses[i] = Status;                // Errors of the whole batch, e.g., out of memory
+                }
+                jobs[i]->Status = Statuses[i];
+            }
+        }
+        clear_words((void*)PrivateKeys, NBYTES_TO_NWORDS(ENGINE_MAX_BATCH*obytes));
+        clear_words((void*)SharedSecrets, NBYTES_TO_NWORDS(ENGINE_MAX_BATCH*ssbytes));
+        __atomic_add_fetch(&Engine->stats.batches, 1, __ATOMIC_RELAXED);
+    } else
+#endif
+    {
+        for (i = 0; i < njobs; i++) {
+            job = jobs[i];
+            switch (job->Type) {
+            case SIDH_JOB_KEYGEN_A:
+                job->Status = KeyGeneration_A(job->pPrivateKey, job->pPublicKey, CurveIsogeny);
+                break;
+            case SIDH_JOB_KEYGEN_B:
+                job->Status = KeyGeneration_B(job->pPrivateKey, job->pPublicKey, CurveIsogeny);
+                break;
+            case SIDH_JOB_VALIDATE_A:
+                job->Status = Validate_PKA(job->pPublicKey, &job->valid, CurveIsogeny);
+                break;
+            case SIDH_JOB_VALIDATE_B:
+                job->Status = Validate_PKB(job->pPublicKey, &job->valid, CurveIsogeny);
+                break;
+            case SIDH_JOB_SHARED_A:
+                job->Status = SecretAgreement_A(job->pPrivateKey, job->pPublicKey, job->pSharedSecret, CurveIsogeny);
+                break;
+            case SIDH_JOB_SHARED_B:
+                job->Status = SecretAgreement_B(job->pPrivateKey, job->pPublicKey, job->pSharedSecret, CurveIsogeny);
+                break;
+            default:
+                job->Status = CRYPTO_ERROR_INVALID_PARAMETER;
+            }
+        }
+    }
+
+    // Completion: record the latencies and call back. A job must not be touched once its callback has been called.
+    now = engine_clock();
+    for (i = 0; i < njobs; i++) {
+        job = jobs[i];
+        latency = now - job->SubmitTime;
+        __atomic_add_fetch(&Engine->stats.latency_total_ns, latency, __ATOMIC_RELAXED);
+        if (latency > __atomic_load_n(&Engine->stats.latency_max_ns, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&Engine->stats.latency_max_ns, latency, __ATOMIC_RELAXED);   // A concurrent maximum may be lost
+        }
+        __atomic_add_fetch(&Engine->stats.completed, 1, __ATOMIC_RELAXED);
+        job->Callback(job);
+    }
+}
+
+
+static void* engine_worker_thread(void* arg)
+{ // Worker thread: runs the jobs of its queue, steals from the other queues when it is empty and sleeps when all of them are
+    engine_worker* worker = (engine_worker*)arg;
+    PJobEngine Engine = worker->Engine;
+    PSIDHJob jobs[ENGINE_MAX_BATCH];
+    unsigned int i, njobs;
+
+    while (true) {
+        njobs = engine_dequeue(&worker->queue, jobs, ENGINE_MAX_BATCH);
+        for (i = 1; i < Engine->nworkers && njobs == 0; i++) {
+            njobs = engine_dequeue(&Engine->workers[(worker->id + i) % Engine->nworkers].queue, jobs, ENGINE_MAX_BATCH);
+            if (njobs != 0) {
+                __atomic_add_fetch(&Engine->stats.stolen, njobs, __ATOMIC_RELAXED);
+            }
+        }
+        if (njobs != 0) {
+            engine_run(worker, jobs, njobs);
+            continue;
+        }
+
+        // No jobs anywhere: quit if requested, otherwise sleep until one is submitted
+        pthread_mutex_lock(&Engine->lock);
+        __atomic_add_fetch(&Engine->sleepers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&Engine->queued, __ATOMIC_SEQ_CST) == 0 && !__atomic_load_n(&Engine->quit, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&Engine->wakeup, &Engine->lock);
+        }
+        __atomic_sub_fetch(&Engine->sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&Engine->lock);
+        if (__atomic_load_n(&Engine->queued, __ATOMIC_SEQ_CST) == 0 && __atomic_load_n(&Engine->quit, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+
+static void engine_pin(engine_worker* worker)
+{ // Pins the worker to the id-th processor, modulo the number of processors the process may run on
+    cpu_set_t allowed, cpus;
+    int cpu, n = 0, target;
+
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0 || CPU_COUNT(&allowed) == 0) {
+        return;
+    }
+    target = (int)(worker->id % (unsigned int)CPU_COUNT(&allowed));
+    for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed) && n++ == target) {
+            CPU_ZERO(&cpus);
+            CPU_SET(cpu, &cpus);
+            pthread_setaffinity_np(worker->thread, sizeof(cpus), &cpus);
+            return;
+        }
+    }
+}
+
+
+static void engine_destroy(PJobEngine Engine, unsigned int nstarted)
+{ // Stops the first "nstarted" workers once the queues are empty and frees the engine
+    unsigned int i;
+
+    pthread_mutex_lock(&Engine->lock);
+    __atomic_store_n(&Engine->quit, 1, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&Engine->wakeup);
+    pthread_mutex_unlock(&Engine->lock);
+    for (i = 0; i < nstarted; i++) {
+        pthread_join(Engine->workers[i].thread, NULL);
+    }
+
+    for (i = 0; i < Engine->nworkers; i++) {
+        pthread_mutex_destroy(&Engine->workers[i].queue.lock);
+        SIDH_curve_free(Engine->workers[i].CurveIsogeny);
+        free(Engine->workers[i].scratch);
+    }
+    pthread_cond_destroy(&Engine->wakeup);
+    pthread_mutex_destroy(&Engine->lock);
+    free(Engine);
+}
+
+
+CRYPTO_STATUS SIDH_engine_create(
+    PCurveIsogenyStaticData CurveData,
+    RandomBytes RandomBytesFunction,
+    unsigned int nworkers,
+    bool pin,
+    PJobEngine* pEngine
+) { // Creates a job engine with "nworkers" worker threads, each one with its own curve isogeny structure
+    PJobEngine Engine;
+    engine_worker* worker;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    unsigned int i;
+
+    if (pEngine == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    *pEngine = NULL;
+    if (CurveData == NULL || RandomBytesFunction == NULL || nworkers < 1 || nworkers > SIDH_ENGINE_MAX_WORKERS) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    Engine = (PJobEngine) calloc(1, sizeof(struct jobengine) + (nworkers - 1)*sizeof(engine_worker));
+    if (Engine == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    Engine->nworkers = nworkers;
+    Engine->pbytes = (CurveData->pwordbits + 7)/8;
+    Engine->obytes = (CurveData->owordbits + 7)/8;
+    pthread_mutex_init(&Engine->lock, NULL);
+    pthread_cond_init(&Engine->wakeup, NULL);
+
+    for (i = 0; i < nworkers; i++) {
+        worker = &Engine->workers[i];
+        worker->Engine = Engine;
+        worker->id = i;
+        pthread_mutex_init(&worker->queue.lock, NULL);
+        worker->CurveIsogeny = SIDH_curve_allocate(CurveData);
+        if (worker->CurveIsogeny == NULL) {
+            Status = CRYPTO_ERROR_NO_MEMORY;
+            continue;
+        }
+        if (Status == CRYPTO_SUCCESS) {
+            Status = SIDH_curve_initialize(worker->CurveIsogeny, RandomBytesFunction, CurveData);
+        }
+#if defined(MULTIBUFFER_SUPPORT)
+        worker->scratch = (unsigned char*) calloc(ENGINE_MAX_BATCH, Engine->obytes + 4*2*Engine->pbytes + 2*Engine->pbytes);
+        if (worker->scratch == NULL) {
+            Status = CRYPTO_ERROR_NO_MEMORY;
+        }
+#endif
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        engine_destroy(Engine, 0);
+        return Status;
+    }
+
+    for (i = 0; i < nworkers; i++) {
+        if (pthread_create(&Engine->workers[i].thread, NULL, engine_worker_thread, &Engine->workers[i]) != 0) {
+            engine_destroy(Engine, i);
+            return CRYPTO_ERROR_NO_MEMORY;
+        }
+        if (pin) {
+            engine_pin(&Engine->workers[i]);
+        }
+    }
+
+    *pEngine = Engine;
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_engine_submit(PJobEngine Engine, PSIDHJob Job)
+{ // Queues a job, which is completed asynchronously by calling its callback
+    job_queue* queue;
+    unsigned int queued, max;
+
+    if (Engine == NULL || Job == NULL || Job->Type >= SIDH_JOB_END_OF_LIST || Job->Callback == NULL || Job->pPublicKey == NULL ||
+        (Job->Type != SIDH_JOB_VALIDATE_A && Job->Type != SIDH_JOB_VALIDATE_B && Job->pPrivateKey == NULL) ||
+        ((Job->Type == SIDH_JOB_SHARED_A || Job->Type == SIDH_JOB_SHARED_B) && Job->pSharedSecret == NULL)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    Job->Status = CRYPTO_SUCCESS;
+    Job->valid = false;
+    Job->Engine = Engine;
+    Job->next = NULL;
+    Job->SubmitTime = engine_clock();
+
+    queue = &Engine->workers[__atomic_fetch_add(&Engine->next, 1, __ATOMIC_RELAXED) % Engine->nworkers].queue;
+    pthread_mutex_lock(&queue->lock);
+    queued = __atomic_add_fetch(&Engine->queued, 1, __ATOMIC_SEQ_CST);     // Counted before it can be dequeued, so "queued" never wraps
+    if (queue->tail == NULL) {
+        queue->head = Job;
+    } else {
+        queue->tail->next = Job;
+    }
+    queue->tail = Job;
+    pthread_mutex_unlock(&queue->lock);
+
+    __atomic_add_fetch(&Engine->stats.submitted, 1, __ATOMIC_RELAXED);
+    max = __atomic_load_n(&Engine->stats.max_queued, __ATOMIC_RELAXED);
+    while (queued > max && !__atomic_compare_exchange_n(&Engine->stats.max_queued, &max, queued, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    if (__atomic_load_n(&Engine->sleepers, __ATOMIC_SEQ_CST) != 0) {
+        pthread_mutex_lock(&Engine->lock);
+        pthread_cond_signal(&Engine->wakeup);
+        pthread_mutex_unlock(&Engine->lock);
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+void SIDH_engine_get_stats(PJobEngine Engine, SIDH_engine_stats* stats)
+{ // Copies the counters of the engine and the current number of queued jobs
+    if (Engine == NULL || stats == NULL) {
+        return;
+    }
+    stats->submitted = __atomic_load_n(&Engine->stats.submitted, __ATOMIC_RELAXED);
+    stats->completed = __atomic_load_n(&Engine->stats.completed, __ATOMIC_RELAXED);
+    stats->stolen = __atomic_load_n(&Engine->stats.stolen, __ATOMIC_RELAXED);
+    stats->batches = __atomic_load_n(&Engine->stats.batches, __ATOMIC_RELAXED);
+    stats->queued = __atomic_load_n(&Engine->queued, __ATOMIC_RELAXED);
+    stats->max_queued = __atomic_load_n(&Engine->stats.max_queued, __ATOMIC_RELAXED);
+    stats->latency_total_ns = __atomic_load_n(&Engine->stats.latency_total_ns, __ATOMIC_RELAXED);
+    stats->latency_max_ns = __atomic_load_n(&Engine->stats.latency_max_ns, __ATOMIC_RELAXED);
+}
+
+
+void SIDH_engine_free(PJobEngine Engine)
+{ // Completes the queued jobs, stops the workers and frees the engine
+    if (Engine == NULL) {
+        return;
+    }
+    engine_destroy(Engine, Engine->nworkers);
+}
+
+#else
+
+CRYPTO_STATUS SIDH_engine_create(
+    PCurveIsogenyStaticData CurveData,
+    RandomBytes RandomBytesFunction,
+    unsigned int nworkers,
+    bool pin,
+    PJobEngine* pEngine
+) { // Job engines are not supported in this build
+    UNREFERENCED_PARAMETER(CurveData);
+    UNREFERENCED_PARAMETER(RandomBytesFunction);
+    UNREFERENCED_PARAMETER(nworkers);
+    UNREFERENCED_PARAMETER(pin);
+    if (pEngine != NULL) {
+        *pEngine = NULL;
+    }
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+
+CRYPTO_STATUS SIDH_engine_submit(PJobEngine Engine, PSIDHJob Job)
+{
+    UNREFERENCED_PARAMETER(Engine);
+    UNREFERENCED_PARAMETER(Job);
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+
+void SIDH_engine_get_stats(PJobEngine Engine, SIDH_engine_stats* stats)
+{
+    SIDH_engine_stats zero = {0};
+
+    UNREFERENCED_PARAMETER(Engine);
+    if (stats != NULL) {
+        *stats = zero;
+    }
+}
+
+
+void SIDH_engine_free(PJobEngine Engine)
+{
+    UNREFERENCED_PARAMETER(Engine);
+}
+
+#endif
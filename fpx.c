@@ -10,15 +10,81 @@
 *********************************************************************************************/ 
 
 #include "SIDH_internal.h"
+#if (OS_TARGET == OS_WIN)
+    #include <intrin.h>
+#endif
     
 
 // Global constants          
+#if !defined(_P503_)
 const uint64_t p751[NWORDS_FIELD]          = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xEEAFFFFFFFFFFFFF,
                                                0xE3EC968549F878A8, 0xDA959B1A13F7CC76, 0x084E9867D6EBE876, 0x8562B5045CB25748, 0x0E12909F97BADC66, 0x00006FE5D541F71C };
 const uint64_t p751p1[NWORDS_FIELD]        = { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0xEEB0000000000000,
                                                0xE3EC968549F878A8, 0xDA959B1A13F7CC76, 0x084E9867D6EBE876, 0x8562B5045CB25748, 0x0E12909F97BADC66, 0x00006FE5D541F71C };
 const uint64_t Montgomery_R2[NWORDS_FIELD] = { 0x233046449DAD4058, 0xDB010161A696452A, 0x5E36941472E3FD8E, 0xF40BFE2082A2E706, 0x4932CCA8904F8751 ,0x1F735F1F1EE7FC81, 
                                                0xA24F4D80C1048E18, 0xB56C383CCDB607C5, 0x441DD47B735F9C90, 0x5673ED2C6A6AC82A, 0x06C905261132294B, 0x000041AD830F1F35 }; 
+#else
+const uint64_t p503[NWORDS_FIELD]          = { 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xFFFFFFFFFFFFFFFF, 0xABFFFFFFFFFFFFFF, 0x13085BDA2211E7A0, 0x1B9BF6C87B7E7DAF,
+                                               0x6045C6BDDA77A4D0, 0x004066F541811E1E };
+const uint64_t p503p1[NWORDS_FIELD]        = { 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0xAC00000000000000, 0x13085BDA2211E7A0, 0x1B9BF6C87B7E7DAF,
+                                               0x6045C6BDDA77A4D0, 0x004066F541811E1E };
+const uint64_t Montgomery_R2[NWORDS_FIELD] = { 0x5289A0CF641D011F, 0x9B88257189FED2B9, 0xA3B365D58DC8F17A, 0x5BC57AB6EFF168EC, 0x9E51998BD84D4423, 0xBF8999CBAC3B5695,
+                                               0x46E9127BCE14CDB6, 0x003F6CFCE8B81771 };
+#endif
+
+// Field arithmetic backend of the process, NULL until fp_select_arithmetic() fixes it. It never changes afterwards.
+static const FieldArithmetic* fp_arithmetic = NULL;
+
+// Atomic read of the selection, and compare-and-swap that sets it if still NULL and returns its previous value
+#if (OS_TARGET == OS_WIN)
+    #define FP_ARITHMETIC_LOAD()                 (*(const FieldArithmetic* volatile*)&fp_arithmetic)
+    #define FP_ARITHMETIC_SET_ONCE(arithmetic)   (const FieldArithmetic*)_InterlockedCompareExchangePointer((void* volatile*)&fp_arithmetic, (void*)(arithmetic), NULL)
+#else
+    #define FP_ARITHMETIC_LOAD()                 __atomic_load_n(&fp_arithmetic, __ATOMIC_ACQUIRE)
+    #define FP_ARITHMETIC_SET_ONCE(arithmetic)   __sync_val_compare_and_swap(&fp_arithmetic, NULL, (arithmetic))
+#endif
+
+
+CRYPTO_STATUS fp_select_arithmetic(ARITHMETIC_ID id, const FieldArithmetic** arithmetic)
+{ // Fix the field arithmetic backend of the process to "id" on the first call and set "arithmetic" to the backend in use.
+  // Later calls cannot change the selection: they succeed with ARITHMETIC_DEFAULT or the backend in use, and return 
+  // CRYPTO_ERROR_INVALID_PARAMETER for any other available backend. Threads racing on the first call agree on one backend.
+    const FieldArithmetic *requested = NULL, *current;
+    CRYPTO_STATUS Status;
+
+    if (arithmetic == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    Status = fp_get_arithmetic(id, &requested);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    current = FP_ARITHMETIC_LOAD();
+    if (current == NULL) {
+        current = FP_ARITHMETIC_SET_ONCE(requested);
+        if (current == NULL) {                         // This call made the selection
+            current = requested;
+        }
+    }
+    *arithmetic = current;
+
+    if (id != ARITHMETIC_DEFAULT && current != requested) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+static __inline const FieldArithmetic* fp_get_selected_arithmetic(void)
+{ // Backend of the process, selecting the fastest one supported by the processor if none was selected yet
+    const FieldArithmetic* arithmetic = FP_ARITHMETIC_LOAD();
+
+    if (arithmetic == NULL) {
+        fp_select_arithmetic(ARITHMETIC_DEFAULT, &arithmetic);
+    }
+    return arithmetic;
+}
 
 
 /*******************************************************/
@@ -44,6 +110,45 @@ __inline void fpzero751(felm_t a)
 }
 
 
+__inline void fpadd751(digit_t* a, digit_t* b, digit_t* c)
+{ // Modular addition, c = a+b mod p751. All the backends of a build share this kernel, so it is called directly.
+  // Inputs: a, b in [0, p751-1] 
+  // Output: c in [0, p751-1] 
+    OPCOUNT(OPCOUNT_FPADD);
+    fpadd751_kernel(a, b, c);
+}
+
+
+__inline void fpsub751(digit_t* a, digit_t* b, digit_t* c)
+{ // Modular subtraction, c = a-b mod p751. All the backends of a build share this kernel, so it is called directly.
+  // Inputs: a, b in [0, p751-1] 
+  // Output: c in [0, p751-1] 
+    OPCOUNT(OPCOUNT_FPSUB);
+    fpsub751_kernel(a, b, c);
+}
+
+
+void mp_mul(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords)
+{ // Multiprecision multiply, c = a*b, where lng(a) = lng(b) = nwords, using the selected field arithmetic backend.
+    OPCOUNT(OPCOUNT_MP_MUL);
+    fp_get_selected_arithmetic()->mp_mul(a, b, c, nwords);
+}
+
+
+void mp_sqr(digit_t* a, digit_t* c, unsigned int nwords)
+{ // Multiprecision squaring, c = a^2, where lng(a) = nwords, using the selected field arithmetic backend.
+    OPCOUNT(OPCOUNT_MP_MUL);
+    fp_get_selected_arithmetic()->mp_sqr(a, c, nwords);
+}
+
+
+void rdc_mont(dfelm_t ma, felm_t mc)
+{ // Montgomery reduction, mc = ma*R^-1 mod p751, where R = 2^768, using the selected field arithmetic backend.
+    OPCOUNT(OPCOUNT_RDC);
+    fp_get_selected_arithmetic()->rdc_mont(ma, mc);
+}
+
+
 void to_mont(felm_t a, felm_t mc)
 { // Conversion to Montgomery representation
   // mc = a*R^2*R^-1 mod p751 = a*R mod p751, where a in [0, p751-1]
@@ -182,7 +287,7 @@ static __inline void power2_setup(felm_t x, int mark)
 
 void fpmul751_mont(felm_t ma, felm_t mb, felm_t mc)
 { // 751-bit Comba multi-precision multiplication, c = a*b mod p751
-    dfelm_t temp = {0};
+    dfelm_t temp;                                  // Fully written by mp_mul()
 
     mp_mul(ma, mb, temp, NWORDS_FIELD);
     rdc_mont(temp, mc);
@@ -191,18 +296,66 @@ void fpmul751_mont(felm_t ma, felm_t mb, felm_t mc)
 
 void fpsqr751_mont(felm_t ma, felm_t mc)
 { // 751-bit Comba multi-precision squaring, c = a^2 mod p751
-    dfelm_t temp = {0};
+    dfelm_t temp;                                  // Fully written by mp_sqr()
 
-    mp_mul(ma, ma, temp, NWORDS_FIELD);
+    mp_sqr(ma, temp, NWORDS_FIELD);
     rdc_mont(temp, mc);
 }
 
 
-void fpinv751_mont(felm_t a)
+#if defined(LOW_MEMORY_SUPPORT)
+
+#define INV_WINDOW      3                           // Window width of the low-memory exponentiation, with a table of 2^(INV_WINDOW-1) odd powers
+
+static __inline unsigned int inv_exponent_bit(int k)
+{ // Bit k of the public exponent p751-2, which is p751 with bit 1 cleared since the lowest word of p751 is all ones
+    return (unsigned int)(p751[k >> 6] >> (k & 63)) & (unsigned int)(k != 1);
+}
+
+void fpinv751_mont_fermat(felm_t a)
+{// Field inversion using Montgomery arithmetic, a = a^-1*R mod p751
+ // Left-to-right sliding window exponentiation by p751-2 with a 4-entry table, t[i] = a^(2*i+1), instead of the fixed addition chain. 
+ // The exponent is public, so the scan depends only on p751.
+    felm_t t[1 << (INV_WINDOW-1)], tt;
+    unsigned int i, w, first = 1;
+    int k, l;
+
+    fpsqr751_mont(a, tt);
+    fpcopy751(a, t[0]);
+    for (i = 1; i < (1 << (INV_WINDOW-1)); i++) {
+        fpmul751_mont(t[i-1], tt, t[i]);
+    }
+
+    for (k = NBITS_FIELD-1; k >= 0; k--) {
+        if (inv_exponent_bit(k) == 0) {
+            if (!first) fpsqr751_mont(tt, tt);
+            continue;
+        }
+        l = (k >= INV_WINDOW-1) ? k-INV_WINDOW+1 : 0;   // Longest window k..l with at most INV_WINDOW bits that ends with a one
+        while (inv_exponent_bit(l) == 0) l++;
+        for (w = 0, i = k+1; i-- > (unsigned int)l; ) {
+            w = (w << 1) | inv_exponent_bit(i);
+        }
+        if (first) {
+            fpcopy751(t[w >> 1], tt);
+            first = 0;
+        } else {
+            for (i = 0; i < (unsigned int)(k-l+1); i++) fpsqr751_mont(tt, tt);
+            fpmul751_mont(t[w >> 1], tt, tt);
+        }
+        k = l;
+    }
+    fpcopy751(tt, a);
+}
+
+#elif !defined(_P503_)
+
+void fpinv751_mont_fermat(felm_t a)
 {// Field inversion using Montgomery arithmetic, a = a^-1*R mod p751
+ // Exponentiation by p751-2 with a fixed addition chain.
     felm_t t[27], tt;
     unsigned int i, j;
-    
+
     // Precomputed table
     fpsqr751_mont(a, tt);
     fpmul751_mont(a, tt, t[0]);
@@ -452,6 +605,286 @@ void fpinv751_mont(felm_t a)
     fpmul751_mont(t[25], tt, a);  
 }
 
+#else
+
+void fpinv751_mont_fermat(felm_t a)
+{// Field inversion using Montgomery arithmetic, a = a^-1*R mod p503
+ // Sliding window exponentiation by p503-2 with window width 5: after the first table entry, each pair of the chain squares 
+ // chain[k][0] times and multiplies by t[chain[k][1]] = a^(2*chain[k][1]+1). The 48 repeated steps cover the run of ones above 2^11.
+    static const unsigned char chain[42][2] = { 
+        {12, 12}, { 5, 11}, { 5, 10}, { 2,  0}, { 7,  1}, {11,  8}, { 3,  3}, { 8,  7}, { 4,  1}, {11,  8},
+        { 4,  3}, { 7,  6}, { 5,  7}, { 6, 14}, { 3,  2}, { 7, 14}, { 5, 14}, { 7,  9}, { 2,  0}, {12, 13},
+        { 5,  9}, { 6, 15}, { 4,  5}, { 6, 12}, { 8,  7}, { 6, 13}, { 4,  7}, { 7, 15}, { 5,  6}, { 5,  7},
+        { 8,  9}, { 5,  0}, { 8,  5}, { 5,  7}, { 5,  6}, { 8,  8}, { 9,  8}, { 3,  3}, { 6,  7}, { 2,  0},
+        {10, 10}, { 6, 15} };
+    felm_t t[16], tt;
+    unsigned int i, j;
+
+    // Precomputed table, t[i] = a^(2*i+1)
+    fpsqr751_mont(a, tt);
+    fpcopy751(a, t[0]);
+    for (i = 0; i < 15; i++) {
+        fpmul751_mont(t[i], tt, t[i+1]);
+    }
+
+    fpcopy751(t[0], tt);
+    for (j = 0; j < 42; j++) {
+        for (i = 0; i < chain[j][0]; i++) {
+            fpsqr751_mont(tt, tt);
+        }
+        fpmul751_mont(t[chain[j][1]], tt, tt);
+    }
+    for (j = 0; j < 48; j++) {
+        for (i = 0; i < 5; i++) fpsqr751_mont(tt, tt);
+        fpmul751_mont(t[15], tt, tt);
+    }
+    for (i = 0; i < 5; i++) fpsqr751_mont(tt, tt);
+    fpmul751_mont(t[14], tt, a);  
+}
+
+#endif
+
+
+#if defined(UINT128_SUPPORT)
+
+// Constant-time inversion with Bernstein-Yang divsteps ("Fast constant-time gcd computation and modular inversion", 2019). 
+// Integers are represented in radix 2^62 with NLIMBS62 signed 64-bit limbs: the low limbs are in [0, 2^62), the top limb carries the sign. 
+// Each round applies 62 divsteps to the low bits of (f, g) and then the resulting 2x2 transition matrix to the full f, g, d and e, 
+// with the invariants d*a = f*R^2 and e*a = g*R^2 (mod p). The number of rounds covers the divstep bound (49*d+57)/17 of the paper 
+// for d = NBITS_FIELD+1, after which g = 0, f = +-1 and d = +-R^2/a.
+
+#define NLIMBS62            ((NBITS_FIELD+61)/62)
+#define SAFEGCD_ROUNDS      (((49*(NBITS_FIELD+1)+57)/17)/62 + 1)
+#define MASK62              ((uint64_t)0x3FFFFFFFFFFFFFFF)
+
+#if !defined(_P503_)
+static const int64_t p751_s62[NLIMBS62] = { 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF,
+                                            0x0968549F878A8EEA, 0x26C684FDF31DB8FB, 0x1867D6EBE876DA95, 0x141172C95D20213A, 0x09F97BADC668562B, 0x3975507DC70384A4,
+                                            0x000000000000006F };
+#else
+static const int64_t p751_s62[NLIMBS62] = { 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x3FFFFFFFFFFFFFFF, 0x085BDA2211E7A0AB, 0x2FDB21EDF9F6BC4C,
+                                            0x1C6BDDA77A4D01B9, 0x19BD506047879811, 0x0000000000000040 };
+#endif
+
+typedef struct { int64_t u, v, q, r; } divstep_matrix;    // Transition matrix of 62 divsteps, 2^62*(f', g') = (u*f + v*g, q*f + r*g)
+
+
+static void felm_to_s62(felm_t a, int64_t* r)
+{ // Conversion of a field element to radix 2^62
+    unsigned int i, word, shift;
+    uint64_t x;
+
+    for (i = 0; i < NLIMBS62; i++) {
+        word = (62*i) / 64;
+        shift = (62*i) % 64;
+        x = 0;
+        if (word < NWORDS_FIELD) {
+            x = (uint64_t)a[word] >> shift;
+            if (shift > 2 && word+1 < NWORDS_FIELD) {
+                x |= (uint64_t)a[word+1] << (64 - shift);
+            }
+        }
+        r[i] = (int64_t)(x & MASK62);
+    }
+}
+
+
+static void s62_to_felm(int64_t* a, felm_t r)
+{ // Conversion of a normalized integer in radix 2^62 to a field element
+    unsigned int i, limb, shift;
+    uint64_t x;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        limb = (64*i) / 62;
+        shift = (64*i) % 62;
+        x = (uint64_t)a[limb] >> shift;
+        if (limb+1 < NLIMBS62) {
+            x |= (uint64_t)a[limb+1] << (62 - shift);
+        }
+        r[i] = (digit_t)x;
+    }
+}
+
+
+static int64_t divsteps_62(int64_t delta, uint64_t f, uint64_t g, divstep_matrix* t)
+{ // 62 divsteps on the low 64 bits of f (odd) and g, in constant time. Returns the updated delta.
+  // A divstep maps (delta, f, g) to (1-delta, g, (g-f)/2) if delta > 0 and g is odd, and to (1+delta, f, (g+(g mod 2)*f)/2) otherwise.
+    uint64_t u = 1, v = 0, q = 0, r = 1, c1, c2, c, x;
+    unsigned int i;
+
+    for (i = 0; i < 62; i++) {
+        c1 = (uint64_t)((-delta) >> 63);       // All ones if delta > 0
+        c2 = 0 - (g & 1);                       // All ones if g is odd
+        c = c1 & c2;
+        // If c, swap (f, g) to (g, -f) and negate delta
+        x = (f ^ g) & c; f ^= x; g ^= x; g = (g ^ c) - c;
+        x = (u ^ q) & c; u ^= x; q ^= x; q = (q ^ c) - c;
+        x = (v ^ r) & c; v ^= x; r ^= x; r = (r ^ c) - c;
+        delta = (delta ^ (int64_t)c) - (int64_t)c;
+        // If g is odd, add f, then halve g
+        g += f & c2;
+        q += u & c2;
+        r += v & c2;
+        g >>= 1;
+        u <<= 1;
+        v <<= 1;
+        delta += 1;
+    }
+    t->u = (int64_t)u; t->v = (int64_t)v; t->q = (int64_t)q; t->r = (int64_t)r;
+
+    return delta;
+}
+
+
+static void update_fg_62(int64_t* f, int64_t* g, divstep_matrix* t)
+{ // (f, g) = (u*f + v*g, q*f + r*g)/2^62, where the divisions are exact
+    sint128_t cf, cg;
+    unsigned int i;
+
+    cf = (sint128_t)t->u*f[0] + (sint128_t)t->v*g[0];
+    cg = (sint128_t)t->q*f[0] + (sint128_t)t->r*g[0];
+    cf >>= 62;
+    cg >>= 62;
+    for (i = 1; i < NLIMBS62; i++) {
+        cf += (sint128_t)t->u*f[i] + (sint128_t)t->v*g[i];
+        cg += (sint128_t)t->q*f[i] + (sint128_t)t->r*g[i];
+        f[i-1] = (int64_t)((uint64_t)cf & MASK62); cf >>= 62;
+        g[i-1] = (int64_t)((uint64_t)cg & MASK62); cg >>= 62;
+    }
+    f[NLIMBS62-1] = (int64_t)cf;
+    g[NLIMBS62-1] = (int64_t)cg;
+}
+
+
+static void update_de_62(int64_t* d, int64_t* e, divstep_matrix* t)
+{ // (d, e) = (u*d + v*e, q*d + r*e)/2^62 mod p751, where d, e in (-2*p751, p751) on input and output
+  // Multiples md, me of p751 are added to make the divisions exact, since p751 = -1 mod 2^62. Choosing them from the signs of d and e 
+  // keeps the outputs in range. 
+    int64_t sd = d[NLIMBS62-1] >> 63, se = e[NLIMBS62-1] >> 63, md, me;
+    sint128_t cd, ce;
+    unsigned int i;
+
+    md = (t->u & sd) + (t->v & se);
+    me = (t->q & sd) + (t->r & se);
+    cd = (sint128_t)t->u*d[0] + (sint128_t)t->v*e[0];
+    ce = (sint128_t)t->q*d[0] + (sint128_t)t->r*e[0];
+    md -= (int64_t)(((uint64_t)md - (uint64_t)cd) & MASK62);
+    me -= (int64_t)(((uint64_t)me - (uint64_t)ce) & MASK62);
+    cd += (sint128_t)p751_s62[0]*md;
+    ce += (sint128_t)p751_s62[0]*me;
+    cd >>= 62;
+    ce >>= 62;
+    for (i = 1; i < NLIMBS62; i++) {
+        cd += (sint128_t)t->u*d[i] + (sint128_t)t->v*e[i] + (sint128_t)p751_s62[i]*md;
+        ce += (sint128_t)t->q*d[i] + (sint128_t)t->r*e[i] + (sint128_t)p751_s62[i]*me;
+        d[i-1] = (int64_t)((uint64_t)cd & MASK62); cd >>= 62;
+        e[i-1] = (int64_t)((uint64_t)ce & MASK62); ce >>= 62;
+    }
+    d[NLIMBS62-1] = (int64_t)cd;
+    e[NLIMBS62-1] = (int64_t)ce;
+}
+
+
+static void normalize_62(int64_t* r, int64_t sign)
+{ // r = sign*r mod p751 in [0, p751-1], where r in (-2*p751, p751) and sign is 0 (r) or -1 (-r)
+    int64_t mask;
+    unsigned int i;
+
+    mask = r[NLIMBS62-1] >> 63;                 // r in (-p751, p751)
+    for (i = 0; i < NLIMBS62; i++) {
+        r[i] += p751_s62[i] & mask;
+    }
+    for (i = 0; i < NLIMBS62; i++) {
+        r[i] = (r[i] ^ sign) - sign;
+    }
+    for (i = 0; i < NLIMBS62-1; i++) {
+        r[i+1] += r[i] >> 62;
+        r[i] &= MASK62;
+    }
+    mask = r[NLIMBS62-1] >> 63;                 // r in [0, p751-1]
+    for (i = 0; i < NLIMBS62; i++) {
+        r[i] += p751_s62[i] & mask;
+    }
+    for (i = 0; i < NLIMBS62-1; i++) {
+        r[i+1] += r[i] >> 62;
+        r[i] &= MASK62;
+    }
+}
+
+
+void fpinv751_mont_safegcd(felm_t a)
+{ // Field inversion using Montgomery arithmetic, a = a^-1*R mod p751, with constant-time divsteps
+  // Starting with e = R^2 instead of 1 yields (a*R^-1)^-1*R = R^2/a directly.
+    int64_t f[NLIMBS62], g[NLIMBS62], d[NLIMBS62] = {0}, e[NLIMBS62], delta = 1;
+    divstep_matrix t;
+    unsigned int i;
+
+    for (i = 0; i < NLIMBS62; i++) {
+        f[i] = p751_s62[i];
+    }
+    felm_to_s62(a, g);
+    felm_to_s62((digit_t*)&Montgomery_R2, e);
+
+    for (i = 0; i < SAFEGCD_ROUNDS; i++) {
+        delta = divsteps_62(delta, (uint64_t)f[0], (uint64_t)g[0], &t);
+        update_fg_62(f, g, &t);
+        update_de_62(d, e, &t);
+    }
+
+    normalize_62(d, f[NLIMBS62-1] >> 63);       // f = +-1
+    s62_to_felm(d, a);
+
+    clear_words((void*)f, NBYTES_TO_NWORDS(sizeof(f)));
+    clear_words((void*)g, NBYTES_TO_NWORDS(sizeof(g)));
+    clear_words((void*)d, NBYTES_TO_NWORDS(sizeof(d)));
+    clear_words((void*)e, NBYTES_TO_NWORDS(sizeof(e)));
+    clear_words((void*)&t, NBYTES_TO_NWORDS(sizeof(t)));
+}
+
+#endif
+
+
+void fpinv751_mont(felm_t a)
+{ // Field inversion using Montgomery arithmetic, a = a^-1*R mod p751
+  // It uses the divstep inversion when 128-bit integers are available, and the exponentiation otherwise.
+    OPCOUNT(OPCOUNT_FPINV);
+#if defined(UINT128_SUPPORT)
+    fpinv751_mont_safegcd(a);
+#else
+    fpinv751_mont_fermat(a);
+#endif
+}
+
+
+void fpsqrt751_mont(felm_t a, felm_t c)
+{ // Square root candidate using Montgomery arithmetic, c = a^((p751+1)/4) = a^(2^370*3^239) mod p751
+  // c^2 = a if and only if a is a square in GF(p751).
+    felm_t t;
+    unsigned int i;
+
+    fpcopy751(a, c);
+    for (i = 0; i < OBOB_EXPON; i++) {
+        fpsqr751_mont(c, t);
+        fpmul751_mont(c, t, c);
+    }
+    for (i = 0; i < OALICE_BITS-2; i++) {
+        fpsqr751_mont(c, c);
+    }
+}
+
+
+bool fpequal751_non_constant_time(felm_t a, felm_t b)
+{ // Is a = b in GF(p751)? Not constant time, only to be used with public values
+    unsigned int i;
+
+    for (i = 0; i < NWORDS_FIELD; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 
 /***********************************************/
 /************* GF(p^2) FUNCTIONS ***************/
@@ -499,6 +932,20 @@ void fp2div2_751(f2elm_t a, f2elm_t c)
 
 
 void fp2sqr751_mont(f2elm_t a, f2elm_t c)
+{// GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2), using the selected field arithmetic backend
+    OPCOUNT(OPCOUNT_FP2SQR);
+    fp_get_selected_arithmetic()->fp2sqr(a, c);
+}
+
+
+void fp2mul751_mont(f2elm_t a, f2elm_t b, f2elm_t c)
+{// GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2), using the selected field arithmetic backend
+    OPCOUNT(OPCOUNT_FP2MUL);
+    fp_get_selected_arithmetic()->fp2mul(a, b, c);
+}
+
+
+void fp2sqr751_mont_default(f2elm_t a, f2elm_t c)
 {// GF(p751^2) squaring using Montgomery arithmetic, c = a^2 in GF(p751^2)
     felm_t t1, t2, t3;
 
@@ -510,34 +957,82 @@ void fp2sqr751_mont(f2elm_t a, f2elm_t c)
 }
 
 
-void fp2mul751_mont(f2elm_t a, f2elm_t b, f2elm_t c)
+void fp2mul751_mont_default(f2elm_t a, f2elm_t b, f2elm_t c)
 {// GF(p751^2) multiplication using Montgomery arithmetic, c = a*b in GF(p751^2)
-    felm_t t1, t2;
-    dfelm_t tt1, tt2, tt3; 
+    df2elm_t tt;
+
+    fp2mul751_unreduced(a, b, tt);                   // tt = a*b, unreduced
+    rdc_mont(tt[0], c[0]);                           // c[0] = a0*b0 - a1*b1
+    rdc_mont(tt[1], c[1]);                           // c[1] = (a0+a1)*(b0+b1) - a0*b0 - a1*b1 
+}
+
+
+void mp_dfadd751(dfelm_t a, dfelm_t b, dfelm_t c)
+{ // Double-precision addition modulo p751*2^768, c = a+b, where a, b, c in [0, p751*2^768)
+    unsigned int i, borrow;
     digit_t mask;
+
+    mp_add(a, b, c, 2*NWORDS_FIELD);                 // c = a+b < 2*p751*2^768, which fits in 2*NWORDS_FIELD words
+    borrow = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {             // c = c - p751*2^768, only the upper half is affected
+        SUBC(borrow, c[NWORDS_FIELD + i], ((digit_t*) p751)[i], borrow, c[NWORDS_FIELD + i]);
+    }
+    mask = 0 - (digit_t) borrow;                     // if c < 0 then mask = 0xFF..F, else if c >= 0 then mask = 0x00..0
+    borrow = 0;
+    for (i = 0; i < NWORDS_FIELD; i++) {             // c = c + (mask & p751*2^768)
+        ADDC(borrow, c[NWORDS_FIELD + i], ((digit_t*) p751)[i] & mask, borrow, c[NWORDS_FIELD + i]);
+    }
+}
+
+
+void mp_dfsub751(dfelm_t a, dfelm_t b, dfelm_t c)
+{ // Double-precision subtraction modulo p751*2^768, c = a-b, where a, b, c in [0, p751*2^768)
     unsigned int i, borrow;
+    digit_t mask;
 
-    mp_mul(a[0], b[0], tt1, NWORDS_FIELD);            // tt1 = a0*b0
-    mp_mul(a[1], b[1], tt2, NWORDS_FIELD);            // tt2 = a1*b1
-    mp_add(a[0], a[1], t1, NWORDS_FIELD);             // t1 = a0+a1
-    mp_add(b[0], b[1], t2, NWORDS_FIELD);             // t2 = b0+b1
-    borrow = mp_sub(tt1, tt2, tt3, 2 * NWORDS_FIELD); // tt3 = a0*b0 - a1*b1
-    mask = 0 - (digit_t) borrow;                      // if tt3 < 0 then mask = 0xFF..F, else if tt3 >= 0 then mask = 0x00..0
+    borrow = mp_sub(a, b, c, 2*NWORDS_FIELD);
+    mask = 0 - (digit_t) borrow;                     // if c < 0 then mask = 0xFF..F, else if c >= 0 then mask = 0x00..0
     borrow = 0;
-    for (i = 0; i < NWORDS_FIELD; i++) {             // tt3 = tt3 + (mask & 2^768*p751)
-        ADDC(
-            borrow,
-            tt3[NWORDS_FIELD + i],
-            ((digit_t*) p751)[i] & mask,
-            borrow,
-            tt3[NWORDS_FIELD+i]
-        );
+    for (i = 0; i < NWORDS_FIELD; i++) {             // c = c + (mask & p751*2^768)
+        ADDC(borrow, c[NWORDS_FIELD + i], ((digit_t*) p751)[i] & mask, borrow, c[NWORDS_FIELD + i]);
     }
-    rdc_mont(tt3, c[0]);                             // c[0] = a0*b0 - a1*b1
+}
+
+
+void fp2mul751_unreduced(f2elm_t a, f2elm_t b, df2elm_t c)
+{// GF(p751^2) multiplication without reduction, c = a*b, where a, b in [0, p751-1] and c in [0, p751*2^768)
+    felm_t t1, t2;
+    dfelm_t tt1, tt2;
+
+    mp_mul(a[0], b[0], tt1, NWORDS_FIELD);           // tt1 = a0*b0
+    mp_mul(a[1], b[1], tt2, NWORDS_FIELD);           // tt2 = a1*b1
+    mp_add(a[0], a[1], t1, NWORDS_FIELD);            // t1 = a0+a1
+    mp_add(b[0], b[1], t2, NWORDS_FIELD);            // t2 = b0+b1
+    mp_dfsub751(tt1, tt2, c[0]);                     // c[0] = a0*b0 - a1*b1
     mp_add(tt1, tt2, tt1, 2 * NWORDS_FIELD);         // tt1 = a0*b0 + a1*b1
-    mp_mul(t1, t2, tt2, NWORDS_FIELD);               // tt2 = (a0+a1)*(b0+b1)
-    mp_sub(tt2, tt1, tt2, 2 * NWORDS_FIELD);         // tt2 = (a0+a1)*(b0+b1) - a0*b0 - a1*b1 
-    rdc_mont(tt2, c[1]);                             // c[1] = (a0+a1)*(b0+b1) - a0*b0 - a1*b1 
+    mp_mul(t1, t2, c[1], NWORDS_FIELD);              // c[1] = (a0+a1)*(b0+b1)
+    mp_sub(c[1], tt1, c[1], 2 * NWORDS_FIELD);       // c[1] = (a0+a1)*(b0+b1) - a0*b0 - a1*b1 < 2*p751^2
+}
+
+
+void fp2dfadd751(df2elm_t a, df2elm_t b, df2elm_t c)
+{// GF(p751^2) double-precision addition without reduction, c = a+b
+    mp_dfadd751(a[0], b[0], c[0]);
+    mp_dfadd751(a[1], b[1], c[1]);
+}
+
+
+void fp2dfsub751(df2elm_t a, df2elm_t b, df2elm_t c)
+{// GF(p751^2) double-precision subtraction without reduction, c = a-b
+    mp_dfsub751(a[0], b[0], c[0]);
+    mp_dfsub751(a[1], b[1], c[1]);
+}
+
+
+void fp2rdc751(df2elm_t a, f2elm_t c)
+{// GF(p751^2) Montgomery reduction, c = a*R^-1 in GF(p751^2), where R = 2^768
+    rdc_mont(a[0], c[0]);
+    rdc_mont(a[1], c[1]);
 }
 
 
@@ -573,6 +1068,61 @@ void fp2inv751_mont(f2elm_t a)
 }
 
 
+bool fp2equal751_non_constant_time(f2elm_t a, f2elm_t b)
+{ // Is a = b in GF(p751^2)? Not constant time, only to be used with public values
+    return (fpequal751_non_constant_time(a[0], b[0]) && fpequal751_non_constant_time(a[1], b[1]));
+}
+
+
+bool fp2sqrt751_mont(f2elm_t a, f2elm_t c)
+{ // GF(p751^2) square root using Montgomery arithmetic, c = sqrt(a) = x0+i*x1 with x0^2-x1^2 = a0 and 2*x0*x1 = a1
+  // Returns false if a is not a square in GF(p751^2). The output is a deterministic function of a.
+  // Not constant time, only to be used with public values.
+    felm_t n, s, t, x0, t1;
+    felm_t zero = {0};
+
+    fpsqr751_mont(a[0], n);
+    fpsqr751_mont(a[1], t);
+    fpadd751(n, t, n);                      // n = a0^2+a1^2, a square in GF(p751) iff a is a square in GF(p751^2)
+    fpsqrt751_mont(n, s);
+    fpsqr751_mont(s, t);
+    if (!fpequal751_non_constant_time(t, n)) {
+        return false;
+    }
+
+    fpadd751(a[0], s, t);
+    fpdiv2_751(t, t);                       // t = (a0+s)/2
+    fpsqrt751_mont(t, x0);
+    fpsqr751_mont(x0, t1);
+    if (!fpequal751_non_constant_time(t1, t)) {
+        fpsub751(a[0], s, t);
+        fpdiv2_751(t, t);                   // t = (a0-s)/2
+        fpsqrt751_mont(t, x0);
+    }
+
+    if (fpequal751_non_constant_time(x0, zero)) {
+        // Then a1 = 0 and either sqrt(a0) or i*sqrt(-a0) lies in GF(p751)
+        fpsqrt751_mont(a[0], t);
+        fpsqr751_mont(t, t1);
+        if (fpequal751_non_constant_time(t1, a[0])) {
+            fpcopy751(t, c[0]);
+            fpzero751(c[1]);
+        } else {
+            fpsub751(zero, a[0], t);
+            fpsqrt751_mont(t, c[1]);
+            fpzero751(c[0]);
+        }
+        return true;
+    }
+
+    fpadd751(x0, x0, t);
+    fpinv751_mont(t);
+    fpmul751_mont(a[1], t, c[1]);           // x1 = a1/(2*x0)
+    fpcopy751(x0, c[0]);
+    return true;
+}
+
+
 void swap_points_basefield(
     point_basefield_proj_t P,
     point_basefield_proj_t Q,
@@ -16,23 +16,45 @@
 extern const uint64_t p751[NWORDS_FIELD];
 extern const uint64_t p751p1[NWORDS_FIELD]; 
 
+// Multiprecision multiplication selection
+#if (RADIX == 64)
+    #define mp_mul_generic       mp_mul_comba
+#else
+    #define mp_mul_generic       mp_mul_schoolbook
+#endif
 
-__inline void fpadd751(digit_t* a, digit_t* b, digit_t* c)
+// Field arithmetic backend of this implementation, see fp_get_arithmetic()
+static const FieldArithmetic fp_arithmetic_generic = { ARITHMETIC_GENERIC, fpadd751_generic, fpsub751_generic, mp_mul_generic, mp_sqr_comba, rdc751_generic, fp2mul751_mont_default, fp2sqr751_mont_default };
+
+
+CRYPTO_STATUS fp_get_arithmetic(ARITHMETIC_ID id, const FieldArithmetic** arithmetic)
+{ // Set "arithmetic" to the kernel table of the backend "id". Only the portable backend is available in this implementation.
+
+    if (arithmetic == NULL || id >= ARITHMETIC_END_OF_LIST) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (id != ARITHMETIC_DEFAULT && id != ARITHMETIC_GENERIC) {
+        return CRYPTO_ERROR_NOT_IMPLEMENTED;
+    }
+
+    *arithmetic = &fp_arithmetic_generic;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+void fpadd751_generic(digit_t* a, digit_t* b, digit_t* c)
 { // Modular addition, c = a+b mod p751.
   // Inputs: a, b in [0, p751-1] 
   // Output: c in [0, p751-1] 
-    unsigned int i, carry = 0;
-    digit_t mask;
+    unsigned int i, carry = 0, borrow = 0;
+    digit_t mask, sum;
 
-    for (i = 0; i < NWORDS_FIELD; i++) {
-        ADDC(carry, a[i], b[i], carry, c[i]); 
+    for (i = 0; i < NWORDS_FIELD; i++) {      // c = a+b-p751, a+b < 2*p751 does not overflow
+        ADDC(carry, a[i], b[i], carry, sum); 
+        SUBC(borrow, sum, ((digit_t*) p751)[i], borrow, c[i]); 
     }
-
-    carry = 0;
-    for (i = 0; i < NWORDS_FIELD; i++) {
-        SUBC(carry, c[i], ((digit_t*) p751)[i], carry, c[i]); 
-    }
-    mask = 0 - (digit_t)carry;
+    mask = 0 - (digit_t)borrow;
 
     carry = 0;
     for (i = 0; i < NWORDS_FIELD; i++) {
@@ -41,7 +63,7 @@ __inline void fpadd751(digit_t* a, digit_t* b, digit_t* c)
 } 
 
 
-__inline void fpsub751(digit_t* a, digit_t* b, digit_t* c)
+void fpsub751_generic(digit_t* a, digit_t* b, digit_t* c)
 { // Modular subtraction, c = a-b mod p751.
   // Inputs: a, b in [0, p751-1] 
   // Output: c in [0, p751-1] 
@@ -178,67 +200,70 @@ void mp_mul_comba(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords)
     c[(2 * nwords) - 1] = v; 
 }
 
+void mp_sqr_comba(digit_t* a, digit_t* c, unsigned int nwords)
+{ // Multiprecision comba squaring, c = a^2, where lng(a) = nwords.
+  // The cross products a[i]*a[j], i < j, of each column are computed once and their sum is doubled.
+    unsigned int i, j, k, carry = 0;
+    digit_t t = 0, u = 0, v = 0, ct, cu, cv, UV[2];
+
+    for (k = 0; k < 2*nwords-1; k++) {
+        ct = 0; cu = 0; cv = 0;
+        i = (k < nwords) ? 0 : k-nwords+1;
+        for (j = k-i; i < j; i++, j--) {
+            MUL(a[i], a[j], UV+1, UV[0]);
+            ADDC(0, UV[0], cv, carry, cv);
+            ADDC(carry, UV[1], cu, carry, cu);
+            ct += carry;
+        }
+        ct = (ct << 1) | (cu >> (RADIX-1));
+        cu = (cu << 1) | (cv >> (RADIX-1));
+        cv <<= 1;
+        if ((k & 1) == 0) {
+            MUL(a[k/2], a[k/2], UV+1, UV[0]);
+            ADDC(0, UV[0], cv, carry, cv);
+            ADDC(carry, UV[1], cu, carry, cu);
+            ct += carry;
+        }
+        ADDC(0, cv, v, carry, v);
+        ADDC(carry, cu, u, carry, u);
+        t += ct + carry;
+        c[k] = v;
+        v = u;
+        u = t;
+        t = 0;
+    }
+    c[2*nwords-1] = v;
+}
+
 
-void rdc_mont(dfelm_t ma, felm_t mc)
+void rdc751_generic(dfelm_t ma, felm_t mc)
 { // Optimized Montgomery reduction using comba and exploiting the special form of the prime p751.
   // mc = ma*mb*R^-1 mod p751, where ma,mb,mc in [0, p751-1] and R = 2^768.
   // ma and mb are assumed to be in Montgomery representation.
-    unsigned int i, j, carry, count = p751_ZERO_WORDS;
-    digit_t mask, UV[2], t = 0, u = 0, v = 0, z[NWORDS_FIELD + 1] = {0};
+  // The products by the p751_ZERO_WORDS least significant words of p751+1, which are zero, are skipped.
+    unsigned int i, j, carry;
+    digit_t mask, UV[2], t = 0, u = 0, v = 0, z[NWORDS_FIELD] = {0};
 
-    for (i = 0; i < NWORDS_FIELD; i++) {
-        for (j = 0; j < i; j++) {
-            if (j < (i-p751_ZERO_WORDS + 1)) { 
-                MUL(
-                    z[j],
-                    ((digit_t*) p751p1)[i - j],
-                    UV + 1,
-                    UV[0]
-                );
-                ADDC(0, UV[0], v, carry, v); 
-                ADDC(carry, UV[1], u, carry, u); 
-                t += carry; 
-            }
+    for (i = 0; i < 2*NWORDS_FIELD-1; i++) {
+        for (j = (i < NWORDS_FIELD) ? 0 : i-NWORDS_FIELD+1; j < NWORDS_FIELD && j + p751_ZERO_WORDS <= i; j++) {
+            MUL(z[j], ((digit_t*) p751p1)[i - j], UV + 1, UV[0]);
+            ADDC(0, UV[0], v, carry, v); 
+            ADDC(carry, UV[1], u, carry, u); 
+            t += carry;
         }
         ADDC(0, v, ma[i], carry, v); 
         ADDC(carry, u, 0, carry, u); 
         t += carry; 
-        z[i] = v;
-        v = u;
-        u = t;
-        t = 0;
-    }    
-
-    for (i = NWORDS_FIELD; i < 2 * NWORDS_FIELD - 1; i++) {
-        if (count > 0) {
-            count -= 1;
+        if (i < NWORDS_FIELD) {
+            z[i] = v;
+        } else {
+            z[i-NWORDS_FIELD] = v;
         }
-        for (j = i - NWORDS_FIELD + 1; j < NWORDS_FIELD; j++) {
-            if (j < (NWORDS_FIELD - count)) { 
-                MUL(
-                    z[j],
-                    ((digit_t*) p751p1)[i - j], 
-                    UV + 1,
-                    UV[0]
-                );
-                ADDC(0, UV[0], v, carry, v); 
-                ADDC(carry, UV[1], u, carry, u); 
-                t += carry;
-            }
-        }
-        ADDC(0, v, ma[i], carry, v); 
-        ADDC(carry, u, 0, carry, u); 
-        t += carry; 
-        z[i-NWORDS_FIELD] = v;
         v = u;
         u = t;
         t = 0;
     }
-    ADDC(0, v, ma[2 * NWORDS_FIELD - 1], carry, v); 
-    ADDC(carry, u, 0, carry, u); 
-    t += carry; 
-    z[NWORDS_FIELD - 1] = v;
-    z[NWORDS_FIELD] = u;
+    ADDC(0, v, ma[2*NWORDS_FIELD-1], carry, z[NWORDS_FIELD-1]); 
 
     // Final, constant-time subtraction     
     carry = mp_sub(z, (digit_t*) &p751, mc, NWORDS_FIELD);     // (carry, mc) = z - p751
@@ -10,37 +10,189 @@
 *********************************************************************************************/ 
 
 #include "SIDH_internal.h"
+#include <malloc.h>
 
-extern const unsigned int splits_Alice[MAX_Alice];
-extern const unsigned int splits_Bob[MAX_Bob];
+// The workspaces of the "_ws" functions must hold a kex_workspace
+typedef char kex_workspace_fits[(sizeof(kex_workspace) <= SIDH_WORKSPACE_BYTES) ? 1 : -1];
 
 
-CRYPTO_STATUS KeyGeneration_A(
+static void eval_isog(unsigned int degree, f2elm_t* coeff, point_proj_t P)
+{ // Evaluates the isogeny of degree 3 or 4 at P, where coeff holds the coefficients computed by get_3_isog() or get_4_isog()
+    if (degree == 4) {
+        eval_4_isog(P, coeff);
+    } else {
+        eval_3_isog(P, coeff);
+    }
+}
+
+
+static void traversal_eval(
+    PThreadTeam Team,
+    unsigned int degree,
+    f2elm_t* coeff,
+    point_proj_t* pts,
+    unsigned int npts,
+    point_proj_t phiP,
+    point_proj_t phiQ,
+    point_proj_t phiD
+) { // Evaluates the isogeny of degree 3 or 4 at the stored points pts[0],...,pts[npts-1] and, if phiP is not NULL, at phiP, phiQ and phiD.
+  // With a thread team, the calling thread only evaluates pts[npts-1], the next kernel point on the spine of the tree, and the team
+  // evaluates the other points while the caller goes on with the next multiplications. These points can only be accessed again 
+  // after the next call to this function or to thread_team_release().
+    point_proj* points[MAX_INT_POINTS_BOB + 3];
+    unsigned int i, n = 0;
+
+    if (Team != NULL) {
+        for (i = 0; i + 1 < npts; i++) {
+            points[n++] = pts[i];
+        }
+        if (phiP != NULL) {
+            points[n++] = phiP;
+            points[n++] = phiQ;
+            points[n++] = phiD;
+        }
+        thread_team_eval(Team, degree, coeff, points, n);
+        eval_isog(degree, coeff, pts[npts - 1]);
+        return;
+    }
+
+    for (i = 0; i < npts; i++) {
+        eval_isog(degree, coeff, pts[i]);
+    }
+    if (phiP != NULL) {
+        eval_isog(degree, coeff, phiP);
+        eval_isog(degree, coeff, phiQ);
+        eval_isog(degree, coeff, phiD);
+    }
+}
+
+
+#if !defined(_P503_)
+
+static void BigMont_precompute(keygen_precomp* Precomp, PCurveIsogenyStruct CurveIsogeny)
+{ // Computes BigMont's constants in Montgomery representation: A24 = (A+2)/4, with A = 4*A24-2, and the short Weierstrass form 
+  // y^2 = X^3+a*X+b of BigMont, with X = x+A/3 and a = 1-A^2/3, in which the fixed-base table of its generator is built
+    felm_t A, one, three, t0;
+
+    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, one);
+    fpzero751(t0);
+    t0[0] = (digit_t) CurveIsogeny->BigMont_A24;
+    to_mont(t0, Precomp->BigMont_A24);
+    fpadd751(Precomp->BigMont_A24, Precomp->BigMont_A24, A);
+    fpadd751(A, A, A);
+    fpsub751(A, one, A);
+    fpsub751(A, one, A);                                       // A = 4*A24-2
+    fpadd751(one, one, three);
+    fpadd751(three, one, three);
+    fpcopy751(three, t0);
+    fpinv751_mont(t0);
+    fpmul751_mont(A, t0, Precomp->BigMont_A3);                 // A/3
+    fpmul751_mont(A, Precomp->BigMont_A3, t0);
+    fpsub751(one, t0, Precomp->BigMont_a);                     // a = 1-A^2/3
+
+    // Generator G = (x,y) with x = BIGMONT_GENERATOR_X, mapped to (x+A/3,y)
+    fpzero751(t0);
+    t0[0] = BIGMONT_GENERATOR_X;
+    to_mont(t0, Precomp->BigMont_G->x);
+    fpadd751(Precomp->BigMont_G->x, A, t0);
+    fpmul751_mont(Precomp->BigMont_G->x, t0, t0);
+    fpadd751(t0, one, t0);
+    fpmul751_mont(Precomp->BigMont_G->x, t0, t0);              // y^2 = x^3+A*x^2+x
+    fpsqrt751_mont(t0, Precomp->BigMont_G->y);
+    fpadd751(Precomp->BigMont_G->x, Precomp->BigMont_A3, Precomp->BigMont_G->x);
+}
+
+#endif
+
+
+CRYPTO_STATUS keygen_precompute(PCurveIsogenyStruct CurveIsogeny)
+{ // Computes the inputs of Alice's and Bob's key generation that do not depend on the private keys: the generators PA and PB, 
+  // the projective x-coordinates of Alice's generators PA, QA and QA-PA, the images of Bob's generators PB, QB and QB-PB through 
+  // Alice's first 4-isogeny, and the base curve parameters, all in Montgomery representation, as well as BigMont's constants for SIDHp751. 
+  // They are stored in CurveIsogeny->KeyGenPrecomp.
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    keygen_precomp* Precomp = (keygen_precomp*)CurveIsogeny->KeyGenPrecomp;
+    point_proj_t phiP, phiQ, phiD;
+    f2elm_t Aout, Cout;
+
+    if (Precomp == NULL) {
+        Precomp = (keygen_precomp*) calloc(1, sizeof(keygen_precomp));
+        if (Precomp == NULL) {
+            return CRYPTO_ERROR_NO_MEMORY;
+        }
+        CurveIsogeny->KeyGenPrecomp = (void*)Precomp;
+    }
+
+    // Conversion of the generators to Montgomery representation:
+    to_mont((digit_t*) CurveIsogeny->PA, Precomp->PA->x);
+    to_mont(((digit_t*) CurveIsogeny->PA) + NWORDS_FIELD, Precomp->PA->y);
+    to_mont((digit_t*) CurveIsogeny->PB, Precomp->PB->x);
+    to_mont(((digit_t*) CurveIsogeny->PB) + NWORDS_FIELD, Precomp->PB->y);
+
+    // Extracting curve parameters A and C:
+    fp2zero751(Precomp->A); fp2zero751(Precomp->C);
+    fpcopy751(CurveIsogeny->A, Precomp->A[0]);
+    fpcopy751(CurveIsogeny->C, Precomp->C[0]);
+    to_mont(Precomp->A[0], Precomp->A[0]);
+    to_mont(Precomp->C[0], Precomp->C[0]);
+
+    // PA = (XPA:1), QA = (-XPA:1) and DA = (x(QA-PA),z(QA-PA)):
+    fp2zero751(phiP->X); fp2zero751(phiP->Z);
+    fp2zero751(phiD->X); fp2zero751(phiD->Z);
+    fpcopy751(Precomp->PA->x, phiP->X[0]);
+    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, phiP->Z[0]);
+    copy_words((digit_t*) phiP, (digit_t*) phiQ, 2 * 2 * pwords);
+    fpneg751(phiQ->X[0]);
+    distort_and_diff(phiP->X[0], phiD, CurveIsogeny);
+    copy_words((digit_t*) phiP, (digit_t*) Precomp->PAx, 2 * 2 * pwords);
+    copy_words((digit_t*) phiQ, (digit_t*) Precomp->QAx, 2 * 2 * pwords);
+    copy_words((digit_t*) phiD, (digit_t*) Precomp->DAx, 2 * 2 * pwords);
+
+    // PB = (XPB:1), QB = (-XPB:1) and DB = (x(QB-PB),z(QB-PB)), mapped through Alice's first 4-isogeny:
+    fp2zero751(phiP->X); fp2zero751(phiP->Z);
+    fp2zero751(phiD->X); fp2zero751(phiD->Z);
+    fpcopy751(Precomp->PB->x, phiP->X[0]);
+    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, phiP->Z[0]);
+    copy_words((digit_t*) phiP, (digit_t*) phiQ, 2 * 2 * pwords);
+    fpneg751(phiQ->X[0]);
+    distort_and_diff(phiP->X[0], phiD, CurveIsogeny);
+    first_4_isog(phiP, Precomp->A, Aout, Cout, CurveIsogeny);     
+    first_4_isog(phiQ, Precomp->A, Aout, Cout, CurveIsogeny);
+    first_4_isog(phiD, Precomp->A, Aout, Cout, CurveIsogeny);
+    copy_words((digit_t*) phiP, (digit_t*) Precomp->phiPB, 2 * 2 * pwords);
+    copy_words((digit_t*) phiQ, (digit_t*) Precomp->phiQB, 2 * 2 * pwords);
+    copy_words((digit_t*) phiD, (digit_t*) Precomp->phiDB, 2 * 2 * pwords);
+
+#if !defined(_P503_)
+    BigMont_precompute(Precomp, CurveIsogeny);
+#endif
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS KeyGeneration_A_setup(
     unsigned char* pPrivateKeyA,
-    unsigned char* pPublicKeyA,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    point_proj_t phiP,
+    point_proj_t phiQ,
+    point_proj_t phiD,
     PCurveIsogenyStruct CurveIsogeny
-) {
-  // Alice's key-pair generation
-  // It produces a private key pPrivateKeyA and computes the public key pPublicKeyA.
-  // The private key is an even integer in the range [2, oA-2], where oA = 2^372 (i.e., 372 bits in total). 
-  // The public key consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+) { // Alice's key-pair generation up to the isogeny tree traversal
+  // It produces a private key pPrivateKeyA and computes the kernel point R, and Bob's generators phiP, phiQ and phiD,
+  // all of them mapped through the first 4-isogeny to Alice's starting curve (A:C).
     unsigned int owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits), pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    point_basefield_t P;
-    point_proj_t R, phiP = {0}, phiQ = {0}, phiD = {0}, pts[MAX_INT_POINTS_ALICE];
-    publickey_t* PublicKeyA = (publickey_t*) pPublicKeyA;
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0; 
-    f2elm_t coeff[5], A = {0}, C = {0}, Aout, Cout;
+    keygen_precomp* Precomp = (keygen_precomp*)CurveIsogeny->KeyGenPrecomp;
     CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
 
-    if (
-        pPrivateKeyA == NULL ||
-        pPublicKeyA == NULL ||
-        is_CurveIsogenyStruct_null(CurveIsogeny)
-    ) {
-        return CRYPTO_ERROR_INVALID_PARAMETER;
-    }  
+    fp2zero751(phiP->X); fp2zero751(phiP->Z);
+    fp2zero751(phiQ->X); fp2zero751(phiQ->Z);
+    fp2zero751(phiD->X); fp2zero751(phiD->Z);
+    fp2zero751(A); fp2zero751(C);
 
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
     // Choose a random even number in the range [2, oA-2] as secret key for Alice
     Status = random_mod_order(
         (digit_t*) pPrivateKeyA,
@@ -55,18 +207,9 @@ CRYPTO_STATUS KeyGeneration_A(
         return Status;
     }
 
-    // Conversion of Alice's generators to Montgomery representation:
-    to_mont(
-        (digit_t*) CurveIsogeny->PA,
-        (digit_t*) P
-    );
-    to_mont(
-        ((digit_t*) CurveIsogeny->PA) + NWORDS_FIELD,
-        ((digit_t*) P) + NWORDS_FIELD
-    );
-
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_SCALAR_MULT);
     Status = secret_pt(
-        P, 
+        Precomp->PA, 
         (digit_t*) pPrivateKeyA,
         ALICE,
         R,
@@ -76,29 +219,48 @@ CRYPTO_STATUS KeyGeneration_A(
         clear_words((void*) pPrivateKeyA, owords);
         return Status;
     }
+    TRACE(CurveIsogeny, SIDH_TRACE_SCALAR_MULT, 0);
 
-    // // Copy X-coordinates from Bob's public parameters, set Z <- 1:
-    copy_words((digit_t*) CurveIsogeny->PB, (digit_t*) phiP, pwords);             
-    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, (digit_t*) phiP->Z);  
-    to_mont((digit_t*) phiP, (digit_t*) phiP);                                        
-    // QB = (-XPB:1):
-    copy_words((digit_t*) phiP, (digit_t*) phiQ, pwords);                             
-    fpneg751(phiQ->X[0]);   
-    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, (digit_t*) phiQ->Z); 
-    // DB = (x(QB-PB),z(QB-PB)):
-    distort_and_diff(phiP->X[0], phiD, CurveIsogeny);                               
-
-    // Extracting curve parameters A and C:
-    fpcopy751(CurveIsogeny->A, A[0]);                                               
-    fpcopy751(CurveIsogeny->C, C[0]);
-    to_mont(A[0], A[0]);
-    to_mont(C[0], C[0]);
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_TRAVERSAL);
+    // Bob's generators and the base curve parameters are fixed, their images through the first 4-isogeny are precomputed:
+    copy_words((digit_t*) Precomp->phiPB, (digit_t*) phiP, 2 * 2 * pwords);
+    copy_words((digit_t*) Precomp->phiQB, (digit_t*) phiQ, 2 * 2 * pwords);
+    copy_words((digit_t*) Precomp->phiDB, (digit_t*) phiD, 2 * 2 * pwords);
+    fp2copy751(Precomp->A, A);
+    fp2copy751(Precomp->C, C);
 
-    first_4_isog(phiP, A, Aout, Cout, CurveIsogeny);     
-    first_4_isog(phiQ, A, Aout, Cout, CurveIsogeny);
-    first_4_isog(phiD, A, Aout, Cout, CurveIsogeny);
     first_4_isog(R, A, A, C, CurveIsogeny);
+
+    return Status;
+}
+
+
+static CRYPTO_STATUS KeyGeneration_A_projective(
+    unsigned char* pPrivateKeyA,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t phiP,
+    point_proj_t phiQ,
+    point_proj_t phiD,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's key-pair generation up to the final normalization
+  // It produces a private key pPrivateKeyA and computes Alice's curve (A:C) together with the projective images phiP, phiQ
+  // and phiD of Bob's generators. The inversion of C, phiP->Z, phiQ->Z and phiD->Z is left to the caller.
+  // The kernel points and the isogeny coefficients are kept in ws, which is left to the caller to wipe.
+    point_proj* R = ws->R;
+    point_proj_t* pts = ws->pts;
+    unsigned int row, m, index = 0, *pts_index = ws->pts_index, npts = 0; 
+    PThreadTeam Team;
+    f2elm_t* coeff = ws->coeff;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    Status = KeyGeneration_A_setup(pPrivateKeyA, A, C, R, phiP, phiQ, phiD, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
     
+    Team = thread_team_acquire(CurveIsogeny);          // Parallel traversal if a thread team is available
     index = 0;        
     for (row = 1; row < MAX_Alice; row++) {
         while (index < MAX_Alice-row) {
@@ -106,80 +268,53 @@ CRYPTO_STATUS KeyGeneration_A(
             fp2copy751(R->Z, pts[npts]->Z);
             pts_index[npts] = index;
             npts += 1;
-            m = splits_Alice[MAX_Alice-index-row];
+            m = CurveIsogeny->StrategyAlice[MAX_Alice-index-row];
             xDBLe(R, R, A, C, (int)(2 * m));
             index += m;
         }
         get_4_isog(R, A, C, coeff);        
-
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
-        }
-        eval_4_isog(phiP, coeff);
-        eval_4_isog(phiQ, coeff);
-        eval_4_isog(phiD, coeff);
+        traversal_eval(Team, 4, coeff, pts, npts, phiP, phiQ, phiD);
 
         fp2copy751(pts[npts - 1]->X, R->X); 
         fp2copy751(pts[npts - 1]->Z, R->Z);
         index = pts_index[npts - 1];
         npts -= 1;
+        TRACE(CurveIsogeny, SIDH_TRACE_ROW, row);
     }
 
     get_4_isog(R, A, C, coeff); 
+    thread_team_release(Team);
     eval_4_isog(phiP, coeff);
     eval_4_isog(phiQ, coeff);
     eval_4_isog(phiD, coeff);
-
-    inv_4_way(C, phiP->Z, phiQ->Z, phiD->Z);
-    fp2mul751_mont(A, C, A);
-    fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
-    fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
-    fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
-
-    from_fp2mont(A, ((f2elm_t*) PublicKeyA)[0]);                                     // Converting back to standard representation
-    from_fp2mont(phiP->X, ((f2elm_t*) PublicKeyA)[1]);
-    from_fp2mont(phiQ->X, ((f2elm_t*) PublicKeyA)[2]);
-    from_fp2mont(phiD->X, ((f2elm_t*) PublicKeyA)[3]);
-
-// Cleanup:
-    clear_words((void*) R, 2 * 2 * pwords);
-    clear_words((void*) phiP, 2 * 2 * pwords);
-    clear_words((void*) phiQ, 2 * 2 * pwords);
-    clear_words((void*) phiD, 2 * 2 * pwords);
-    clear_words((void*) pts, MAX_INT_POINTS_ALICE * 2 * 2 * pwords);
-    clear_words((void*) A, 2 * pwords);
-    clear_words((void*) C, 2 * pwords);
-    clear_words((void*) coeff, 5 * 2 * pwords);
+    TRACE(CurveIsogeny, SIDH_TRACE_TRAVERSAL, 0);
       
     return Status;
 }
 
 
-CRYPTO_STATUS KeyGeneration_B(
+CRYPTO_STATUS KeyGeneration_B_setup(
     unsigned char* pPrivateKeyB,
-    unsigned char* pPublicKeyB,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    point_proj_t phiP,
+    point_proj_t phiQ,
+    point_proj_t phiD,
     PCurveIsogenyStruct CurveIsogeny
-) { // Bob's key-pair generation
-  // It produces a private key pPrivateKeyB and computes the public key pPublicKeyB.
-  // The private key is an integer in the range [1, oB-1], where oA = 3^239 (i.e., 379 bits in total). 
-  // The public key consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+) { // Bob's key-pair generation up to the isogeny tree traversal
+  // It produces a private key pPrivateKeyB and computes the kernel point R, Alice's generators phiP, phiQ and phiD,
+  // and the starting curve (A:C).
     unsigned int owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits), pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    point_basefield_t P;
-    point_proj_t R, phiP = {0}, phiQ = {0}, phiD = {0}, pts[MAX_INT_POINTS_BOB];
-    publickey_t* PublicKeyB = (publickey_t*)pPublicKeyB;
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0; 
-    f2elm_t A = {0}, C = {0};
+    keygen_precomp* Precomp = (keygen_precomp*)CurveIsogeny->KeyGenPrecomp;
     CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
 
-    if (
-        pPrivateKeyB == NULL ||
-        pPublicKeyB == NULL ||
-        is_CurveIsogenyStruct_null(CurveIsogeny)
-    ) {
-        return CRYPTO_ERROR_INVALID_PARAMETER;
-    }  
+    fp2zero751(phiP->X); fp2zero751(phiP->Z);
+    fp2zero751(phiQ->X); fp2zero751(phiQ->Z);
+    fp2zero751(phiD->X); fp2zero751(phiD->Z);
+    fp2zero751(A); fp2zero751(C);
 
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
     // Choose a random number equivalent to 0 (mod 3) in the range [3, oB-3] as secret key for Bob
     Status = random_mod_order(
         (digit_t*) pPrivateKeyB,
@@ -191,40 +326,52 @@ CRYPTO_STATUS KeyGeneration_B(
         return Status;
     }
 
-    // Conversion of Bob's generators to Montgomery representation:
-    to_mont(
-        (digit_t*) CurveIsogeny->PB,
-        (digit_t*) P
-    );
-    to_mont(
-        ((digit_t*) CurveIsogeny->PB) + NWORDS_FIELD, 
-        ((digit_t*) P) + NWORDS_FIELD
-    ); 
-
-    Status = secret_pt(P, (digit_t*) pPrivateKeyB, BOB, R, CurveIsogeny);
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_SCALAR_MULT);
+    Status = secret_pt(Precomp->PB, (digit_t*) pPrivateKeyB, BOB, R, CurveIsogeny);
     if (Status != CRYPTO_SUCCESS) {
         clear_words((void*) pPrivateKeyB, owords);
         return Status;
     }
+    TRACE(CurveIsogeny, SIDH_TRACE_SCALAR_MULT, 0);
 
-    // Copy X-coordinates from Alice's public parameters, set Z <- 1
-    copy_words((digit_t*) CurveIsogeny->PA, (digit_t*) phiP, pwords);                 
-    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, (digit_t*) phiP->Z);   
-    // Conversion to Montgomery representation
-    to_mont((digit_t*) phiP, (digit_t*) phiP);                                        
-    // QA = (-XPA:1)
-    copy_words((digit_t*) phiP, (digit_t*) phiQ, pwords);                             
-    fpneg751(phiQ->X[0]); 
-    fpcopy751((digit_t*) CurveIsogeny->Montgomery_one, (digit_t*) phiQ->Z);  
-    // DA = (x(QA-PA),z(QA-PA))
-    distort_and_diff(phiP->X[0], phiD, CurveIsogeny);                               
-
-    // Extracting curve parameters A and C
-    fpcopy751(CurveIsogeny->A, A[0]);                                               
-    fpcopy751(CurveIsogeny->C, C[0]);
-    to_mont(A[0], A[0]);
-    to_mont(C[0], C[0]);
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_TRAVERSAL);
+    // Alice's generators and the base curve parameters are fixed and precomputed:
+    copy_words((digit_t*) Precomp->PAx, (digit_t*) phiP, 2 * 2 * pwords);
+    copy_words((digit_t*) Precomp->QAx, (digit_t*) phiQ, 2 * 2 * pwords);
+    copy_words((digit_t*) Precomp->DAx, (digit_t*) phiD, 2 * 2 * pwords);
+    fp2copy751(Precomp->A, A);
+    fp2copy751(Precomp->C, C);
+
+    return Status;
+}
+
+
+static CRYPTO_STATUS KeyGeneration_B_projective(
+    unsigned char* pPrivateKeyB,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t phiP,
+    point_proj_t phiQ,
+    point_proj_t phiD,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's key-pair generation up to the final normalization
+  // It produces a private key pPrivateKeyB and computes Bob's curve (A:C) together with the projective images phiP, phiQ
+  // and phiD of Alice's generators. The inversion of C, phiP->Z, phiQ->Z and phiD->Z is left to the caller.
+  // The kernel points are kept in ws, which is left to the caller to wipe.
+    point_proj* R = ws->R;
+    point_proj_t* pts = ws->pts;
+    unsigned int row, m, index = 0, *pts_index = ws->pts_index, npts = 0; 
+    PThreadTeam Team;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    Status = KeyGeneration_B_setup(pPrivateKeyB, A, C, R, phiP, phiQ, phiD, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
     
+    get_A24_tpl(A, C, A, C);                           // Along the traversal, (A:C) holds the constants (A-2C:A+2C) of xTPL()
+    Team = thread_team_acquire(CurveIsogeny);          // Parallel traversal if a thread team is available
     index = 0;  
     for (row = 1; row < MAX_Bob; row++) {
         while (index < MAX_Bob-row) {
@@ -232,226 +379,1247 @@ CRYPTO_STATUS KeyGeneration_B(
             fp2copy751(R->Z, pts[npts]->Z);
             pts_index[npts] = index;
             npts += 1;
-            m = splits_Bob[MAX_Bob - index - row];
-            xTPLe(R, R, A, C, (int)m);
+            m = CurveIsogeny->StrategyBob[MAX_Bob - index - row];
+            xTPLe_A24(R, R, A, C, (int)m);
             index += m;
         }
-        get_3_isog(R, A, C);        
-
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(R, pts[i]);
-        }     
-        eval_3_isog(R, phiP);
-        eval_3_isog(R, phiQ);
-        eval_3_isog(R, phiD);
+        get_3_isog(R, A, C, ws->coeff);        
+        traversal_eval(Team, 3, ws->coeff, pts, npts, phiP, phiQ, phiD);
 
         fp2copy751(pts[npts - 1]->X, R->X); 
         fp2copy751(pts[npts - 1]->Z, R->Z);
         index = pts_index[npts - 1];
         npts -= 1;
+        TRACE(CurveIsogeny, SIDH_TRACE_ROW, row);
     }
     
-    get_3_isog(R, A, C);    
-    eval_3_isog(R, phiP);
-    eval_3_isog(R, phiQ);
-    eval_3_isog(R, phiD);
-
-    inv_4_way(C, phiP->Z, phiQ->Z, phiD->Z);
-    fp2mul751_mont(A, C, A);
-    fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
-    fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
-    fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
-
-    from_fp2mont(A, ((f2elm_t*) PublicKeyB)[0]);                                     // Converting back to standard representation
-    from_fp2mont(phiP->X, ((f2elm_t*) PublicKeyB)[1]);
-    from_fp2mont(phiQ->X, ((f2elm_t*) PublicKeyB)[2]);
-    from_fp2mont(phiD->X, ((f2elm_t*) PublicKeyB)[3]);
-
-// Cleanup:
-    clear_words((void*) R, 2 * 2 * pwords);
-    clear_words((void*) phiP, 2 * 2 * pwords);
-    clear_words((void*) phiQ, 2 * 2 * pwords);
-    clear_words((void*) phiD, 2 * 2 * pwords);
-    clear_words(
-        (void*) pts, 
-        MAX_INT_POINTS_BOB * 2 * 2 * pwords
-    );
-    clear_words((void*) A, 2 * pwords);
-    clear_words((void*) C, 2 * pwords);
+    get_3_isog(R, A, C, ws->coeff);    
+    thread_team_release(Team);
+    eval_3_isog(phiP, ws->coeff);
+    eval_3_isog(phiQ, ws->coeff);
+    eval_3_isog(phiD, ws->coeff);
+    get_A_tpl(A, C, A, C);
+    TRACE(CurveIsogeny, SIDH_TRACE_TRAVERSAL, 0);
       
     return Status;
 }
 
 
-CRYPTO_STATUS SecretAgreement_A(
+static CRYPTO_STATUS KeyGeneration_workspace(
+    unsigned char* pPrivateKey,
+    unsigned char* pPublicKey,
+    unsigned int AliceOrBob,
+    bool montgomery,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's (AliceOrBob = ALICE) or Bob's (AliceOrBob = BOB) key-pair generation
+  // The public key is written in Montgomery representation if "montgomery" is true, and in standard representation otherwise.
+  // All the intermediate values are kept in ws, which is left to the caller to wipe.
+    f2elm_t* PublicKey = (f2elm_t*) pPublicKey;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, (AliceOrBob == ALICE) ? SIDH_TRACE_KEYGEN_A : SIDH_TRACE_KEYGEN_B);
+    if (AliceOrBob == ALICE) {
+        Status = KeyGeneration_A_projective(pPrivateKey, ws->A, ws->C, ws->phiP, ws->phiQ, ws->phiD, ws, CurveIsogeny);
+    } else {
+        Status = KeyGeneration_B_projective(pPrivateKey, ws->A, ws->C, ws->phiP, ws->phiQ, ws->phiD, ws, CurveIsogeny);
+    }
+    if (Status == CRYPTO_SUCCESS) {
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_NORMALIZATION);
+        inv_4_way(ws->C, ws->phiP->Z, ws->phiQ->Z, ws->phiD->Z);
+        fp2mul751_mont(ws->A, ws->C, ws->A);
+        fp2mul751_mont(ws->phiP->X, ws->phiP->Z, ws->phiP->X);
+        fp2mul751_mont(ws->phiQ->X, ws->phiQ->Z, ws->phiQ->X);
+        fp2mul751_mont(ws->phiD->X, ws->phiD->Z, ws->phiD->X);
+
+        if (montgomery) {
+            fp2copy751(ws->A, PublicKey[0]);
+            fp2copy751(ws->phiP->X, PublicKey[1]);
+            fp2copy751(ws->phiQ->X, PublicKey[2]);
+            fp2copy751(ws->phiD->X, PublicKey[3]);
+        } else {
+            from_fp2mont(ws->A, PublicKey[0]);                                       // Converting back to standard representation
+            from_fp2mont(ws->phiP->X, PublicKey[1]);
+            from_fp2mont(ws->phiQ->X, PublicKey[2]);
+            from_fp2mont(ws->phiD->X, PublicKey[3]);
+        }
+        TRACE(CurveIsogeny, SIDH_TRACE_NORMALIZATION, 0);
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, (AliceOrBob == ALICE) ? SIDH_TRACE_KEYGEN_A : SIDH_TRACE_KEYGEN_B);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS KeyGeneration_A(
     unsigned char* pPrivateKeyA,
-    unsigned char* pPublicKeyB,
-    unsigned char* pSharedSecretA,
+    unsigned char* pPublicKeyA,
     PCurveIsogenyStruct CurveIsogeny
-) { // Alice's shared secret generation
-  // It produces a shared secret key pSharedSecretA using her secret key pPrivateKeyA and Bob's public key pPublicKeyB
-  // Inputs: Alice's pPrivateKeyA is an even integer in the range [2, oA-2], where oA = 2^372 (i.e., 372 bits in total). 
-  //         Bob's pPublicKeyB consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
-  // Output: a shared secret pSharedSecretA that consists of one element in GF(p751^2), i.e., 1502 bits in total. 
+) {
+  // Alice's key-pair generation
+  // It produces a private key pPrivateKeyA and computes the public key pPublicKeyA.
+  // The private key is an even integer in the range [2, oA-2], where oA = 2^372 (i.e., 372 bits in total). 
+  // The public key consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
   // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
-    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0; 
-    point_proj_t R, pts[MAX_INT_POINTS_ALICE];
-    publickey_t* PublicKeyB = (publickey_t*)pPublicKeyB;
-    f2elm_t jinv, coeff[5], A, C = {0}, PKB2, PKB3, PKB4;
-    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
 
     if (
         pPrivateKeyA == NULL ||
-        pPublicKeyB == NULL ||
-        pSharedSecretA == NULL ||
+        pPublicKeyA == NULL ||
         is_CurveIsogenyStruct_null(CurveIsogeny)
     ) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
-    }
+    }  
+    FIELD_DISPATCH(CurveIsogeny->pbits, KeyGeneration_A_p503(pPrivateKeyA, pPublicKeyA, CurveIsogeny));
 
-    to_fp2mont(((f2elm_t*) PublicKeyB)[0], A);         // Extracting and converting Bob's public curve parameters to Montgomery representation
-    to_fp2mont(((f2elm_t*) PublicKeyB)[1], PKB2);
-    to_fp2mont(((f2elm_t*) PublicKeyB)[2], PKB3);        
-    to_fp2mont(((f2elm_t*) PublicKeyB)[3], PKB4);
+    Status = KeyGeneration_workspace(pPrivateKeyA, pPublicKeyA, ALICE, false, &ws, CurveIsogeny);
 
-    fpcopy751(CurveIsogeny->C, C[0]);
-    to_mont(C[0], C[0]);
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
 
-    Status = ladder_3_pt(
-        PKB2, 
-        PKB3,
-        PKB4,
-        (digit_t*) pPrivateKeyA,
-        ALICE,
-        R,
-        A,
-        CurveIsogeny
-    );
-    if (Status != CRYPTO_SUCCESS) {
-        return Status;
-    }
-    first_4_isog(R, A, A, C, CurveIsogeny); 
-        
-    index = 0;  
-    for (row = 1; row < MAX_Alice; row++) {
-        while (index < MAX_Alice-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Alice[MAX_Alice - index - row];
-            xDBLe(R, R, A, C, (int)(2 * m));
-            index += m;
-        }
-        get_4_isog(R, A, C, coeff);        
 
-        for (i = 0; i < npts; i++) {
-            eval_4_isog(pts[i], coeff);
-        }
+CRYPTO_STATUS KeyGeneration_B(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyB,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's key-pair generation
+  // It produces a private key pPrivateKeyB and computes the public key pPublicKeyB.
+  // The private key is an integer in the range [1, oB-1], where oA = 3^239 (i.e., 379 bits in total). 
+  // The public key consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
 
-        fp2copy751(pts[npts - 1]->X, R->X); 
-        fp2copy751(pts[npts - 1]->Z, R->Z);
-        index = pts_index[npts - 1];
-        npts -= 1;
-    }
-    
-    get_4_isog(R, A, C, coeff); 
-    j_inv(A, C, jinv);
-    from_fp2mont(jinv, (felm_t*) pSharedSecretA);      // Converting back to standard representation
+    if (
+        pPrivateKeyB == NULL ||
+        pPublicKeyB == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
+    FIELD_DISPATCH(CurveIsogeny->pbits, KeyGeneration_B_p503(pPrivateKeyB, pPublicKeyB, CurveIsogeny));
+
+    Status = KeyGeneration_workspace(pPrivateKeyB, pPublicKeyB, BOB, false, &ws, CurveIsogeny);
 
 // Cleanup:
-    clear_words((void*) R, 2 * 2 * pwords);
-    clear_words(
-        (void*) pts,
-        MAX_INT_POINTS_ALICE * 2 * 2 * pwords
-    );
-    clear_words((void*) A, 2 * pwords);
-    clear_words((void*) C, 2 * pwords);
-    clear_words((void*) jinv, 2 * pwords);
-    clear_words((void*) coeff, 5 * 2 * pwords);
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
       
     return Status;
 }
 
 
-CRYPTO_STATUS SecretAgreement_B(
-    unsigned char* pPrivateKeyB,
+CRYPTO_STATUS KeyGeneration_A_ws(
+    unsigned char* pPrivateKeyA,
     unsigned char* pPublicKeyA,
-    unsigned char* pSharedSecretB,
+    void* Workspace,
     PCurveIsogenyStruct CurveIsogeny
-) { // Bob's shared secret generation
-  // It produces a shared secret key pSharedSecretB using his secret key pPrivateKeyB and Alice's public key pPublicKeyA
-  // Inputs: Bob's pPrivateKeyB is an integer in the range [1, oB-1], where oA = 3^239 (i.e., 379 bits in total). 
-  //         Alice's pPublicKeyA consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
-  // Output: a shared secret pSharedSecretB that consists of one element in GF(p751^2), i.e., 1502 bits in total. 
-  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
-    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
-    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0; 
-    point_proj_t R, pts[MAX_INT_POINTS_BOB];
-    publickey_t* PublicKeyA = (publickey_t*)pPublicKeyA;
-    f2elm_t jinv, A, C = {0}, PKA2, PKA3, PKA4;
-    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+) { // Alice's key-pair generation as in KeyGeneration_A(), with the intermediate values in Workspace, or in the workspace of the
+  // calling thread if it is NULL
+    kex_workspace* ws = (kex_workspace*) ((Workspace != NULL) ? Workspace : workspace_thread());
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
 
     if (
-        pPrivateKeyB == NULL ||
+        pPrivateKeyA == NULL ||
         pPublicKeyA == NULL ||
-        pSharedSecretB == NULL ||
         is_CurveIsogenyStruct_null(CurveIsogeny)
     ) {
         return CRYPTO_ERROR_INVALID_PARAMETER;
-    }
+    }  
+    FIELD_DISPATCH(CurveIsogeny->pbits, KeyGeneration_A_ws_p503(pPrivateKeyA, pPublicKeyA, Workspace, CurveIsogeny));
 
-    // Extracting and converting Alice's public curve parameters to Montgomery representation
-    to_fp2mont(((f2elm_t*) PublicKeyA)[0], A);         
-    to_fp2mont(((f2elm_t*) PublicKeyA)[1], PKA2);
-    to_fp2mont(((f2elm_t*) PublicKeyA)[2], PKA3);       
-    to_fp2mont(((f2elm_t*) PublicKeyA)[3], PKA4);
+    Status = KeyGeneration_workspace(pPrivateKeyA, pPublicKeyA, ALICE, false, ws, CurveIsogeny);
 
-    fpcopy751(CurveIsogeny->C, C[0]);
-    to_mont(C[0], C[0]);
+// Cleanup:
+    clear_words((void*) ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
 
-    Status = ladder_3_pt(PKA2, PKA3, PKA4, (digit_t*) pPrivateKeyB, BOB, R, A, CurveIsogeny);
-    if (Status != CRYPTO_SUCCESS) {
-        return Status;
-    }
-    
-    index = 0;  
-    for (row = 1; row < MAX_Bob; row++) {
-        while (index < MAX_Bob-row) {
-            fp2copy751(R->X, pts[npts]->X);
-            fp2copy751(R->Z, pts[npts]->Z);
-            pts_index[npts] = index;
-            npts += 1;
-            m = splits_Bob[MAX_Bob - index - row];
-            xTPLe(R, R, A, C, (int) m);
-            index += m;
-        }
-        get_3_isog(R, A, C);        
 
-        for (i = 0; i < npts; i++) {
-            eval_3_isog(R, pts[i]);
-        } 
+CRYPTO_STATUS KeyGeneration_B_ws(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyB,
+    void* Workspace,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's key-pair generation as in KeyGeneration_B(), with the intermediate values in Workspace, or in the workspace of the
+  // calling thread if it is NULL
+    kex_workspace* ws = (kex_workspace*) ((Workspace != NULL) ? Workspace : workspace_thread());
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    if (
+        pPrivateKeyB == NULL ||
+        pPublicKeyB == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
+    FIELD_DISPATCH(CurveIsogeny->pbits, KeyGeneration_B_ws_p503(pPrivateKeyB, pPublicKeyB, Workspace, CurveIsogeny));
+
+    Status = KeyGeneration_workspace(pPrivateKeyB, pPublicKeyB, BOB, false, ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+static CRYPTO_STATUS KeyGeneration_batch(
+    unsigned char* pPrivateKeys,
+    unsigned char* pPublicKeys,
+    unsigned int nkeys,
+    unsigned int AliceOrBob,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Batched key-pair generation shared by Alice and Bob
+  // It produces nkeys private keys at pPrivateKeys and computes the corresponding public keys at pPublicKeys.
+  // The final inversions of the nkeys key pairs are merged into a single simultaneous inversion of 4*nkeys elements.
+    unsigned int i, owords, pwords;
+    unsigned char *PrivateKey;
+    f2elm_t *A, *X, *Z, *t;
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS; 
+
+    if (
+        pPrivateKeys == NULL ||
+        pPublicKeys == NULL ||
+        nkeys == 0 ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, (AliceOrBob == ALICE) ? KeyGeneration_A_batch_p503(pPrivateKeys, pPublicKeys, nkeys, CurveIsogeny) : 
+                                                                KeyGeneration_B_batch_p503(pPrivateKeys, pPublicKeys, nkeys, CurveIsogeny));
+    owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits);
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+
+    // Per key: A, the 3 X-coordinates, and C and the 3 Z-coordinates to be inverted; plus scratch space for the inversion
+    A = (f2elm_t*) calloc(12 * (size_t)nkeys, sizeof(f2elm_t));
+    if (A == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    X = A + nkeys;
+    Z = X + 3 * nkeys;
+    t = Z + 4 * nkeys;
+
+    for (i = 0; i < nkeys && Status == CRYPTO_SUCCESS; i++) {
+        PrivateKey = pPrivateKeys + i * owords * sizeof(digit_t);
+#if defined(MULTIBUFFER_SUPPORT)
+        if (nkeys - i > 1) {                           // Groups of up to MB_LANES keys run in parallel
+            unsigned int nlanes = (nkeys - i < MB_LANES) ? (nkeys - i) : MB_LANES;
+            Status = KeyGeneration_projective_mb(PrivateKey, nlanes, AliceOrBob, &A[i], &X[3*i], &Z[4*i], CurveIsogeny);
+            i += nlanes - 1;
+            continue;
+        }
+#endif
+        if (AliceOrBob == ALICE) {
+            Status = KeyGeneration_A_projective(PrivateKey, A[i], Z[4*i], ws.phiP, ws.phiQ, ws.phiD, &ws, CurveIsogeny);
+        } else {
+            Status = KeyGeneration_B_projective(PrivateKey, A[i], Z[4*i], ws.phiP, ws.phiQ, ws.phiD, &ws, CurveIsogeny);
+        }
+        fp2copy751(ws.phiP->X, X[3*i]);
+        fp2copy751(ws.phiQ->X, X[3*i + 1]);
+        fp2copy751(ws.phiD->X, X[3*i + 2]);
+        fp2copy751(ws.phiP->Z, Z[4*i + 1]);
+        fp2copy751(ws.phiQ->Z, Z[4*i + 2]);
+        fp2copy751(ws.phiD->Z, Z[4*i + 3]);
+    }
+
+    if (Status == CRYPTO_SUCCESS) {
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_NORMALIZATION);
+        inv_n_way(Z, t, 4 * nkeys);
+
+        for (i = 0; i < nkeys; i++) {
+            f2elm_t* PublicKey = (f2elm_t*) (pPublicKeys + i * 4 * 2 * pwords * sizeof(digit_t));
+
+            fp2mul751_mont(A[i], Z[4*i], A[i]);
+            fp2mul751_mont(X[3*i], Z[4*i + 1], X[3*i]);
+            fp2mul751_mont(X[3*i + 1], Z[4*i + 2], X[3*i + 1]);
+            fp2mul751_mont(X[3*i + 2], Z[4*i + 3], X[3*i + 2]);
+
+            from_fp2mont(A[i], PublicKey[0]);                                        // Converting back to standard representation
+            from_fp2mont(X[3*i], PublicKey[1]);
+            from_fp2mont(X[3*i + 1], PublicKey[2]);
+            from_fp2mont(X[3*i + 2], PublicKey[3]);
+        }
+    } else {
+        clear_words((void*) pPrivateKeys, nkeys * owords);
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+    clear_words((void*) A, 12 * nkeys * 2 * pwords);
+    free(A);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS KeyGeneration_A_batch(
+    unsigned char* pPrivateKeysA,
+    unsigned char* pPublicKeysA,
+    unsigned int nkeys,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's batched key-pair generation
+  // It produces nkeys private keys pPrivateKeysA and computes the corresponding public keys pPublicKeysA.
+  // Keys are stored back to back, each one with the same format as in KeyGeneration_A(). The final inversions of all the key pairs 
+  // are shared through one simultaneous inversion.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return KeyGeneration_batch(pPrivateKeysA, pPublicKeysA, nkeys, ALICE, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS KeyGeneration_B_batch(
+    unsigned char* pPrivateKeysB,
+    unsigned char* pPublicKeysB,
+    unsigned int nkeys,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's batched key-pair generation
+  // It produces nkeys private keys pPrivateKeysB and computes the corresponding public keys pPublicKeysB.
+  // Keys are stored back to back, each one with the same format as in KeyGeneration_B(). The final inversions of all the key pairs 
+  // are shared through one simultaneous inversion.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return KeyGeneration_batch(pPrivateKeysB, pPublicKeysB, nkeys, BOB, CurveIsogeny);
+}
+
+
+static CRYPTO_STATUS SecretAgreement_A_setup_mont(
+    unsigned char* pPrivateKeyA,
+    f2elm_t* PKB,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation up to the isogeny tree traversal, from Bob's public key PKB in Montgomery representation
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    fp2copy751(PKB[0], A);
+    fp2zero751(C);
+    fpcopy751(CurveIsogeny->C, C[0]);
+    to_mont(C[0], C[0]);
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_SCALAR_MULT);
+    Status = ladder_3_pt(
+        PKB[1], 
+        PKB[2],
+        PKB[3],
+        (digit_t*) pPrivateKeyA,
+        ALICE,
+        R,
+        A,
+        CurveIsogeny
+    );
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    TRACE(CurveIsogeny, SIDH_TRACE_SCALAR_MULT, 0);
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_TRAVERSAL);
+    first_4_isog(R, A, A, C, CurveIsogeny); 
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_A_setup(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyB,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation up to the isogeny tree traversal
+  // It computes the kernel point R using her secret key pPrivateKeyA and Bob's public key pPublicKeyB, mapped through the first
+  // 4-isogeny to the starting curve (A:C).
+    publickey_t* PublicKeyB = (publickey_t*)pPublicKeyB;
+    f2elm_t PKB[4];
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+
+    to_fp2mont(((f2elm_t*) PublicKeyB)[0], PKB[0]);    // Extracting and converting Bob's public curve parameters to Montgomery representation
+    to_fp2mont(((f2elm_t*) PublicKeyB)[1], PKB[1]);
+    to_fp2mont(((f2elm_t*) PublicKeyB)[2], PKB[2]);        
+    to_fp2mont(((f2elm_t*) PublicKeyB)[3], PKB[3]);
+
+    return SecretAgreement_A_setup_mont(pPrivateKeyA, PKB, A, C, R, CurveIsogeny);
+}
+
+
+static void SecretAgreement_A_traversal(
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's isogeny tree traversal in the shared secret generation
+  // It computes the shared curve (A:C) from the kernel point R on the curve (A:C) produced by SecretAgreement_A_setup().
+  // The intermediate points and the isogeny coefficients are kept in ws, which is left to the caller to wipe.
+    unsigned int row, m, index = 0, *pts_index = ws->pts_index, npts = 0; 
+    PThreadTeam Team;
+    point_proj_t* pts = ws->pts;
+    f2elm_t* coeff = ws->coeff;
+        
+    Team = thread_team_acquire(CurveIsogeny);          // Parallel traversal if a thread team is available
+    index = 0;  
+    for (row = 1; row < MAX_Alice; row++) {
+        while (index < MAX_Alice-row) {
+            fp2copy751(R->X, pts[npts]->X);
+            fp2copy751(R->Z, pts[npts]->Z);
+            pts_index[npts] = index;
+            npts += 1;
+            m = CurveIsogeny->StrategyAlice[MAX_Alice - index - row];
+            xDBLe(R, R, A, C, (int)(2 * m));
+            index += m;
+        }
+        get_4_isog(R, A, C, coeff);        
+        traversal_eval(Team, 4, coeff, pts, npts, NULL, NULL, NULL);
 
         fp2copy751(pts[npts - 1]->X, R->X); 
         fp2copy751(pts[npts - 1]->Z, R->Z);
         index = pts_index[npts - 1];
         npts -= 1;
+        TRACE(CurveIsogeny, SIDH_TRACE_ROW, row);
     }
     
-    get_3_isog(R, A, C);    
-    j_inv(A, C, jinv);
-    from_fp2mont(jinv, (felm_t*) pSharedSecretB);      // Converting back to standard representation
+    get_4_isog(R, A, C, coeff); 
+    thread_team_release(Team);
+    TRACE(CurveIsogeny, SIDH_TRACE_TRAVERSAL, 0);
+}
+
+
+void SecretAgreement_A_isogeny(
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's isogeny tree traversal in the shared secret generation
+  // It computes the shared curve (A:C) from the kernel point R on the curve (A:C) produced by SecretAgreement_A_setup().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    kex_workspace ws;
+
+    SecretAgreement_A_traversal(A, C, R, &ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) ws.pts, MAX_INT_POINTS * 2 * 2 * pwords);
+    clear_words((void*) ws.coeff, 5 * 2 * pwords);
+}
+
+
+static CRYPTO_STATUS SecretAgreement_A_projective(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyB,
+    bool montgomery,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation up to the j-invariant computation
+  // It computes the shared curve (ws->A:ws->C) using her secret key pPrivateKeyA and Bob's public key pPublicKeyB, in Montgomery
+  // representation if "montgomery" is true and in standard representation otherwise.
+  // All the intermediate values are kept in ws, which is left to the caller to wipe.
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (montgomery) {
+        Status = SecretAgreement_A_setup_mont(pPrivateKeyA, (f2elm_t*) pPublicKeyB, ws->A, ws->C, ws->R, CurveIsogeny);
+    } else {
+        Status = SecretAgreement_A_setup(pPrivateKeyA, pPublicKeyB, ws->A, ws->C, ws->R, CurveIsogeny);
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    SecretAgreement_A_traversal(ws->A, ws->C, ws->R, ws, CurveIsogeny);
+      
+    return Status;
+}
+
+
+static CRYPTO_STATUS SecretAgreement_B_setup_mont(
+    unsigned char* pPrivateKeyB,
+    f2elm_t* PKA,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation up to the isogeny tree traversal, from Alice's public key PKA in Montgomery representation
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    fp2copy751(PKA[0], A);
+    fp2zero751(C);
+    fpcopy751(CurveIsogeny->C, C[0]);
+    to_mont(C[0], C[0]);
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_SCALAR_MULT);
+    Status = ladder_3_pt(PKA[1], PKA[2], PKA[3], (digit_t*) pPrivateKeyB, BOB, R, A, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_SCALAR_MULT, 0);
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_TRAVERSAL);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_B_setup(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyA,
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation up to the isogeny tree traversal
+  // It computes the kernel point R on the starting curve (A:C) using his secret key pPrivateKeyB and Alice's public key pPublicKeyA.
+    publickey_t* PublicKeyA = (publickey_t*)pPublicKeyA;
+    f2elm_t PKA[4];
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+
+    // Extracting and converting Alice's public curve parameters to Montgomery representation
+    to_fp2mont(((f2elm_t*) PublicKeyA)[0], PKA[0]);         
+    to_fp2mont(((f2elm_t*) PublicKeyA)[1], PKA[1]);
+    to_fp2mont(((f2elm_t*) PublicKeyA)[2], PKA[2]);       
+    to_fp2mont(((f2elm_t*) PublicKeyA)[3], PKA[3]);
+
+    return SecretAgreement_B_setup_mont(pPrivateKeyB, PKA, A, C, R, CurveIsogeny);
+}
+
+
+static void SecretAgreement_B_traversal(
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's isogeny tree traversal in the shared secret generation
+  // It computes the shared curve (A:C) from the kernel point R on the curve (A:C) produced by SecretAgreement_B_setup().
+  // The intermediate points are kept in ws, which is left to the caller to wipe.
+    unsigned int row, m, index = 0, *pts_index = ws->pts_index, npts = 0; 
+    PThreadTeam Team;
+    point_proj_t* pts = ws->pts;
+    
+    get_A24_tpl(A, C, A, C);                           // Along the traversal, (A:C) holds the constants (A-2C:A+2C) of xTPL()
+    Team = thread_team_acquire(CurveIsogeny);          // Parallel traversal if a thread team is available
+    index = 0;  
+    for (row = 1; row < MAX_Bob; row++) {
+        while (index < MAX_Bob-row) {
+            fp2copy751(R->X, pts[npts]->X);
+            fp2copy751(R->Z, pts[npts]->Z);
+            pts_index[npts] = index;
+            npts += 1;
+            m = CurveIsogeny->StrategyBob[MAX_Bob - index - row];
+            xTPLe_A24(R, R, A, C, (int) m);
+            index += m;
+        }
+        get_3_isog(R, A, C, ws->coeff);        
+        traversal_eval(Team, 3, ws->coeff, pts, npts, NULL, NULL, NULL);
+
+        fp2copy751(pts[npts - 1]->X, R->X); 
+        fp2copy751(pts[npts - 1]->Z, R->Z);
+        index = pts_index[npts - 1];
+        npts -= 1;
+        TRACE(CurveIsogeny, SIDH_TRACE_ROW, row);
+    }
+    
+    get_3_isog(R, A, C, ws->coeff);    
+    thread_team_release(Team);
+    get_A_tpl(A, C, A, C);
+    TRACE(CurveIsogeny, SIDH_TRACE_TRAVERSAL, 0);
+}
+
+
+void SecretAgreement_B_isogeny(
+    f2elm_t A,
+    f2elm_t C,
+    point_proj_t R,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's isogeny tree traversal in the shared secret generation
+  // It computes the shared curve (A:C) from the kernel point R on the curve (A:C) produced by SecretAgreement_B_setup().
+    unsigned int pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    kex_workspace ws;
+
+    SecretAgreement_B_traversal(A, C, R, &ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) ws.pts, MAX_INT_POINTS * 2 * 2 * pwords);
+    clear_words((void*) ws.coeff, 2 * 2 * pwords);
+}
+
+
+static CRYPTO_STATUS SecretAgreement_B_projective(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyA,
+    bool montgomery,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation up to the j-invariant computation
+  // It computes the shared curve (ws->A:ws->C) using his secret key pPrivateKeyB and Alice's public key pPublicKeyA, in Montgomery
+  // representation if "montgomery" is true and in standard representation otherwise.
+  // All the intermediate values are kept in ws, which is left to the caller to wipe.
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (montgomery) {
+        Status = SecretAgreement_B_setup_mont(pPrivateKeyB, (f2elm_t*) pPublicKeyA, ws->A, ws->C, ws->R, CurveIsogeny);
+    } else {
+        Status = SecretAgreement_B_setup(pPrivateKeyB, pPublicKeyA, ws->A, ws->C, ws->R, CurveIsogeny);
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    SecretAgreement_B_traversal(ws->A, ws->C, ws->R, ws, CurveIsogeny);
+      
+    return Status;
+}
+
+
+static CRYPTO_STATUS SecretAgreement_workspace(
+    unsigned char* pPrivateKey,
+    unsigned char* pPublicKey,
+    unsigned char* pSharedSecret,
+    unsigned int AliceOrBob,
+    bool montgomery,
+    kex_workspace* ws,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's (AliceOrBob = ALICE) or Bob's (AliceOrBob = BOB) shared secret generation
+  // The public key is in Montgomery representation if "montgomery" is true, and in standard representation otherwise.
+  // All the intermediate values are kept in ws, which is left to the caller to wipe.
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, (AliceOrBob == ALICE) ? SIDH_TRACE_SHARED_A : SIDH_TRACE_SHARED_B);
+    if (AliceOrBob == ALICE) {
+        Status = SecretAgreement_A_projective(pPrivateKey, pPublicKey, montgomery, ws, CurveIsogeny);
+    } else {
+        Status = SecretAgreement_B_projective(pPrivateKey, pPublicKey, montgomery, ws, CurveIsogeny);
+    }
+    if (Status == CRYPTO_SUCCESS) {
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+        if (!j_inv_checked(ws->A, ws->C, ws->jinv)) {    // Singular shared curve, the secret is zeroed as in SecretAgreement_batch()
+            Status = CRYPTO_ERROR_SHARED_KEY;
+        }
+        from_fp2mont(ws->jinv, (felm_t*) pSharedSecret);  // Converting back to standard representation
+        TRACE(CurveIsogeny, SIDH_TRACE_JINV, 0);
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, (AliceOrBob == ALICE) ? SIDH_TRACE_SHARED_A : SIDH_TRACE_SHARED_B);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_A(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyB,
+    unsigned char* pSharedSecretA,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation
+  // It produces a shared secret key pSharedSecretA using her secret key pPrivateKeyA and Bob's public key pPublicKeyB
+  // Inputs: Alice's pPrivateKeyA is an even integer in the range [2, oA-2], where oA = 2^372 (i.e., 372 bits in total). 
+  //         Bob's pPublicKeyB consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
+  // Output: a shared secret pSharedSecretA that consists of one element in GF(p751^2), i.e., 1502 bits in total. 
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKeyA == NULL ||
+        pPublicKeyB == NULL ||
+        pSharedSecretA == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SecretAgreement_A_p503(pPrivateKeyA, pPublicKeyB, pSharedSecretA, CurveIsogeny));
+
+    Status = SecretAgreement_workspace(pPrivateKeyA, pPublicKeyB, pSharedSecretA, ALICE, false, &ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_A_ws(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyB,
+    unsigned char* pSharedSecretA,
+    void* Workspace,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation as in SecretAgreement_A(), with the intermediate values in Workspace, or in the workspace 
+  // of the calling thread if it is NULL
+    kex_workspace* ws = (kex_workspace*) ((Workspace != NULL) ? Workspace : workspace_thread());
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKeyA == NULL ||
+        pPublicKeyB == NULL ||
+        pSharedSecretA == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SecretAgreement_A_ws_p503(pPrivateKeyA, pPublicKeyB, pSharedSecretA, Workspace, CurveIsogeny));
+
+    Status = SecretAgreement_workspace(pPrivateKeyA, pPublicKeyB, pSharedSecretA, ALICE, false, ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_B(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyA,
+    unsigned char* pSharedSecretB,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation
+  // It produces a shared secret key pSharedSecretB using his secret key pPrivateKeyB and Alice's public key pPublicKeyA
+  // Inputs: Bob's pPrivateKeyB is an integer in the range [1, oB-1], where oA = 3^239 (i.e., 379 bits in total). 
+  //         Alice's pPublicKeyA consists of 4 elements in GF(p751^2), i.e., 751 bytes in total.
+  // Output: a shared secret pSharedSecretB that consists of one element in GF(p751^2), i.e., 1502 bits in total. 
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKeyB == NULL ||
+        pPublicKeyA == NULL ||
+        pSharedSecretB == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SecretAgreement_B_p503(pPrivateKeyB, pPublicKeyA, pSharedSecretB, CurveIsogeny));
+
+    Status = SecretAgreement_workspace(pPrivateKeyB, pPublicKeyA, pSharedSecretB, BOB, false, &ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_B_ws(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyA,
+    unsigned char* pSharedSecretB,
+    void* Workspace,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation as in SecretAgreement_B(), with the intermediate values in Workspace, or in the workspace 
+  // of the calling thread if it is NULL
+    kex_workspace* ws = (kex_workspace*) ((Workspace != NULL) ? Workspace : workspace_thread());
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKeyB == NULL ||
+        pPublicKeyA == NULL ||
+        pSharedSecretB == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SecretAgreement_B_ws_p503(pPrivateKeyB, pPublicKeyA, pSharedSecretB, Workspace, CurveIsogeny));
+
+    Status = SecretAgreement_workspace(pPrivateKeyB, pPublicKeyA, pSharedSecretB, BOB, false, ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS tagged_pk_format(
+    unsigned char* pPublicKey,
+    bool* montgomery,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Reads the format byte of the tagged public key pPublicKey, and sets montgomery = true if its elements are in Montgomery representation
+  // Elements in Montgomery representation are checked to be in [0, p751-1], since they are not reduced by the conversion.
+    unsigned int i, pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    felm_t t;
+
+    switch (pPublicKey[sizeof(publickey_t)]) {
+    case SIDH_PK_FORMAT_STANDARD:
+        *montgomery = false;
+        return CRYPTO_SUCCESS;
+    case SIDH_PK_FORMAT_MONTGOMERY:
+        for (i = 0; i < 4 * 2; i++) {
+            if (mp_sub(((felm_t*) pPublicKey)[i], CurveIsogeny->prime, t, pwords) == 0) {   // No borrow if the element is >= p751
+                return CRYPTO_ERROR_INVALID_PARAMETER;
+            }
+        }
+        *montgomery = true;
+        return CRYPTO_SUCCESS;
+    default:
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+}
+
+
+static CRYPTO_STATUS KeyGeneration_tagged(
+    unsigned char* pPrivateKey,
+    unsigned char* pPublicKey,
+    unsigned char format,
+    unsigned int AliceOrBob,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's (AliceOrBob = ALICE) or Bob's (AliceOrBob = BOB) key-pair generation with a tagged public key in the given format
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN; 
+
+    if (
+        pPrivateKey == NULL ||
+        pPublicKey == NULL ||
+        (format != SIDH_PK_FORMAT_STANDARD && format != SIDH_PK_FORMAT_MONTGOMERY) ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }  
+    FIELD_DISPATCH(CurveIsogeny->pbits, (AliceOrBob == ALICE) ? KeyGeneration_A_tagged_p503(pPrivateKey, pPublicKey, format, CurveIsogeny) : 
+                                                                KeyGeneration_B_tagged_p503(pPrivateKey, pPublicKey, format, CurveIsogeny));
+
+    Status = KeyGeneration_workspace(pPrivateKey, pPublicKey, AliceOrBob, (format == SIDH_PK_FORMAT_MONTGOMERY), &ws, CurveIsogeny);
+    pPublicKey[sizeof(publickey_t)] = format;
+
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS KeyGeneration_A_tagged(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyA,
+    unsigned char format,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's key-pair generation as in KeyGeneration_A(), followed by the format byte of the public key
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return KeyGeneration_tagged(pPrivateKeyA, pPublicKeyA, format, ALICE, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS KeyGeneration_B_tagged(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyB,
+    unsigned char format,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's key-pair generation as in KeyGeneration_B(), followed by the format byte of the public key
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return KeyGeneration_tagged(pPrivateKeyB, pPublicKeyB, format, BOB, CurveIsogeny);
+}
+
+
+static CRYPTO_STATUS SecretAgreement_tagged(
+    unsigned char* pPrivateKey,
+    unsigned char* pPublicKey,
+    unsigned char* pSharedSecret,
+    unsigned int AliceOrBob,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's (AliceOrBob = ALICE) or Bob's (AliceOrBob = BOB) shared secret generation from a tagged public key in any format
+    kex_workspace ws;
+    bool montgomery = false;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKey == NULL ||
+        pPublicKey == NULL ||
+        pSharedSecret == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, (AliceOrBob == ALICE) ? SecretAgreement_A_tagged_p503(pPrivateKey, pPublicKey, pSharedSecret, CurveIsogeny) : 
+                                                                SecretAgreement_B_tagged_p503(pPrivateKey, pPublicKey, pSharedSecret, CurveIsogeny));
+
+    Status = tagged_pk_format(pPublicKey, &montgomery, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = SecretAgreement_workspace(pPrivateKey, pPublicKey, pSharedSecret, AliceOrBob, montgomery, &ws, CurveIsogeny);
+
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+      
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_A_tagged(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyB,
+    unsigned char* pSharedSecretA,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation as in SecretAgreement_A(), from Bob's tagged public key pPublicKeyB in any format
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return SecretAgreement_tagged(pPrivateKeyA, pPublicKeyB, pSharedSecretA, ALICE, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS SecretAgreement_B_tagged(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyA,
+    unsigned char* pSharedSecretB,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation as in SecretAgreement_B(), from Alice's tagged public key pPublicKeyA in any format
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return SecretAgreement_tagged(pPrivateKeyB, pPublicKeyA, pSharedSecretB, BOB, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS PublicKey_set_format(
+    unsigned char* pPublicKey,
+    unsigned char format,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Converts the tagged public key pPublicKey, of Alice or Bob, to the given format in place
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    f2elm_t* PublicKey = (f2elm_t*) pPublicKey;
+    unsigned int i;
+    bool montgomery = false;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPublicKey == NULL ||
+        (format != SIDH_PK_FORMAT_STANDARD && format != SIDH_PK_FORMAT_MONTGOMERY) ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, PublicKey_set_format_p503(pPublicKey, format, CurveIsogeny));
+
+    Status = tagged_pk_format(pPublicKey, &montgomery, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS || montgomery == (format == SIDH_PK_FORMAT_MONTGOMERY)) {
+        return Status;
+    }
+    for (i = 0; i < 4; i++) {
+        if (montgomery) {
+            from_fp2mont(PublicKey[i], PublicKey[i]);
+        } else {
+            to_fp2mont(PublicKey[i], PublicKey[i]);
+        }
+    }
+    pPublicKey[sizeof(publickey_t)] = format;
+
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SecretAgreement_A_validated(
+    unsigned char* pPrivateKeyA,
+    unsigned char* pPublicKeyB,
+    unsigned char* pSharedSecretA,
+    bool* valid,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's shared secret generation from Bob's public key, validated in the same pass
+  // It validates pPublicKeyB as Validate_PKB() and, only if it is valid, produces the shared secret pSharedSecretA as
+  // SecretAgreement_A(). The public key is converted to Montgomery representation once for both. If the key is invalid, 
+  // pSharedSecretA is zeroed.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords;
+    f2elm_t PK[4], jinv, A, C;
+    point_proj_t R;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKeyA == NULL ||
+        pPublicKeyB == NULL ||
+        pSharedSecretA == NULL ||
+        valid == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SecretAgreement_A_validated_p503(pPrivateKeyA, pPublicKeyB, pSharedSecretA, valid, CurveIsogeny));
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    *valid = false;
+    clear_words((void*)pSharedSecretA, 2 * pwords);
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    to_fp2mont(((f2elm_t*) pPublicKeyB)[0], PK[0]);  // Converting Bob's public key to Montgomery representation
+    to_fp2mont(((f2elm_t*) pPublicKeyB)[1], PK[1]);
+    to_fp2mont(((f2elm_t*) pPublicKeyB)[2], PK[2]);
+    to_fp2mont(((f2elm_t*) pPublicKeyB)[3], PK[3]);
+
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_B);
+    Status = validate_PKB_mont(PK, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_B);
+    if (Status != CRYPTO_SUCCESS || *valid == false) {
+        return Status;
+    }
+
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_SHARED_A);
+    Status = SecretAgreement_A_setup_mont(pPrivateKeyA, PK, A, C, R, CurveIsogeny);
+    if (Status == CRYPTO_SUCCESS) {
+        SecretAgreement_A_isogeny(A, C, R, CurveIsogeny);
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+        if (!j_inv_checked(A, C, jinv)) {              // Singular shared curve, the secret is zeroed as in SecretAgreement_batch()
+            Status = CRYPTO_ERROR_SHARED_KEY;
+        }
+        from_fp2mont(jinv, (felm_t*) pSharedSecretA);  // Converting back to standard representation
+        TRACE(CurveIsogeny, SIDH_TRACE_JINV, 0);
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_SHARED_A);
 
 // Cleanup:
     clear_words((void*) R, 2 * 2 * pwords);
-    clear_words(
-        (void*) pts,
-        MAX_INT_POINTS_BOB * 2 * 2 * pwords
-    );
     clear_words((void*) A, 2 * pwords);
     clear_words((void*) C, 2 * pwords);
     clear_words((void*) jinv, 2 * pwords);
       
     return Status;
 }
+
+
+CRYPTO_STATUS SecretAgreement_B_validated(
+    unsigned char* pPrivateKeyB,
+    unsigned char* pPublicKeyA,
+    unsigned char* pSharedSecretB,
+    bool* valid,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's shared secret generation from Alice's public key, validated in the same pass
+  // It validates pPublicKeyA as Validate_PKA() and, only if it is valid, produces the shared secret pSharedSecretB as
+  // SecretAgreement_B(). The public key is converted to Montgomery representation once for both. If the key is invalid, 
+  // pSharedSecretB is zeroed.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+    unsigned int pwords;
+    f2elm_t PK[4], jinv, A, C;
+    point_proj_t R;
+    CRYPTO_STATUS Status = CRYPTO_ERROR_UNKNOWN;  
+
+    if (
+        pPrivateKeyB == NULL ||
+        pPublicKeyA == NULL ||
+        pSharedSecretB == NULL ||
+        valid == NULL ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SecretAgreement_B_validated_p503(pPrivateKeyB, pPublicKeyA, pSharedSecretB, valid, CurveIsogeny));
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    *valid = false;
+    clear_words((void*)pSharedSecretB, 2 * pwords);
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    to_fp2mont(((f2elm_t*) pPublicKeyA)[0], PK[0]);  // Converting Alice's public key to Montgomery representation
+    to_fp2mont(((f2elm_t*) pPublicKeyA)[1], PK[1]);
+    to_fp2mont(((f2elm_t*) pPublicKeyA)[2], PK[2]);
+    to_fp2mont(((f2elm_t*) pPublicKeyA)[3], PK[3]);
+
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_A);
+    Status = validate_PKA_mont(PK, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_A);
+    if (Status != CRYPTO_SUCCESS || *valid == false) {
+        return Status;
+    }
+
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_SHARED_B);
+    Status = SecretAgreement_B_setup_mont(pPrivateKeyB, PK, A, C, R, CurveIsogeny);
+    if (Status == CRYPTO_SUCCESS) {
+        SecretAgreement_B_isogeny(A, C, R, CurveIsogeny);
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+        if (!j_inv_checked(A, C, jinv)) {              // Singular shared curve, the secret is zeroed as in SecretAgreement_batch()
+            Status = CRYPTO_ERROR_SHARED_KEY;
+        }
+        from_fp2mont(jinv, (felm_t*) pSharedSecretB);  // Converting back to standard representation
+        TRACE(CurveIsogeny, SIDH_TRACE_JINV, 0);
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_SHARED_B);
+
+// Cleanup:
+    clear_words((void*) R, 2 * 2 * pwords);
+    clear_words((void*) A, 2 * pwords);
+    clear_words((void*) C, 2 * pwords);
+    clear_words((void*) jinv, 2 * pwords);
+      
+    return Status;
+}
+
+
+static CRYPTO_STATUS SecretAgreement_batch(
+    unsigned char* pPrivateKeys,
+    unsigned char* pPublicKeys,
+    unsigned char* pSharedSecrets,
+    CRYPTO_STATUS* pStatuses,
+    unsigned int nkeys,
+    unsigned int AliceOrBob,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Batched shared secret generation shared by Alice and Bob
+  // It computes nkeys shared secrets at pSharedSecrets from the private keys at pPrivateKeys and the public keys at pPublicKeys.
+  // The inversions required by the nkeys j-invariant computations are merged into a single simultaneous inversion.
+  // A shared curve with a zero j-invariant denominator, e.g., from a crafted public key, does not spoil the other secrets: its 
+  // secret is zeroed, its entry in pStatuses (if not NULL) is set to CRYPTO_ERROR_SHARED_KEY and so is the returned status.
+    unsigned int i, j, owords, pwords;
+    unsigned char *PrivateKey, *PublicKey;
+    f2elm_t *jnum, *jden, *t;
+    digit_t z, mask, *one;
+    kex_workspace ws;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS, EntryStatus = CRYPTO_SUCCESS; 
+
+    if (
+        pPrivateKeys == NULL ||
+        pPublicKeys == NULL ||
+        pSharedSecrets == NULL ||
+        nkeys == 0 ||
+        is_CurveIsogenyStruct_null(CurveIsogeny)
+    ) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, (AliceOrBob == ALICE) ? SecretAgreement_A_batch_status_p503(pPrivateKeys, pPublicKeys, pSharedSecrets, pStatuses, nkeys, CurveIsogeny) : 
+                                                                SecretAgreement_B_batch_status_p503(pPrivateKeys, pPublicKeys, pSharedSecrets, pStatuses, nkeys, CurveIsogeny));
+    owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits);
+    pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+
+    // Per shared secret: the numerator and denominator of the j-invariant; plus scratch space for the inversion
+    jnum = (f2elm_t*) calloc(3 * (size_t)nkeys, sizeof(f2elm_t));
+    if (jnum == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    jden = jnum + nkeys;
+    t = jden + nkeys;
+
+    for (i = 0; i < nkeys && Status == CRYPTO_SUCCESS; i++) {
+        PrivateKey = pPrivateKeys + i * owords * sizeof(digit_t);
+        PublicKey = pPublicKeys + i * 4 * 2 * pwords * sizeof(digit_t);
+#if defined(MULTIBUFFER_SUPPORT)
+        if (nkeys - i > 1) {                           // Groups of up to MB_LANES secrets run in parallel, (A:C) are kept in (jnum:jden)
+            unsigned int nlanes = (nkeys - i < MB_LANES) ? (nkeys - i) : MB_LANES;
+            Status = SecretAgreement_projective_mb(PrivateKey, PublicKey, nlanes, AliceOrBob, &jnum[i], &jden[i], CurveIsogeny);
+            OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+            for (j = 0; j < nlanes; j++, i++) {
+                fp2copy751(jnum[i], ws.A);
+                fp2copy751(jden[i], ws.C);
+                j_inv_fraction(ws.A, ws.C, jnum[i], jden[i]);
+            }
+            i -= 1;
+            continue;
+        }
+#endif
+        if (AliceOrBob == ALICE) {
+            Status = SecretAgreement_A_projective(PrivateKey, PublicKey, false, &ws, CurveIsogeny);
+        } else {
+            Status = SecretAgreement_B_projective(PrivateKey, PublicKey, false, &ws, CurveIsogeny);
+        }
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+        j_inv_fraction(ws.A, ws.C, jnum[i], jden[i]);
+    }
+
+    if (Status == CRYPTO_SUCCESS) {
+        OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_JINV);
+        // Replace a zero denominator by 1 and its numerator by 0 to keep the product of the denominators invertible
+        one = (digit_t*)CurveIsogeny->Montgomery_one;
+        for (i = 0; i < nkeys; i++) {
+            z = 0;
+            for (j = 0; j < 2*pwords; j++) {
+                z |= ((digit_t*)jden[i])[j];
+            }
+            mask = 0 - (digit_t)is_digit_zero_ct(z);   // mask = 0xFF...FF if jden[i] = 0
+            for (j = 0; j < pwords; j++) {
+                jden[i][0][j] = (mask & (jden[i][0][j] ^ one[j])) ^ jden[i][0][j];
+                jnum[i][0][j] = ~mask & jnum[i][0][j];
+                jnum[i][1][j] = ~mask & jnum[i][1][j];
+            }
+            if (mask != 0) {
+                EntryStatus = CRYPTO_ERROR_SHARED_KEY;
+            }
+            if (pStatuses != NULL) {
+                pStatuses[i] = (mask != 0) ? CRYPTO_ERROR_SHARED_KEY : CRYPTO_SUCCESS;
+            }
+        }
+        inv_n_way(jden, t, nkeys);
+
+        for (i = 0; i < nkeys; i++) {
+            fp2mul751_mont(jnum[i], jden[i], jnum[i]);
+            from_fp2mont(jnum[i], (felm_t*) (pSharedSecrets + i * 2 * pwords * sizeof(digit_t)));    // Converting back to standard representation
+        }
+        Status = EntryStatus;
+    } else if (pStatuses != NULL) {
+        for (i = 0; i < nkeys; i++) {
+            pStatuses[i] = Status;
+        }
+    }
+
+    OPCOUNT_PHASE(CurveIsogeny, OPCOUNT_PHASE_OTHER);
+
+// Cleanup:
+    clear_words((void*) &ws, NBYTES_TO_NWORDS(sizeof(kex_workspace)));
+    clear_words((void*) jnum, 3 * nkeys * 2 * pwords);
+    free(jnum);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_A_batch(
+    unsigned char* pPrivateKeysA,
+    unsigned char* pPublicKeysB,
+    unsigned char* pSharedSecretsA,
+    unsigned int nkeys,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's batched shared secret generation
+  // It produces nkeys shared secrets pSharedSecretsA using her private keys pPrivateKeysA and Bob's public keys pPublicKeysB, such that
+  // the i-th shared secret is computed from the i-th private key and the i-th public key. 
+  // Keys and secrets are stored back to back, each one with the same format as in SecretAgreement_A(). The inversions of all the 
+  // j-invariant computations are shared through one simultaneous inversion.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return SecretAgreement_batch(pPrivateKeysA, pPublicKeysB, pSharedSecretsA, NULL, nkeys, ALICE, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS SecretAgreement_B_batch(
+    unsigned char* pPrivateKeysB,
+    unsigned char* pPublicKeysA,
+    unsigned char* pSharedSecretsB,
+    unsigned int nkeys,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's batched shared secret generation
+  // It produces nkeys shared secrets pSharedSecretsB using his private keys pPrivateKeysB and Alice's public keys pPublicKeysA, such that
+  // the i-th shared secret is computed from the i-th private key and the i-th public key. 
+  // Keys and secrets are stored back to back, each one with the same format as in SecretAgreement_B(). The inversions of all the 
+  // j-invariant computations are shared through one simultaneous inversion.
+  // CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+
+    return SecretAgreement_batch(pPrivateKeysB, pPublicKeysA, pSharedSecretsB, NULL, nkeys, BOB, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS SecretAgreement_A_batch_status(
+    unsigned char* pPrivateKeysA,
+    unsigned char* pPublicKeysB,
+    unsigned char* pSharedSecretsA,
+    CRYPTO_STATUS* pStatuses,
+    unsigned int nkeys,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Alice's batched shared secret generation with one status per secret
+  // It works as SecretAgreement_A_batch() and additionally sets pStatuses[i] to the status of the i-th shared secret, unless pStatuses is NULL.
+
+    return SecretAgreement_batch(pPrivateKeysA, pPublicKeysB, pSharedSecretsA, pStatuses, nkeys, ALICE, CurveIsogeny);
+}
+
+
+CRYPTO_STATUS SecretAgreement_B_batch_status(
+    unsigned char* pPrivateKeysB,
+    unsigned char* pPublicKeysA,
+    unsigned char* pSharedSecretsB,
+    CRYPTO_STATUS* pStatuses,
+    unsigned int nkeys,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Bob's batched shared secret generation with one status per secret
+  // It works as SecretAgreement_B_batch() and additionally sets pStatuses[i] to the status of the i-th shared secret, unless pStatuses is NULL.
+
+    return SecretAgreement_batch(pPrivateKeysB, pPublicKeysA, pSharedSecretsB, pStatuses, nkeys, BOB, CurveIsogeny);
+}
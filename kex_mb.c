@@ -0,0 +1,459 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: multi-buffer isogeny-based key exchange
+*
+* Up to MB_LANES independent key exchanges run the isogeny tree traversal in lockstep, one per
+* vector lane. The traversal only depends on public strategy parameters, so all lanes follow the
+* same sequence of operations. The scalar multiplications preceding the traversal are computed
+* on each lane separately.
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+
+#if defined(MULTIBUFFER_SUPPORT)
+
+
+static void vxDBL(vpoint_proj_t P, vpoint_proj_t Q, vf2elm_t A24, vf2elm_t C24)
+{ // Multi-buffer doubling of a Montgomery point in projective coordinates (X:Z), see xDBL().
+    vf2elm_t t0, t1;
+
+    vfp2sub751(P->X, P->Z, t0);                        // t0 = X1-Z1
+    vfp2add751(P->X, P->Z, t1);                        // t1 = X1+Z1
+    vfp2sqr751_mont(t0, t0);                           // t0 = (X1-Z1)^2
+    vfp2sqr751_mont(t1, t1);                           // t1 = (X1+Z1)^2
+    vfp2mul751_mont(C24, t0, Q->Z);                    // Z2 = C24*(X1-Z1)^2
+    vfp2mul751_mont(t1, Q->Z, Q->X);                   // X2 = C24*(X1-Z1)^2*(X1+Z1)^2
+    vfp2sub751(t1, t0, t1);                            // t1 = (X1+Z1)^2-(X1-Z1)^2
+    vfp2mul751_mont(A24, t1, t0);                      // t0 = A24*[(X1+Z1)^2-(X1-Z1)^2]
+    vfp2add751(Q->Z, t0, Q->Z);                        // Z2 = A24*[(X1+Z1)^2-(X1-Z1)^2] + C24*(X1-Z1)^2
+    vfp2mul751_mont(Q->Z, t1, Q->Z);                   // Z2 = [A24*[(X1+Z1)^2-(X1-Z1)^2] + C24*(X1-Z1)^2]*[(X1+Z1)^2-(X1-Z1)^2]
+}
+
+
+static void vxDBLe(vpoint_proj_t P, vpoint_proj_t Q, vf2elm_t A, vf2elm_t C, int e)
+{ // Multi-buffer computation of [2^e](X:Z) via e repeated doublings, see xDBLe().
+    vf2elm_t A24num, A24den;
+    int i;
+
+    vfp2add751(C, C, A24num);
+    vfp2add751(A24num, A24num, A24den);
+    vfp2add751(A24num, A, A24num);
+    vfp2copy751(P->X, Q->X);
+    vfp2copy751(P->Z, Q->Z);
+
+    for (i = 0; i < e; i++) {
+        vxDBL(Q, Q, A24num, A24den);
+    }
+}
+
+
+static void vget_4_isog(vpoint_proj_t P, vf2elm_t A, vf2elm_t C, vf2elm_t* coeff)
+{ // Multi-buffer computation of the 4-isogeny of a projective Montgomery point (X4:Z4) of order 4, see get_4_isog().
+
+    vfp2add751(P->X, P->Z, coeff[0]);                  // coeff[0] = X4+Z4
+    vfp2sqr751_mont(P->X, coeff[3]);                   // coeff[3] = X4^2
+    vfp2sqr751_mont(P->Z, coeff[4]);                   // coeff[4] = Z4^2
+    vfp2sqr751_mont(coeff[0], coeff[0]);               // coeff[0] = (X4+Z4)^2
+    vfp2add751(coeff[3], coeff[4], coeff[1]);          // coeff[1] = X4^2+Z4^2
+    vfp2sub751(coeff[3], coeff[4], coeff[2]);          // coeff[2] = X4^2-Z4^2
+    vfp2sqr751_mont(coeff[3], coeff[3]);               // coeff[3] = X4^4
+    vfp2sqr751_mont(coeff[4], coeff[4]);               // coeff[4] = Z4^4
+    vfp2add751(coeff[3], coeff[3], A);                 // A = 2*X4^4
+    vfp2sub751(coeff[0], coeff[1], coeff[0]);          // coeff[0] = 2*X4*Z4 = (X4+Z4)^2 - (X4^2+Z4^2)
+    vfp2sub751(A, coeff[4], A);                        // A = 2*X4^4-Z4^4
+    vfp2copy751(coeff[4], C);                          // C = Z4^4
+    vfp2add751(A, A, A);                               // A = 2(2*X4^4-Z4^4)
+}
+
+
+static void veval_4_isog(vpoint_proj_t P, vf2elm_t* coeff)
+{ // Multi-buffer evaluation of a 4-isogeny at the point (X:Z), see eval_4_isog().
+    vf2elm_t t0, t1;
+
+    vfp2mul751_mont(P->X, coeff[0], P->X);             // X = coeff[0]*X
+    vfp2mul751_mont(P->Z, coeff[1], t0);               // t0 = coeff[1]*Z
+    vfp2sub751(P->X, t0, P->X);                        // X = X-t0
+    vfp2mul751_mont(P->Z, coeff[2], P->Z);             // Z = coeff[2]*Z
+    vfp2sub751(P->X, P->Z, t0);                        // t0 = X-Z
+    vfp2mul751_mont(P->Z, P->X, P->Z);                 // Z = X*Z
+    vfp2sqr751_mont(t0, t0);                           // t0 = t0^2
+    vfp2add751(P->Z, P->Z, P->Z);                      // Z = Z+Z
+    vfp2add751(P->Z, P->Z, P->Z);                      // Z = Z+Z
+    vfp2add751(P->Z, t0, P->X);                        // X = t0+Z
+    vfp2mul751_mont(P->Z, t0, P->Z);                   // Z = t0*Z
+    vfp2mul751_mont(P->Z, coeff[4], P->Z);             // Z = coeff[4]*Z
+    vfp2mul751_mont(t0, coeff[4], t0);                 // t0 = t0*coeff[4]
+    vfp2mul751_mont(P->X, coeff[3], t1);               // t1 = X*coeff[3]
+    vfp2sub751(t0, t1, t0);                            // t0 = t0-t1
+    vfp2mul751_mont(P->X, t0, P->X);                   // X = X*t0
+}
+
+
+static void vxTPL(vpoint_proj_t P, vpoint_proj_t Q, vf2elm_t A24minus, vf2elm_t A24plus)
+{ // Multi-buffer tripling of a Montgomery point in projective coordinates (X:Z), see xTPL().
+    vf2elm_t t0, t1, t2, t3, t4, t5, t6;
+
+    vfp2sub751(P->X, P->Z, t0);                        // t0 = X-Z
+    vfp2sqr751_mont(t0, t2);                           // t2 = (X-Z)^2
+    vfp2add751(P->X, P->Z, t1);                        // t1 = X+Z
+    vfp2sqr751_mont(t1, t3);                           // t3 = (X+Z)^2
+    vfp2add751(t0, t1, t4);                            // t4 = 2X
+    vfp2sub751(t1, t0, t0);                            // t0 = 2Z
+    vfp2sqr751_mont(t4, t1);                           // t1 = 4X^2
+    vfp2sub751(t1, t3, t1);                            // t1 = 4X^2-(X+Z)^2
+    vfp2sub751(t1, t2, t1);                            // t1 = 4X^2-(X+Z)^2-(X-Z)^2 = 2(X^2-Z^2)
+    vfp2mul751_mont(t3, A24plus, t5);                  // t5 = A24plus*(X+Z)^2
+    vfp2mul751_mont(t3, t5, t3);                       // t3 = A24plus*(X+Z)^4
+    vfp2mul751_mont(A24minus, t2, t6);                 // t6 = A24minus*(X-Z)^2
+    vfp2mul751_mont(t2, t6, t2);                       // t2 = A24minus*(X-Z)^4
+    vfp2sub751(t2, t3, t3);                            // t3 = A24minus*(X-Z)^4-A24plus*(X+Z)^4
+    vfp2sub751(t5, t6, t2);                            // t2 = A24plus*(X+Z)^2-A24minus*(X-Z)^2
+    vfp2mul751_mont(t1, t2, t1);                       // t1 = 2(X^2-Z^2)*[A24plus*(X+Z)^2-A24minus*(X-Z)^2]
+    vfp2add751(t3, t1, t2);                            // t2 = t3+t1
+    vfp2sqr751_mont(t2, t2);                           // t2 = (t3+t1)^2
+    vfp2mul751_mont(t4, t2, Q->X);                     // X3 = 2X*(t3+t1)^2
+    vfp2sub751(t3, t1, t1);                            // t1 = t3-t1
+    vfp2sqr751_mont(t1, t1);                           // t1 = (t3-t1)^2
+    vfp2mul751_mont(t0, t1, Q->Z);                     // Z3 = 2Z*(t3-t1)^2
+}
+
+
+static void vxTPLe(vpoint_proj_t P, vpoint_proj_t Q, vf2elm_t A24minus, vf2elm_t A24plus, int e)
+{ // Multi-buffer computation of [3^e](X:Z) via e repeated triplings, see xTPLe_A24().
+    int i;
+
+    vfp2copy751(P->X, Q->X);
+    vfp2copy751(P->Z, Q->Z);
+
+    for (i = 0; i < e; i++) {
+        vxTPL(Q, Q, A24minus, A24plus);
+    }
+}
+
+
+static void vget_3_isog(vpoint_proj_t P, vf2elm_t A24minus, vf2elm_t A24plus, vf2elm_t* coeff)
+{ // Multi-buffer computation of the 3-isogeny of a projective Montgomery point (X3:Z3) of order 3, see get_3_isog().
+    vf2elm_t t0, t1, t2, t3, t4;
+
+    vfp2sub751(P->X, P->Z, coeff[0]);                  // coeff[0] = X3-Z3
+    vfp2sqr751_mont(coeff[0], t0);                     // t0 = (X3-Z3)^2
+    vfp2add751(P->X, P->Z, coeff[1]);                  // coeff[1] = X3+Z3
+    vfp2sqr751_mont(coeff[1], t1);                     // t1 = (X3+Z3)^2
+    vfp2add751(t0, t1, t2);                            // t2 = (X3+Z3)^2+(X3-Z3)^2
+    vfp2add751(coeff[0], coeff[1], t3);                // t3 = 2X3
+    vfp2sqr751_mont(t3, t3);                           // t3 = 4X3^2
+    vfp2sub751(t3, t2, t3);                            // t3 = 4X3^2-(X3+Z3)^2-(X3-Z3)^2
+    vfp2add751(t1, t3, t2);                            // t2 = 4X3^2-(X3-Z3)^2
+    vfp2add751(t3, t0, t3);                            // t3 = 4X3^2-(X3+Z3)^2
+    vfp2add751(t0, t3, t4);                            // t4 = 4X3^2-(X3+Z3)^2+(X3-Z3)^2
+    vfp2add751(t4, t4, t4);                            // t4 = 2*[4X3^2-(X3+Z3)^2+(X3-Z3)^2]
+    vfp2add751(t1, t4, t4);                            // t4 = 8X3^2-(X3+Z3)^2+2(X3-Z3)^2
+    vfp2mul751_mont(t2, t4, A24minus);                 // A24minus = [4X3^2-(X3-Z3)^2]*[8X3^2-(X3+Z3)^2+2(X3-Z3)^2]
+    vfp2add751(t1, t2, t4);                            // t4 = 4X3^2+(X3+Z3)^2-(X3-Z3)^2
+    vfp2add751(t4, t4, t4);                            // t4 = 2*[4X3^2+(X3+Z3)^2-(X3-Z3)^2]
+    vfp2add751(t0, t4, t4);                            // t4 = 8X3^2+2(X3+Z3)^2-(X3-Z3)^2
+    vfp2mul751_mont(t3, t4, A24plus);                  // A24plus = [4X3^2-(X3+Z3)^2]*[8X3^2+2(X3+Z3)^2-(X3-Z3)^2]
+}
+
+
+static void veval_3_isog(vpoint_proj_t Q, vf2elm_t* coeff)
+{ // Multi-buffer evaluation of the 3-isogeny with the coefficients of vget_3_isog() at the point Q = (X:Z), see eval_3_isog().
+    vf2elm_t t0, t1, t2;
+
+    vfp2add751(Q->X, Q->Z, t0);                        // t0 = X+Z
+    vfp2sub751(Q->X, Q->Z, t1);                        // t1 = X-Z
+    vfp2mul751_mont(t0, coeff[0], t0);                 // t0 = coeff[0]*(X+Z)
+    vfp2mul751_mont(t1, coeff[1], t1);                 // t1 = coeff[1]*(X-Z)
+    vfp2add751(t0, t1, t2);                            // t2 = coeff[0]*(X+Z)+coeff[1]*(X-Z)
+    vfp2sub751(t1, t0, t0);                            // t0 = coeff[1]*(X-Z)-coeff[0]*(X+Z)
+    vfp2sqr751_mont(t2, t2);                           // t2 = [coeff[0]*(X+Z)+coeff[1]*(X-Z)]^2
+    vfp2sqr751_mont(t0, t0);                           // t0 = [coeff[1]*(X-Z)-coeff[0]*(X+Z)]^2
+    vfp2mul751_mont(Q->X, t2, Q->X);                   // X = X*[coeff[0]*(X+Z)+coeff[1]*(X-Z)]^2
+    vfp2mul751_mont(Q->Z, t0, Q->Z);                   // Z = Z*[coeff[1]*(X-Z)-coeff[0]*(X+Z)]^2
+}
+
+
+static void vpoint_pack(point_proj* P, vpoint_proj_t V)
+{ // Interleaving of the MB_LANES points P[0],...,P[MB_LANES-1] into the multi-buffer point V
+    f2elm_t t[MB_LANES];
+    unsigned int j;
+
+    for (j = 0; j < MB_LANES; j++) {
+        fp2copy751(P[j].X, t[j]);
+    }
+    vfp2pack751(t, V->X);
+    for (j = 0; j < MB_LANES; j++) {
+        fp2copy751(P[j].Z, t[j]);
+    }
+    vfp2pack751(t, V->Z);
+    clear_words((void*) t, MB_LANES * 2 * NWORDS_FIELD);
+}
+
+
+static void vpoint_unpack(vpoint_proj_t V, point_proj* P)
+{ // De-interleaving of the multi-buffer point V into the MB_LANES points P[0],...,P[MB_LANES-1]
+    f2elm_t t[MB_LANES];
+    unsigned int j;
+
+    vfp2unpack751(V->X, t);
+    for (j = 0; j < MB_LANES; j++) {
+        fp2copy751(t[j], P[j].X);
+    }
+    vfp2unpack751(V->Z, t);
+    for (j = 0; j < MB_LANES; j++) {
+        fp2copy751(t[j], P[j].Z);
+    }
+    clear_words((void*) t, MB_LANES * 2 * NWORDS_FIELD);
+}
+
+
+static void traverse_tree_A_mb(vpoint_proj_t R, vf2elm_t A, vf2elm_t C, vpoint_proj_t* phi, unsigned int nphi, const unsigned int* splits)
+{ // Multi-buffer traversal of Alice's isogeny tree with kernel point R, starting on the curve (A:C).
+  // The nphi points in phi are mapped to the final curve, which is returned in (A:C). "splits" is the traversal strategy.
+    vpoint_proj_t pts[MAX_INT_POINTS_ALICE];
+    vf2elm_t coeff[5];
+    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_ALICE], npts = 0;
+
+    for (row = 1; row < MAX_Alice; row++) {
+        while (index < MAX_Alice-row) {
+            vfp2copy751(R->X, pts[npts]->X);
+            vfp2copy751(R->Z, pts[npts]->Z);
+            pts_index[npts] = index;
+            npts += 1;
+            m = splits[MAX_Alice-index-row];
+            vxDBLe(R, R, A, C, (int)(2 * m));
+            index += m;
+        }
+        vget_4_isog(R, A, C, coeff);
+
+        for (i = 0; i < npts; i++) {
+            veval_4_isog(pts[i], coeff);
+        }
+        for (i = 0; i < nphi; i++) {
+            veval_4_isog(phi[i], coeff);
+        }
+
+        vfp2copy751(pts[npts - 1]->X, R->X);
+        vfp2copy751(pts[npts - 1]->Z, R->Z);
+        index = pts_index[npts - 1];
+        npts -= 1;
+    }
+
+    vget_4_isog(R, A, C, coeff);
+    for (i = 0; i < nphi; i++) {
+        veval_4_isog(phi[i], coeff);
+    }
+
+// Cleanup:
+    clear_words((void*) pts, NBYTES_TO_NWORDS(sizeof(pts)));
+    clear_words((void*) coeff, NBYTES_TO_NWORDS(sizeof(coeff)));
+}
+
+
+static void traverse_tree_B_mb(vpoint_proj_t R, vf2elm_t A, vf2elm_t C, vpoint_proj_t* phi, unsigned int nphi, const unsigned int* splits)
+{ // Multi-buffer traversal of Bob's isogeny tree with kernel point R, starting on the curve (A:C).
+  // The nphi points in phi are mapped to the final curve, which is returned in (A:C). "splits" is the traversal strategy.
+    vpoint_proj_t pts[MAX_INT_POINTS_BOB];
+    vf2elm_t t0, coeff[2];
+    unsigned int i, row, m, index = 0, pts_index[MAX_INT_POINTS_BOB], npts = 0;
+
+    vfp2add751(C, C, t0);                              // Along the traversal, (A:C) holds the constants (A-2C:A+2C) of vxTPL()
+    vfp2add751(A, t0, C);
+    vfp2sub751(A, t0, A);
+
+    for (row = 1; row < MAX_Bob; row++) {
+        while (index < MAX_Bob-row) {
+            vfp2copy751(R->X, pts[npts]->X);
+            vfp2copy751(R->Z, pts[npts]->Z);
+            pts_index[npts] = index;
+            npts += 1;
+            m = splits[MAX_Bob - index - row];
+            vxTPLe(R, R, A, C, (int)m);
+            index += m;
+        }
+        vget_3_isog(R, A, C, coeff);
+
+        for (i = 0; i < npts; i++) {
+            veval_3_isog(pts[i], coeff);
+        }
+        for (i = 0; i < nphi; i++) {
+            veval_3_isog(phi[i], coeff);
+        }
+
+        vfp2copy751(pts[npts - 1]->X, R->X);
+        vfp2copy751(pts[npts - 1]->Z, R->Z);
+        index = pts_index[npts - 1];
+        npts -= 1;
+    }
+
+    vget_3_isog(R, A, C, coeff);
+    for (i = 0; i < nphi; i++) {
+        veval_3_isog(phi[i], coeff);
+    }
+    vfp2add751(C, A, t0);                              // (A:C) = (2(A24plus+A24minus):A24plus-A24minus)
+    vfp2sub751(C, A, C);
+    vfp2add751(t0, t0, A);
+
+// Cleanup:
+    clear_words((void*) pts, NBYTES_TO_NWORDS(sizeof(pts)));
+    clear_words((void*) coeff, NBYTES_TO_NWORDS(sizeof(coeff)));
+}
+
+
+CRYPTO_STATUS KeyGeneration_projective_mb(
+    unsigned char* pPrivateKeys,
+    unsigned int nlanes,
+    unsigned int AliceOrBob,
+    f2elm_t* A,
+    f2elm_t* X,
+    f2elm_t* Z,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Multi-buffer key-pair generation for Alice or Bob up to the final normalization
+  // It produces nlanes <= MB_LANES private keys at pPrivateKeys and computes, for the i-th key, the curve coefficient A[i], the
+  // X-coordinates X[3*i], X[3*i+1], X[3*i+2] of the images of the other party's generators, and the elements to be inverted
+  // Z[4*i] = C, Z[4*i+1], Z[4*i+2], Z[4*i+3]. Unused lanes replicate the first one.
+    unsigned int i, j, owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits);
+    point_proj R[MB_LANES], phi[3][MB_LANES];
+    f2elm_t Al[MB_LANES], Cl[MB_LANES];
+    vpoint_proj_t vR, vphi[3];
+    vf2elm_t vA, vC;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    if (nlanes == 0 || nlanes > MB_LANES) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    for (j = 0; j < nlanes && Status == CRYPTO_SUCCESS; j++) {
+        unsigned char* PrivateKey = pPrivateKeys + j * owords * sizeof(digit_t);
+        if (AliceOrBob == ALICE) {
+            Status = KeyGeneration_A_setup(PrivateKey, Al[j], Cl[j], &R[j], &phi[0][j], &phi[1][j], &phi[2][j], CurveIsogeny);
+        } else {
+            Status = KeyGeneration_B_setup(PrivateKey, Al[j], Cl[j], &R[j], &phi[0][j], &phi[1][j], &phi[2][j], CurveIsogeny);
+        }
+    }
+
+    if (Status == CRYPTO_SUCCESS) {
+        for (j = nlanes; j < MB_LANES; j++) {
+            fp2copy751(Al[0], Al[j]);
+            fp2copy751(Cl[0], Cl[j]);
+            R[j] = R[0];
+            for (i = 0; i < 3; i++) {
+                phi[i][j] = phi[i][0];
+            }
+        }
+        vfp2pack751(Al, vA);
+        vfp2pack751(Cl, vC);
+        vpoint_pack(R, vR);
+        for (i = 0; i < 3; i++) {
+            vpoint_pack(phi[i], vphi[i]);
+        }
+
+        if (AliceOrBob == ALICE) {
+            traverse_tree_A_mb(vR, vA, vC, vphi, 3, CurveIsogeny->StrategyAlice);
+        } else {
+            traverse_tree_B_mb(vR, vA, vC, vphi, 3, CurveIsogeny->StrategyBob);
+        }
+
+        vfp2unpack751(vA, Al);
+        vfp2unpack751(vC, Cl);
+        for (i = 0; i < 3; i++) {
+            vpoint_unpack(vphi[i], phi[i]);
+        }
+        for (j = 0; j < nlanes; j++) {
+            fp2copy751(Al[j], A[j]);
+            fp2copy751(Cl[j], Z[4*j]);
+            for (i = 0; i < 3; i++) {
+                fp2copy751(phi[i][j].X, X[3*j + i]);
+                fp2copy751(phi[i][j].Z, Z[4*j + i + 1]);
+            }
+        }
+    }
+
+// Cleanup:
+    clear_words((void*) R, NBYTES_TO_NWORDS(sizeof(R)));
+    clear_words((void*) phi, NBYTES_TO_NWORDS(sizeof(phi)));
+    clear_words((void*) Al, NBYTES_TO_NWORDS(sizeof(Al)));
+    clear_words((void*) Cl, NBYTES_TO_NWORDS(sizeof(Cl)));
+    clear_words((void*) vR, NBYTES_TO_NWORDS(sizeof(vR)));
+    clear_words((void*) vphi, NBYTES_TO_NWORDS(sizeof(vphi)));
+    clear_words((void*) vA, NBYTES_TO_NWORDS(sizeof(vA)));
+    clear_words((void*) vC, NBYTES_TO_NWORDS(sizeof(vC)));
+
+    return Status;
+}
+
+
+CRYPTO_STATUS SecretAgreement_projective_mb(
+    unsigned char* pPrivateKeys,
+    unsigned char* pPublicKeys,
+    unsigned int nlanes,
+    unsigned int AliceOrBob,
+    f2elm_t* A,
+    f2elm_t* C,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Multi-buffer shared secret generation for Alice or Bob up to the j-invariant computation
+  // It computes the shared curves (A[i]:C[i]) for nlanes <= MB_LANES pairs of private keys at pPrivateKeys and public keys at pPublicKeys.
+  // Unused lanes replicate the first one.
+    unsigned int j, owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits), pwords = NBITS_TO_NWORDS(CurveIsogeny->pwordbits);
+    point_proj R[MB_LANES];
+    f2elm_t Al[MB_LANES], Cl[MB_LANES];
+    vpoint_proj_t vR;
+    vf2elm_t vA, vC;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    if (nlanes == 0 || nlanes > MB_LANES) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    for (j = 0; j < nlanes && Status == CRYPTO_SUCCESS; j++) {
+        unsigned char* PrivateKey = pPrivateKeys + j * owords * sizeof(digit_t);
+        unsigned char* PublicKey = pPublicKeys + j * 4 * 2 * pwords * sizeof(digit_t);
+        if (AliceOrBob == ALICE) {
+            Status = SecretAgreement_A_setup(PrivateKey, PublicKey, Al[j], Cl[j], &R[j], CurveIsogeny);
+        } else {
+            Status = SecretAgreement_B_setup(PrivateKey, PublicKey, Al[j], Cl[j], &R[j], CurveIsogeny);
+        }
+    }
+
+    if (Status == CRYPTO_SUCCESS) {
+        for (j = nlanes; j < MB_LANES; j++) {
+            fp2copy751(Al[0], Al[j]);
+            fp2copy751(Cl[0], Cl[j]);
+            R[j] = R[0];
+        }
+        vfp2pack751(Al, vA);
+        vfp2pack751(Cl, vC);
+        vpoint_pack(R, vR);
+
+        if (AliceOrBob == ALICE) {
+            traverse_tree_A_mb(vR, vA, vC, NULL, 0, CurveIsogeny->StrategyAlice);
+        } else {
+            traverse_tree_B_mb(vR, vA, vC, NULL, 0, CurveIsogeny->StrategyBob);
+        }
+
+        vfp2unpack751(vA, Al);
+        vfp2unpack751(vC, Cl);
+        for (j = 0; j < nlanes; j++) {
+            fp2copy751(Al[j], A[j]);
+            fp2copy751(Cl[j], C[j]);
+        }
+    }
+
+// Cleanup:
+    clear_words((void*) R, NBYTES_TO_NWORDS(sizeof(R)));
+    clear_words((void*) Al, NBYTES_TO_NWORDS(sizeof(Al)));
+    clear_words((void*) Cl, NBYTES_TO_NWORDS(sizeof(Cl)));
+    clear_words((void*) vR, NBYTES_TO_NWORDS(sizeof(vR)));
+    clear_words((void*) vA, NBYTES_TO_NWORDS(sizeof(vA)));
+    clear_words((void*) vC, NBYTES_TO_NWORDS(sizeof(vC)));
+
+    return Status;
+}
+
+#endif
@@ -0,0 +1,309 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: step-wise key exchange, computed in bounded slices of work
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <malloc.h>
+
+
+// Costs of the indivisible parts of an operation in work units, where one unit is about the cost of a point quadrupling
+#define KEXSTEP_COST_SCALAR_MULT    48        // Key generation's scalar multiplication with the fixed-base tables
+#define KEXSTEP_COST_LADDER_MULT    160       // Key generation's scalar multiplication with the Montgomery ladder
+#define KEXSTEP_COST_NORMALIZATION  40        // Final inversion and conversion of the outputs
+
+// Phases of an operation
+typedef enum {
+    KEXSTEP_SETUP,                            // Key generation: private key, kernel point and generators
+    KEXSTEP_LADDER,                           // Shared secret: three-point ladder computing the kernel point
+    KEXSTEP_TRAVERSAL,                        // Isogeny tree traversal
+    KEXSTEP_NORMALIZATION,                    // Public key or j-invariant
+    KEXSTEP_DONE
+} KEXSTEP_PHASE;
+
+struct kexstep {
+    PCurveIsogenyStruct CurveIsogeny;                    // First member, read by SIDH_kex_step() and SIDH_kex_free() before the dispatch on the parameter set
+    SIDH_KEX_OPERATION  Operation;
+    unsigned int        AliceOrBob;
+    KEXSTEP_PHASE       phase;
+    CRYPTO_STATUS       Status;                          // Error of a previous step, returned by the next ones
+    unsigned char      *pPrivateKey, *pPublicKey, *pSharedSecret;   // Outputs, written by the last step
+    digit_t             PrivateKey[NWORDS_ORDER];
+    f2elm_t             PK[4];                           // Peer's public key in Montgomery representation, for the shared secret
+    ladder_3_pt_state   ladder;
+    f2elm_t             A, C;                            // For Bob, the constants (A-2C:A+2C) of xTPL() during the traversal
+    point_proj_t        R, phi[3];                       // Kernel point and, for key generation, the images of the peer's generators
+    point_proj_t        pts[MAX_INT_POINTS_BOB];         // Points stored along the traversal, as in KeyGeneration_B()
+    unsigned int        pts_index[MAX_INT_POINTS_BOB];
+    unsigned int        npts, row, index;
+    unsigned int        nmul;                            // Multiplications left to reach the next point of the row
+    unsigned int        neval;                           // Next point to map through the isogeny of the row
+    bool                evaluating;                      // Set while the points are mapped through the isogeny of the row
+    f2elm_t             coeff[5];                        // Coefficients of the isogeny of the row, see eval_kexstep()
+};
+
+
+static void eval_kexstep(PKexStep KexStep, point_proj_t P)
+{ // Evaluates the isogeny of the current row at P: the 4-isogeny with the coefficients of get_4_isog() for Alice, or the 3-isogeny
+  // with the coefficients of get_3_isog() for Bob
+    if (KexStep->AliceOrBob == ALICE) {
+        eval_4_isog(P, KexStep->coeff);
+    } else {
+        eval_3_isog(P, KexStep->coeff);
+    }
+}
+
+
+static unsigned int traversal_kexstep(PKexStep KexStep)
+{ // Performs the next operation of the isogeny tree traversal computed by KeyGeneration_A() and SecretAgreement_A() for Alice, or by
+  // KeyGeneration_B() and SecretAgreement_B() for Bob, and returns its cost. The last row, row = MAX, computes the final isogeny.
+    PCurveIsogenyStruct CurveIsogeny = KexStep->CurveIsogeny;
+    unsigned int max = (KexStep->AliceOrBob == ALICE) ? MAX_Alice : MAX_Bob;
+    unsigned int* strategy = (KexStep->AliceOrBob == ALICE) ? CurveIsogeny->StrategyAlice : CurveIsogeny->StrategyBob;
+    bool keygen = (KexStep->Operation == SIDH_KEX_KEYGEN_A || KexStep->Operation == SIDH_KEX_KEYGEN_B);
+    point_proj* R = KexStep->R;
+
+    if (KexStep->nmul > 0) {                           // Next multiplication towards the kernel point of the row
+        if (KexStep->AliceOrBob == ALICE) {
+            xDBLe(R, R, KexStep->A, KexStep->C, 2);
+        } else {
+            xTPLe_A24(R, R, KexStep->A, KexStep->C, 1);
+        }
+        KexStep->nmul--;
+        return 1;
+    }
+
+    if (!KexStep->evaluating) {
+        if (KexStep->index < max - KexStep->row) {     // Store R and move down the tree
+            fp2copy751(R->X, KexStep->pts[KexStep->npts]->X);
+            fp2copy751(R->Z, KexStep->pts[KexStep->npts]->Z);
+            KexStep->pts_index[KexStep->npts] = KexStep->index;
+            KexStep->npts++;
+            KexStep->nmul = strategy[max - KexStep->index - KexStep->row];
+            KexStep->index += KexStep->nmul;
+            return 0;
+        }
+        if (KexStep->AliceOrBob == ALICE) {            // R is the kernel of the isogeny of the row
+            get_4_isog(R, KexStep->A, KexStep->C, KexStep->coeff);
+        } else {
+            get_3_isog(R, KexStep->A, KexStep->C, KexStep->coeff);
+        }
+        KexStep->evaluating = true;
+        KexStep->neval = 0;
+        return 1;
+    }
+
+    if (KexStep->neval < KexStep->npts) {
+        eval_kexstep(KexStep, KexStep->pts[KexStep->neval++]);
+        return 1;
+    }
+    if (keygen && KexStep->neval < KexStep->npts + 3) {
+        eval_kexstep(KexStep, KexStep->phi[KexStep->neval++ - KexStep->npts]);
+        return 1;
+    }
+
+    // End of the row: continue from the last stored point
+    KexStep->evaluating = false;
+    if (KexStep->row == max) {
+        if (KexStep->AliceOrBob == BOB) {
+            get_A_tpl(KexStep->A, KexStep->C, KexStep->A, KexStep->C);
+        }
+        KexStep->phase = KEXSTEP_NORMALIZATION;
+        return 0;
+    }
+    KexStep->npts--;
+    fp2copy751(KexStep->pts[KexStep->npts]->X, R->X);
+    fp2copy751(KexStep->pts[KexStep->npts]->Z, R->Z);
+    KexStep->index = KexStep->pts_index[KexStep->npts];
+    KexStep->row++;
+    return 0;
+}
+
+
+static CRYPTO_STATUS normalization_kexstep(PKexStep KexStep)
+{ // Computes the outputs: the key pair for key generation, as KeyGeneration_A() and KeyGeneration_B(), or the j-invariant of the
+  // shared curve, as SecretAgreement_A() and SecretAgreement_B(), including their CRYPTO_ERROR_SHARED_KEY for a singular shared curve
+    unsigned int owords = NBITS_TO_NWORDS(KexStep->CurveIsogeny->owordbits);
+    f2elm_t* PublicKey = (f2elm_t*)KexStep->pPublicKey;
+    point_proj* phiP = KexStep->phi[0], *phiQ = KexStep->phi[1], *phiD = KexStep->phi[2];
+    f2elm_t jinv;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+
+    if (KexStep->Operation == SIDH_KEX_KEYGEN_A || KexStep->Operation == SIDH_KEX_KEYGEN_B) {
+        inv_4_way(KexStep->C, phiP->Z, phiQ->Z, phiD->Z);
+        fp2mul751_mont(KexStep->A, KexStep->C, KexStep->A);
+        fp2mul751_mont(phiP->X, phiP->Z, phiP->X);
+        fp2mul751_mont(phiQ->X, phiQ->Z, phiQ->X);
+        fp2mul751_mont(phiD->X, phiD->Z, phiD->X);
+
+        from_fp2mont(KexStep->A, PublicKey[0]);                                      // Converting back to standard representation
+        from_fp2mont(phiP->X, PublicKey[1]);
+        from_fp2mont(phiQ->X, PublicKey[2]);
+        from_fp2mont(phiD->X, PublicKey[3]);
+        copy_words(KexStep->PrivateKey, (digit_t*)KexStep->pPrivateKey, owords);
+    } else {
+        if (!j_inv_checked(KexStep->A, KexStep->C, jinv)) {
+            Status = CRYPTO_ERROR_SHARED_KEY;
+        }
+        from_fp2mont(jinv, (felm_t*)KexStep->pSharedSecret);                        // Converting back to standard representation
+        clear_words((void*)jinv, 2*NWORDS_FIELD);
+    }
+    return Status;
+}
+
+
+static void clear_kexstep(PKexStep KexStep)
+{ // Wipes the secret state of the operation, keeping the fields that describe it
+    unsigned int offset = (unsigned int)(((unsigned char*)KexStep->PrivateKey - (unsigned char*)KexStep) / sizeof(digit_t));
+
+    clear_words((void*)KexStep->PrivateKey, sizeof(struct kexstep)/sizeof(digit_t) - offset);
+}
+
+
+CRYPTO_STATUS SIDH_kex_start(
+    PCurveIsogenyStruct CurveIsogeny,
+    SIDH_KEX_OPERATION Operation,
+    unsigned char* pPrivateKey,
+    unsigned char* pPublicKey,
+    unsigned char* pSharedSecret,
+    PKexStep* pKexStep
+) { // Creates the state of a step-wise key exchange operation in pKexStep, see SIDH_kex_step()
+    unsigned int i, owords;
+    PKexStep KexStep;
+    CRYPTO_STATUS Status;
+
+    if (pKexStep == NULL || is_CurveIsogenyStruct_null(CurveIsogeny) || Operation >= SIDH_KEX_END_OF_LIST ||
+        pPrivateKey == NULL || pPublicKey == NULL || ((Operation == SIDH_KEX_SHARED_A || Operation == SIDH_KEX_SHARED_B) && pSharedSecret == NULL)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(CurveIsogeny->pbits, SIDH_kex_start_p503(CurveIsogeny, Operation, pPrivateKey, pPublicKey, pSharedSecret, pKexStep));
+    owords = NBITS_TO_NWORDS(CurveIsogeny->owordbits);
+
+    KexStep = (PKexStep) calloc(1, sizeof(struct kexstep));
+    if (KexStep == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    KexStep->CurveIsogeny = CurveIsogeny;
+    KexStep->Operation = Operation;
+    KexStep->AliceOrBob = (Operation == SIDH_KEX_KEYGEN_A || Operation == SIDH_KEX_SHARED_A) ? ALICE : BOB;
+    KexStep->Status = CRYPTO_SUCCESS;
+    KexStep->pPrivateKey = pPrivateKey;
+    KexStep->pPublicKey = pPublicKey;
+    KexStep->pSharedSecret = pSharedSecret;
+    KexStep->row = 1;
+
+    if (Operation == SIDH_KEX_KEYGEN_A || Operation == SIDH_KEX_KEYGEN_B) {
+        KexStep->phase = KEXSTEP_SETUP;
+    } else {
+        // The private key and the peer's public key are read here, so that only the shared secret has to outlive this call
+        copy_words((digit_t*)pPrivateKey, KexStep->PrivateKey, owords);
+        for (i = 0; i < 4; i++) {
+            to_fp2mont(((f2elm_t*)pPublicKey)[i], KexStep->PK[i]);
+        }
+        fp2copy751(KexStep->PK[0], KexStep->A);
+        fpcopy751(CurveIsogeny->C, KexStep->C[0]);
+        to_mont(KexStep->C[0], KexStep->C[0]);
+        Status = ladder_3_pt_init(KexStep->PK[1], KexStep->PK[2], KexStep->PrivateKey, KexStep->AliceOrBob, KexStep->A, &KexStep->ladder, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            clear_kexstep(KexStep);
+            free(KexStep);
+            return Status;
+        }
+        KexStep->phase = KEXSTEP_LADDER;
+    }
+
+    *pKexStep = KexStep;
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_kex_step(PKexStep KexStep, unsigned int budget, bool* done)
+{ // Advances the operation by about "budget" work units, see SIDH_kex_step() in SIDH.h
+    PCurveIsogenyStruct CurveIsogeny;
+    unsigned int n, spent = 0;
+
+    if (KexStep == NULL || done == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(KexStep->CurveIsogeny->pbits, SIDH_kex_step_p503(KexStep, budget, done));
+    CurveIsogeny = KexStep->CurveIsogeny;
+
+    *done = false;
+    if (KexStep->Status != CRYPTO_SUCCESS) {
+        return KexStep->Status;
+    }
+
+    while (KexStep->phase != KEXSTEP_DONE && (spent < budget || spent == 0)) {
+        switch (KexStep->phase) {
+        case KEXSTEP_SETUP:
+            if (KexStep->AliceOrBob == ALICE) {
+                KexStep->Status = KeyGeneration_A_setup((unsigned char*)KexStep->PrivateKey, KexStep->A, KexStep->C, KexStep->R, KexStep->phi[0], KexStep->phi[1], KexStep->phi[2], CurveIsogeny);
+            } else {
+                KexStep->Status = KeyGeneration_B_setup((unsigned char*)KexStep->PrivateKey, KexStep->A, KexStep->C, KexStep->R, KexStep->phi[0], KexStep->phi[1], KexStep->phi[2], CurveIsogeny);
+            }
+            if (KexStep->Status != CRYPTO_SUCCESS) {
+                clear_kexstep(KexStep);
+                return KexStep->Status;
+            }
+            spent += (CurveIsogeny->FixedBaseWindow != 0) ? KEXSTEP_COST_SCALAR_MULT : KEXSTEP_COST_LADDER_MULT;
+            if (KexStep->AliceOrBob == BOB) {
+                get_A24_tpl(KexStep->A, KexStep->C, KexStep->A, KexStep->C);
+            }
+            KexStep->phase = KEXSTEP_TRAVERSAL;
+            break;
+
+        case KEXSTEP_LADDER:
+            n = (budget > spent) ? budget - spent : 1;
+            n = (n < KexStep->ladder.nbits) ? n : KexStep->ladder.nbits;
+            ladder_3_pt_steps(KexStep->PK[1], KexStep->PK[2], KexStep->PK[3], &KexStep->ladder, n);
+            spent += n;
+            if (KexStep->ladder.nbits == 0) {
+                copy_words((digit_t*)KexStep->ladder.W, (digit_t*)KexStep->R, 2*2*NWORDS_FIELD);
+                if (KexStep->AliceOrBob == ALICE) {
+                    first_4_isog(KexStep->R, KexStep->A, KexStep->A, KexStep->C, CurveIsogeny);
+                    spent += 1;
+                } else {
+                    get_A24_tpl(KexStep->A, KexStep->C, KexStep->A, KexStep->C);
+                }
+                KexStep->phase = KEXSTEP_TRAVERSAL;
+            }
+            break;
+
+        case KEXSTEP_TRAVERSAL:
+            spent += traversal_kexstep(KexStep);
+            break;
+
+        default:
+            KexStep->Status = normalization_kexstep(KexStep);
+            spent += KEXSTEP_COST_NORMALIZATION;
+            clear_kexstep(KexStep);
+            KexStep->phase = KEXSTEP_DONE;
+            break;
+        }
+    }
+
+    *done = (KexStep->phase == KEXSTEP_DONE);
+    return KexStep->Status;
+}
+
+
+void SIDH_kex_free(PKexStep KexStep)
+{ // Wipes and frees the state of the operation
+    if (KexStep == NULL) {
+        return;
+    }
+#if !defined(_P503_)
+    if (KexStep->CurveIsogeny->pbits == 503) {
+        SIDH_kex_free_p503(KexStep);
+        return;
+    }
+#endif
+    clear_kexstep(KexStep);
+    free(KexStep);
+}
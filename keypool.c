@@ -0,0 +1,273 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: pool of ephemeral key pairs precomputed by a background thread
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <malloc.h>
+#if defined(THREADS_SUPPORT)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+
+#if defined(THREADS_SUPPORT)
+
+// Ring of key pairs with one producer, the pool thread, and any number of consumers. Slot i is ready to be taken at position
+// pos = i (mod capacity) when its sequence number equals pos+1, and free for the producer at position pos when it equals pos.
+typedef struct {
+    unsigned int     seq;
+    digit_t          PrivateKey[NWORDS_ORDER];
+    publickey_t      PublicKey;
+} keypool_slot;
+
+struct keypool {
+    PCurveIsogenyStruct CurveIsogeny;
+    unsigned int     AliceOrBob;
+    unsigned int     capacity;                           // Number of slots, a power of 2
+    unsigned int     low_watermark;                      // The producer is woken up when fewer keys than this remain
+    unsigned int     head;                               // Next position to be taken, advanced by the consumers
+    unsigned int     tail;                               // Next position to be filled, advanced by the producer
+    unsigned int     sleeping;                           // Set while the producer waits on "wakeup"
+    unsigned int     quit;
+    CRYPTO_STATUS    status;                             // Error of the last key generation of the producer, reported and cleared by SIDH_keypool_take()
+    pthread_t        thread;
+    pthread_mutex_t  lock;
+    pthread_cond_t   wakeup;
+    keypool_slot*    slots;
+};
+
+
+static CRYPTO_STATUS keypool_generate(PKeyPool KeyPool, unsigned char* pPrivateKey, unsigned char* pPublicKey)
+{ // Generates one key pair of the pool's party
+    if (KeyPool->AliceOrBob == ALICE) {
+        return KeyGeneration_A(pPrivateKey, pPublicKey, KeyPool->CurveIsogeny);
+    }
+    return KeyGeneration_B(pPrivateKey, pPublicKey, KeyPool->CurveIsogeny);
+}
+
+
+static void* keypool_producer(void* arg)
+{ // Pool thread: fills the ring up to its capacity and then sleeps until the number of keys drops below the low watermark.
+  // After a failed key generation it sleeps until a consumer has taken the error, see SIDH_keypool_take()
+    PKeyPool KeyPool = (PKeyPool)arg;
+    keypool_slot* slot;
+    unsigned int tail, head;
+    CRYPTO_STATUS Status;
+
+    while (!__atomic_load_n(&KeyPool->quit, __ATOMIC_ACQUIRE)) {
+        tail = KeyPool->tail;
+        head = __atomic_load_n(&KeyPool->head, __ATOMIC_SEQ_CST);
+        if (tail - head >= KeyPool->capacity || __atomic_load_n(&KeyPool->status, __ATOMIC_RELAXED) != CRYPTO_SUCCESS) {
+            pthread_mutex_lock(&KeyPool->lock);
+            __atomic_store_n(&KeyPool->sleeping, 1, __ATOMIC_SEQ_CST);
+            while (!__atomic_load_n(&KeyPool->quit, __ATOMIC_ACQUIRE) &&
+                   (KeyPool->tail - __atomic_load_n(&KeyPool->head, __ATOMIC_SEQ_CST) >= KeyPool->low_watermark ||
+                    __atomic_load_n(&KeyPool->status, __ATOMIC_RELAXED) != CRYPTO_SUCCESS)) {
+                pthread_cond_wait(&KeyPool->wakeup, &KeyPool->lock);
+            }
+            __atomic_store_n(&KeyPool->sleeping, 0, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&KeyPool->lock);
+            continue;
+        }
+
+        // The slot at position tail is released by the consumer that took position tail-capacity, which may still be copying it out
+        slot = &KeyPool->slots[tail & (KeyPool->capacity - 1)];
+        while (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != tail) {
+            sched_yield();
+        }
+        Status = keypool_generate(KeyPool, (unsigned char*)slot->PrivateKey, (unsigned char*)slot->PublicKey);
+        if (Status != CRYPTO_SUCCESS) {
+            clear_words((void*)slot->PrivateKey, NWORDS_ORDER);
+            __atomic_store_n(&KeyPool->status, Status, __ATOMIC_RELAXED);
+            continue;
+        }
+        __atomic_store_n(&slot->seq, tail + 1, __ATOMIC_RELEASE);
+        __atomic_store_n(&KeyPool->tail, tail + 1, __ATOMIC_SEQ_CST);
+    }
+
+    return NULL;
+}
+
+
+CRYPTO_STATUS SIDH_keypool_create(
+    PCurveIsogenyStruct CurveIsogeny,
+    unsigned int AliceOrBob,
+    unsigned int capacity,
+    unsigned int low_watermark,
+    PKeyPool* pKeyPool
+) { // Creates a pool of up to "capacity" key pairs for Alice or Bob and starts the thread that fills it
+    PKeyPool KeyPool;
+    unsigned int i;
+
+    if (pKeyPool == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    *pKeyPool = NULL;
+    if (is_CurveIsogenyStruct_null(CurveIsogeny) || AliceOrBob > 1 || capacity < 2 || capacity > SIDH_KEYPOOL_MAX_CAPACITY ||
+        (capacity & (capacity - 1)) != 0 || low_watermark < 1 || low_watermark > capacity) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    KeyPool = (PKeyPool) calloc(1, sizeof(struct keypool));
+    if (KeyPool == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    KeyPool->slots = (keypool_slot*) calloc(capacity, sizeof(keypool_slot));
+    if (KeyPool->slots == NULL) {
+        free(KeyPool);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    for (i = 0; i < capacity; i++) {
+        KeyPool->slots[i].seq = i;
+    }
+    KeyPool->CurveIsogeny = CurveIsogeny;
+    KeyPool->AliceOrBob = AliceOrBob;
+    KeyPool->capacity = capacity;
+    KeyPool->low_watermark = low_watermark;
+    KeyPool->status = CRYPTO_SUCCESS;
+    pthread_mutex_init(&KeyPool->lock, NULL);
+    pthread_cond_init(&KeyPool->wakeup, NULL);
+
+    if (pthread_create(&KeyPool->thread, NULL, keypool_producer, KeyPool) != 0) {
+        pthread_cond_destroy(&KeyPool->wakeup);
+        pthread_mutex_destroy(&KeyPool->lock);
+        free(KeyPool->slots);
+        free(KeyPool);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+
+    *pKeyPool = KeyPool;
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_keypool_take(PKeyPool KeyPool, unsigned char* pPrivateKey, unsigned char* pPublicKey)
+{ // Takes a key pair from the pool, or generates one if the pool is empty
+    unsigned int pbytes, obytes, pos, seq;
+    keypool_slot* slot;
+    CRYPTO_STATUS Status;
+
+    if (KeyPool == NULL || pPrivateKey == NULL || pPublicKey == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    pbytes = (KeyPool->CurveIsogeny->pwordbits + 7)/8;
+    obytes = (KeyPool->CurveIsogeny->owordbits + 7)/8;
+
+    // An error of the producer is reported once, and clearing it lets the producer retry
+    if (__atomic_load_n(&KeyPool->status, __ATOMIC_RELAXED) != CRYPTO_SUCCESS) {
+        pthread_mutex_lock(&KeyPool->lock);
+        Status = __atomic_exchange_n(&KeyPool->status, CRYPTO_SUCCESS, __ATOMIC_RELAXED);
+        pthread_cond_signal(&KeyPool->wakeup);
+        pthread_mutex_unlock(&KeyPool->lock);
+        if (Status != CRYPTO_SUCCESS) {
+            return Status;
+        }
+    }
+
+    pos = __atomic_load_n(&KeyPool->head, __ATOMIC_RELAXED);
+    while (true) {
+        slot = &KeyPool->slots[pos & (KeyPool->capacity - 1)];
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (seq == pos + 1) {
+            if (__atomic_compare_exchange_n(&KeyPool->head, &pos, pos + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if ((int)(seq - (pos + 1)) < 0) {
+            return keypool_generate(KeyPool, pPrivateKey, pPublicKey);   // Empty pool
+        } else {
+            pos = __atomic_load_n(&KeyPool->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    // Copy the key pair out, wipe the slot and hand it back to the producer
+    copy_words(slot->PrivateKey, (digit_t*)pPrivateKey, NBYTES_TO_NWORDS(obytes));
+    copy_words((digit_t*)slot->PublicKey, (digit_t*)pPublicKey, NBYTES_TO_NWORDS(4*2*pbytes));
+    clear_words((void*)slot->PrivateKey, NWORDS_ORDER);
+    __atomic_store_n(&slot->seq, pos + KeyPool->capacity, __ATOMIC_RELEASE);
+
+    if (__atomic_load_n(&KeyPool->sleeping, __ATOMIC_SEQ_CST) &&
+        __atomic_load_n(&KeyPool->tail, __ATOMIC_SEQ_CST) - (pos + 1) < KeyPool->low_watermark) {
+        pthread_mutex_lock(&KeyPool->lock);
+        pthread_cond_signal(&KeyPool->wakeup);
+        pthread_mutex_unlock(&KeyPool->lock);
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+unsigned int SIDH_keypool_available(PKeyPool KeyPool)
+{ // Number of key pairs ready in the pool
+    if (KeyPool == NULL) {
+        return 0;
+    }
+    return __atomic_load_n(&KeyPool->tail, __ATOMIC_SEQ_CST) - __atomic_load_n(&KeyPool->head, __ATOMIC_SEQ_CST);
+}
+
+
+void SIDH_keypool_free(PKeyPool KeyPool)
+{ // Stops the pool thread, wipes the remaining private keys and frees the pool
+    if (KeyPool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&KeyPool->lock);
+    __atomic_store_n(&KeyPool->quit, 1, __ATOMIC_RELEASE);
+    pthread_cond_signal(&KeyPool->wakeup);
+    pthread_mutex_unlock(&KeyPool->lock);
+    pthread_join(KeyPool->thread, NULL);
+
+    pthread_cond_destroy(&KeyPool->wakeup);
+    pthread_mutex_destroy(&KeyPool->lock);
+    clear_words((void*)KeyPool->slots, KeyPool->capacity*(sizeof(keypool_slot)/sizeof(digit_t)));
+    free(KeyPool->slots);
+    free(KeyPool);
+}
+
+#else
+
+CRYPTO_STATUS SIDH_keypool_create(
+    PCurveIsogenyStruct CurveIsogeny,
+    unsigned int AliceOrBob,
+    unsigned int capacity,
+    unsigned int low_watermark,
+    PKeyPool* pKeyPool
+) { // Key pools are not supported in this build
+    UNREFERENCED_PARAMETER(CurveIsogeny);
+    UNREFERENCED_PARAMETER(AliceOrBob);
+    UNREFERENCED_PARAMETER(capacity);
+    UNREFERENCED_PARAMETER(low_watermark);
+    if (pKeyPool != NULL) {
+        *pKeyPool = NULL;
+    }
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+
+CRYPTO_STATUS SIDH_keypool_take(PKeyPool KeyPool, unsigned char* pPrivateKey, unsigned char* pPublicKey)
+{
+    UNREFERENCED_PARAMETER(KeyPool);
+    UNREFERENCED_PARAMETER(pPrivateKey);
+    UNREFERENCED_PARAMETER(pPublicKey);
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+
+unsigned int SIDH_keypool_available(PKeyPool KeyPool)
+{
+    UNREFERENCED_PARAMETER(KeyPool);
+    return 0;
+}
+
+
+void SIDH_keypool_free(PKeyPool KeyPool)
+{
+    UNREFERENCED_PARAMETER(KeyPool);
+}
+
+#endif
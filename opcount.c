@@ -0,0 +1,102 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: operation counters for the instrumented build (SIDH_OPCOUNT)
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <string.h>
+
+
+#if defined(SIDH_OPCOUNT)
+
+static __thread OpCounters opcount_thread;              // Counters of the calling thread
+static __thread OpCounters* opcount_curve = NULL;       // Counters of the curve isogeny structure in use by the calling thread
+static __thread OPCOUNT_PHASE opcount_phase = OPCOUNT_PHASE_OTHER;
+
+
+void opcount_add(OPCOUNT_OP op)
+{ // Counts one call to "op" in the current phase of the calling thread
+    opcount_thread.count[opcount_phase][op]++;
+    if (opcount_curve != NULL) {
+        __atomic_add_fetch(&opcount_curve->count[opcount_phase][op], 1, __ATOMIC_RELAXED);   // Several threads may use the same structure
+    }
+}
+
+
+void opcount_set_phase(OpCounters* Counters, OPCOUNT_PHASE phase)
+{ // Sets the current phase of the calling thread, whose operations are also counted in "Counters" if it is not NULL
+    opcount_curve = Counters;
+    opcount_phase = phase;
+}
+
+
+void opcount_detach(OpCounters* Counters)
+{ // Stops counting the operations of the calling thread in "Counters", which are about to be freed
+    if (opcount_curve == Counters) {
+        opcount_curve = NULL;
+    }
+}
+
+
+CRYPTO_STATUS SIDH_opcount_get(PCurveIsogenyStruct pCurveIsogeny, OpCounters* Counters)
+{ // Copy the operation counters of pCurveIsogeny, or of the calling thread if pCurveIsogeny is NULL, to Counters
+    unsigned int i, j;
+
+    if (Counters == NULL || (pCurveIsogeny != NULL && pCurveIsogeny->OpCounts == NULL)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    if (pCurveIsogeny == NULL) {
+        *Counters = opcount_thread;
+        return CRYPTO_SUCCESS;
+    }
+    for (i = 0; i < OPCOUNT_PHASE_END_OF_LIST; i++) {
+        for (j = 0; j < OPCOUNT_END_OF_LIST; j++) {
+            Counters->count[i][j] = __atomic_load_n(&pCurveIsogeny->OpCounts->count[i][j], __ATOMIC_RELAXED);
+        }
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_opcount_reset(PCurveIsogenyStruct pCurveIsogeny)
+{ // Reset the operation counters of pCurveIsogeny, or of the calling thread if pCurveIsogeny is NULL
+    unsigned int i, j;
+
+    if (pCurveIsogeny == NULL) {
+        memset(&opcount_thread, 0, sizeof(OpCounters));
+        return CRYPTO_SUCCESS;
+    }
+    if (pCurveIsogeny->OpCounts == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    for (i = 0; i < OPCOUNT_PHASE_END_OF_LIST; i++) {
+        for (j = 0; j < OPCOUNT_END_OF_LIST; j++) {
+            __atomic_store_n(&pCurveIsogeny->OpCounts->count[i][j], 0, __ATOMIC_RELAXED);
+        }
+    }
+    return CRYPTO_SUCCESS;
+}
+
+#else
+
+CRYPTO_STATUS SIDH_opcount_get(PCurveIsogenyStruct pCurveIsogeny, OpCounters* Counters)
+{ // Operation counters are not supported in this build
+    UNREFERENCED_PARAMETER(pCurveIsogeny);
+    UNREFERENCED_PARAMETER(Counters);
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+
+CRYPTO_STATUS SIDH_opcount_reset(PCurveIsogenyStruct pCurveIsogeny)
+{
+    UNREFERENCED_PARAMETER(pCurveIsogeny);
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+#endif
@@ -0,0 +1,296 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: cache of validated public keys for static key exchange
+*
+* SECURITY NOTE: lookups run in variable time because it is assumed that they are used over
+*                public data.
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <malloc.h>
+#include <string.h>
+#if defined(THREADS_SUPPORT)
+    #include <pthread.h>
+#endif
+
+#define PKCACHE_NONE    0xFFFFFFFF    // End of the LRU list and of the bucket chains
+
+
+// Entries are indexed by a digest of the party and the public key. The digest only selects the bucket: a hit requires the
+// whole key to match, so a collision can never make a key that has not been validated pass. The seeded digest is a fast mix, not a
+// keyed PRF: colliding keys may still be crafted, and the only effect of flooding a bucket with them is a longer chain to search.
+typedef struct {
+    uint64_t         digest;
+    unsigned int     AliceOrBob;
+    unsigned int     chain;                              // Next entry in the same bucket
+    unsigned int     prev;                               // Neighbours in the LRU list, most recently used first
+    unsigned int     next;
+} pkcache_entry;
+
+struct pkcache {
+    PCurveIsogenyStruct CurveIsogeny;
+    unsigned int     capacity;                           // Max. number of entries
+    unsigned int     count;                              // Number of entries in use
+    unsigned int     nbuckets;                           // Number of buckets, a power of 2
+    unsigned int     keybytes;                           // Size of a public key
+    unsigned int     first, last;                        // Most and least recently used entries
+    uint64_t         seed;                               // Random seed of the digest, which makes bucket flooding harder but does not prevent it
+    uint64_t         hits;
+    uint64_t         misses;
+#if defined(THREADS_SUPPORT)
+    pthread_mutex_t  lock;
+#endif
+    unsigned int*    buckets;
+    pkcache_entry*   entries;
+    unsigned char*   keys;                               // Public key of entry i at keys + i*keybytes
+};
+
+
+static void pkcache_lock(PPublicKeyCache Cache)
+{
+#if defined(THREADS_SUPPORT)
+    pthread_mutex_lock(&Cache->lock);
+#else
+    UNREFERENCED_PARAMETER(Cache);
+#endif
+}
+
+
+static void pkcache_unlock(PPublicKeyCache Cache)
+{
+#if defined(THREADS_SUPPORT)
+    pthread_mutex_unlock(&Cache->lock);
+#else
+    UNREFERENCED_PARAMETER(Cache);
+#endif
+}
+
+
+static uint64_t pkcache_digest(PPublicKeyCache Cache, unsigned int AliceOrBob, const unsigned char* pPublicKey)
+{ // Seeded, non-cryptographic 64-bit digest of a public key, read as little endian 64-bit words
+    uint64_t h = Cache->seed ^ ((uint64_t)AliceOrBob << 63), w;
+    unsigned int i, j;
+
+    for (i = 0; i < Cache->keybytes; i += 8) {
+        w = 0;
+        for (j = 0; j < 8 && i + j < Cache->keybytes; j++) {
+            w |= (uint64_t)pPublicKey[i + j] << (8*j);
+        }
+        h = (h ^ w) * 0x9E3779B97F4A7C15;
+        h ^= h >> 29;
+    }
+    h *= 0xBF58476D1CE4E5B9;
+    return h ^ (h >> 32);
+}
+
+
+static unsigned int pkcache_find(PPublicKeyCache Cache, uint64_t digest, unsigned int AliceOrBob, const unsigned char* pPublicKey)
+{ // Index of the entry holding the public key, or PKCACHE_NONE
+    unsigned int i = Cache->buckets[digest & (Cache->nbuckets - 1)];
+
+    while (i != PKCACHE_NONE) {
+        if (Cache->entries[i].digest == digest && Cache->entries[i].AliceOrBob == AliceOrBob &&
+            memcmp(Cache->keys + (size_t)i*Cache->keybytes, pPublicKey, Cache->keybytes) == 0) {
+            return i;
+        }
+        i = Cache->entries[i].chain;
+    }
+    return PKCACHE_NONE;
+}
+
+
+static void lru_unlink(PPublicKeyCache Cache, unsigned int i)
+{ // Removes entry i from the LRU list
+    pkcache_entry* e = &Cache->entries[i];
+
+    if (e->prev != PKCACHE_NONE) {
+        Cache->entries[e->prev].next = e->next;
+    } else {
+        Cache->first = e->next;
+    }
+    if (e->next != PKCACHE_NONE) {
+        Cache->entries[e->next].prev = e->prev;
+    } else {
+        Cache->last = e->prev;
+    }
+}
+
+
+static void lru_push(PPublicKeyCache Cache, unsigned int i)
+{ // Inserts entry i at the front of the LRU list
+    pkcache_entry* e = &Cache->entries[i];
+
+    e->prev = PKCACHE_NONE;
+    e->next = Cache->first;
+    if (Cache->first != PKCACHE_NONE) {
+        Cache->entries[Cache->first].prev = i;
+    } else {
+        Cache->last = i;
+    }
+    Cache->first = i;
+}
+
+
+static void pkcache_insert(PPublicKeyCache Cache, uint64_t digest, unsigned int AliceOrBob, const unsigned char* pPublicKey)
+{ // Records a validated public key, evicting the least recently used entry if the cache is full
+    unsigned int i, *link;
+
+    if (pkcache_find(Cache, digest, AliceOrBob, pPublicKey) != PKCACHE_NONE) {
+        return;    // Inserted by another thread that validated the same key concurrently
+    }
+
+    if (Cache->count < Cache->capacity) {
+        i = Cache->count++;
+    } else {
+        i = Cache->last;
+        lru_unlink(Cache, i);
+        link = &Cache->buckets[Cache->entries[i].digest & (Cache->nbuckets - 1)];
+        while (*link != i) {
+            link = &Cache->entries[*link].chain;
+        }
+        *link = Cache->entries[i].chain;
+    }
+
+    Cache->entries[i].digest = digest;
+    Cache->entries[i].AliceOrBob = AliceOrBob;
+    memcpy(Cache->keys + (size_t)i*Cache->keybytes, pPublicKey, Cache->keybytes);
+    link = &Cache->buckets[digest & (Cache->nbuckets - 1)];
+    Cache->entries[i].chain = *link;
+    *link = i;
+    lru_push(Cache, i);
+}
+
+
+CRYPTO_STATUS SIDH_pkcache_create(PCurveIsogenyStruct CurveIsogeny, unsigned int capacity, PPublicKeyCache* pCache)
+{ // Creates a cache of up to "capacity" validated public keys of CurveIsogeny
+    PPublicKeyCache Cache;
+    unsigned int i;
+    CRYPTO_STATUS Status;
+
+    if (pCache == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    *pCache = NULL;
+    if (is_CurveIsogenyStruct_null(CurveIsogeny) || CurveIsogeny->RandomBytesFunction == NULL || capacity < 1 || capacity > SIDH_PKCACHE_MAX_CAPACITY) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    Cache = (PPublicKeyCache) calloc(1, sizeof(struct pkcache));
+    if (Cache == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    Cache->CurveIsogeny = CurveIsogeny;
+    Cache->capacity = capacity;
+    Cache->keybytes = 4*2*((CurveIsogeny->pwordbits + 7)/8);
+    for (Cache->nbuckets = 1; Cache->nbuckets < capacity; Cache->nbuckets <<= 1);
+    Cache->first = Cache->last = PKCACHE_NONE;
+
+    Cache->buckets = (unsigned int*) calloc(Cache->nbuckets, sizeof(unsigned int));
+    Cache->entries = (pkcache_entry*) calloc(capacity, sizeof(pkcache_entry));
+    Cache->keys = (unsigned char*) calloc(capacity, Cache->keybytes);
+    if (Cache->buckets == NULL || Cache->entries == NULL || Cache->keys == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    for (i = 0; i < Cache->nbuckets; i++) {
+        Cache->buckets[i] = PKCACHE_NONE;
+    }
+    Status = (CurveIsogeny->RandomBytesFunction)(sizeof(Cache->seed), (unsigned char*)&Cache->seed);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+#if defined(THREADS_SUPPORT)
+    pthread_mutex_init(&Cache->lock, NULL);
+#endif
+
+    *pCache = Cache;
+    return CRYPTO_SUCCESS;
+
+cleanup:
+    free(Cache->buckets);
+    free(Cache->entries);
+    free(Cache->keys);
+    free(Cache);
+    return Status;
+}
+
+
+CRYPTO_STATUS SIDH_pkcache_validate(PPublicKeyCache Cache, unsigned int AliceOrBob, unsigned char* pPublicKey, bool* valid)
+{ // Validates Alice's (AliceOrBob = ALICE) or Bob's (AliceOrBob = BOB) public key, skipping the validation if the key is cached
+    uint64_t digest;
+    unsigned int i;
+    CRYPTO_STATUS Status;
+
+    if (Cache == NULL || AliceOrBob > 1 || pPublicKey == NULL || valid == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    digest = pkcache_digest(Cache, AliceOrBob, pPublicKey);
+
+    pkcache_lock(Cache);
+    i = pkcache_find(Cache, digest, AliceOrBob, pPublicKey);
+    if (i != PKCACHE_NONE) {
+        lru_unlink(Cache, i);
+        lru_push(Cache, i);
+        Cache->hits++;
+        pkcache_unlock(Cache);
+        *valid = true;
+        return CRYPTO_SUCCESS;
+    }
+    Cache->misses++;
+    pkcache_unlock(Cache);
+
+    // The validation runs without holding the lock
+    if (AliceOrBob == ALICE) {
+        Status = Validate_PKA(pPublicKey, valid, Cache->CurveIsogeny);
+    } else {
+        Status = Validate_PKB(pPublicKey, valid, Cache->CurveIsogeny);
+    }
+    if (Status != CRYPTO_SUCCESS || *valid == false) {
+        return Status;    // Only successful validations are recorded
+    }
+
+    pkcache_lock(Cache);
+    pkcache_insert(Cache, digest, AliceOrBob, pPublicKey);
+    pkcache_unlock(Cache);
+    return CRYPTO_SUCCESS;
+}
+
+
+void SIDH_pkcache_stats(PPublicKeyCache Cache, uint64_t* hits, uint64_t* misses, unsigned int* entries)
+{ // Reads the counters of the cache
+    if (Cache == NULL) {
+        return;
+    }
+    pkcache_lock(Cache);
+    if (hits != NULL) {
+        *hits = Cache->hits;
+    }
+    if (misses != NULL) {
+        *misses = Cache->misses;
+    }
+    if (entries != NULL) {
+        *entries = Cache->count;
+    }
+    pkcache_unlock(Cache);
+}
+
+
+void SIDH_pkcache_free(PPublicKeyCache Cache)
+{ // Frees the cache
+    if (Cache == NULL) {
+        return;
+    }
+#if defined(THREADS_SUPPORT)
+    pthread_mutex_destroy(&Cache->lock);
+#endif
+    free(Cache->buckets);
+    free(Cache->entries);
+    free(Cache->keys);
+    free(Cache);
+}
@@ -0,0 +1,209 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: optimal strategies for the isogeny tree traversals, computed from the costs measured on the host
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <malloc.h>
+#include <time.h>
+
+#define STRATEGY_NO_COST      ((uint64_t)-1)
+#define STRATEGY_MIN_TIME     (CLOCKS_PER_SEC/40)    // Min. duration of each cost measurement
+
+
+static unsigned int strategy_points(const unsigned int* splits, unsigned int nleaves, unsigned int max_points)
+{ // Number of points stored by the traversal of a tree on nleaves leaves, or max_points+1 if "splits" is not a valid strategy
+  // or needs more than max_points points. A tree on n leaves is split into a subtree on n-splits[n-1] leaves, which is traversed
+  // while the root is stored, and a subtree on splits[n-1] leaves.
+    unsigned int n, s, left, right, *points;
+
+    points = (unsigned int*) calloc(nleaves + 1, sizeof(unsigned int));
+    if (points == NULL) {
+        return max_points + 1;
+    }
+    points[1] = 0;
+    for (n = 2; n <= nleaves; n++) {
+        s = splits[n-1];
+        if (s < 1 || s > n-1) {
+            points[nleaves] = max_points + 1;
+            break;
+        }
+        left = points[n-s] + 1;
+        right = points[s];
+        points[n] = (left > right) ? left : right;
+        if (points[n] > max_points) {
+            points[nleaves] = max_points + 1;
+            break;
+        }
+    }
+    n = points[nleaves];
+    free(points);
+    return n;
+}
+
+
+CRYPTO_STATUS SIDH_compute_strategy(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, unsigned int cost_mul, unsigned int cost_eval, unsigned int max_points, unsigned int* splits)
+{ // Dynamic programming over the number of leaves as in SIDH-Magma/optimalstrategies.mag, except that the splits are limited to
+  // those whose subtrees are traversed with at most max_points stored points. Ties are broken towards more isogeny evaluations.
+    unsigned int nleaves, m, n, best, *points;
+    uint64_t *cost, c, best_cost;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || splits == NULL || AliceOrBob > 1 || cost_mul == 0 || cost_eval == 0 || max_points < 1) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, SIDH_compute_strategy_p503(pCurveIsogeny, AliceOrBob, cost_mul, cost_eval, max_points, splits));
+    nleaves = (AliceOrBob == ALICE) ? MAX_Alice : MAX_Bob;
+    if (max_points > ((AliceOrBob == ALICE) ? MAX_INT_POINTS_ALICE : MAX_INT_POINTS_BOB)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    cost = (uint64_t*) calloc(nleaves + 1, sizeof(uint64_t));
+    points = (unsigned int*) calloc(nleaves + 1, sizeof(unsigned int));
+    if (cost == NULL || points == NULL) {
+        free(cost);
+        free(points);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+
+    // cost[n] is the cost of the strategy on n leaves, which stores points[n] points
+    splits[0] = 0;
+    for (n = 2; n <= nleaves; n++) {
+        best = 0;
+        best_cost = STRATEGY_NO_COST;
+        for (m = 1; m < n; m++) {           // Subtree on m leaves after n-m multiplications, subtree on n-m leaves after m evaluations
+            if (points[m] + 1 > max_points) {
+                continue;
+            }
+            c = cost[m] + cost[n-m] + (uint64_t)(n-m)*cost_mul + (uint64_t)m*cost_eval;
+            if (c <= best_cost) {
+                best_cost = c;
+                best = m;
+            }
+        }
+        cost[n] = best_cost;
+        points[n] = (points[best] + 1 > points[n-best]) ? points[best] + 1 : points[n-best];
+        splits[n-1] = n - best;
+    }
+
+    free(cost);
+    free(points);
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS SIDH_set_strategy(PCurveIsogenyStruct pCurveIsogeny, unsigned int AliceOrBob, const unsigned int* splits)
+{ // Install the strategy "splits" for Alice's or Bob's isogeny tree traversals
+    unsigned int i, nleaves, max_points;
+    unsigned int* strategy;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || splits == NULL || AliceOrBob > 1) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, SIDH_set_strategy_p503(pCurveIsogeny, AliceOrBob, splits));
+    if (AliceOrBob == ALICE) {
+        nleaves = MAX_Alice;
+        max_points = MAX_INT_POINTS_ALICE;
+        strategy = pCurveIsogeny->StrategyAlice;
+    } else {
+        nleaves = MAX_Bob;
+        max_points = MAX_INT_POINTS_BOB;
+        strategy = pCurveIsogeny->StrategyBob;
+    }
+    if (strategy_points(splits, nleaves, max_points) > max_points) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+
+    for (i = 0; i < nleaves; i++) {
+        strategy[i] = splits[i];
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+typedef struct {
+    point_proj_t     P, Q;
+    f2elm_t          A, C;
+    f2elm_t          coeff[5];
+} strategy_bench;
+
+static void bench_mul_4(strategy_bench* b)  { xDBLe(b->P, b->Q, b->A, b->C, 2); }
+static void bench_eval_4(strategy_bench* b) { eval_4_isog(b->Q, b->coeff); }
+static void bench_mul_3(strategy_bench* b)  { xTPLe_A24(b->P, b->Q, b->A, b->C, 1); }
+static void bench_eval_3(strategy_bench* b) { eval_3_isog(b->Q, b->coeff); }
+
+
+static unsigned int measure_cost(void (*op)(strategy_bench*), strategy_bench* b)
+{ // Average duration of "op" in nanoseconds, at least 1
+    unsigned int i, reps = 16;
+    clock_t start, elapsed;
+    double ns;
+
+    op(b);                                  // Warm-up
+    while (true) {
+        start = clock();
+        for (i = 0; i < reps; i++) {
+            op(b);
+        }
+        elapsed = clock() - start;
+        if (elapsed >= STRATEGY_MIN_TIME || reps >= (1u << 30)) {
+            break;
+        }
+        reps *= 2;
+    }
+    ns = 1e9 * (double)elapsed / ((double)CLOCKS_PER_SEC * reps);
+    return (ns < 1.0) ? 1 : (unsigned int)(ns + 0.5);
+}
+
+
+CRYPTO_STATUS SIDH_tune_strategies(PCurveIsogenyStruct pCurveIsogeny, unsigned int* costs)
+{ // Measure the costs of the traversal operations and install the optimal strategies for them
+    keygen_precomp* Precomp;
+    strategy_bench* b;
+    unsigned int cost[4], splits[MAX_Bob];
+    CRYPTO_STATUS Status;
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny) || pCurveIsogeny->KeyGenPrecomp == NULL) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    FIELD_DISPATCH(pCurveIsogeny->pbits, SIDH_tune_strategies_p503(pCurveIsogeny, costs));
+    Precomp = (keygen_precomp*)pCurveIsogeny->KeyGenPrecomp;
+
+    // The operations are constant-time, any point on the starting curve gives the same costs
+    b = (strategy_bench*) calloc(1, sizeof(strategy_bench));
+    if (b == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    copy_words((digit_t*)Precomp->PAx, (digit_t*)b->P, 2*2*NWORDS_FIELD);
+    copy_words((digit_t*)Precomp->QAx, (digit_t*)b->Q, 2*2*NWORDS_FIELD);
+    fp2copy751(Precomp->A, b->A);
+    fp2copy751(Precomp->C, b->C);
+    get_4_isog(b->P, b->A, b->C, b->coeff);
+
+    cost[0] = measure_cost(bench_mul_4, b);
+    cost[1] = measure_cost(bench_eval_4, b);
+    cost[2] = measure_cost(bench_mul_3, b);
+    cost[3] = measure_cost(bench_eval_3, b);
+    clear_words((void*)b, sizeof(strategy_bench)/sizeof(digit_t));
+    free(b);
+    if (costs != NULL) {
+        costs[0] = cost[0]; costs[1] = cost[1]; costs[2] = cost[2]; costs[3] = cost[3];
+    }
+
+    Status = SIDH_compute_strategy(pCurveIsogeny, ALICE, cost[0], cost[1], MAX_INT_POINTS_ALICE, splits);
+    if (Status == CRYPTO_SUCCESS) {
+        Status = SIDH_set_strategy(pCurveIsogeny, ALICE, splits);
+    }
+    if (Status == CRYPTO_SUCCESS) {
+        Status = SIDH_compute_strategy(pCurveIsogeny, BOB, cost[2], cost[3], MAX_INT_POINTS_BOB, splits);
+    }
+    if (Status == CRYPTO_SUCCESS) {
+        Status = SIDH_set_strategy(pCurveIsogeny, BOB, splits);
+    }
+    return Status;
+}
@@ -0,0 +1,740 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: testing/benchmarking the field arithmetic
+*
+*********************************************************************************************/
+
+#include "test_extras.h"
+#include <stdio.h>
+
+
+extern const uint64_t p751[NWORDS_FIELD];
+
+
+// Benchmark and test parameters
+#define BENCH_LOOPS       100000  // Number of iterations per bench
+#define TEST_LOOPS        100000  // Number of iterations per test
+
+
+// Names of the field arithmetic backends
+static const char* ArithmeticNames[ARITHMETIC_END_OF_LIST] = { "default", "generic", "x64", "x64 BMI2/ADX", "ARM64" };
+
+
+bool fp_test(ARITHMETIC_ID id)
+{ // Tests for the field arithmetic using the backend "id", the one selected for the process
+    bool OK = true;
+    int n, passed;
+    unsigned int i;
+    felm_t a, b, c, d;
+    f2elm_t a2, b2, c2, d2, e2, f2, g2, h2;
+    df2elm_t tt1, tt2, tt3;
+    dfelm_t aa, bb;
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Testing field arithmetic over GF(p751) using the %s backend: \n\n", ArithmeticNames[id]);
+
+    // Montgomery multiplication, c = a*b*R^-1 mod p751, compared against a basic implementation
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a); fprandom751_test(b);
+        fpmul751_mont(a, b, c);
+        fpmul751_mont_basic(a, b, d);
+        if (fpcompare751(c, d) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p) multiplication tests ................................................ PASSED");
+    else { printf("  GF(p) multiplication tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Squaring, a^2 = a*a
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a);
+        fpsqr751_mont(a, c);
+        fpmul751_mont(a, a, d);
+        if (fpcompare751(c, d) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p) squaring tests ...................................................... PASSED");
+    else { printf("  GF(p) squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Integer squaring, a^2 = a*a, including the all-ones input that maximizes the carries
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a);
+        if (n == 0) {
+            for (i = 0; i < NWORDS_FIELD; i++) a[i] = (digit_t)-1;
+        }
+        mp_sqr(a, aa, NWORDS_FIELD);
+        mp_mul(a, a, bb, NWORDS_FIELD);
+        for (i = 0; i < 2*NWORDS_FIELD; i++) {
+            if (aa[i] != bb[i]) passed = 0;
+        }
+        if (passed == 0) break;
+    }
+    if (passed == 1) printf("  Integer squaring tests .................................................... PASSED");
+    else { printf("  Integer squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Inversion, a*a^-1 = 1, with the divstep inversion also compared against the exponentiation
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/100; n++)
+    {
+        fprandom751_test(a);
+        if (n == 0) {                                        // Extreme value p751-1
+            fpzero751(a);
+            mp_sub((digit_t*)&p751, a, a, NWORDS_FIELD);
+            a[0] -= 1;
+        }
+        fpcopy751(a, c);
+        fpinv751_mont(c);
+        fpmul751_mont(a, c, d);
+        from_mont(d, d);
+        fpzero751(b); b[0] = 1;
+        if (fpcompare751(d, b) != 0) { passed = 0; break; }
+        fpcopy751(a, c);
+        fpinv751_mont_fermat(c);
+#if defined(UINT128_SUPPORT)
+        fpcopy751(a, d);
+        fpinv751_mont_safegcd(d);
+        if (fpcompare751(c, d) != 0) { passed = 0; break; }
+#endif
+    }
+    fpzero751(a);                                            // 0 is mapped to 0
+    fpinv751_mont(a);
+    fpzero751(b);
+    if (fpcompare751(a, b) != 0) passed = 0;
+    if (passed == 1) printf("  GF(p) inversion tests ..................................................... PASSED");
+    else { printf("  GF(p) inversion tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // GF(p^2) multiplication and squaring, compared against the default formulas over the backend's GF(p) kernels
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fp2random751_test(a2); fp2random751_test(b2);
+        fp2mul751_mont(a2, b2, c2);
+        fp2mul751_mont_default(a2, b2, d2);
+        if (fp2compare751(c2, d2) != 0) { passed = 0; break; }
+        fp2sqr751_mont(a2, c2);
+        fp2mul751_mont(a2, a2, d2);
+        if (fp2compare751(c2, d2) != 0) { passed = 0; break; }
+        fp2copy751(a2, e2);                                  // Outputs overlapping the inputs
+        fp2mul751_mont(e2, b2, e2);
+        fp2mul751_mont(a2, b2, d2);
+        if (fp2compare751(e2, d2) != 0) { passed = 0; break; }
+        fp2copy751(a2, e2);
+        fp2sqr751_mont(e2, e2);
+        if (fp2compare751(e2, c2) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p^2) multiplication and squaring tests ................................. PASSED");
+    else { printf("  GF(p^2) multiplication and squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Lazy reduction, a*b+c*d and a*b-c*d with a single reduction per component
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fp2random751_test(a2); fp2random751_test(b2); fp2random751_test(c2); fp2random751_test(d2);
+        if (n == 0) {                                        // Extreme values p751-1
+            fpzero751(a2[0]);
+            mp_sub((digit_t*)&p751, a2[0], a2[0], NWORDS_FIELD);
+            a2[0][0] -= 1;
+            fpcopy751(a2[0], a2[1]); fp2copy751(a2, b2); fp2copy751(a2, c2);
+        }
+        fp2mul751_unreduced(a2, b2, tt1);
+        fp2mul751_unreduced(c2, d2, tt2);
+        fp2dfadd751(tt1, tt2, tt3);
+        fp2rdc751(tt3, e2);
+        fp2mul751_mont(a2, b2, f2);
+        fp2mul751_mont(c2, d2, g2);
+        fp2add751(f2, g2, h2);
+        if (fp2compare751(e2, h2) != 0) { passed = 0; break; }
+        fp2dfsub751(tt1, tt2, tt3);
+        fp2rdc751(tt3, e2);
+        fp2sub751(f2, g2, h2);
+        if (fp2compare751(e2, h2) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p^2) lazy reduction tests .............................................. PASSED");
+    else { printf("  GF(p^2) lazy reduction tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Reduction of the product of the extreme values p751-1
+    fpzero751(a);
+    mp_sub((digit_t*)&p751, a, a, NWORDS_FIELD);
+    a[0] -= 1;
+    mp_mul(a, a, aa, NWORDS_FIELD);
+    rdc_mont(aa, c);
+    fpmul751_mont_basic(a, a, d);
+    if (fpcompare751(c, d) == 0) printf("  GF(p) reduction edge-case tests ........................................... PASSED");
+    else { printf("  GF(p) reduction edge-case tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    return OK;
+}
+
+
+bool fp503_test()
+{ // Tests for the field arithmetic compiled for SIDHp503, using the backend selected for GF(p503), and for the kernels of the 
+  // other backends available against it
+    bool OK = true;
+    int n, passed;
+    unsigned int i;
+    felm503_t a, b, c, d;
+    f2elm503_t a2, b2, c2, d2, e2, f2, g2, h2;
+    df2elm503_t tt1, tt2, tt3;
+    dfelm503_t aa, bb;
+    const FieldArithmetic *selected = NULL, *backend = NULL;
+    ARITHMETIC_ID id;
+
+    fp_select_arithmetic_p503(ARITHMETIC_DEFAULT, &selected);
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Testing field arithmetic over GF(p503) using the %s backend: \n\n", ArithmeticNames[selected->Id]);
+
+    // Montgomery multiplication, c = a*b*R^-1 mod p503, compared against a basic implementation
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom503_test(a); fprandom503_test(b);
+        fpmul503_mont(a, b, c);
+        fpmul503_mont_basic(a, b, d);
+        if (fpcompare503(c, d) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p) multiplication tests ................................................ PASSED");
+    else { printf("  GF(p) multiplication tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Squaring, a^2 = a*a
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom503_test(a);
+        fpsqr503_mont(a, c);
+        fpmul503_mont(a, a, d);
+        if (fpcompare503(c, d) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p) squaring tests ...................................................... PASSED");
+    else { printf("  GF(p) squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Integer squaring, a^2 = a*a, including the all-ones input that maximizes the carries
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom503_test(a);
+        if (n == 0) {
+            for (i = 0; i < NWORDS_FIELD_P503; i++) a[i] = (digit_t)-1;
+        }
+        mp_sqr_p503(a, aa, NWORDS_FIELD_P503);
+        mp_mul_p503(a, a, bb, NWORDS_FIELD_P503);
+        if (compare_words(aa, bb, 2*NWORDS_FIELD_P503) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  Integer squaring tests .................................................... PASSED");
+    else { printf("  Integer squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Inversion, a*a^-1 = 1
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/100; n++)
+    {
+        fprandom503_test(a);
+        if (n == 0) {                                        // Extreme value p503-1
+            fpcopy503((digit_t*)&p503, a);
+            a[0] -= 1;
+        }
+        fpcopy503(a, c);
+        fpinv503_mont(c);
+        fpmul503_mont(a, c, d);
+        from_mont_p503(d, d);
+        fpzero503(b); b[0] = 1;
+        if (fpcompare503(d, b) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p) inversion tests ..................................................... PASSED");
+    else { printf("  GF(p) inversion tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // GF(p^2) multiplication and squaring, compared against the default formulas over the backend's GF(p) kernels
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fp2random503_test(a2); fp2random503_test(b2);
+        fp2mul503_mont(a2, b2, c2);
+        fp2mul503_mont_default(a2, b2, d2);
+        if (fp2compare503(c2, d2) != 0) { passed = 0; break; }
+        fp2sqr503_mont(a2, c2);
+        fp2mul503_mont(a2, a2, d2);
+        if (fp2compare503(c2, d2) != 0) { passed = 0; break; }
+        fp2copy503(a2, e2);                                  // Outputs overlapping the inputs
+        fp2mul503_mont(e2, b2, e2);
+        fp2mul503_mont(a2, b2, d2);
+        if (fp2compare503(e2, d2) != 0) { passed = 0; break; }
+        fp2copy503(a2, e2);
+        fp2sqr503_mont(e2, e2);
+        if (fp2compare503(e2, c2) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p^2) multiplication and squaring tests ................................. PASSED");
+    else { printf("  GF(p^2) multiplication and squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Lazy reduction, a*b+c*d and a*b-c*d with a single reduction per component
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fp2random503_test(a2); fp2random503_test(b2); fp2random503_test(c2); fp2random503_test(d2);
+        if (n == 0) {                                        // Extreme values p503-1
+            fpcopy503((digit_t*)&p503, a2[0]);
+            a2[0][0] -= 1;
+            fpcopy503(a2[0], a2[1]); fp2copy503(a2, b2); fp2copy503(a2, c2);
+        }
+        fp2mul503_unreduced(a2, b2, tt1);
+        fp2mul503_unreduced(c2, d2, tt2);
+        fp2dfadd503(tt1, tt2, tt3);
+        fp2rdc503(tt3, e2);
+        fp2mul503_mont(a2, b2, f2);
+        fp2mul503_mont(c2, d2, g2);
+        fp2add503(f2, g2, h2);
+        if (fp2compare503(e2, h2) != 0) { passed = 0; break; }
+        fp2dfsub503(tt1, tt2, tt3);
+        fp2rdc503(tt3, e2);
+        fp2sub503(f2, g2, h2);
+        if (fp2compare503(e2, h2) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p^2) lazy reduction tests .............................................. PASSED");
+    else { printf("  GF(p^2) lazy reduction tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Reduction of the product of the extreme values p503-1
+    fpcopy503((digit_t*)&p503, a);
+    a[0] -= 1;
+    mp_mul_p503(a, a, aa, NWORDS_FIELD_P503);
+    rdc_mont_p503(aa, c);
+    fpmul503_mont_basic(a, a, d);
+    if (fpcompare503(c, d) == 0) printf("  GF(p) reduction edge-case tests ........................................... PASSED");
+    else { printf("  GF(p) reduction edge-case tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // Multiplication, squaring and reduction kernels of the other backends, including the fused GF(p^2) kernels
+    for (id = ARITHMETIC_GENERIC; id < ARITHMETIC_END_OF_LIST; id++) {
+        if (fp_get_arithmetic_p503(id, &backend) != CRYPTO_SUCCESS || backend == selected) {
+            continue;
+        }
+        printf("\nTesting the %s backend against the %s backend over GF(p503): \n\n", ArithmeticNames[backend->Id], ArithmeticNames[selected->Id]);
+        passed = 1;
+        for (n = 0; n < TEST_LOOPS; n++)
+        {
+            fprandom503_test(a); fprandom503_test(b);
+            selected->mp_mul(a, b, aa, NWORDS_FIELD_P503);
+            backend->mp_mul(a, b, bb, NWORDS_FIELD_P503);
+            if (compare_words(aa, bb, 2*NWORDS_FIELD_P503) != 0) { passed = 0; break; }
+            selected->mp_sqr(a, aa, NWORDS_FIELD_P503);
+            backend->mp_sqr(a, bb, NWORDS_FIELD_P503);
+            if (compare_words(aa, bb, 2*NWORDS_FIELD_P503) != 0) { passed = 0; break; }
+            selected->rdc_mont(aa, c);
+            backend->rdc_mont(bb, d);
+            if (fpcompare503(c, d) != 0) { passed = 0; break; }
+            fp2random503_test(a2); fp2random503_test(b2);    // The table types use the GF(p751) element size, hence the casts
+            selected->fp2mul((void*)a2, (void*)b2, (void*)c2);
+            backend->fp2mul((void*)a2, (void*)b2, (void*)d2);
+            if (fp2compare503(c2, d2) != 0) { passed = 0; break; }
+            selected->fp2sqr((void*)a2, (void*)c2);
+            backend->fp2sqr((void*)a2, (void*)d2);
+            if (fp2compare503(c2, d2) != 0) { passed = 0; break; }
+        }
+        if (passed == 1) printf("  Multiplication, squaring and reduction kernel tests ....................... PASSED");
+        else { printf("  Multiplication, squaring and reduction kernel tests... FAILED"); printf("\n"); return false; }
+        printf("\n");
+    }
+
+    return OK;
+}
+
+
+bool backend_test(const FieldArithmetic* selected, const FieldArithmetic* backend)
+{ // Tests for the kernels of "backend" against those of the backend "selected" used by the process, which passed fp_test()
+    int n, passed;
+    felm_t a, b, c, d;
+    f2elm_t a2, b2, c2, d2;
+    dfelm_t aa, bb;
+    const FieldArithmetic* current;
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Testing the %s backend against the %s backend: \n\n", ArithmeticNames[backend->Id], ArithmeticNames[selected->Id]);
+
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a); fprandom751_test(b);
+        selected->fpadd(a, b, c);
+        backend->fpadd(a, b, d);
+        if (fpcompare751(c, d) != 0) { passed = 0; break; }
+        selected->fpsub(a, b, c);
+        backend->fpsub(a, b, d);
+        if (fpcompare751(c, d) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p) addition and subtraction tests ...................................... PASSED");
+    else { printf("  GF(p) addition and subtraction tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a); fprandom751_test(b);
+        selected->mp_mul(a, b, aa, NWORDS_FIELD);
+        backend->mp_mul(a, b, bb, NWORDS_FIELD);
+        if (compare_words(aa, bb, 2*NWORDS_FIELD) != 0) { passed = 0; break; }
+        selected->mp_sqr(a, aa, NWORDS_FIELD);
+        backend->mp_sqr(a, bb, NWORDS_FIELD);
+        if (compare_words(aa, bb, 2*NWORDS_FIELD) != 0) { passed = 0; break; }
+        selected->rdc_mont(aa, c);
+        backend->rdc_mont(bb, d);
+        if (fpcompare751(c, d) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  Integer multiplication and Montgomery reduction tests ..................... PASSED");
+    else { printf("  Integer multiplication and Montgomery reduction tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fp2random751_test(a2); fp2random751_test(b2);
+        selected->fp2mul(a2, b2, c2);
+        backend->fp2mul(a2, b2, d2);
+        if (fp2compare751(c2, d2) != 0) { passed = 0; break; }
+        selected->fp2sqr(a2, c2);
+        backend->fp2sqr(a2, d2);
+        if (fp2compare751(c2, d2) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  GF(p^2) multiplication and squaring tests ................................. PASSED");
+    else { printf("  GF(p^2) multiplication and squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // The backend of the process is selected once, so it cannot be switched to "backend"
+    current = NULL;
+    if (fp_select_arithmetic(backend->Id, &current) == CRYPTO_ERROR_INVALID_PARAMETER && current == selected) printf("  Backend selection tests ................................................... PASSED");
+    else { printf("  Backend selection tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    return true;
+}
+
+
+#if (TARGET == TARGET_AMD64) && (OS_TARGET == OS_LINUX) && !defined(GENERIC_IMPLEMENTATION)
+
+bool adx_test()
+{ // Tests for the BMI2/ADX multiplication and reduction kernels against the baseline x64 assembly
+    int n, passed;
+    felm_t a, b, c, d;
+    dfelm_t aa, bb;
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Testing BMI2/ADX kernels against the baseline x64 assembly: \n\n");
+
+    if (!is_adx_supported()) {
+        printf("  BMI2/ADX not supported by this processor, tests skipped \n");
+        return true;
+    }
+
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a); fprandom751_test(b);
+        mul751_asm(a, b, aa);
+        mul751_adx(a, b, bb);
+        if (compare_words(aa, bb, 2*NWORDS_FIELD) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  Integer multiplication tests .............................................. PASSED");
+    else { printf("  Integer multiplication tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        fprandom751_test(a); fprandom751_test(b);
+        mul751_asm(a, b, aa);
+        copy_words(aa, bb, 2*NWORDS_FIELD);
+        rdc751_asm(aa, c);
+        rdc751_adx(bb, d);
+        if (compare_words(c, d, NWORDS_FIELD) != 0) { passed = 0; break; }
+    }
+    if (passed == 1) printf("  Montgomery reduction tests ................................................ PASSED");
+    else { printf("  Montgomery reduction tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    return true;
+}
+
+#endif
+
+
+#if defined(MULTIBUFFER_SUPPORT)
+
+bool mb_test()
+{ // Tests for the multi-buffer field arithmetic against the scalar field arithmetic, lane by lane
+    int n, passed;
+    unsigned int j;
+    f2elm_t a[MB_LANES], b[MB_LANES], c[MB_LANES], d;
+    vf2elm_t va, vb, vc;
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Testing the %d-lane multi-buffer field arithmetic against the scalar field arithmetic: \n\n", MB_LANES);
+
+    // Packing and unpacking, a = unpack(pack(a))
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/MB_LANES; n++)
+    {
+        for (j = 0; j < MB_LANES; j++) {
+            fp2random751_test(a[j]);
+        }
+        vfp2pack751(a, va);
+        vfp2unpack751(va, c);
+        for (j = 0; j < MB_LANES; j++) {
+            if (fp2compare751(a[j], c[j]) != 0) { passed = 0; break; }
+        }
+        if (passed == 0) break;
+    }
+    if (passed == 1) printf("  Packing tests ............................................................. PASSED");
+    else { printf("  Packing tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // GF(p) multiplication on the first coordinates, compared against fpmul751_mont
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/MB_LANES; n++)
+    {
+        for (j = 0; j < MB_LANES; j++) {
+            fp2random751_test(a[j]); fp2random751_test(b[j]);
+        }
+        vfp2pack751(a, va); vfp2pack751(b, vb);
+        vfpmul751_mont(va[0], vb[0], vc[0]);
+        vfpcopy751(va[1], vc[1]);
+        vfp2unpack751(vc, c);
+        for (j = 0; j < MB_LANES; j++) {
+            fpmul751_mont(a[j][0], b[j][0], d[0]);
+            if (fpcompare751(c[j][0], d[0]) != 0) { passed = 0; break; }
+        }
+        if (passed == 0) break;
+    }
+    if (passed == 1) printf("  GF(p) multiplication tests ................................................ PASSED");
+    else { printf("  GF(p) multiplication tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // GF(p^2) addition and subtraction, compared against fp2add751 and fp2sub751
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/MB_LANES; n++)
+    {
+        for (j = 0; j < MB_LANES; j++) {
+            fp2random751_test(a[j]); fp2random751_test(b[j]);
+        }
+        vfp2pack751(a, va); vfp2pack751(b, vb);
+        vfp2add751(va, vb, vc);
+        vfp2unpack751(vc, c);
+        for (j = 0; j < MB_LANES; j++) {
+            fp2add751(a[j], b[j], d);
+            if (fp2compare751(c[j], d) != 0) { passed = 0; break; }
+        }
+        vfp2sub751(va, vb, vc);
+        vfp2unpack751(vc, c);
+        for (j = 0; j < MB_LANES; j++) {
+            fp2sub751(a[j], b[j], d);
+            if (fp2compare751(c[j], d) != 0) { passed = 0; break; }
+        }
+        if (passed == 0) break;
+    }
+    if (passed == 1) printf("  GF(p^2) addition and subtraction tests .................................... PASSED");
+    else { printf("  GF(p^2) addition and subtraction tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // GF(p^2) multiplication, compared against fp2mul751_mont
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/MB_LANES; n++)
+    {
+        for (j = 0; j < MB_LANES; j++) {
+            fp2random751_test(a[j]); fp2random751_test(b[j]);
+        }
+        vfp2pack751(a, va); vfp2pack751(b, vb);
+        vfp2mul751_mont(va, vb, vc);
+        vfp2unpack751(vc, c);
+        for (j = 0; j < MB_LANES; j++) {
+            fp2mul751_mont(a[j], b[j], d);
+            if (fp2compare751(c[j], d) != 0) { passed = 0; break; }
+        }
+        if (passed == 0) break;
+    }
+    if (passed == 1) printf("  GF(p^2) multiplication tests .............................................. PASSED");
+    else { printf("  GF(p^2) multiplication tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    // GF(p^2) squaring, compared against fp2sqr751_mont
+    passed = 1;
+    for (n = 0; n < TEST_LOOPS/MB_LANES; n++)
+    {
+        for (j = 0; j < MB_LANES; j++) {
+            fp2random751_test(a[j]);
+        }
+        vfp2pack751(a, va);
+        vfp2sqr751_mont(va, vc);
+        vfp2unpack751(vc, c);
+        for (j = 0; j < MB_LANES; j++) {
+            fp2sqr751_mont(a[j], d);
+            if (fp2compare751(c[j], d) != 0) { passed = 0; break; }
+        }
+        if (passed == 0) break;
+    }
+    if (passed == 1) printf("  GF(p^2) squaring tests .................................................... PASSED");
+    else { printf("  GF(p^2) squaring tests... FAILED"); printf("\n"); return false; }
+    printf("\n");
+
+    return true;
+}
+
+#endif
+
+
+bool fp_run(const FieldArithmetic* selected)
+{
+    bool OK = true;
+    int n;
+    unsigned long long cycles, cycles1, cycles2;
+    felm_t a, b, c;
+    dfelm_t aa;
+
+    printf("\n--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Benchmarking field arithmetic over GF(p751) using the %s backend: \n\n", ArithmeticNames[selected->Id]);
+
+    fprandom751_test(a); fprandom751_test(b);
+
+    // GF(p) multiplication using p751
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        fpmul751_mont(a, b, c);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  GF(p) multiplication runs in ............................................... %7lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+    // Integer multiplication
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        mp_mul(a, b, aa, NWORDS_FIELD);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Integer multiplication runs in ............................................. %7lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+    // Integer squaring
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        mp_sqr(a, aa, NWORDS_FIELD);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Integer squaring runs in ................................................... %7lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+    // Montgomery reduction
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        mp_mul(a, b, aa, NWORDS_FIELD);
+        cycles1 = cpucycles();
+        rdc_mont(aa, c);
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Montgomery reduction runs in ............................................... %7lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+#if (TARGET == TARGET_AMD64) && (OS_TARGET == OS_LINUX) && !defined(GENERIC_IMPLEMENTATION)
+    if (is_adx_supported()) {
+        // Baseline and BMI2/ADX kernels, side by side
+        cycles = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            cycles1 = cpucycles();
+            mul751_asm(a, b, aa);
+            cycles2 = cpucycles();
+            cycles = cycles+(cycles2-cycles1);
+        }
+        printf("  Integer multiplication (baseline) runs in .................................. %7lld cycles", cycles/BENCH_LOOPS);
+        printf("\n");
+
+        cycles = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            cycles1 = cpucycles();
+            mul751_adx(a, b, aa);
+            cycles2 = cpucycles();
+            cycles = cycles+(cycles2-cycles1);
+        }
+        printf("  Integer multiplication (BMI2/ADX) runs in .................................. %7lld cycles", cycles/BENCH_LOOPS);
+        printf("\n");
+
+        cycles = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            mul751_asm(a, b, aa);
+            cycles1 = cpucycles();
+            rdc751_asm(aa, c);
+            cycles2 = cpucycles();
+            cycles = cycles+(cycles2-cycles1);
+        }
+        printf("  Montgomery reduction (baseline) runs in .................................... %7lld cycles", cycles/BENCH_LOOPS);
+        printf("\n");
+
+        cycles = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            mul751_asm(a, b, aa);
+            cycles1 = cpucycles();
+            rdc751_adx(aa, c);
+            cycles2 = cpucycles();
+            cycles = cycles+(cycles2-cycles1);
+        }
+        printf("  Montgomery reduction (BMI2/ADX) runs in .................................... %7lld cycles", cycles/BENCH_LOOPS);
+        printf("\n");
+    }
+#endif
+
+    return OK;
+}
+
+
+int main()
+{
+    bool OK = true;
+    const FieldArithmetic *selected = NULL, *backend = NULL;
+    ARITHMETIC_ID id;
+
+    fp_select_arithmetic(ARITHMETIC_DEFAULT, &selected);   // The fastest backend supported by the processor is used by the process
+    OK = OK && fp_test(selected->Id);  // Test field operations using p751 with the selected backend
+    for (id = ARITHMETIC_GENERIC; id < ARITHMETIC_END_OF_LIST; id++) {
+        if (fp_get_arithmetic(id, &backend) == CRYPTO_SUCCESS && backend != selected) {
+            OK = OK && backend_test(selected, backend);    // Test every other backend available against it
+        }
+    }
+    OK = OK && fp503_test();           // Test field operations using p503 and its backends
+#if (TARGET == TARGET_AMD64) && (OS_TARGET == OS_LINUX) && !defined(GENERIC_IMPLEMENTATION)
+    OK = OK && adx_test();             // Test the BMI2/ADX kernels
+#endif
+#if defined(MULTIBUFFER_SUPPORT)
+    OK = OK && mb_test();              // Test the multi-buffer arithmetic of the SIMD option
+#endif
+
+    OK = OK && fp_run(selected);       // Benchmark field operations using p751 with the selected backend
+
+    return OK;
+}
@@ -0,0 +1,571 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: benchmarking the field arithmetic, the curve and isogeny primitives and the key exchange
+*
+*********************************************************************************************/
+
+#include "test_extras.h"
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if (OS_TARGET == OS_LINUX)
+    #include <time.h>
+    #include <unistd.h>
+#endif
+#if defined(THREADS_SUPPORT)
+    #include <pthread.h>
+#endif
+
+
+// Benchmark parameters
+#define BENCH_WARMUP          10      // Number of untimed runs before the samples of each primitive
+#define BENCH_SAMPLES_FAST    1000    // Number of samples of the field and curve primitives
+#define BENCH_BATCH_FAST      100     // Number of calls per sample of the field and curve primitives
+#define BENCH_SAMPLES_SLOW    25      // Number of samples of the scalar multiplications, validations and key exchange functions
+#define BENCH_KEX_PER_THREAD  4       // Number of full key exchanges per thread in the throughput benchmark
+#define BENCH_MAX_RESULTS     32
+#define BENCH_STACK_SIZE      (1 << 20)   // Size of the stack on which the peak stack usage of each API function is measured
+
+
+// Names of the field arithmetic backends
+static const char* ArithmeticNames[ARITHMETIC_END_OF_LIST] = { "default", "generic", "x64", "x64 BMI2/ADX", "ARM64" };
+
+
+static const char* backend_name(void)
+{ // Name of the field arithmetic backend used by the process
+    const FieldArithmetic* arithmetic = NULL;
+
+    fp_select_arithmetic(ARITHMETIC_DEFAULT, &arithmetic);
+    return ArithmeticNames[arithmetic->Id];
+}
+
+
+// Operands of the benchmarked primitives
+typedef struct {
+    PCurveIsogenyStruct CurveIsogeny;
+    felm_t a, b, c;
+    f2elm_t a2, b2, c2, A, C;
+    f2elm_t coeff[5];
+    f2elm_t PKA[4], PKB[4];                                  // Public keys in Montgomery representation
+    point_proj_t P, Q, R;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecret;
+    CRYPTO_STATUS Status;
+} bench_ctx;
+
+typedef void (*bench_fn)(bench_ctx* ctx);
+
+typedef struct {
+    const char* name;
+    unsigned int samples;
+    unsigned int batch;
+    double median, p99, mean, min;                           // Cycles per call
+} bench_result;
+
+static bench_result results[BENCH_MAX_RESULTS];
+static unsigned int nresults = 0;
+
+
+static void record_status(bench_ctx* ctx, CRYPTO_STATUS Status)
+{ // Keeps the first error of the benchmarked functions
+    if (Status != CRYPTO_SUCCESS && ctx->Status == CRYPTO_SUCCESS) {
+        ctx->Status = Status;
+    }
+}
+
+
+static void run_fpmul(bench_ctx* ctx)    { fpmul751_mont(ctx->a, ctx->b, ctx->c); }
+static void run_fpsqr(bench_ctx* ctx)    { fpsqr751_mont(ctx->a, ctx->c); }
+static void run_fpinv(bench_ctx* ctx)    { fpinv751_mont(ctx->c); }
+static void run_fpinv_fermat(bench_ctx* ctx)  { fpinv751_mont_fermat(ctx->c); }
+#if defined(UINT128_SUPPORT)
+static void run_fpinv_safegcd(bench_ctx* ctx) { fpinv751_mont_safegcd(ctx->c); }
+#endif
+static void run_fp2inv(bench_ctx* ctx)   { fp2inv751_mont(ctx->c2); }
+static void run_fp2mul(bench_ctx* ctx)   { fp2mul751_mont(ctx->a2, ctx->b2, ctx->c2); }
+static void run_fp2sqr(bench_ctx* ctx)   { fp2sqr751_mont(ctx->a2, ctx->c2); }
+static void run_xDBLe(bench_ctx* ctx)    { xDBLe(ctx->P, ctx->Q, ctx->A, ctx->C, 2); }
+static void run_xTPLe(bench_ctx* ctx)    { xTPLe(ctx->P, ctx->Q, ctx->A, ctx->C, 1); }
+static void run_eval_4(bench_ctx* ctx)   { eval_4_isog(ctx->Q, ctx->coeff); }
+static void run_eval_3(bench_ctx* ctx)   { eval_3_isog(ctx->Q, ctx->coeff); }
+
+static void run_secret_pt_A(bench_ctx* ctx)
+{
+    record_status(ctx, secret_pt(((keygen_precomp*)ctx->CurveIsogeny->KeyGenPrecomp)->PA, (digit_t*)ctx->PrivateKeyA, ALICE, ctx->R, ctx->CurveIsogeny));
+}
+
+static void run_secret_pt_B(bench_ctx* ctx)
+{
+    record_status(ctx, secret_pt(((keygen_precomp*)ctx->CurveIsogeny->KeyGenPrecomp)->PB, (digit_t*)ctx->PrivateKeyB, BOB, ctx->R, ctx->CurveIsogeny));
+}
+
+static void run_ladder_3_pt_A(bench_ctx* ctx)
+{
+    record_status(ctx, ladder_3_pt(ctx->PKB[1], ctx->PKB[2], ctx->PKB[3], (digit_t*)ctx->PrivateKeyA, ALICE, ctx->R, ctx->PKB[0], ctx->CurveIsogeny));
+}
+
+static void run_ladder_3_pt_B(bench_ctx* ctx)
+{
+    record_status(ctx, ladder_3_pt(ctx->PKA[1], ctx->PKA[2], ctx->PKA[3], (digit_t*)ctx->PrivateKeyB, BOB, ctx->R, ctx->PKA[0], ctx->CurveIsogeny));
+}
+
+static void run_validate_A(bench_ctx* ctx)
+{
+    bool valid;
+    record_status(ctx, Validate_PKA(ctx->PublicKeyA, &valid, ctx->CurveIsogeny));
+    if (valid == false) record_status(ctx, CRYPTO_ERROR_PUBLIC_KEY_VALIDATION);
+}
+
+static void run_validate_B(bench_ctx* ctx)
+{
+    bool valid;
+    record_status(ctx, Validate_PKB(ctx->PublicKeyB, &valid, ctx->CurveIsogeny));
+    if (valid == false) record_status(ctx, CRYPTO_ERROR_PUBLIC_KEY_VALIDATION);
+}
+
+static void run_keygen_A(bench_ctx* ctx) { record_status(ctx, KeyGeneration_A(ctx->PrivateKeyA, ctx->PublicKeyA, ctx->CurveIsogeny)); }
+static void run_keygen_B(bench_ctx* ctx) { record_status(ctx, KeyGeneration_B(ctx->PrivateKeyB, ctx->PublicKeyB, ctx->CurveIsogeny)); }
+static void run_agree_A(bench_ctx* ctx)  { record_status(ctx, SecretAgreement_A(ctx->PrivateKeyA, ctx->PublicKeyB, ctx->SharedSecret, ctx->CurveIsogeny)); }
+static void run_agree_B(bench_ctx* ctx)  { record_status(ctx, SecretAgreement_B(ctx->PrivateKeyB, ctx->PublicKeyA, ctx->SharedSecret, ctx->CurveIsogeny)); }
+
+static void run_agree_validated_A(bench_ctx* ctx)
+{
+    bool valid;
+    record_status(ctx, SecretAgreement_A_validated(ctx->PrivateKeyA, ctx->PublicKeyB, ctx->SharedSecret, &valid, ctx->CurveIsogeny));
+    if (valid == false) record_status(ctx, CRYPTO_ERROR_PUBLIC_KEY_VALIDATION);
+}
+
+static void run_agree_validated_B(bench_ctx* ctx)
+{
+    bool valid;
+    record_status(ctx, SecretAgreement_B_validated(ctx->PrivateKeyB, ctx->PublicKeyA, ctx->SharedSecret, &valid, ctx->CurveIsogeny));
+    if (valid == false) record_status(ctx, CRYPTO_ERROR_PUBLIC_KEY_VALIDATION);
+}
+
+
+static int compare_samples(const void* a, const void* b)
+{
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+
+static void bench_op(const char* name, bench_fn fn, bench_ctx* ctx, unsigned int nsamples, unsigned int batch)
+{ // Times "nsamples" batches of "batch" calls to fn() after BENCH_WARMUP untimed calls, and records the statistics per call
+    double* samples = (double*)calloc(nsamples, sizeof(double));
+    bench_result* result = &results[nresults];
+    unsigned long long cycles1, cycles2;
+    unsigned int n, k;
+    double sum = 0;
+
+    if (samples == NULL || nresults == BENCH_MAX_RESULTS) {
+        free(samples);
+        return;
+    }
+    for (n = 0; n < BENCH_WARMUP; n++) {
+        fn(ctx);
+    }
+    for (n = 0; n < nsamples; n++) {
+        cycles1 = cpucycles();
+        for (k = 0; k < batch; k++) {
+            fn(ctx);
+        }
+        cycles2 = cpucycles();
+        samples[n] = (double)(cycles2 - cycles1) / batch;
+        sum += samples[n];
+    }
+    qsort(samples, nsamples, sizeof(double), compare_samples);
+
+    result->name = name;
+    result->samples = nsamples;
+    result->batch = batch;
+    result->median = samples[nsamples/2];
+    result->p99 = samples[(99*nsamples + 99)/100 - 1];
+    result->mean = sum / nsamples;
+    result->min = samples[0];
+    nresults++;
+    free(samples);
+}
+
+
+static double wall_time(void)
+{ // Wall-clock time in seconds
+#if (OS_TARGET == OS_LINUX)
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (double)time.tv_sec + 1e-9*(double)time.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+
+static void* kex_worker(void* arg)
+{ // Runs BENCH_KEX_PER_THREAD full key exchanges on the curve isogeny structure "arg"
+    PCurveIsogenyStruct CurveIsogeny = (PCurveIsogenyStruct)arg;
+    digit_t PrivateKeyA[NWORDS_ORDER], PrivateKeyB[NWORDS_ORDER];
+    publickey_t PublicKeyA, PublicKeyB;
+    f2elm_t SharedSecretA, SharedSecretB;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    unsigned int n;
+
+    for (n = 0; n < BENCH_KEX_PER_THREAD && Status == CRYPTO_SUCCESS; n++) {
+        Status = KeyGeneration_A((unsigned char*)PrivateKeyA, (unsigned char*)PublicKeyA, CurveIsogeny);
+        if (Status == CRYPTO_SUCCESS) Status = KeyGeneration_B((unsigned char*)PrivateKeyB, (unsigned char*)PublicKeyB, CurveIsogeny);
+        if (Status == CRYPTO_SUCCESS) Status = SecretAgreement_A((unsigned char*)PrivateKeyA, (unsigned char*)PublicKeyB, (unsigned char*)SharedSecretA, CurveIsogeny);
+        if (Status == CRYPTO_SUCCESS) Status = SecretAgreement_B((unsigned char*)PrivateKeyB, (unsigned char*)PublicKeyA, (unsigned char*)SharedSecretB, CurveIsogeny);
+    }
+    return (Status == CRYPTO_SUCCESS) ? NULL : arg;
+}
+
+
+static double kex_throughput(PCurveIsogenyStruct CurveIsogeny, unsigned int nthreads)
+{ // Full key exchanges per second computed by nthreads threads running concurrently, 0 on error
+#if defined(THREADS_SUPPORT)
+    pthread_t threads[SIDH_MAX_THREADS];
+    void* ret;
+    unsigned int i, nstarted = 0;
+    bool failed = false;
+    double start = wall_time(), elapsed;
+
+    for (i = 0; i < nthreads; i++) {
+        if (pthread_create(&threads[i], NULL, kex_worker, CurveIsogeny) != 0) {
+            failed = true;
+            break;
+        }
+        nstarted++;
+    }
+    for (i = 0; i < nstarted; i++) {
+        pthread_join(threads[i], &ret);
+        failed = failed || (ret != NULL);
+    }
+#else
+    bool failed;
+    double start = wall_time(), elapsed;
+
+    failed = (nthreads != 1) || (kex_worker(CurveIsogeny) != NULL);
+#endif
+    elapsed = wall_time() - start;
+    if (failed || elapsed <= 0) {
+        return 0;
+    }
+    return (double)(nthreads*BENCH_KEX_PER_THREAD) / elapsed;
+}
+
+
+static CRYPTO_STATUS bench_setup(bench_ctx* ctx, PCurveIsogenyStaticData CurveIsogenyData)
+{ // Allocates and initializes the operands
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8, obytes = (CurveIsogenyData->owordbits + 7)/8, i;
+    point_proj_t K;
+    CRYPTO_STATUS Status;
+
+    memset(ctx, 0, sizeof(bench_ctx));
+    ctx->PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    ctx->PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    ctx->PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    ctx->PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    ctx->SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
+    ctx->CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (ctx->CurveIsogeny == NULL || ctx->PrivateKeyA == NULL || ctx->PrivateKeyB == NULL || ctx->PublicKeyA == NULL ||
+        ctx->PublicKeyB == NULL || ctx->SharedSecret == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    Status = SIDH_curve_initialize(ctx->CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+
+    Status = KeyGeneration_A(ctx->PrivateKeyA, ctx->PublicKeyA, ctx->CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    Status = KeyGeneration_B(ctx->PrivateKeyB, ctx->PublicKeyB, ctx->CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    if (CurveIsogenyData->pbits != 751) {
+        return CRYPTO_SUCCESS;                     // The field and curve operands are only used with SIDHp751
+    }
+    for (i = 0; i < 4; i++) {
+        to_fp2mont(((f2elm_t*)ctx->PublicKeyA)[i], ctx->PKA[i]);
+        to_fp2mont(((f2elm_t*)ctx->PublicKeyB)[i], ctx->PKB[i]);
+    }
+
+    fprandom751_test(ctx->a); fprandom751_test(ctx->b); fprandom751_test(ctx->c);
+    fp2random751_test(ctx->a2); fp2random751_test(ctx->b2);
+    fp2random751_test(ctx->A); fp2random751_test(ctx->C);
+    fp2random751_test(ctx->P->X); fp2random751_test(ctx->P->Z);
+    fp2random751_test(ctx->Q->X); fp2random751_test(ctx->Q->Z);
+    fp2random751_test(K->X); fp2random751_test(K->Z);
+    get_4_isog(K, ctx->A, ctx->C, ctx->coeff);              // Coefficients used by eval_4_isog() and eval_3_isog()
+    fp2random751_test(ctx->A); fp2random751_test(ctx->C);
+
+    return CRYPTO_SUCCESS;
+}
+
+
+static void bench_cleanup(bench_ctx* ctx)
+{
+    SIDH_curve_free(ctx->CurveIsogeny);
+    free(ctx->PrivateKeyA);
+    free(ctx->PrivateKeyB);
+    free(ctx->PublicKeyA);
+    free(ctx->PublicKeyB);
+    free(ctx->SharedSecret);
+}
+
+
+static void print_text(unsigned int nthreads, double* throughput)
+{
+    unsigned int i;
+
+    printf("\nBENCHMARKING SIDHp751 USING THE %s BACKEND (CYCLES PER CALL, %d WARMUP CALLS) \n", backend_name(), BENCH_WARMUP);
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("  %-28s %14s %14s %14s %14s\n", "primitive", "median", "p99", "mean", "min");
+    for (i = 0; i < nresults; i++) {
+        printf("  %-28s %14.0f %14.0f %14.0f %14.0f\n", results[i].name, results[i].median, results[i].p99, results[i].mean, results[i].min);
+    }
+    printf("\n  Key exchange throughput (%d key exchanges per thread): \n", BENCH_KEX_PER_THREAD);
+    for (i = 1; i <= nthreads; i++) {
+        printf("  %2d thread(s) ............................................ %10.2f key exchanges/s\n", i, throughput[i-1]);
+    }
+    printf("\n");
+}
+
+
+static void print_json(unsigned int nthreads, double* throughput)
+{
+    unsigned int i;
+
+    printf("{\n");
+    printf("  \"curve\": \"SIDHp751\",\n");
+    printf("  \"backend\": \"%s\",\n", backend_name());
+#if defined(GENERIC_IMPLEMENTATION)
+    printf("  \"implementation\": \"generic\",\n");
+#else
+    printf("  \"implementation\": \"optimized\",\n");
+#endif
+#if defined(MULTIBUFFER_SUPPORT)
+    printf("  \"mb_lanes\": %d,\n", MB_LANES);
+#endif
+    printf("  \"fixed_base_window\": %d,\n", FIXED_BASE_WINDOW);
+    printf("  \"warmup\": %d,\n", BENCH_WARMUP);
+    printf("  \"unit\": \"cycles\",\n");
+    printf("  \"primitives\": [\n");
+    for (i = 0; i < nresults; i++) {
+        printf("    {\"name\": \"%s\", \"samples\": %d, \"batch\": %d, \"median\": %.1f, \"p99\": %.1f, \"mean\": %.1f, \"min\": %.1f}%s\n",
+               results[i].name, results[i].samples, results[i].batch, results[i].median, results[i].p99, results[i].mean, results[i].min,
+               (i + 1 < nresults) ? "," : "");
+    }
+    printf("  ],\n");
+    printf("  \"throughput\": [\n");
+    for (i = 1; i <= nthreads; i++) {
+        printf("    {\"threads\": %d, \"kex_per_second\": %.3f}%s\n", i, throughput[i-1], (i < nthreads) ? "," : "");
+    }
+    printf("  ]\n");
+    printf("}\n");
+}
+
+
+static void print_splits(const char* name, const char* size, const unsigned int* splits, unsigned int nleaves)
+{
+    unsigned int i;
+
+    printf("const unsigned int %s[%s] = {", name, size);
+    for (i = 0; i < nleaves; i++) {
+        printf("%s%d%s", (i % 16 == 0) ? "\n " : " ", splits[i], (i + 1 < nleaves) ? "," : "");
+    }
+    printf(" };\n");
+}
+
+
+static CRYPTO_STATUS print_strategies(PCurveIsogenyStruct CurveIsogeny)
+{ // Tunes the strategies on this processor and prints them in the format of the precomputed tables of SIDH.c
+    unsigned int costs[4];
+    CRYPTO_STATUS Status;
+
+    Status = SIDH_tune_strategies(CurveIsogeny, costs);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    printf("// Optimal strategies for the %s backend, measured costs (ns): 4-mult %d, 4-isog eval %d, 3-mult %d, 3-isog eval %d\n\n",
+           ArithmeticNames[CurveIsogeny->Arithmetic.Id], costs[0], costs[1], costs[2], costs[3]);
+    print_splits("splits_Alice", "MAX_Alice", CurveIsogeny->StrategyAlice, SIDH_STRATEGY_LEAVES_ALICE);
+    printf("\n");
+    print_splits("splits_Bob", "MAX_Bob", CurveIsogeny->StrategyBob, SIDH_STRATEGY_LEAVES_BOB);
+    return CRYPTO_SUCCESS;
+}
+
+
+typedef struct {
+    bench_fn fn;
+    bench_ctx* ctx;
+} stack_call;
+
+static void run_stack_call(void* arg)
+{
+    stack_call* call = (stack_call*)arg;
+    call->fn(call->ctx);
+}
+
+
+static CRYPTO_STATUS print_stack(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Measures and prints the peak stack usage of the key exchange and validation functions on the curve isogeny system CurveIsogenyData
+    static const struct {
+        const char* name;
+        bench_fn fn;
+    } calls[] = {
+        { "KeyGeneration_A", run_keygen_A }, { "KeyGeneration_B", run_keygen_B },
+        { "SecretAgreement_A", run_agree_A }, { "SecretAgreement_B", run_agree_B },
+        { "Validate_PKA", run_validate_A }, { "Validate_PKB", run_validate_B },
+        { "SecretAgreement_A_validated", run_agree_validated_A }, { "SecretAgreement_B_validated", run_agree_validated_B } };
+    bench_ctx ctx;
+    stack_call call;
+    size_t used;
+    unsigned int i;
+    CRYPTO_STATUS Status;
+
+    Status = bench_setup(&ctx, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        bench_cleanup(&ctx);
+        return Status;
+    }
+    printf("\nPEAK STACK USAGE ON %s (BYTES), ", CurveIsogenyData->CurveIsogeny);
+#if defined(LOW_MEMORY_SUPPORT)
+    printf("LOW-MEMORY MODE, AT MOST %d STORED POINTS PER TRAVERSAL \n", LOW_MEMORY_POINTS);
+#else
+    printf("DEFAULT MODE, AT MOST %d (ALICE) AND %d (BOB) STORED POINTS PER TRAVERSAL \n", ctx.CurveIsogeny->pbits == 751 ? SIDH_STRATEGY_POINTS_ALICE : SIDHp503_STRATEGY_POINTS_ALICE,
+           ctx.CurveIsogeny->pbits == 751 ? SIDH_STRATEGY_POINTS_BOB : SIDHp503_STRATEGY_POINTS_BOB);
+#endif
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    call.ctx = &ctx;
+    for (i = 0; i < sizeof(calls)/sizeof(calls[0]); i++) {
+        call.fn = calls[i].fn;
+        used = stack_usage(run_stack_call, &call, BENCH_STACK_SIZE);
+        if (used == 0 || used == BENCH_STACK_SIZE) {
+            Status = CRYPTO_ERROR;
+            break;
+        }
+        printf("  %-28s %10d\n", calls[i].name, (int)used);
+    }
+    if (ctx.Status != CRYPTO_SUCCESS) {
+        Status = ctx.Status;
+    }
+    bench_cleanup(&ctx);
+    return Status;
+}
+
+
+int main(int argc, char** argv)
+{ // Usage: bench [-json] [-threads N] [-strategies] [-stack]
+  // -json prints the results in JSON format, -threads N measures the key exchange throughput with 1 to N threads
+  // (by default, the number of online processors, at most SIDH_MAX_THREADS). -strategies only prints the optimal strategies
+  // for this processor as C tables, see SIDH_tune_strategies(). -stack only prints the peak stack usage of the key exchange
+  // and validation functions on SIDHp751 and SIDHp503 (Linux only), e.g., to compare with the low-memory mode (LOW_MEMORY option).
+    bench_ctx ctx;
+    double throughput[SIDH_MAX_THREADS];
+    unsigned int i, nthreads = 1;
+    bool json = false, strategies = false, stack = false;
+    CRYPTO_STATUS Status;
+
+#if defined(THREADS_SUPPORT)
+    nthreads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    for (i = 1; i < (unsigned int)argc; i++) {
+        if (strcmp(argv[i], "-json") == 0) {
+            json = true;
+        } else if (strcmp(argv[i], "-strategies") == 0) {
+            strategies = true;
+        } else if (strcmp(argv[i], "-stack") == 0) {
+            stack = true;
+        } else if (strcmp(argv[i], "-threads") == 0 && i + 1 < (unsigned int)argc) {
+            nthreads = (unsigned int)atoi(argv[++i]);
+        } else {
+            fprintf(stderr, "Usage: %s [-json] [-threads N] [-strategies] [-stack]\n", argv[0]);
+            return false;
+        }
+    }
+#if !defined(THREADS_SUPPORT)
+    nthreads = 1;                                  // Only the calling thread without thread support (see the THREADS option)
+#endif
+    if (nthreads < 1) nthreads = 1;
+    if (nthreads > SIDH_MAX_THREADS) nthreads = SIDH_MAX_THREADS;
+
+    if (stack) {
+        Status = print_stack(&CurveIsogeny_SIDHp751);
+        if (Status == CRYPTO_SUCCESS) {
+            Status = print_stack(&CurveIsogeny_SIDHp503);
+        }
+        if (Status != CRYPTO_SUCCESS) {
+            fprintf(stderr, "\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        }
+        return (Status == CRYPTO_SUCCESS);
+    }
+
+    Status = bench_setup(&ctx, &CurveIsogeny_SIDHp751);
+    if (Status != CRYPTO_SUCCESS) {
+        fprintf(stderr, "\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        bench_cleanup(&ctx);
+        return false;
+    }
+    if (strategies) {
+        Status = print_strategies(ctx.CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            fprintf(stderr, "\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        }
+        bench_cleanup(&ctx);
+        return (Status == CRYPTO_SUCCESS);
+    }
+
+    bench_op("fpmul751_mont", run_fpmul, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST);
+    bench_op("fpsqr751_mont", run_fpsqr, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST);
+    bench_op("fpinv751_mont", run_fpinv, &ctx, BENCH_SAMPLES_FAST/10, 1);
+    bench_op("fpinv751_mont (Fermat)", run_fpinv_fermat, &ctx, BENCH_SAMPLES_FAST/10, 1);
+#if defined(UINT128_SUPPORT)
+    bench_op("fpinv751_mont (safegcd)", run_fpinv_safegcd, &ctx, BENCH_SAMPLES_FAST/10, 1);
+#endif
+    bench_op("fp2mul751_mont", run_fp2mul, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST);
+    bench_op("fp2sqr751_mont", run_fp2sqr, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST);
+    bench_op("fp2inv751_mont", run_fp2inv, &ctx, BENCH_SAMPLES_FAST/10, 1);
+    bench_op("xDBLe (e=2)", run_xDBLe, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST/10);
+    bench_op("xTPLe (e=1)", run_xTPLe, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST/10);
+    bench_op("eval_4_isog", run_eval_4, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST/10);
+    bench_op("eval_3_isog", run_eval_3, &ctx, BENCH_SAMPLES_FAST, BENCH_BATCH_FAST/10);
+    bench_op("secret_pt (Alice)", run_secret_pt_A, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("secret_pt (Bob)", run_secret_pt_B, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("ladder_3_pt (Alice)", run_ladder_3_pt_A, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("ladder_3_pt (Bob)", run_ladder_3_pt_B, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("Validate_PKA", run_validate_A, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("Validate_PKB", run_validate_B, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("KeyGeneration_A", run_keygen_A, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("KeyGeneration_B", run_keygen_B, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("SecretAgreement_A", run_agree_A, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("SecretAgreement_B", run_agree_B, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("SecretAgreement_A_validated", run_agree_validated_A, &ctx, BENCH_SAMPLES_SLOW, 1);
+    bench_op("SecretAgreement_B_validated", run_agree_validated_B, &ctx, BENCH_SAMPLES_SLOW, 1);
+
+    for (i = 1; i <= nthreads; i++) {
+        throughput[i-1] = kex_throughput(ctx.CurveIsogeny, i);
+        if (throughput[i-1] == 0) ctx.Status = CRYPTO_ERROR;
+    }
+
+    if (ctx.Status != CRYPTO_SUCCESS) {
+        fprintf(stderr, "\n\n   Error detected during the benchmarks \n\n");
+        bench_cleanup(&ctx);
+        return false;
+    }
+    if (json) {
+        print_json(nthreads, throughput);
+    } else {
+        print_text(nthreads, throughput);
+    }
+
+    bench_cleanup(&ctx);
+    return true;
+}
@@ -13,11 +13,13 @@
 #include "test_extras.h"
 #include <malloc.h>
 #include <stdio.h>
+#include <time.h>
 
 
 // Benchmark and test parameters  
 #define BENCH_LOOPS       10      // Number of iterations per bench 
 #define TEST_LOOPS        10      // Number of iterations per test
+#define BATCH_KEYS        10      // Number of key pairs per batch, not a multiple of the number of multi-buffer lanes 
 
 // Used in BigMont tests
 static const uint64_t output1[12] = { 0x30E9AFA5BF75A92F, 0x88BC71EE9E221028, 0x999A50A9EE3B9A8E, 0x77E2934BD8D38B5A, 0x2668CAFC2933DB58, 0x457C65F7AD941041, 
@@ -119,17 +121,25 @@ cleanup:
 }
 
 
-CRYPTO_STATUS cryptotest_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
-{ // Testing BigMont
-    unsigned int i, j; 
-    digit_t scalar[BIGMONT_NWORDS_ORDER] = {0};
-    felm_t x = {0};
+CRYPTO_STATUS cryptotest_kex_batch(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing batched key exchange
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int i;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB, *SharedSecret;
     PCurveIsogenyStruct CurveIsogeny = {0};
-    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS, Statuses[BATCH_KEYS];
+    bool valid_PublicKey = false;
     bool passed = true;
-
-    printf("\n\nTESTING ELLIPTIC CURVE BIGMONT \n");
-    printf("--------------------------------------------------------------------------------------------------------\n\n");
+        
+    // Allocating memory for BATCH_KEYS private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(BATCH_KEYS, obytes);        
+    PrivateKeyB = (unsigned char*)calloc(BATCH_KEYS, obytes);
+    PublicKeyA = (unsigned char*)calloc(BATCH_KEYS, 4*2*pbytes);     
+    PublicKeyB = (unsigned char*)calloc(BATCH_KEYS, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(BATCH_KEYS, 2*pbytes);    
+    SharedSecretB = (unsigned char*)calloc(BATCH_KEYS, 2*pbytes);
+    SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
 
     // Curve isogeny system initialization
     CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
@@ -141,61 +151,156 @@ CRYPTO_STATUS cryptotest_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
     if (Status != CRYPTO_SUCCESS) {
         goto cleanup;
     }
-    
-    copy_words((digit_t*)scalar1, scalar, BIGMONT_NWORDS_ORDER);    // Set scalar
-    x[0] = 3;                                                       // Set initial x-coordinate
 
-    for (i = 0; i < TEST_LOOPS; i++)
-    {
-        for (j = 0; j < BIGMONT_NWORDS_ORDER-1; j++) {
-            scalar[j] = (scalar[j] >> 1) | (scalar[j+1] << (RADIX-1));  
+    Status = KeyGeneration_A_batch(PrivateKeyA, PublicKeyA, BATCH_KEYS, CurveIsogeny);  // Alice's and Bob's key pairs, computed in one batch each
+    if (Status != CRYPTO_SUCCESS) {                                                  
+        goto cleanup;
+    }  
+    Status = KeyGeneration_B_batch(PrivateKeyB, PublicKeyB, BATCH_KEYS, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {                                                  
+        goto cleanup;
+    }
+    for (i = 0; i < BATCH_KEYS; i++) {
+        Status = Validate_PKA(PublicKeyA + i*4*2*pbytes, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {  
+            goto cleanup;
+        }  
+        if (valid_PublicKey != true) {
+            passed = false;
+            Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+            goto finish;
         }
-        scalar[BIGMONT_NWORDS_ORDER-1] >>= 1;
+        Status = Validate_PKB(PublicKeyB + i*4*2*pbytes, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {  
+            goto cleanup;
+        }  
+        if (valid_PublicKey != true) {
+            passed = false;
+            Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION;
+            goto finish;
+        }
+    }
+    
+    Status = SecretAgreement_A_batch(PrivateKeyA, PublicKeyB, SharedSecretA, BATCH_KEYS, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }    
+    Status = SecretAgreement_B_batch(PrivateKeyB, PublicKeyA, SharedSecretB, BATCH_KEYS, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
 
-        Status = BigMont_ladder((unsigned char*)x, scalar, (unsigned char*)x, CurveIsogeny);   
+    for (i = 0; i < BATCH_KEYS; i++) {
+        if (compare_words((digit_t*)(SharedSecretA + i*2*pbytes), (digit_t*)(SharedSecretB + i*2*pbytes), NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            goto finish;
+        }
+        // The batched shared secret must match the one computed individually 
+        Status = SecretAgreement_A(PrivateKeyA + i*obytes, PublicKeyB + i*4*2*pbytes, SharedSecret, CurveIsogeny);
         if (Status != CRYPTO_SUCCESS) {
             goto cleanup;
         }
+        if (compare_words((digit_t*)(SharedSecretA + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            goto finish;
+        }
     }
 
-    if (compare_words((digit_t*)x, (digit_t*)output1, BIGMONT_NWORDS_ORDER) != 0) {
+    // A crafted (all-zero) public key in the batch only zeroes its own shared secret, the other ones must still match the individual ones.
+    // The individual functions must fail on the crafted key in the same way
+    clear_words((void*)(PublicKeyB + 1*4*2*pbytes), NBYTES_TO_NWORDS(4*2*pbytes));
+    clear_words((void*)(PublicKeyA + 1*4*2*pbytes), NBYTES_TO_NWORDS(4*2*pbytes));
+    Status = SecretAgreement_A_batch_status(PrivateKeyA, PublicKeyB, SharedSecretA, Statuses, BATCH_KEYS, CurveIsogeny);
+    if (Status != CRYPTO_ERROR_SHARED_KEY) {
         passed = false;
-        Status = CRYPTO_ERROR_SHARED_KEY;
+        goto finish;
+    }
+    Status = SecretAgreement_B_batch(PrivateKeyB, PublicKeyA, SharedSecretB, BATCH_KEYS, CurveIsogeny);
+    if (Status != CRYPTO_ERROR_SHARED_KEY) {
+        passed = false;
+        goto finish;
     }
+    for (i = 0; i < BATCH_KEYS; i++) {
+        if (i == 1) {
+            if (SecretAgreement_A(PrivateKeyA + i*obytes, PublicKeyB + i*4*2*pbytes, SharedSecret, CurveIsogeny) != CRYPTO_ERROR_SHARED_KEY ||
+                compare_words((digit_t*)(SharedSecretA + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+                passed = false;
+            }
+            if (SecretAgreement_B(PrivateKeyB + i*obytes, PublicKeyA + i*4*2*pbytes, SharedSecret, CurveIsogeny) != CRYPTO_ERROR_SHARED_KEY ||
+                compare_words((digit_t*)(SharedSecretB + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+                passed = false;
+            }
+            clear_words((void*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes));
+            if (Statuses[i] != CRYPTO_ERROR_SHARED_KEY || compare_words((digit_t*)(SharedSecretA + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+                compare_words((digit_t*)(SharedSecretB + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+                passed = false;
+            }
+            continue;
+        }
+        Status = SecretAgreement_A(PrivateKeyA + i*obytes, PublicKeyB + i*4*2*pbytes, SharedSecret, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (Statuses[i] != CRYPTO_SUCCESS || compare_words((digit_t*)(SharedSecretA + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+        Status = SecretAgreement_B(PrivateKeyB + i*obytes, PublicKeyA + i*4*2*pbytes, SharedSecret, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)(SharedSecretB + i*2*pbytes), (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+    }
+    Status = (passed == true) ? CRYPTO_SUCCESS : CRYPTO_ERROR_SHARED_KEY;
 
-    if (passed == true) printf("  BigMont's scalar multiplication tests ........................ PASSED");
-    else { printf("  BigMont's scalar multiplication tests ... FAILED"); printf("\n"); goto cleanup; }
+finish:
+    if (passed == true) printf("  Batched key exchange tests ................................... PASSED");
+    else { printf("  Batched key exchange tests ... FAILED"); printf("\n"); goto cleanup; }
     printf("\n"); 
 
 cleanup:
     SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(BATCH_KEYS*obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(BATCH_KEYS*obytes));
+    clear_words((void*)PublicKeyA, NBYTES_TO_NWORDS(BATCH_KEYS*4*2*pbytes));
+    clear_words((void*)PublicKeyB, NBYTES_TO_NWORDS(BATCH_KEYS*4*2*pbytes));
+    clear_words((void*)SharedSecretA, NBYTES_TO_NWORDS(BATCH_KEYS*2*pbytes));
+    clear_words((void*)SharedSecretB, NBYTES_TO_NWORDS(BATCH_KEYS*2*pbytes));
+    clear_words((void*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecret);
 
     return Status;
 }
 
 
-CRYPTO_STATUS cryptorun_kex(PCurveIsogenyStaticData CurveIsogenyData)
-{ // Benchmarking key exchange
-    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
-    unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
-    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
-    bool valid_PublicKey = false;
+CRYPTO_STATUS cryptotest_kex_step(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing step-wise key exchange, interleaving Alice's and Bob's operations in slices of a few work units
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int n, nsteps, budget;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB, *SharedSecret;
     PCurveIsogenyStruct CurveIsogeny = {0};
-    unsigned long long cycles, cycles1, cycles2;
+    PKexStep KexStepA = NULL, KexStepB = NULL;
     CRYPTO_STATUS Status = CRYPTO_SUCCESS;
-    bool passed;
-        
-    // Allocating memory for private keys, public keys and shared secrets
-    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    bool doneA, doneB, valid_PublicKey = false;
+    bool passed = true;
+
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
     PrivateKeyB = (unsigned char*)calloc(1, obytes);
-    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);     // Four elements in GF(p^2)
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
     PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
-    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
     SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
-
-    printf("\n\nBENCHMARKING ISOGENY-BASED KEY EXCHANGE \n");
-    printf("--------------------------------------------------------------------------------------------------------\n\n");
-    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+    SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
 
     // Curve isogeny system initialization
     CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
@@ -208,139 +313,124 @@ CRYPTO_STATUS cryptorun_kex(PCurveIsogenyStaticData CurveIsogenyData)
         goto cleanup;
     }
 
-    // Benchmarking Alice's key generation
-    passed = true;
-    cycles = 0;
-    for (n = 0; n < BENCH_LOOPS; n++)
-    {
-        cycles1 = cpucycles();
-        Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);                     
-        if (Status != CRYPTO_SUCCESS) {                                                  
-            passed = false;
-            break;
-        }    
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
-    }
-    if (passed) printf("  Alice's key generation runs in ............................... %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  Alice's key generation failed"); goto cleanup; } 
-    printf("\n");
+    for (n = 0; n < TEST_LOOPS && passed; n++) {
+        budget = (n == 0) ? 1 : 7*n;                                                 // Slices of 1, 7, 14, ... units
 
-    // Benchmarking Bob's key generation
-    passed = true;
-    cycles = 0;
-    for (n = 0; n < BENCH_LOOPS; n++)
-    {
-        cycles1 = cpucycles();
-        Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);                     
-        if (Status != CRYPTO_SUCCESS) {                                                  
+        // Alice's and Bob's key pairs, computed in turns
+        Status = SIDH_kex_start(CurveIsogeny, SIDH_KEX_KEYGEN_A, PrivateKeyA, PublicKeyA, NULL, &KexStepA);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SIDH_kex_start(CurveIsogeny, SIDH_KEX_KEYGEN_B, PrivateKeyB, PublicKeyB, NULL, &KexStepB);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        doneA = doneB = false;
+        for (nsteps = 0; !doneA || !doneB; nsteps++) {
+            if (!doneA && (Status = SIDH_kex_step(KexStepA, budget, &doneA)) != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            if (!doneB && (Status = SIDH_kex_step(KexStepB, budget, &doneB)) != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+        }
+        SIDH_kex_free(KexStepA);
+        SIDH_kex_free(KexStepB);
+        KexStepA = KexStepB = NULL;
+        if (nsteps < 2) {
             passed = false;
             break;
-        }    
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
-    }
-    if (passed) printf("  Bob's key generation runs in ................................. %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  Bob's key generation failed"); goto cleanup; } 
-    printf("\n");
+        }
 
-    // Benchmarking Alice's public key validation
-    passed = true;
-    cycles = 0;
-    for (n = 0; n < BENCH_LOOPS; n++)
-    {
-        cycles1 = cpucycles();
-        Status = Validate_PKA(PublicKeyA, &valid_PublicKey, CurveIsogeny);                     
-        if (Status != CRYPTO_SUCCESS || valid_PublicKey != true) {                                                  
-            passed = false;
-            break;
-        }    
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
-    }
-    if (passed) printf("  Alice's public key validation runs in ........................ %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  Alice's public key validation failed"); goto cleanup; } 
-    printf("\n");
+        Status = Validate_PKA(PublicKeyA, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+        Status = Validate_PKB(PublicKeyB, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
 
-    // Benchmarking Bob's public key validation
-    passed = true;
-    cycles = 0;
-    for (n = 0; n < BENCH_LOOPS; n++)
-    {
-        cycles1 = cpucycles();
-        Status = Validate_PKB(PublicKeyB, &valid_PublicKey, CurveIsogeny);                     
-        if (Status != CRYPTO_SUCCESS || valid_PublicKey != true) {                                                  
-            passed = false;
-            break;
-        }    
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
-    }
-    if (passed) printf("  Bob's public key validation runs in .......................... %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  Bob's public key validation failed"); goto cleanup; } 
-    printf("\n");
+        // Shared secrets, computed in turns
+        Status = SIDH_kex_start(CurveIsogeny, SIDH_KEX_SHARED_A, PrivateKeyA, PublicKeyB, SharedSecretA, &KexStepA);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SIDH_kex_start(CurveIsogeny, SIDH_KEX_SHARED_B, PrivateKeyB, PublicKeyA, SharedSecretB, &KexStepB);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        doneA = doneB = false;
+        while (!doneA || !doneB) {
+            if (!doneA && (Status = SIDH_kex_step(KexStepA, budget, &doneA)) != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            if (!doneB && (Status = SIDH_kex_step(KexStepB, budget, &doneB)) != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+        }
+        SIDH_kex_free(KexStepA);
+        SIDH_kex_free(KexStepB);
+        KexStepA = KexStepB = NULL;
 
-    // Benchmarking Alice's shared key computation
-    passed = true;
-    cycles = 0;
-    for (n = 0; n < BENCH_LOOPS; n++)
-    {
-        cycles1 = cpucycles();
-        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);                     
-        if (Status != CRYPTO_SUCCESS) {                                                  
+        // The shared secrets must match each other and the one computed by SecretAgreement_A()
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecret, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+            compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
             passed = false;
-            break;
-        }    
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
+        }
     }
-    if (passed) printf("  Alice's shared key computation runs in ....................... %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  Alice's shared key computation failed"); goto cleanup; } 
-    printf("\n");
 
-    // Benchmarking Bob's shared key computation
-    passed = true;
-    cycles = 0;
-    for (n = 0; n < BENCH_LOOPS; n++)
-    {
-        cycles1 = cpucycles();
-        Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);                     
-        if (Status != CRYPTO_SUCCESS) {                                                  
-            passed = false;
-            break;
-        }    
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
-    }
-    if (passed) printf("  Bob's shared key computation runs in ......................... %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  Bob's shared key computation failed"); goto cleanup; } 
-    printf("\n");
+    if (passed == true) printf("  Step-wise key exchange tests ................................. PASSED");
+    else { printf("  Step-wise key exchange tests ... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
 
 cleanup:
+    SIDH_kex_free(KexStepA);
+    SIDH_kex_free(KexStepB);
     SIDH_curve_free(CurveIsogeny);
     clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
     clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
-    clear_words((void*)PublicKeyA, NBYTES_TO_NWORDS(4*2*pbytes));
-    clear_words((void*)PublicKeyB, NBYTES_TO_NWORDS(4*2*pbytes));
     clear_words((void*)SharedSecretA, NBYTES_TO_NWORDS(2*pbytes));
     clear_words((void*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes));
+    clear_words((void*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecret);
 
     return Status;
 }
 
 
-CRYPTO_STATUS cryptorun_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
-{ // Benchmarking BigMont
-    unsigned int i; 
-    digit_t scalar[BIGMONT_NWORDS_ORDER] = {0};
-    f2elm_t x = {0};
+CRYPTO_STATUS cryptotest_kex_compression(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with compressed public keys
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int n;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPKA, *CompressedPKB, *SharedSecretA, *SharedSecretB, *SharedSecret;
     PCurveIsogenyStruct CurveIsogeny = {0};
-    unsigned long long cycles, cycles1, cycles2;
     CRYPTO_STATUS Status = CRYPTO_SUCCESS;
-    bool passed;
-
-    printf("\n\nBENCHMARKING ELLIPTIC CURVE BIGMONT \n");
-    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);     
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    CompressedPKA = (unsigned char*)calloc(1, SIDH_COMPRESSED_PKA_BYTES);
+    CompressedPKB = (unsigned char*)calloc(1, SIDH_COMPRESSED_PKB_BYTES);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
 
     // Curve isogeny system initialization
     CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
@@ -352,29 +442,2281 @@ CRYPTO_STATUS cryptorun_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
     if (Status != CRYPTO_SUCCESS) {
         goto cleanup;
     }
-    
-    x[0][0] = 3;                                                    // Set initial x-coordinate
-    
-    passed = true;
-    cycles = 0;
-    for (i = 0; i < BENCH_LOOPS; i++)
-    {        
-        // Choose a random number in [1, BigMont_order-1] as scalar
-        Status = random_BigMont_mod_order(scalar, CurveIsogeny);    
-        if (Status != CRYPTO_SUCCESS) {
+
+    for (n = 0; n < TEST_LOOPS; n++)
+    {
+        Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }  
+        Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }
+        Status = PublicKeyCompression_A(PublicKeyA, CompressedPKA, CurveIsogeny);                        // Alice compresses her public key
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }
+        Status = PublicKeyCompression_B(PublicKeyB, CompressedPKB, CurveIsogeny);                        // Bob compresses his public key
+        if (Status != CRYPTO_SUCCESS) {                                                  
             goto cleanup;
         }
 
-        cycles1 = cpucycles();
-        Status = BigMont_ladder((unsigned char*)x, scalar, (unsigned char*)x, CurveIsogeny);   
+        // The shared secrets computed from compressed keys must match the ones computed from uncompressed keys
+        Status = SecretAgreement_Compression_A(PrivateKeyA, CompressedPKB, SharedSecretA, CurveIsogeny);
         if (Status != CRYPTO_SUCCESS) {
             goto cleanup;
-        }   
-        cycles2 = cpucycles();
-        cycles = cycles+(cycles2-cycles1);
-    }
-    if (passed) printf("  BigMont's scalar multiplication runs in ...................... %10lld cycles", cycles/BENCH_LOOPS);
-    else { printf("  BigMont's scalar multiplication failed"); goto cleanup; } 
+        }    
+        Status = SecretAgreement_Compression_B(PrivateKeyB, CompressedPKA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecret, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+            compare_words((digit_t*)SharedSecretB, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+    }
+
+    if (passed == true) printf("  Key exchange tests with compressed public keys ............... PASSED");
+    else { printf("  Key exchange tests with compressed public keys ... FAILED"); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)SharedSecretA, NBYTES_TO_NWORDS(2*pbytes));
+    clear_words((void*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes));
+    clear_words((void*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(CompressedPKA);
+    free(CompressedPKB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecret);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing BigMont
+    unsigned int i, j, w; 
+    digit_t scalar[BIGMONT_NWORDS_ORDER] = {0}, PrivateKey[BATCH_KEYS][BIGMONT_MAXWORDS_ORDER];
+    felm_t x = {0}, xG = {0}, PublicKey[BATCH_KEYS], SharedSecret[BATCH_KEYS];
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+
+    printf("\n\nTESTING ELLIPTIC CURVE BIGMONT \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    
+    copy_words((digit_t*)scalar1, scalar, BIGMONT_NWORDS_ORDER);    // Set scalar
+    x[0] = 3;                                                       // Set initial x-coordinate
+
+    for (i = 0; i < TEST_LOOPS; i++)
+    {
+        for (j = 0; j < BIGMONT_NWORDS_ORDER-1; j++) {
+            scalar[j] = (scalar[j] >> 1) | (scalar[j+1] << (RADIX-1));  
+        }
+        scalar[BIGMONT_NWORDS_ORDER-1] >>= 1;
+
+        Status = BigMont_ladder((unsigned char*)x, scalar, (unsigned char*)x, CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+    }
+
+    if (compare_words((digit_t*)x, (digit_t*)output1, BIGMONT_NWORDS_ORDER) != 0) {
+        passed = false;
+        Status = CRYPTO_ERROR_SHARED_KEY;
+    }
+
+    if (passed == true) printf("  BigMont's scalar multiplication tests ........................ PASSED");
+    else { printf("  BigMont's scalar multiplication tests ... FAILED"); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+    // Key generation with the fixed-base table of every supported window width, and with the Montgomery ladder (width 0)
+    xG[0] = BIGMONT_GENERATOR_X;
+    for (w = 0; w <= 6 && passed; w++) {
+        if (w == 1) {
+            continue;
+        }
+        Status = SIDH_set_fixed_base_window(CurveIsogeny, w);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        for (i = 0; i < TEST_LOOPS; i++) {
+            Status = BigMont_KeyGeneration((unsigned char*)PrivateKey[0], (unsigned char*)PublicKey[0], CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            Status = BigMont_ladder((unsigned char*)xG, PrivateKey[0], (unsigned char*)x, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            if (compare_words((digit_t*)x, (digit_t*)PublicKey[0], NWORDS_FIELD) != 0) {
+                passed = false;
+                Status = CRYPTO_ERROR_DURING_TEST;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  BigMont's key generation tests ............................... PASSED");
+    else { printf("  BigMont's key generation tests (window width %d) ... FAILED", w - 1); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+    // Batched shared secrets, including a point of order 2 whose multiples are encoded as 0
+    for (i = 0; i < BATCH_KEYS; i++) {
+        Status = BigMont_KeyGeneration((unsigned char*)PrivateKey[i], (unsigned char*)PublicKey[i], CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+    }
+    clear_words((digit_t*)PublicKey[0], NWORDS_FIELD);                       // x = 0, the point (0,0) of order 2
+    Status = BigMont_SecretAgreement_batch((unsigned char*)PrivateKey, (unsigned char*)PublicKey, (unsigned char*)SharedSecret, BATCH_KEYS, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    for (i = 0; i < BATCH_KEYS; i++) {
+        Status = BigMont_ladder((unsigned char*)PublicKey[i], PrivateKey[i], (unsigned char*)x, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)x, (digit_t*)SharedSecret[i], NWORDS_FIELD) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+    }
+
+    if (passed == true) printf("  BigMont's batched shared secret tests ........................ PASSED");
+    else { printf("  BigMont's batched shared secret tests ... FAILED"); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_fixed_base(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing the fixed-base key generation against the Montgomery ladder, for every supported window width
+    unsigned int n, w, AliceOrBob;
+    digit_t scalar[NWORDS_ORDER], t[NWORDS_ORDER] = {0};
+    point_basefield_t P;
+    point_proj_t R1, R2;
+    f2elm_t t0, t1;
+    PCurveIsogenyStruct CurveIsogeny = {0}, CurveIsogenyLadder = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+
+    printf("\n\nTESTING FIXED-BASE KEY GENERATION \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization, with and without fixed-base tables
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    CurveIsogenyLadder = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL || CurveIsogenyLadder == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogenyLadder, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_set_fixed_base_window(CurveIsogenyLadder, 0);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (w = 2; w <= 6 && passed; w++) {
+        Status = SIDH_set_fixed_base_window(CurveIsogeny, w);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        for (n = 0; n < TEST_LOOPS && passed; n++) {
+            for (AliceOrBob = ALICE; AliceOrBob <= BOB; AliceOrBob++) {
+                if (n == 0) {                                                        // Largest secret keys, oA-2 and oB-3
+                    t[0] = 2 + AliceOrBob;
+                    mp_sub((AliceOrBob == ALICE) ? CurveIsogeny->Aorder : CurveIsogeny->Border, t, scalar, NWORDS_ORDER);
+                } else if (n == 1) {                                                 // Smallest secret keys, 2 and 3
+                    clear_words((void*)scalar, NWORDS_ORDER);
+                    scalar[0] = 2 + AliceOrBob;
+                } else {
+                    Status = random_mod_order(scalar, AliceOrBob, CurveIsogeny);
+                    if (Status != CRYPTO_SUCCESS) {
+                        goto cleanup;
+                    }
+                }
+                to_mont((AliceOrBob == ALICE) ? CurveIsogeny->PA : CurveIsogeny->PB, P->x);
+                to_mont(((AliceOrBob == ALICE) ? CurveIsogeny->PA : CurveIsogeny->PB) + NWORDS_FIELD, P->y);
+
+                Status = secret_pt(P, scalar, AliceOrBob, R1, CurveIsogeny);
+                if (Status != CRYPTO_SUCCESS) {
+                    goto cleanup;
+                }
+                Status = secret_pt(P, scalar, AliceOrBob, R2, CurveIsogenyLadder);
+                if (Status != CRYPTO_SUCCESS) {
+                    goto cleanup;
+                }
+                fp2mul751_mont(R1->X, R2->Z, t0);                                    // Projective comparison, X1*Z2 = X2*Z1
+                fp2mul751_mont(R2->X, R1->Z, t1);
+                if (fp2compare751(t0, t1) != 0) {
+                    passed = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (passed == true) printf("  Fixed-base key generation tests .............................. PASSED");
+    else { printf("  Fixed-base key generation tests (window width %d) ... FAILED", w - 1); printf("\n"); Status = CRYPTO_ERROR_DURING_TEST; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    SIDH_curve_free(CurveIsogenyLadder);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_kex_threads(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with the parallel isogeny tree traversal against the serial traversal
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int n, nthreads;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB, *SharedSecret;
+    PCurveIsogenyStruct CurveIsogeny = {0}, CurveIsogenySerial = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTESTING MULTI-THREADED ISOGENY-BASED KEY EXCHANGE \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization, with and without thread team
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    CurveIsogenySerial = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL || CurveIsogenySerial == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogenySerial, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (nthreads = 2; nthreads <= 4 && passed; nthreads += 2) {
+        Status = SIDH_set_threads(CurveIsogeny, nthreads);
+        if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+            printf("  Thread support not enabled in this build, tests skipped \n");
+            Status = CRYPTO_SUCCESS;
+            goto cleanup;
+        }
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        for (n = 0; n < TEST_LOOPS; n++)
+        {
+            Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecret, CurveIsogenySerial);   // Serial traversal on the same keys
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+
+            if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+                compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+                passed = false;
+                Status = CRYPTO_ERROR_SHARED_KEY;
+                break;
+            }
+        }
+    }
+
+    if (passed == true) printf("  Multi-threaded key exchange tests ............................ PASSED");
+    else { printf("  Multi-threaded key exchange tests (%d threads) ... FAILED", nthreads); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    SIDH_curve_free(CurveIsogenySerial);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecret);
+
+    return Status;
+}
+
+
+static volatile bool keypool_test_fail = false;
+static volatile unsigned int keypool_test_failures = 0;
+
+static CRYPTO_STATUS random_bytes_failing(unsigned int nbytes, unsigned char* random_array)
+{ // Random bytes function of the key pool tests, which fails while keypool_test_fail is set
+    if (keypool_test_fail) {
+        keypool_test_failures++;
+        return CRYPTO_ERROR;
+    }
+    return random_bytes_test(nbytes, random_array);
+}
+
+
+CRYPTO_STATUS cryptotest_keypool(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with key pairs taken from key pools
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int n, capacity = 4;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *PreviousKeyA, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0}, CurveIsogenyFailing = {0};
+    PKeyPool KeyPoolA = NULL, KeyPoolB = NULL, KeyPoolFailing = NULL;
+    time_t start;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    PreviousKeyA = (unsigned char*)calloc(1, obytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTESTING ISOGENY-BASED KEY EXCHANGE WITH KEY POOLS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    Status = SIDH_keypool_create(CurveIsogeny, ALICE, capacity, capacity/2, &KeyPoolA);
+    if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+        printf("  Thread support not enabled in this build, tests skipped \n");
+        Status = CRYPTO_SUCCESS;
+        goto cleanup;
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_keypool_create(CurveIsogeny, BOB, capacity, capacity/2, &KeyPoolB);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Taking more key pairs than the capacity exercises both the pooled and the fallback key generation
+    for (n = 0; n < 3*capacity; n++)
+    {
+        Status = SIDH_keypool_take(KeyPoolA, PrivateKeyA, PublicKeyA);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SIDH_keypool_take(KeyPoolB, PrivateKeyB, PublicKeyB);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+            compare_words((digit_t*)PrivateKeyA, (digit_t*)PreviousKeyA, NBYTES_TO_NWORDS(obytes)) == 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+        copy_words((digit_t*)PrivateKeyA, (digit_t*)PreviousKeyA, NBYTES_TO_NWORDS(obytes));
+    }
+
+    if (passed == true) printf("  Key exchange tests with key pools ............................ PASSED");
+    else { printf("  Key exchange tests with key pools... FAILED"); printf("\n"); goto cleanup; }
+    printf("\n"); 
+
+    // A failed key generation of the pool thread is reported by the next take, after which the pool fills up again
+    CurveIsogenyFailing = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogenyFailing == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogenyFailing, &random_bytes_failing, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    SIDH_set_drbg(CurveIsogenyFailing, false);
+    keypool_test_failures = 0;
+    keypool_test_fail = true;
+    Status = SIDH_keypool_create(CurveIsogenyFailing, ALICE, capacity, capacity/2, &KeyPoolFailing);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    start = time(NULL);
+    while (keypool_test_failures == 0 && time(NULL) - start < 60);
+    if (SIDH_keypool_take(KeyPoolFailing, PrivateKeyA, PublicKeyA) == CRYPTO_SUCCESS) {
+        passed = false;
+    }
+    keypool_test_fail = false;
+    for (n = 0; n < 2; n++) {                  // The error of the pool thread may be reported after the one of the calling thread
+        Status = SIDH_keypool_take(KeyPoolFailing, PrivateKeyA, PublicKeyA);
+        if (Status == CRYPTO_SUCCESS) {
+            break;
+        }
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        passed = false;
+        Status = CRYPTO_SUCCESS;
+    }
+    start = time(NULL);
+    while (SIDH_keypool_available(KeyPoolFailing) < capacity && time(NULL) - start < 60);
+    if (SIDH_keypool_available(KeyPoolFailing) < capacity) {
+        passed = false;
+    }
+
+    if (passed == true) printf("  Key pool error reporting tests ............................... PASSED");
+    else { printf("  Key pool error reporting tests... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    keypool_test_fail = false;
+    SIDH_keypool_free(KeyPoolA);
+    SIDH_keypool_free(KeyPoolB);
+    SIDH_keypool_free(KeyPoolFailing);
+    SIDH_curve_free(CurveIsogeny);
+    SIDH_curve_free(CurveIsogenyFailing);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(PreviousKeyA);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+static unsigned int drbg_test_calls = 0;
+
+static CRYPTO_STATUS random_bytes_counted(unsigned int nbytes, unsigned char* random_array)
+{ // Random bytes function of the DRBG tests, which counts its calls
+    drbg_test_calls++;
+    return random_bytes_test(nbytes, random_array);
+}
+
+
+CRYPTO_STATUS cryptotest_drbg(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with random values drawn from the built-in DRBG
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int i, nkeys = BATCH_KEYS;
+    unsigned char *PrivateKeysA, *PrivateKeysB, *PublicKeysA, *PublicKeysB, *SharedSecretsA, *SharedSecretsB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool valid_PublicKey = false;
+    bool passed = true;
+
+    PrivateKeysA = (unsigned char*)calloc(nkeys, obytes);
+    PrivateKeysB = (unsigned char*)calloc(nkeys, obytes);
+    PublicKeysA = (unsigned char*)calloc(nkeys, 4*2*pbytes);
+    PublicKeysB = (unsigned char*)calloc(nkeys, 4*2*pbytes);
+    SharedSecretsA = (unsigned char*)calloc(nkeys, 2*pbytes);
+    SharedSecretsB = (unsigned char*)calloc(nkeys, 2*pbytes);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_counted, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_set_drbg(CurveIsogeny, true);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // All the random values of the key exchanges are drawn from one seed of the DRBG
+    SIDH_drbg_clear();
+    drbg_test_calls = 0;
+    Status = KeyGeneration_A_batch(PrivateKeysA, PublicKeysA, nkeys, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = KeyGeneration_B_batch(PrivateKeysB, PublicKeysB, nkeys, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    for (i = 0; i < nkeys; i++) {
+        Status = Validate_PKA(PublicKeysA + i*4*2*pbytes, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+        Status = Validate_PKB(PublicKeysB + i*4*2*pbytes, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+    }
+    Status = SecretAgreement_A_batch(PrivateKeysA, PublicKeysB, SharedSecretsA, nkeys, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SecretAgreement_B_batch(PrivateKeysB, PublicKeysA, SharedSecretsB, nkeys, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (drbg_test_calls != 1) {
+        passed = false;
+    }
+    for (i = 0; i < nkeys; i++) {
+        if (compare_words((digit_t*)(SharedSecretsA + i*2*pbytes), (digit_t*)(SharedSecretsB + i*2*pbytes), NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+            (i > 0 && compare_words((digit_t*)(PrivateKeysA + i*obytes), (digit_t*)(PrivateKeysA + (i-1)*obytes), NBYTES_TO_NWORDS(obytes)) == 0)) {
+            passed = false;
+        }
+    }
+
+    // A wiped DRBG is reseeded, and a disabled one is not used
+    SIDH_drbg_clear();
+    Status = KeyGeneration_A(PrivateKeysA, PublicKeysA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    SIDH_set_drbg(CurveIsogeny, false);
+    Status = KeyGeneration_A(PrivateKeysA, PublicKeysA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (drbg_test_calls != 3) {
+        passed = false;
+    }
+
+    if (passed == true) printf("  Key exchange tests with the built-in DRBG .................... PASSED");
+    else { printf("  Key exchange tests with the built-in DRBG... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeysA, NBYTES_TO_NWORDS(nkeys*obytes));
+    clear_words((void*)PrivateKeysB, NBYTES_TO_NWORDS(nkeys*obytes));
+    free(PrivateKeysA);
+    free(PrivateKeysB);
+    free(PublicKeysA);
+    free(PublicKeysB);
+    free(SharedSecretsA);
+    free(SharedSecretsB);
+
+    return Status;
+}
+
+
+typedef struct {
+    unsigned int points[SIDH_TRACE_END_OF_LIST];
+    uint64_t last;
+    bool ordered;
+} trace_test_log;
+
+static void trace_test_callback(void* Context, SIDH_TRACE_POINT Point, unsigned int arg, uint64_t cycles)
+{ // Trace callback of the trace point tests, which counts the points of each type and checks that timestamps do not go backwards
+    trace_test_log* log = (trace_test_log*)Context;
+
+    UNREFERENCED_PARAMETER(arg);
+    log->points[Point]++;
+    log->ordered = log->ordered && (cycles >= log->last);
+    log->last = cycles;
+}
+
+
+CRYPTO_STATUS cryptotest_trace(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing the trace points of key generation, shared secret computation and public key validation
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int leavesA = SIDH_STRATEGY_LEAVES_ALICE, leavesB = SIDH_STRATEGY_LEAVES_BOB;      // Tree sizes of SIDHp751 or SIDHp503
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    trace_test_log log = {{0}, 0, true}, EmptyLog = {{0}, 0, true};
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool valid_PublicKey = false;
+    bool passed = true;
+
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    if (CurveIsogenyData->pbits == 503) {
+        leavesA = SIDHp503_STRATEGY_LEAVES_ALICE; leavesB = SIDHp503_STRATEGY_LEAVES_BOB;
+    }
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_set_trace(CurveIsogeny, &trace_test_callback, &log);
+    if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+        printf("  Trace support not enabled in this build, trace point tests skipped \n");
+        Status = CRYPTO_SUCCESS;
+        goto cleanup;
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // One point per phase of Alice's key generation, and one per row of her strategy
+    Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (log.points[SIDH_TRACE_BEGIN] != 1 || log.points[SIDH_TRACE_END] != 1 || log.points[SIDH_TRACE_SCALAR_MULT] != 1 ||
+        log.points[SIDH_TRACE_TRAVERSAL] != 1 || log.points[SIDH_TRACE_NORMALIZATION] != 1 || log.points[SIDH_TRACE_ROW] != leavesA - 1) {
+        passed = false;
+    }
+
+    Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Bob's shared secret goes through his strategy and ends with the j-invariant
+    log = EmptyLog;
+    Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (log.points[SIDH_TRACE_BEGIN] != 1 || log.points[SIDH_TRACE_END] != 1 || log.points[SIDH_TRACE_JINV] != 1 ||
+        log.points[SIDH_TRACE_ROW] != leavesB - 1 || log.points[SIDH_TRACE_NORMALIZATION] != 0) {
+        passed = false;
+    }
+
+    log = EmptyLog;
+    Status = Validate_PKA(PublicKeyA, &valid_PublicKey, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (valid_PublicKey == false || log.points[SIDH_TRACE_BEGIN] != 1 || log.points[SIDH_TRACE_END] != 1 || log.points[SIDH_TRACE_VALIDATION_STEP] == 0) {
+        passed = false;
+    }
+    passed = passed && log.ordered;
+
+    // The validated shared secrets report a validation followed by a shared secret computation
+    log = EmptyLog;
+    Status = SecretAgreement_A_validated(PrivateKeyA, PublicKeyB, SharedSecretA, &valid_PublicKey, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (valid_PublicKey == false || log.points[SIDH_TRACE_BEGIN] != 2 || log.points[SIDH_TRACE_END] != 2 || log.points[SIDH_TRACE_VALIDATION_STEP] == 0 ||
+        log.points[SIDH_TRACE_JINV] != 1 || log.points[SIDH_TRACE_ROW] != leavesA - 1) {
+        passed = false;
+    }
+    passed = passed && log.ordered;
+    log = EmptyLog;
+    Status = SecretAgreement_B_validated(PrivateKeyB, PublicKeyA, SharedSecretB, &valid_PublicKey, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (valid_PublicKey == false || log.points[SIDH_TRACE_BEGIN] != 2 || log.points[SIDH_TRACE_END] != 2 || log.points[SIDH_TRACE_VALIDATION_STEP] == 0 ||
+        log.points[SIDH_TRACE_JINV] != 1 || log.points[SIDH_TRACE_ROW] != leavesB - 1) {
+        passed = false;
+    }
+    passed = passed && log.ordered;
+
+    // No points are reported once the callback is removed
+    SIDH_set_trace(CurveIsogeny, NULL, NULL);
+    log = EmptyLog;
+    Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (log.points[SIDH_TRACE_BEGIN] != 0) {
+        passed = false;
+    }
+
+    if (passed == true) printf("  Trace point tests ............................................ PASSED");
+    else { printf("  Trace point tests... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_workspace(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with caller-provided and per-thread workspaces
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int i, j;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB, *SharedSecret;
+    digit_t* Workspace = NULL;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool valid_PublicKey = false;
+    bool passed = true;
+
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Workspace = (digit_t*)SIDH_workspace_allocate();
+    if (Workspace == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+
+    for (i = 0; i < TEST_LOOPS; i++) 
+    {
+        // Alice uses her own workspace and Bob the one of the calling thread
+        Status = KeyGeneration_A_ws(PrivateKeyA, PublicKeyA, Workspace, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = KeyGeneration_B_ws(PrivateKeyB, PublicKeyB, NULL, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = Validate_PKA_ws(PublicKeyA, &valid_PublicKey, NULL, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+        Status = Validate_PKB_ws(PublicKeyB, &valid_PublicKey, Workspace, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+
+        Status = SecretAgreement_A_ws(PrivateKeyA, PublicKeyB, SharedSecretA, Workspace, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        for (j = 0; j < NBYTES_TO_NWORDS(2*pbytes); j++) {                // The curve coefficient at the start of the workspace is wiped
+            passed = passed && (Workspace[j] == 0);
+        }
+        Status = SecretAgreement_B_ws(PrivateKeyB, PublicKeyA, SharedSecretB, NULL, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecret, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+            compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+    }
+
+    if (passed == true) printf("  Key exchange tests with workspaces ........................... PASSED");
+    else { printf("  Key exchange tests with workspaces... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_workspace_free(Workspace);
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecret);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_kex_tagged(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with tagged public keys in the standard and Montgomery formats
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int pkbytes = 4*2*pbytes;                           // Number of bytes in an untagged public key
+    unsigned int i, j;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB, *SharedSecret;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool valid_PublicKey = false;
+    bool passed = true;
+
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, pkbytes + 1);
+    PublicKeyB = (unsigned char*)calloc(1, pkbytes + 1);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecret = (unsigned char*)calloc(1, 2*pbytes);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < TEST_LOOPS; i++) 
+    {
+        // Alice's key is in the Montgomery format and Bob's in the standard format
+        Status = KeyGeneration_A_tagged(PrivateKeyA, PublicKeyA, SIDH_PK_FORMAT_MONTGOMERY, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = KeyGeneration_B_tagged(PrivateKeyB, PublicKeyB, SIDH_PK_FORMAT_STANDARD, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (PublicKeyA[pkbytes] == SIDH_PK_FORMAT_MONTGOMERY) && (PublicKeyB[pkbytes] == SIDH_PK_FORMAT_STANDARD);
+        Status = Validate_PKA_tagged(PublicKeyA, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+        Status = Validate_PKB_tagged(PublicKeyB, &valid_PublicKey, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && valid_PublicKey;
+
+        Status = SecretAgreement_A_tagged(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_B_tagged(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecret, CurveIsogeny);     // A standard tagged key is also an untagged key
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+            compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            Status = CRYPTO_ERROR_SHARED_KEY;
+            break;
+        }
+
+        // Conversion of Alice's key to the standard format for Bob's untagged shared secret generation
+        Status = PublicKey_set_format(PublicKeyA, SIDH_PK_FORMAT_STANDARD, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecret, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        passed = passed && (PublicKeyA[pkbytes] == SIDH_PK_FORMAT_STANDARD) && 
+                 (compare_words((digit_t*)SharedSecretB, (digit_t*)SharedSecret, NBYTES_TO_NWORDS(2*pbytes)) == 0);
+
+        // Unknown formats and unreduced elements in the Montgomery format are rejected
+        PublicKeyA[pkbytes] = 0x02;
+        passed = passed && (SecretAgreement_B_tagged(PrivateKeyB, PublicKeyA, SharedSecret, CurveIsogeny) == CRYPTO_ERROR_INVALID_PARAMETER);
+        passed = passed && (Validate_PKA_tagged(PublicKeyA, &valid_PublicKey, CurveIsogeny) == CRYPTO_ERROR_INVALID_PARAMETER) && !valid_PublicKey;
+        passed = passed && (KeyGeneration_A_tagged(PrivateKeyA, PublicKeyA, 0x02, CurveIsogeny) == CRYPTO_ERROR_INVALID_PARAMETER);
+        PublicKeyB[pkbytes] = SIDH_PK_FORMAT_MONTGOMERY;
+        for (j = 0; j < pbytes; j++) {
+            PublicKeyB[j] = 0xFF;                                             // Above p, which is below 2^(8*pbytes)
+        }
+        passed = passed && (SecretAgreement_A_tagged(PrivateKeyA, PublicKeyB, SharedSecret, CurveIsogeny) == CRYPTO_ERROR_INVALID_PARAMETER);
+        passed = passed && (PublicKey_set_format(PublicKeyB, SIDH_PK_FORMAT_STANDARD, CurveIsogeny) == CRYPTO_ERROR_INVALID_PARAMETER);
+    }
+
+    if (passed == true) printf("  Key exchange tests with tagged public keys ................... PASSED");
+    else { printf("  Key exchange tests with tagged public keys... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecret);
+
+    return Status;
+}
+
+
+static void engine_test_callback(PSIDHJob Job)
+{ // Counts the completed jobs of the job engine tests
+    __atomic_add_fetch((unsigned int*)Job->Context, 1, __ATOMIC_RELEASE);
+}
+
+
+static CRYPTO_STATUS engine_test_wait(SIDH_job* Jobs, unsigned int njobs, unsigned int* ndone)
+{ // Waits until the callbacks of "njobs" jobs have been called and returns the first error
+    unsigned int i;
+
+    while (__atomic_load_n(ndone, __ATOMIC_ACQUIRE) < njobs);
+    for (i = 0; i < njobs; i++) {
+        if (Jobs[i].Status != CRYPTO_SUCCESS) {
+            return Jobs[i].Status;
+        }
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+CRYPTO_STATUS cryptotest_engine(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing key exchange with jobs run by a job engine
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int i, ndone = 0, nkeys = BATCH_KEYS;
+    unsigned char *PrivateKeysA, *PrivateKeysB, *PublicKeysA, *PublicKeysB, *SharedSecretsA, *SharedSecretsB;
+    SIDH_job* Jobs, EmptyJob = {0};
+    SIDH_engine_stats stats;
+    PJobEngine Engine = NULL;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+
+    PrivateKeysA = (unsigned char*)calloc(nkeys, obytes);
+    PrivateKeysB = (unsigned char*)calloc(nkeys, obytes);
+    PublicKeysA = (unsigned char*)calloc(nkeys, 4*2*pbytes);
+    PublicKeysB = (unsigned char*)calloc(nkeys, 4*2*pbytes);
+    SharedSecretsA = (unsigned char*)calloc(nkeys, 2*pbytes);
+    SharedSecretsB = (unsigned char*)calloc(nkeys, 2*pbytes);
+    Jobs = (SIDH_job*)calloc(4*nkeys, sizeof(SIDH_job));
+
+    Status = SIDH_engine_create(CurveIsogenyData, &random_bytes_test, 3, true, &Engine);
+    if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+        printf("  Thread support not enabled in this build, job engine tests skipped \n");
+        Status = CRYPTO_SUCCESS;
+        goto cleanup;
+    }
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Key pairs of both parties
+    for (i = 0; i < 2*nkeys; i++) {
+        Jobs[i].Type = (i < nkeys) ? SIDH_JOB_KEYGEN_A : SIDH_JOB_KEYGEN_B;
+        Jobs[i].pPrivateKey = (i < nkeys) ? PrivateKeysA + i*obytes : PrivateKeysB + (i - nkeys)*obytes;
+        Jobs[i].pPublicKey = (i < nkeys) ? PublicKeysA + i*4*2*pbytes : PublicKeysB + (i - nkeys)*4*2*pbytes;
+        Jobs[i].Callback = engine_test_callback;
+        Jobs[i].Context = &ndone;
+        Status = SIDH_engine_submit(Engine, &Jobs[i]);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+    }
+    Status = engine_test_wait(Jobs, 2*nkeys, &ndone);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Validation of the public keys and shared secrets, mixed in one queue
+    ndone = 0;
+    for (i = 0; i < 4*nkeys; i++) {
+        unsigned int k = i/4;
+        Jobs[i] = EmptyJob;
+        switch (i % 4) {
+        case 0: Jobs[i].Type = SIDH_JOB_VALIDATE_A; Jobs[i].pPublicKey = PublicKeysA + k*4*2*pbytes; break;
+        case 1: Jobs[i].Type = SIDH_JOB_VALIDATE_B; Jobs[i].pPublicKey = PublicKeysB + k*4*2*pbytes; break;
+        case 2: Jobs[i].Type = SIDH_JOB_SHARED_A; Jobs[i].pPrivateKey = PrivateKeysA + k*obytes; 
+                Jobs[i].pPublicKey = PublicKeysB + k*4*2*pbytes; Jobs[i].pSharedSecret = SharedSecretsA + k*2*pbytes; break;
+        default: Jobs[i].Type = SIDH_JOB_SHARED_B; Jobs[i].pPrivateKey = PrivateKeysB + k*obytes; 
+                Jobs[i].pPublicKey = PublicKeysA + k*4*2*pbytes; Jobs[i].pSharedSecret = SharedSecretsB + k*2*pbytes; break;
+        }
+        Jobs[i].Callback = engine_test_callback;
+        Jobs[i].Context = &ndone;
+        Status = SIDH_engine_submit(Engine, &Jobs[i]);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+    }
+    Status = engine_test_wait(Jobs, 4*nkeys, &ndone);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (i = 0; i < nkeys; i++) {
+        if (Jobs[4*i].valid == false || Jobs[4*i + 1].valid == false ||
+            compare_words((digit_t*)(SharedSecretsA + i*2*pbytes), (digit_t*)(SharedSecretsB + i*2*pbytes), NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+    }
+    SIDH_engine_get_stats(Engine, &stats);
+    if (stats.submitted != 6*nkeys || stats.completed != 6*nkeys || stats.queued != 0 || stats.max_queued == 0) {
+        passed = false;
+    }
+
+    if (passed == true) printf("  Key exchange tests with a job engine ......................... PASSED");
+    else { printf("  Key exchange tests with a job engine... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_engine_free(Engine);
+    clear_words((void*)PrivateKeysA, NBYTES_TO_NWORDS(nkeys*obytes));
+    clear_words((void*)PrivateKeysB, NBYTES_TO_NWORDS(nkeys*obytes));
+    free(PrivateKeysA);
+    free(PrivateKeysB);
+    free(PublicKeysA);
+    free(PublicKeysB);
+    free(SharedSecretsA);
+    free(SharedSecretsB);
+    free(Jobs);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_pkcache(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing public key validation through a cache of validated public keys
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int n, entries;
+    unsigned char *PrivateKey, *PublicKeyA1, *PublicKeyA2, *PublicKeyB1, *PublicKeyBad;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    PPublicKeyCache Cache = NULL;
+    uint64_t hits, misses;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool valid, passed = true;
+    // Lookups of a cache of 2 keys: A1 is evicted by A2 and comes back; invalid keys are never cached
+    struct { unsigned int AliceOrBob; unsigned char** key; bool valid; } lookups[8] = {
+        {ALICE, &PublicKeyA1, true}, {ALICE, &PublicKeyA1, true}, {BOB, &PublicKeyB1, true}, {ALICE, &PublicKeyA2, true},
+        {BOB, &PublicKeyB1, true}, {ALICE, &PublicKeyA1, true}, {ALICE, &PublicKeyBad, false}, {ALICE, &PublicKeyBad, false} };
+
+    // Allocating memory for private keys and public keys
+    PrivateKey = (unsigned char*)calloc(1, obytes);
+    PublicKeyA1 = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyA2 = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB1 = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyBad = (unsigned char*)calloc(1, 4*2*pbytes);
+
+    printf("\n\nTESTING PUBLIC KEY VALIDATION WITH A CACHE OF VALIDATED KEYS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_pkcache_create(CurveIsogeny, 2, &Cache);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    Status = KeyGeneration_A(PrivateKey, PublicKeyA1, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = KeyGeneration_A(PrivateKey, PublicKeyA2, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = KeyGeneration_B(PrivateKey, PublicKeyB1, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    copy_words((digit_t*)PublicKeyA1, (digit_t*)PublicKeyBad, NBYTES_TO_NWORDS(4*2*pbytes));
+    PublicKeyBad[2*pbytes] ^= 1;    // Changes the x-coordinate of the first point
+
+    for (n = 0; n < 8; n++) {
+        Status = SIDH_pkcache_validate(Cache, lookups[n].AliceOrBob, *lookups[n].key, &valid);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (valid != lookups[n].valid) {
+            passed = false;
+        }
+    }
+    SIDH_pkcache_stats(Cache, &hits, &misses, &entries);
+    if (hits != 2 || misses != 6 || entries != 2) {
+        passed = false;
+    }
+
+    if (passed == true) printf("  Public key validation tests with a cache ..................... PASSED");
+    else { printf("  Public key validation tests with a cache... FAILED"); printf("\n"); Status = CRYPTO_ERROR_PUBLIC_KEY_VALIDATION; goto cleanup; }
+    printf("\n");
+
+cleanup:
+    SIDH_pkcache_free(Cache);
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKey);
+    free(PublicKeyA1);
+    free(PublicKeyA2);
+    free(PublicKeyB1);
+    free(PublicKeyBad);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_kex_validated(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing shared secret generation with validation of the other party's public key
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int i;
+    unsigned char *PrivateKeyA, *PublicKeyA, *PrivateKeyB, *PublicKeyB, *PublicKeyBad, *SharedSecretA, *SharedSecretB;
+    unsigned char *SharedSecretValidatedA, *SharedSecretValidatedB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool validA, validB, passed = true;
+
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyBad = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretValidatedA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretValidatedB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTESTING SHARED SECRET GENERATION WITH PUBLIC KEY VALIDATION \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Valid public keys give the same shared secrets as the unvalidated functions
+    Status = SecretAgreement_A_validated(PrivateKeyA, PublicKeyB, SharedSecretValidatedA, &validB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SecretAgreement_B_validated(PrivateKeyB, PublicKeyA, SharedSecretValidatedB, &validA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (validA == false || validB == false ||
+        compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretValidatedA, NBYTES_TO_NWORDS(2*pbytes)) != 0 ||
+        compare_words((digit_t*)SharedSecretB, (digit_t*)SharedSecretValidatedB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+        passed = false;
+    }
+
+    // Invalid public keys are rejected and no shared secret is produced
+    copy_words((digit_t*)PublicKeyB, (digit_t*)PublicKeyBad, NBYTES_TO_NWORDS(4*2*pbytes));
+    PublicKeyBad[2*pbytes] ^= 1;    // Changes the x-coordinate of the first point
+    Status = SecretAgreement_A_validated(PrivateKeyA, PublicKeyBad, SharedSecretValidatedA, &validB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    copy_words((digit_t*)PublicKeyA, (digit_t*)PublicKeyBad, NBYTES_TO_NWORDS(4*2*pbytes));
+    PublicKeyBad[2*pbytes] ^= 1;
+    Status = SecretAgreement_B_validated(PrivateKeyB, PublicKeyBad, SharedSecretValidatedB, &validA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (validA == true || validB == true) {
+        passed = false;
+    }
+    for (i = 0; i < 2*pbytes; i++) {
+        if (SharedSecretValidatedA[i] != 0 || SharedSecretValidatedB[i] != 0) {
+            passed = false;
+        }
+    }
+
+    if (passed == true) printf("  Shared secret generation with validation tests ............... PASSED");
+    else { printf("  Shared secret generation with validation tests... FAILED"); printf("\n"); Status = CRYPTO_ERROR_SHARED_KEY; goto cleanup; }
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKeyA);
+    free(PublicKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyB);
+    free(PublicKeyBad);
+    free(SharedSecretA);
+    free(SharedSecretB);
+    free(SharedSecretValidatedA);
+    free(SharedSecretValidatedB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptotest_opcount(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing the operation counters of the instrumented build
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int n, i, j;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    OpCounters Counts[3], ThreadCounts;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nTESTING OPERATION COUNTERS \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Counts of a serial key exchange are taken twice, and a third time with the parallel traversal if it is available
+    for (n = 0; n < 3; n++)
+    {
+        if (n == 2 && SIDH_set_threads(CurveIsogeny, 2) != CRYPTO_SUCCESS) {
+            Counts[2] = Counts[0];
+            break;
+        }
+        Status = SIDH_opcount_reset(CurveIsogeny);
+        if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+            printf("  Operation counters not enabled in this build, tests skipped \n");
+            Status = CRYPTO_SUCCESS;
+            goto cleanup;
+        }
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SIDH_opcount_reset(NULL);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+            break;
+        }
+
+        Status = SIDH_opcount_get(CurveIsogeny, &Counts[n]);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SIDH_opcount_get(NULL, &ThreadCounts);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        // Every phase does some work, the final inversions are one per key pair and one per shared secret, and the serial
+        // traversal runs on the calling thread only
+        for (i = OPCOUNT_PHASE_SCALAR_MULT; i < OPCOUNT_PHASE_END_OF_LIST; i++) {
+            if (Counts[n].count[i][OPCOUNT_MP_MUL] == 0) {
+                passed = false;
+            }
+        }
+        if (Counts[n].count[OPCOUNT_PHASE_NORMALIZATION][OPCOUNT_FPINV] != 2 || Counts[n].count[OPCOUNT_PHASE_JINV][OPCOUNT_FPINV] != 2 ||
+            Counts[n].count[OPCOUNT_PHASE_SCALAR_MULT][OPCOUNT_FPINV] != 0 || Counts[n].count[OPCOUNT_PHASE_TRAVERSAL][OPCOUNT_FPINV] != 0) {
+            passed = false;
+        }
+        for (i = 0; i < OPCOUNT_PHASE_END_OF_LIST && n < 2; i++) {
+            for (j = 0; j < OPCOUNT_END_OF_LIST; j++) {
+                if (ThreadCounts.count[i][j] != Counts[n].count[i][j]) {
+                    passed = false;
+                }
+            }
+        }
+    }
+
+    // The key exchange is constant-time, so the counts do not depend on the keys or on the number of threads
+    for (i = 0; i < OPCOUNT_PHASE_END_OF_LIST; i++) {
+        for (j = 0; j < OPCOUNT_END_OF_LIST; j++) {
+            if (Counts[1].count[i][j] != Counts[0].count[i][j] || Counts[2].count[i][j] != Counts[0].count[i][j]) {
+                passed = false;
+            }
+        }
+    }
+
+    if (passed == true) printf("  Operation counter tests ...................................... PASSED");
+    else { printf("  Operation counter tests... FAILED"); printf("\n"); Status = CRYPTO_ERROR_UNKNOWN; goto cleanup; }
+    printf("\n"); 
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+static unsigned long long strategy_cost(const unsigned int* splits, unsigned int nleaves, unsigned long long p, unsigned long long q)
+{ // Cost of the traversal of a tree on nleaves leaves with strategy "splits", for costs p of a scalar multiplication and q of an isogeny evaluation
+    unsigned long long cost[SIDH_STRATEGY_LEAVES_BOB + 1] = {0};
+    unsigned int n, s;
+
+    for (n = 2; n <= nleaves; n++) {
+        s = splits[n-1];
+        cost[n] = cost[n-s] + cost[s] + s*p + (n-s)*q;
+    }
+    return cost[nleaves];
+}
+
+
+CRYPTO_STATUS cryptotest_strategy(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Testing the computation of optimal strategies and key exchange with strategies installed at runtime
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;   // Number of bytes in a field element 
+    unsigned int obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int leavesA = SIDH_STRATEGY_LEAVES_ALICE, leavesB = SIDH_STRATEGY_LEAVES_BOB;      // Tree sizes of SIDHp751 or SIDHp503
+    unsigned int pointsA = SIDH_STRATEGY_POINTS_ALICE, pointsB = SIDH_STRATEGY_POINTS_BOB;
+    unsigned int n, i, splits[SIDH_STRATEGY_LEAVES_BOB], costs[4];
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0}, CurveIsogenyTuned = {0};
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed = true;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    if (CurveIsogenyData->pbits == 503) {
+        leavesA = SIDHp503_STRATEGY_LEAVES_ALICE; leavesB = SIDHp503_STRATEGY_LEAVES_BOB;
+        pointsA = SIDHp503_STRATEGY_POINTS_ALICE; pointsB = SIDHp503_STRATEGY_POINTS_BOB;
+    }
+
+    printf("\n\nTESTING OPTIMAL STRATEGIES \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    CurveIsogenyTuned = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL || CurveIsogenyTuned == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogenyTuned, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // With the cost ratios of SIDH-Magma/optimalstrategies.mag, the computed strategies are as cheap as the precomputed ones
+    Status = SIDH_compute_strategy(CurveIsogeny, 0, 258, 228, pointsA, splits);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (strategy_cost(splits, leavesA, 258, 228) != strategy_cost(CurveIsogeny->StrategyAlice, leavesA, 258, 228)) {
+        passed = false;
+    }
+    Status = SIDH_compute_strategy(CurveIsogeny, 1, 278, 170, pointsB, splits);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    if (strategy_cost(splits, leavesB, 278, 170) != strategy_cost(CurveIsogeny->StrategyBob, leavesB, 278, 170)) {
+        passed = false;
+    }
+
+    // Strategies that store too many points are rejected
+    for (i = 1; i < leavesB; i++) {
+        splits[i] = 1;
+    }
+    if (SIDH_set_strategy(CurveIsogenyTuned, 1, splits) != CRYPTO_ERROR_INVALID_PARAMETER) {
+        passed = false;
+    }
+
+    // Shared secrets match between a structure using strategies bounded to 4 points (fewer in the low-memory mode) or tuned to the host 
+    // and one using the defaults
+    for (n = 0; n < 2*TEST_LOOPS && passed == true; n++)
+    {
+        if (n == 0) {
+            Status = SIDH_compute_strategy(CurveIsogenyTuned, 0, 258, 228, (pointsA < 4) ? pointsA : 4, splits);
+            if (Status == CRYPTO_SUCCESS) {
+                Status = SIDH_set_strategy(CurveIsogenyTuned, 0, splits);
+            }
+            if (Status == CRYPTO_SUCCESS) {
+                Status = SIDH_compute_strategy(CurveIsogenyTuned, 1, 278, 170, (pointsB < 4) ? pointsB : 4, splits);
+            }
+            if (Status == CRYPTO_SUCCESS) {
+                Status = SIDH_set_strategy(CurveIsogenyTuned, 1, splits);
+            }
+        } else if (n == TEST_LOOPS) {
+            Status = SIDH_tune_strategies(CurveIsogenyTuned, costs);
+        }
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, (n & 1) ? CurveIsogeny : CurveIsogenyTuned);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, (n & 1) ? CurveIsogenyTuned : CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogenyTuned);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        if (compare_words((digit_t*)SharedSecretA, (digit_t*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes)) != 0) {
+            passed = false;
+        }
+    }
+
+    if (passed == true) printf("  Optimal strategy tests ....................................... PASSED");
+    else { printf("  Optimal strategy tests... FAILED"); printf("\n"); Status = CRYPTO_ERROR_UNKNOWN; goto cleanup; }
+    printf("\n"); 
+    printf("  Measured costs (ns): 4-mult %u, 4-isog eval %u, 3-mult %u, 3-isog eval %u \n", costs[0], costs[1], costs[2], costs[3]);
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    SIDH_curve_free(CurveIsogenyTuned);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_kex(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking key exchange
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    bool valid_PublicKey = false;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cycles, cycles1, cycles2;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        // One element in [1, order]  
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);     // Four elements in GF(p^2)
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    // One element in GF(p^2)  
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nBENCHMARKING ISOGENY-BASED KEY EXCHANGE \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+    printf("Curve isogeny system: %s \n\n", CurveIsogenyData->CurveIsogeny);
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Benchmarking Alice's key generation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Alice's key generation runs in ............................... %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  Alice's key generation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Bob's key generation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Bob's key generation runs in ................................. %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  Bob's key generation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Alice's public key validation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = Validate_PKA(PublicKeyA, &valid_PublicKey, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS || valid_PublicKey != true) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Alice's public key validation runs in ........................ %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  Alice's public key validation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Bob's public key validation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = Validate_PKB(PublicKeyB, &valid_PublicKey, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS || valid_PublicKey != true) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Bob's public key validation runs in .......................... %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  Bob's public key validation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Alice's shared key computation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Alice's shared key computation runs in ....................... %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  Alice's shared key computation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Bob's shared key computation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Bob's shared key computation runs in ......................... %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  Bob's shared key computation failed"); goto cleanup; } 
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PublicKeyA, NBYTES_TO_NWORDS(4*2*pbytes));
+    clear_words((void*)PublicKeyB, NBYTES_TO_NWORDS(4*2*pbytes));
+    clear_words((void*)SharedSecretA, NBYTES_TO_NWORDS(2*pbytes));
+    clear_words((void*)SharedSecretB, NBYTES_TO_NWORDS(2*pbytes));
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_kex_batch(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking batched key exchange
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cycles, cycles1, cycles2;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed;
+        
+    // Allocating memory for BATCH_KEYS private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(BATCH_KEYS, obytes);        
+    PrivateKeyB = (unsigned char*)calloc(BATCH_KEYS, obytes);
+    PublicKeyA = (unsigned char*)calloc(BATCH_KEYS, 4*2*pbytes);     
+    PublicKeyB = (unsigned char*)calloc(BATCH_KEYS, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(BATCH_KEYS, 2*pbytes);    
+    SharedSecretB = (unsigned char*)calloc(BATCH_KEYS, 2*pbytes);
+
+    printf("\n\nBENCHMARKING BATCHED ISOGENY-BASED KEY EXCHANGE (%d KEYS PER BATCH) \n", BATCH_KEYS);
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    // Benchmarking Alice's batched key generation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = KeyGeneration_A_batch(PrivateKeyA, PublicKeyA, BATCH_KEYS, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Alice's key generation runs in ........................ %10lld cycles per key", cycles/(BENCH_LOOPS*BATCH_KEYS));
+    else { printf("  Alice's batched key generation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Bob's batched key generation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = KeyGeneration_B_batch(PrivateKeyB, PublicKeyB, BATCH_KEYS, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Bob's key generation runs in .......................... %10lld cycles per key", cycles/(BENCH_LOOPS*BATCH_KEYS));
+    else { printf("  Bob's batched key generation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Alice's batched shared key computation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = SecretAgreement_A_batch(PrivateKeyA, PublicKeyB, SharedSecretA, BATCH_KEYS, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Alice's shared key computation runs in ................ %10lld cycles per key", cycles/(BENCH_LOOPS*BATCH_KEYS));
+    else { printf("  Alice's batched shared key computation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking Bob's batched shared key computation
+    passed = true;
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = SecretAgreement_B_batch(PrivateKeyB, PublicKeyA, SharedSecretB, BATCH_KEYS, CurveIsogeny);                     
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            passed = false;
+            break;
+        }    
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  Bob's shared key computation runs in .................. %10lld cycles per key", cycles/(BENCH_LOOPS*BATCH_KEYS));
+    else { printf("  Bob's batched shared key computation failed"); goto cleanup; } 
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(BATCH_KEYS*obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(BATCH_KEYS*obytes));
+    clear_words((void*)PublicKeyA, NBYTES_TO_NWORDS(BATCH_KEYS*4*2*pbytes));
+    clear_words((void*)PublicKeyB, NBYTES_TO_NWORDS(BATCH_KEYS*4*2*pbytes));
+    clear_words((void*)SharedSecretA, NBYTES_TO_NWORDS(BATCH_KEYS*2*pbytes));
+    clear_words((void*)SharedSecretB, NBYTES_TO_NWORDS(BATCH_KEYS*2*pbytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_kex_step(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking step-wise key exchange: total cost of Alice's operations and longest slice
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned int budget = 64;
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    PKexStep KexStep = NULL;
+    unsigned long long cycles, cycles1, cycles2, slice, longest;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    SIDH_KEX_OPERATION Operation;
+    bool done;
+        
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);     
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    
+
+    printf("\n\nBENCHMARKING STEP-WISE ISOGENY-BASED KEY EXCHANGE (%d UNITS PER SLICE) \n", budget);
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (Operation = SIDH_KEX_KEYGEN_A; Operation <= SIDH_KEX_SHARED_A; Operation += SIDH_KEX_SHARED_A - SIDH_KEX_KEYGEN_A) {
+        cycles = 0;
+        longest = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            if (Operation == SIDH_KEX_KEYGEN_A) {
+                Status = SIDH_kex_start(CurveIsogeny, Operation, PrivateKeyA, PublicKeyA, NULL, &KexStep);
+            } else {
+                Status = SIDH_kex_start(CurveIsogeny, Operation, PrivateKeyA, PublicKeyB, SharedSecretA, &KexStep);
+            }
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            done = false;
+            while (!done) {
+                cycles1 = cpucycles();
+                Status = SIDH_kex_step(KexStep, budget, &done);
+                cycles2 = cpucycles();
+                if (Status != CRYPTO_SUCCESS) {
+                    goto cleanup;
+                }
+                slice = cycles2-cycles1;
+                cycles = cycles+slice;
+                longest = (slice > longest) ? slice : longest;
+            }
+            SIDH_kex_free(KexStep);
+            KexStep = NULL;
+        }
+        if (Operation == SIDH_KEX_KEYGEN_A) {
+            printf("  Alice's key generation runs in ............................... %10lld cycles", cycles/BENCH_LOOPS);
+        } else {
+            printf("  Alice's shared key computation runs in ....................... %10lld cycles", cycles/BENCH_LOOPS);
+        }
+        printf("\n");
+        printf("    longest slice ............................................... %10lld cycles", longest);
+        printf("\n");
+    }
+
+cleanup:
+    SIDH_kex_free(KexStep);
+    SIDH_curve_free(CurveIsogeny);
+    clear_words((void*)PrivateKeyA, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)PrivateKeyB, NBYTES_TO_NWORDS(obytes));
+    clear_words((void*)SharedSecretA, NBYTES_TO_NWORDS(2*pbytes));
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_kex_compression(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking public key compression and shared secret generation from compressed public keys
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *CompressedPKA, *CompressedPKB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cycles, cycles1, cycles2;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);        
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);     
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    CompressedPKA = (unsigned char*)calloc(1, SIDH_COMPRESSED_PKA_BYTES);
+    CompressedPKB = (unsigned char*)calloc(1, SIDH_COMPRESSED_PKB_BYTES);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);    
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nBENCHMARKING ISOGENY-BASED KEY EXCHANGE WITH COMPRESSED PUBLIC KEYS (%d AND %d BYTES) \n", SIDH_COMPRESSED_PKA_BYTES, SIDH_COMPRESSED_PKB_BYTES);
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {                                                  
+        goto cleanup;
+    }  
+    Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {                                                  
+        goto cleanup;
+    }
+
+    // Benchmarking Alice's public key compression
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = PublicKeyCompression_A(PublicKeyA, CompressedPKA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Alice's public key compression runs in ....................... %10lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+    // Benchmarking Bob's public key compression
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = PublicKeyCompression_B(PublicKeyB, CompressedPKB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {                                                  
+            goto cleanup;
+        }
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Bob's public key compression runs in ......................... %10lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+    // Benchmarking Alice's shared key computation from Bob's compressed public key
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = SecretAgreement_Compression_A(PrivateKeyA, CompressedPKB, SharedSecretA, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Alice's shared key computation (compressed key) runs in ...... %10lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+    // Benchmarking Bob's shared key computation from Alice's compressed public key
+    cycles = 0;
+    for (n = 0; n < BENCH_LOOPS; n++)
+    {
+        cycles1 = cpucycles();
+        Status = SecretAgreement_Compression_B(PrivateKeyB, CompressedPKA, SharedSecretB, CurveIsogeny);
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    printf("  Bob's shared key computation (compressed key) runs in ........ %10lld cycles", cycles/BENCH_LOOPS);
+    printf("\n");
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(CompressedPKA);
+    free(CompressedPKB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_kex_threads(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking the latency of key exchange with the parallel isogeny tree traversal
+    unsigned int pbytes = (CurveIsogenyData->pwordbits + 7)/8;      // Number of bytes in a field element 
+    unsigned int n, nthreads, obytes = (CurveIsogenyData->owordbits + 7)/8;   // Number of bytes in an element in [1, order]
+    unsigned char *PrivateKeyA, *PrivateKeyB, *PublicKeyA, *PublicKeyB, *SharedSecretA, *SharedSecretB;
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cycles, cycles1, cycles2, cycles3, cycles4;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+        
+    // Allocating memory for private keys, public keys and shared secrets
+    PrivateKeyA = (unsigned char*)calloc(1, obytes);
+    PrivateKeyB = (unsigned char*)calloc(1, obytes);
+    PublicKeyA = (unsigned char*)calloc(1, 4*2*pbytes);
+    PublicKeyB = (unsigned char*)calloc(1, 4*2*pbytes);
+    SharedSecretA = (unsigned char*)calloc(1, 2*pbytes);
+    SharedSecretB = (unsigned char*)calloc(1, 2*pbytes);
+
+    printf("\n\nBENCHMARKING MULTI-THREADED ISOGENY-BASED KEY EXCHANGE \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+
+    for (nthreads = 2; nthreads <= 4; nthreads += 2) {
+        Status = SIDH_set_threads(CurveIsogeny, nthreads);
+        if (Status == CRYPTO_ERROR_NOT_IMPLEMENTED) {
+            printf("  Thread support not enabled in this build, benchmarks skipped \n");
+            Status = CRYPTO_SUCCESS;
+            goto cleanup;
+        }
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        // Benchmarking key generation, cycles1 and cycles2 for Alice, cycles3 and cycles4 for Bob
+        cycles = 0; cycles3 = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            cycles1 = cpucycles();
+            Status = KeyGeneration_A(PrivateKeyA, PublicKeyA, CurveIsogeny);
+            cycles2 = cpucycles();
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            cycles = cycles+(cycles2-cycles1);
+            cycles1 = cpucycles();
+            Status = KeyGeneration_B(PrivateKeyB, PublicKeyB, CurveIsogeny);
+            cycles2 = cpucycles();
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            cycles3 = cycles3+(cycles2-cycles1);
+        }
+        printf("  Alice's key generation (%d threads) runs in .................. %10lld cycles", nthreads, cycles/BENCH_LOOPS);
+        printf("\n");
+        printf("  Bob's key generation (%d threads) runs in .................... %10lld cycles", nthreads, cycles3/BENCH_LOOPS);
+        printf("\n");
+
+        // Benchmarking shared key computation
+        cycles = 0; cycles4 = 0;
+        for (n = 0; n < BENCH_LOOPS; n++)
+        {
+            cycles1 = cpucycles();
+            Status = SecretAgreement_A(PrivateKeyA, PublicKeyB, SharedSecretA, CurveIsogeny);
+            cycles2 = cpucycles();
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            cycles = cycles+(cycles2-cycles1);
+            cycles1 = cpucycles();
+            Status = SecretAgreement_B(PrivateKeyB, PublicKeyA, SharedSecretB, CurveIsogeny);
+            cycles2 = cpucycles();
+            if (Status != CRYPTO_SUCCESS) {
+                goto cleanup;
+            }
+            cycles4 = cycles4+(cycles2-cycles1);
+        }
+        printf("  Alice's shared key computation (%d threads) runs in .......... %10lld cycles", nthreads, cycles/BENCH_LOOPS);
+        printf("\n");
+        printf("  Bob's shared key computation (%d threads) runs in ............ %10lld cycles", nthreads, cycles4/BENCH_LOOPS);
+        printf("\n");
+    }
+
+cleanup:
+    SIDH_curve_free(CurveIsogeny);
+    free(PrivateKeyA);
+    free(PrivateKeyB);
+    free(PublicKeyA);
+    free(PublicKeyB);
+    free(SharedSecretA);
+    free(SharedSecretB);
+
+    return Status;
+}
+
+
+CRYPTO_STATUS cryptorun_BigMont(PCurveIsogenyStaticData CurveIsogenyData)
+{ // Benchmarking BigMont
+    unsigned int i; 
+    digit_t scalar[BIGMONT_NWORDS_ORDER] = {0}, PrivateKey[BATCH_KEYS][BIGMONT_MAXWORDS_ORDER];
+    f2elm_t x = {0};
+    felm_t PublicKey[BATCH_KEYS], SharedSecret[BATCH_KEYS];
+    PCurveIsogenyStruct CurveIsogeny = {0};
+    unsigned long long cycles, cycles1, cycles2;
+    CRYPTO_STATUS Status = CRYPTO_SUCCESS;
+    bool passed;
+
+    printf("\n\nBENCHMARKING ELLIPTIC CURVE BIGMONT \n");
+    printf("--------------------------------------------------------------------------------------------------------\n\n");
+
+    // Curve isogeny system initialization
+    CurveIsogeny = SIDH_curve_allocate(CurveIsogenyData);
+    if (CurveIsogeny == NULL) {
+        Status = CRYPTO_ERROR_NO_MEMORY;
+        goto cleanup;
+    }
+    Status = SIDH_curve_initialize(CurveIsogeny, &random_bytes_test, CurveIsogenyData);
+    if (Status != CRYPTO_SUCCESS) {
+        goto cleanup;
+    }
+    
+    x[0][0] = 3;                                                    // Set initial x-coordinate
+    
+    passed = true;
+    cycles = 0;
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {        
+        // Choose a random number in [1, BigMont_order-1] as scalar
+        Status = random_BigMont_mod_order(scalar, CurveIsogeny);    
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }
+
+        cycles1 = cpucycles();
+        Status = BigMont_ladder((unsigned char*)x, scalar, (unsigned char*)x, CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            goto cleanup;
+        }   
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  BigMont's scalar multiplication runs in ...................... %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  BigMont's scalar multiplication failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking key generation with the fixed-base table
+    passed = true;
+    cycles = 0;
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {        
+        cycles1 = cpucycles();
+        Status = BigMont_KeyGeneration((unsigned char*)PrivateKey[i % BATCH_KEYS], (unsigned char*)PublicKey[i % BATCH_KEYS], CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            passed = false;
+            break;
+        }   
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  BigMont's key generation runs in ............................. %10lld cycles", cycles/BENCH_LOOPS);
+    else { printf("  BigMont's key generation failed"); goto cleanup; } 
+    printf("\n");
+
+    // Benchmarking batched shared secrets
+    passed = true;
+    cycles = 0;
+    for (i = 0; i < BENCH_LOOPS; i++)
+    {        
+        cycles1 = cpucycles();
+        Status = BigMont_SecretAgreement_batch((unsigned char*)PrivateKey, (unsigned char*)PublicKey, (unsigned char*)SharedSecret, BATCH_KEYS, CurveIsogeny);   
+        if (Status != CRYPTO_SUCCESS) {
+            passed = false;
+            break;
+        }   
+        cycles2 = cpucycles();
+        cycles = cycles+(cycles2-cycles1);
+    }
+    if (passed) printf("  BigMont's batched shared secret runs in ...................... %10lld cycles per session", cycles/(BENCH_LOOPS*BATCH_KEYS));
+    else { printf("  BigMont's batched shared secret failed"); goto cleanup; } 
     printf("\n");
 
 cleanup:
@@ -394,12 +2736,210 @@ int main()
         return false;
     }
 
+    Status = cryptotest_kex_batch(&CurveIsogeny_SIDHp751); // Test batched key exchange using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_step(&CurveIsogeny_SIDHp751);  // Test step-wise key exchange using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_compression(&CurveIsogeny_SIDHp751);  // Test key exchange with compressed public keys using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_fixed_base(&CurveIsogeny_SIDHp751);  // Test fixed-base key generation using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_threads(&CurveIsogeny_SIDHp751);  // Test multi-threaded key exchange using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_keypool(&CurveIsogeny_SIDHp751);      // Test key exchange with key pools using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_engine(&CurveIsogeny_SIDHp751);       // Test key exchange with a job engine using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_drbg(&CurveIsogeny_SIDHp751);         // Test key exchange with the built-in DRBG using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_trace(&CurveIsogeny_SIDHp751);        // Test the trace points using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_workspace(&CurveIsogeny_SIDHp751);    // Test key exchange with workspaces using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_tagged(&CurveIsogeny_SIDHp751);    // Test key exchange with tagged public keys using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_pkcache(&CurveIsogeny_SIDHp751);      // Test public key validation with a cache using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_validated(&CurveIsogeny_SIDHp751); // Test shared secrets with validation using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_strategy(&CurveIsogeny_SIDHp751);     // Test optimal strategies using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_opcount(&CurveIsogeny_SIDHp751);      // Test the operation counters using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex(&CurveIsogeny_SIDHp503);       // Test elliptic curve isogeny system "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_batch(&CurveIsogeny_SIDHp503); // Test batched key exchange using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_step(&CurveIsogeny_SIDHp503);  // Test step-wise key exchange using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_threads(&CurveIsogeny_SIDHp503);  // Test multi-threaded key exchange using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_keypool(&CurveIsogeny_SIDHp503);      // Test key exchange with key pools using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_engine(&CurveIsogeny_SIDHp503);       // Test key exchange with a job engine using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_drbg(&CurveIsogeny_SIDHp503);         // Test key exchange with the built-in DRBG using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_trace(&CurveIsogeny_SIDHp503);        // Test the trace points using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_workspace(&CurveIsogeny_SIDHp503);    // Test key exchange with workspaces using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_tagged(&CurveIsogeny_SIDHp503);    // Test key exchange with tagged public keys using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_pkcache(&CurveIsogeny_SIDHp503);      // Test public key validation with a cache using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_kex_validated(&CurveIsogeny_SIDHp503); // Test shared secrets with validation using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptotest_strategy(&CurveIsogeny_SIDHp503);     // Test optimal strategies using "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
     Status = cryptorun_kex(&CurveIsogeny_SIDHp751);        // Benchmark elliptic curve isogeny system "SIDHp751"
     if (Status != CRYPTO_SUCCESS) {
         printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
         return false;
     }
 
+    Status = cryptorun_kex_batch(&CurveIsogeny_SIDHp751);  // Benchmark batched key exchange using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_kex_step(&CurveIsogeny_SIDHp751);   // Benchmark step-wise key exchange using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_kex_compression(&CurveIsogeny_SIDHp751);   // Benchmark key exchange with compressed public keys using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_kex_threads(&CurveIsogeny_SIDHp751);   // Benchmark multi-threaded key exchange using "SIDHp751"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
+    Status = cryptorun_kex(&CurveIsogeny_SIDHp503);        // Benchmark elliptic curve isogeny system "SIDHp503"
+    if (Status != CRYPTO_SUCCESS) {
+        printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
+        return false;
+    }
+
     Status = cryptotest_BigMont(&CurveIsogeny_SIDHp751);   // Test elliptic curve "BigMont"
     if (Status != CRYPTO_SUCCESS) {
         printf("\n\n   Error detected: %s \n\n", SIDH_get_error_message(Status));
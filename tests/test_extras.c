@@ -16,10 +16,16 @@
     #include <windows.h>
     #include <intrin.h>
 #endif
-#if (OS_TARGET == OS_LINUX) && (TARGET == TARGET_ARM)
+#if (OS_TARGET == OS_LINUX) && (TARGET == TARGET_ARM || TARGET == TARGET_ARM64 || TARGET == TARGET_GENERIC64)
     #include <time.h>
 #endif
 #include <stdlib.h>
+#include <string.h>
+#if (OS_TARGET == OS_LINUX)
+    #include <ucontext.h>
+#endif
+
+#define STACK_PAINT     0xA5                        // Fill byte of the stacks used by stack_usage()
 
 
 // Global constants          
@@ -30,6 +36,10 @@ extern const uint64_t Montgomery_R2[NWORDS_FIELD];
 static uint64_t Montgomery_pp751[NWORDS_FIELD] = { 0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0x0000000000000000, 0xEEB0000000000000, 
                                                    0xE3EC968549F878A8, 0xDA959B1A13F7CC76, 0x084E9867D6EBE876, 0x8562B5045CB25748, 0x0E12909F97BADC66, 0x258C28E5D541F71C };   
 
+// Montgomery constant -p503^-1 mod 2^512
+static uint64_t Montgomery_pp503[NWORDS_FIELD_P503] = { 0x0000000000000001, 0x0000000000000000, 0x0000000000000000, 0xAC00000000000000, 0x13085BDA2211E7A0, 0x1B9BF6C87B7E7DAF, 
+                                                        0x6045C6BDDA77A4D0, 0x73D066F541811E1E };
+
 
 int64_t cpucycles(void)
 { // Access system counter for benchmarking
@@ -42,7 +52,7 @@ int64_t cpucycles(void)
 
     asm volatile ("rdtsc\n\t" : "=a" (lo), "=d"(hi));
     return ((int64_t)lo) | (((int64_t)hi) << 32);
-#elif (OS_TARGET == OS_LINUX) && (TARGET == TARGET_ARM)
+#elif (OS_TARGET == OS_LINUX) && (TARGET == TARGET_ARM || TARGET == TARGET_ARM64 || TARGET == TARGET_GENERIC64)
     struct timespec time;
 
     clock_gettime(CLOCK_REALTIME, &time);
@@ -53,6 +63,61 @@ int64_t cpucycles(void)
 }
 
 
+#if (OS_TARGET == OS_LINUX)
+
+static ucontext_t stack_caller, stack_callee;
+static void (*stack_function)(void*);
+static void* stack_argument;
+
+static void stack_entry(void)
+{
+    stack_function(stack_argument);
+}
+
+#endif
+
+
+size_t stack_usage(void (*function)(void*), void* argument, size_t size)
+{ // Run function(argument) on a fresh stack of "size" bytes filled with STACK_PAINT and return the number of bytes that were written, 
+  // i.e., the peak stack usage of the call (assuming a downward-growing stack). Returns 0 on error or if not supported on this platform.
+  // NOTE: the function runs on the calling thread and must not be called concurrently. TO BE USED FOR TESTING ONLY.
+#if (OS_TARGET == OS_LINUX)
+    unsigned char* stack = (unsigned char*)malloc(size);
+    size_t untouched = 0;
+
+    if (stack == NULL) {
+        return 0;
+    }
+    memset(stack, STACK_PAINT, size);
+    if (getcontext(&stack_callee) != 0) {
+        free(stack);
+        return 0;
+    }
+    stack_callee.uc_stack.ss_sp = stack;
+    stack_callee.uc_stack.ss_size = size;
+    stack_callee.uc_link = &stack_caller;
+    stack_function = function;
+    stack_argument = argument;
+    makecontext(&stack_callee, stack_entry, 0);
+    if (swapcontext(&stack_caller, &stack_callee) != 0) {
+        free(stack);
+        return 0;
+    }
+
+    while (untouched < size && stack[untouched] == STACK_PAINT) {
+        untouched++;
+    }
+    free(stack);
+    return size - untouched;
+#else
+    UNREFERENCED_PARAMETER(function);
+    UNREFERENCED_PARAMETER(argument);
+    UNREFERENCED_PARAMETER(size);
+    return 0;
+#endif
+}
+
+
 CRYPTO_STATUS random_bytes_test(unsigned int nbytes, unsigned char* random_array)
 { // Generate "nbytes" random bytes and output the result to random_array
   // Returns CRYPTO_SUCCESS (=1) on success, CRYPTO_ERROR (=0) otherwise.
@@ -180,35 +245,43 @@ static __inline void mp_mul_basic(digit_t* a, digit_t* b, digit_t* c, unsigned i
 }
 
 
-void fpmul751_mont_basic(felm_t ma, felm_t mb, felm_t mc)
-{ // Basic Montgomery multiplication, mc = ma*mb*R^-1 mod p751, where ma,mb,mc in [0, p751-1] and R = 2^768.
-  // ma and mb are assumed to be in Montgomery representation.
-  // The Montgomery constant pp751 = -p751^(-1) mod R is the global value "Montgomery_pp751".   
+static void fpmul_mont_basic(digit_t* ma, digit_t* mb, digit_t* mc, digit_t* p, digit_t* pp, unsigned int nwords)
+{ // Basic Montgomery multiplication, mc = ma*mb*R^-1 mod p, where ma,mb,mc in [0, p-1] and R = 2^(nwords*RADIX).
+  // The Montgomery constant pp = -p^(-1) mod R, and nwords is at most NWORDS_FIELD.
     unsigned int i, bout = 0;
     digit_t mask, P[2*NWORDS_FIELD], Q[2*NWORDS_FIELD], temp[2*NWORDS_FIELD];
 
-    mp_mul_basic(ma, mb, P, NWORDS_FIELD);                          // P = ma * mb
-    mp_mul_basic(P, (digit_t*)&Montgomery_pp751, Q, NWORDS_FIELD);  // Q = P * pp751 mod R
-    mp_mul_basic(Q, (digit_t*)&p751, temp, NWORDS_FIELD);           // temp = Q * p751
-    mp_add(P, temp, temp, 2*NWORDS_FIELD);                    // temp = P + Q * p751     
+    mp_mul_basic(ma, mb, P, nwords);                          // P = ma * mb
+    mp_mul_basic(P, pp, Q, nwords);                           // Q = P * pp mod R
+    mp_mul_basic(Q, p, temp, nwords);                         // temp = Q * p
+    mp_add(P, temp, temp, 2*nwords);                          // temp = P + Q * p     
 
-    for (i = 0; i < NWORDS_FIELD; i++) {                      // mc = (P + Q * p751)/R
-        mc[i] = temp[NWORDS_FIELD+i];
+    for (i = 0; i < nwords; i++) {                            // mc = (P + Q * p)/R
+        mc[i] = temp[nwords+i];
     }
 
     // Final, constant-time subtraction     
-    bout = mp_sub(mc, (digit_t*)&p751, mc, NWORDS_FIELD);     // (bout, mc) = mc - p751
+    bout = mp_sub(mc, p, mc, nwords);                         // (bout, mc) = mc - p
     mask = 0 - (digit_t)bout;                                 // if mc < 0 then mask = 0xFF..F, else if mc >= 0 then mask = 0x00..0
 
-    for (i = 0; i < NWORDS_FIELD; i++) {                      // temp = mask & p751
-        temp[i] = (((digit_t*)p751)[i] & mask);
+    for (i = 0; i < nwords; i++) {                            // temp = mask & p
+        temp[i] = (p[i] & mask);
     }
-    mp_add(mc, temp, mc, NWORDS_FIELD);                       //  mc = mc + (mask & p751)
+    mp_add(mc, temp, mc, nwords);                             //  mc = mc + (mask & p)
 
     return;
 }
 
 
+void fpmul751_mont_basic(felm_t ma, felm_t mb, felm_t mc)
+{ // Basic Montgomery multiplication, mc = ma*mb*R^-1 mod p751, where ma,mb,mc in [0, p751-1] and R = 2^768.
+  // ma and mb are assumed to be in Montgomery representation.
+  // The Montgomery constant pp751 = -p751^(-1) mod R is the global value "Montgomery_pp751".   
+
+    fpmul_mont_basic(ma, mb, mc, (digit_t*)&p751, (digit_t*)&Montgomery_pp751, NWORDS_FIELD);
+}
+
+
 void to_mont_basic(felm_t a, felm_t mc)
 { // Conversion to Montgomery representation
   // mc = a*R^2*R^-1 mod p751 = a*R mod p751, where a in [0, p751-1]
@@ -225,4 +298,65 @@ void from_mont_basic(felm_t ma, felm_t c)
     
     one[0] = 1;
     fpmul751_mont_basic(ma, one, c);
-}
\ No newline at end of file
+}
+
+
+void fprandom503_test(felm503_t a)
+{ // Generating a pseudo-random field element in [0, p503-1] 
+  // SECURITY NOTE: distribution is not fully uniform. TO BE USED FOR TESTING ONLY.
+    int i, diff = 512-503;
+    unsigned char* string = NULL;
+
+    string = (unsigned char*)a;
+    for (i = 0; i < sizeof(digit_t)*NWORDS_FIELD_P503; i++) {
+        *(string + i) = (unsigned char)rand();              // Obtain 512-bit number
+    }
+    a[NWORDS_FIELD_P503-1] &= (((digit_t)(-1) << diff) >> diff);
+
+    while (fpcompare503((digit_t*)p503, a) < 1) {           // Force it to [0, modulus-1]
+        mp_sub(a, (digit_t*)p503, a, NWORDS_FIELD_P503);
+    }
+
+    return;
+}
+
+
+void fp2random503_test(f2elm503_t a)
+{ // Generating a pseudo-random element in GF(p503^2) 
+  // SECURITY NOTE: distribution is not fully uniform. TO BE USED FOR TESTING ONLY.
+
+    fprandom503_test(a[0]);
+    fprandom503_test(a[1]);
+}
+
+
+int fpcompare503(felm503_t a, felm503_t b)
+{ // Comparing two field elements, a=b? : (1) a>b, (0) a=b, (-1) a<b
+  // NOTE: this function does not have constant-time execution. TO BE USED FOR TESTING ONLY.
+    int i;
+
+    for (i = NWORDS_FIELD_P503-1; i >= 0; i--)
+    {
+        if (a[i] > b[i]) return 1;
+        else if (a[i] < b[i]) return -1;
+    }
+
+    return 0; 
+}
+
+
+int fp2compare503(f2elm503_t a, f2elm503_t b)
+{ // Comparing two quadratic extension field elements, ai=bi? : (1) ai!=bi, (0) ai=bi
+  // NOTE: this function does not have constant-time execution. TO BE USED FOR TESTING ONLY.
+
+    if (fpcompare503(a[0], b[0])!=0 || fpcompare503(a[1], b[1])!=0) return 1;
+    return 0; 
+}
+
+
+void fpmul503_mont_basic(felm503_t ma, felm503_t mb, felm503_t mc)
+{ // Basic Montgomery multiplication, mc = ma*mb*R^-1 mod p503, where ma,mb,mc in [0, p503-1] and R = 2^512.
+  // ma and mb are assumed to be in Montgomery representation.
+
+    fpmul_mont_basic(ma, mb, mc, (digit_t*)&p503, (digit_t*)&Montgomery_pp503, NWORDS_FIELD_P503);
+}
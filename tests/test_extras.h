@@ -25,6 +25,9 @@ extern "C" {
 // Access system counter for benchmarking
 int64_t cpucycles(void);
 
+// Peak stack usage in bytes of function(argument), run on a separate stack of "size" bytes. Returns 0 if not supported (Linux only)
+size_t stack_usage(void (*function)(void*), void* argument, size_t size);
+
 // Generate "nbytes" random bytes and output the result to random_array
 CRYPTO_STATUS random_bytes_test(unsigned int nbytes, unsigned char* random_array);
 
@@ -52,6 +55,55 @@ void to_mont_basic(felm_t a, felm_t mc);
 // Conversion from Montgomery representation to standard representation
 void from_mont_basic(felm_t ma, felm_t c);
 
+/******** Field arithmetic compiled for SIDHp503 (see P503/P503_internal.h) *********/
+
+#define NWORDS_FIELD_P503    NBITS_TO_NWORDS(503)
+typedef digit_t felm503_t[NWORDS_FIELD_P503];                    // Element of GF(p503)
+typedef digit_t dfelm503_t[2*NWORDS_FIELD_P503];                 // Double-precision element of GF(p503)
+typedef felm503_t f2elm503_t[2];                                 // Element of GF(p503^2)
+typedef dfelm503_t df2elm503_t[2];                               // Double-precision (unreduced) element of GF(p503^2)
+
+// Prime p503
+extern const uint64_t p503[NWORDS_FIELD_P503];
+
+// Generating a pseudo-random field element in [0, p503-1] 
+void fprandom503_test(felm503_t a);
+
+// Generating a pseudo-random element in GF(p503^2)
+void fp2random503_test(f2elm503_t a);
+
+// Comparing two field elements, a=b? : (1) a>b, (0) a=b, (-1) a<b
+int fpcompare503(felm503_t a, felm503_t b);
+
+// Comparing two quadratic extension field elements, ai=bi? : (1) ai!=bi, (0) ai=bi
+int fp2compare503(f2elm503_t a, f2elm503_t b);
+
+// Basic Montgomery multiplication, mc = ma*mb*R^-1 mod p503, where ma,mb,mc in [0, p503-1] and R = 2^512
+void fpmul503_mont_basic(felm503_t ma, felm503_t mb, felm503_t mc);
+
+// Library functions over GF(p503) and GF(p503^2), with the same specifications as the ones over GF(p751)
+CRYPTO_STATUS fp_get_arithmetic_p503(ARITHMETIC_ID id, const FieldArithmetic** arithmetic);
+CRYPTO_STATUS fp_select_arithmetic_p503(ARITHMETIC_ID id, const FieldArithmetic** arithmetic);
+void mp_mul_p503(digit_t* a, digit_t* b, digit_t* c, unsigned int nwords);
+void mp_sqr_p503(digit_t* a, digit_t* c, unsigned int nwords);
+void rdc_mont_p503(dfelm503_t ma, felm503_t mc);
+void from_mont_p503(felm503_t ma, felm503_t c);
+void fpcopy503(felm503_t a, felm503_t c);
+void fpzero503(felm503_t a);
+void fpmul503_mont(felm503_t a, felm503_t b, felm503_t c);
+void fpsqr503_mont(felm503_t ma, felm503_t mc);
+void fpinv503_mont(felm503_t a);
+void fp2copy503(f2elm503_t a, f2elm503_t c);
+void fp2add503(f2elm503_t a, f2elm503_t b, f2elm503_t c);
+void fp2sub503(f2elm503_t a, f2elm503_t b, f2elm503_t c);
+void fp2mul503_mont(f2elm503_t a, f2elm503_t b, f2elm503_t c);
+void fp2mul503_mont_default(f2elm503_t a, f2elm503_t b, f2elm503_t c);
+void fp2sqr503_mont(f2elm503_t a, f2elm503_t c);
+void fp2mul503_unreduced(f2elm503_t a, f2elm503_t b, df2elm503_t c);
+void fp2dfadd503(df2elm503_t a, df2elm503_t b, df2elm503_t c);
+void fp2dfsub503(df2elm503_t a, df2elm503_t b, df2elm503_t c);
+void fp2rdc503(df2elm503_t a, f2elm503_t c);
+
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,278 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: thread team for the parallel isogeny tree traversal
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <malloc.h>
+#if defined(THREADS_SUPPORT)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+
+#if defined(THREADS_SUPPORT)
+
+#define TEAM_SPIN_LIMIT   (1 << 15)      // Number of spins before an idle worker blocks on the condition variable
+#define TEAM_YIELD_PERIOD (1 << 6)       // Spinning threads give up the processor every TEAM_YIELD_PERIOD spins
+#define TEAM_MAX_POINTS   (MAX_INT_POINTS_BOB + 3)
+
+// The calling thread publishes a job by incrementing "round" and waits for "done" to reach the number of workers before
+// publishing the next one. Workers spin on "round" for a while and then block, so that an idle team does not burn CPU time.
+struct thread_team {
+    pthread_t        threads[SIDH_MAX_THREADS - 1];
+    unsigned int     nworkers;                           // Number of worker threads, the calling thread is not included
+    unsigned int     busy;                               // Set while an operation owns the team
+    unsigned int     pending;                            // Set while the workers run a job, only accessed by the owner
+    unsigned int     round;                              // Job counter
+    unsigned int     done;                               // Number of workers done with the current job
+    unsigned int     quit;
+    unsigned int     sleepers;                           // Number of workers blocked on "wakeup"
+    pthread_mutex_t  lock;
+    pthread_cond_t   wakeup;
+    unsigned int     degree;                             // Job: evaluate the isogeny of degree 3 or 4 with coefficients "coeff" at "points"
+    f2elm_t          coeff[5];
+    point_proj*      points[TEAM_MAX_POINTS];
+    unsigned int     npoints;
+#if defined(SIDH_OPCOUNT)
+    OpCounters*      OpCounts;                           // Counters of the curve isogeny structure of the owner, the workers' operations are added to them
+#endif
+};
+
+typedef struct {
+    PThreadTeam      team;
+    unsigned int     id;
+} worker_arg;
+
+
+static __inline void cpu_relax(void)
+{ // Hint to the processor that the calling thread is spinning
+#if (TARGET == TARGET_AMD64) || (TARGET == TARGET_x86)
+    __builtin_ia32_pause();
+#elif (TARGET == TARGET_ARM) || (TARGET == TARGET_ARM64)
+    __asm__ __volatile__ ("yield");
+#endif
+}
+
+
+static void* team_worker(void* arg)
+{ // Worker thread: evaluates its share of the points of every job published by the owner of the team
+    PThreadTeam team = ((worker_arg*)arg)->team;
+    unsigned int i, id = ((worker_arg*)arg)->id, seen = 0, round, spins;
+
+    free(arg);
+    while (true) {
+        spins = 0;
+        while ((round = __atomic_load_n(&team->round, __ATOMIC_SEQ_CST)) == seen) {
+            if (++spins < TEAM_SPIN_LIMIT) {
+                if ((spins & (TEAM_YIELD_PERIOD - 1)) == 0) {
+                    sched_yield();
+                } else {
+                    cpu_relax();
+                }
+                continue;
+            }
+            pthread_mutex_lock(&team->lock);
+            __atomic_add_fetch(&team->sleepers, 1, __ATOMIC_SEQ_CST);
+            while (__atomic_load_n(&team->round, __ATOMIC_SEQ_CST) == seen) {
+                pthread_cond_wait(&team->wakeup, &team->lock);
+            }
+            __atomic_sub_fetch(&team->sleepers, 1, __ATOMIC_SEQ_CST);
+            pthread_mutex_unlock(&team->lock);
+            spins = 0;
+        }
+        seen = round;
+        if (__atomic_load_n(&team->quit, __ATOMIC_ACQUIRE)) {
+            return NULL;
+        }
+
+        OPCOUNT_PHASE(team, OPCOUNT_PHASE_TRAVERSAL);
+        for (i = id; i < team->npoints; i += team->nworkers) {
+            if (team->degree == 4) {
+                eval_4_isog(team->points[i], team->coeff);
+            } else {
+                eval_3_isog(team->points[i], team->coeff);
+            }
+        }
+        __atomic_add_fetch(&team->done, 1, __ATOMIC_RELEASE);
+    }
+}
+
+
+static void team_publish(PThreadTeam team)
+{ // Publishes the job stored in the team and wakes up the blocked workers
+    __atomic_store_n(&team->done, 0, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&team->round, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&team->sleepers, __ATOMIC_SEQ_CST) != 0) {
+        pthread_mutex_lock(&team->lock);
+        pthread_cond_broadcast(&team->wakeup);
+        pthread_mutex_unlock(&team->lock);
+    }
+}
+
+
+static void team_wait(PThreadTeam team)
+{ // Waits until the workers are done with the current job
+  // Gives up the processor periodically, so that the workers can make progress when there are fewer cores than threads.
+    unsigned int spins = 0;
+
+    if (team->pending) {
+        while (__atomic_load_n(&team->done, __ATOMIC_ACQUIRE) != team->nworkers) {
+            if ((++spins & (TEAM_YIELD_PERIOD - 1)) == 0) {
+                sched_yield();
+            } else {
+                cpu_relax();
+            }
+        }
+        team->pending = 0;
+    }
+}
+
+
+CRYPTO_STATUS thread_team_create(unsigned int nthreads, PThreadTeam* pteam)
+{ // Creates a team of nthreads-1 worker threads, in addition to the calling thread
+    PThreadTeam team;
+    worker_arg* arg;
+    unsigned int i;
+
+    *pteam = NULL;
+    if (nthreads < 2 || nthreads > SIDH_MAX_THREADS) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+    team = (PThreadTeam) calloc(1, sizeof(struct thread_team));
+    if (team == NULL) {
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+    pthread_mutex_init(&team->lock, NULL);
+    pthread_cond_init(&team->wakeup, NULL);
+
+    for (i = 0; i < nthreads - 1; i++) {
+        arg = (worker_arg*) malloc(sizeof(worker_arg));
+        if (arg == NULL) {
+            break;
+        }
+        arg->team = team;
+        arg->id = i;
+        if (pthread_create(&team->threads[i], NULL, team_worker, arg) != 0) {
+            free(arg);
+            break;
+        }
+        team->nworkers++;
+    }
+    if (team->nworkers != nthreads - 1) {
+        thread_team_free(team);
+        return CRYPTO_ERROR_NO_MEMORY;
+    }
+
+    *pteam = team;
+    return CRYPTO_SUCCESS;
+}
+
+
+void thread_team_free(PThreadTeam team)
+{ // Stops the worker threads and frees the team
+    unsigned int i;
+
+    if (team == NULL) {
+        return;
+    }
+    __atomic_store_n(&team->quit, 1, __ATOMIC_RELEASE);
+    team_publish(team);
+    for (i = 0; i < team->nworkers; i++) {
+        pthread_join(team->threads[i], NULL);
+    }
+    pthread_cond_destroy(&team->wakeup);
+    pthread_mutex_destroy(&team->lock);
+    clear_words((void*)team->coeff, 5 * 2 * NWORDS_FIELD);
+    free(team);
+}
+
+
+PThreadTeam thread_team_acquire(PCurveIsogenyStruct CurveIsogeny)
+{ // Takes ownership of the thread team of CurveIsogeny for one isogeny tree traversal
+  // Returns NULL if there is no team or if it is in use by another operation, in which case the traversal is computed serially.
+    PThreadTeam team = (PThreadTeam)CurveIsogeny->ThreadTeam;
+
+    if (team == NULL || __atomic_exchange_n(&team->busy, 1, __ATOMIC_ACQUIRE) != 0) {
+        return NULL;
+    }
+#if defined(SIDH_OPCOUNT)
+    team->OpCounts = CurveIsogeny->OpCounts;
+#endif
+    return team;
+}
+
+
+void thread_team_eval(PThreadTeam team, unsigned int degree, f2elm_t* coeff, point_proj** points, unsigned int npoints)
+{ // Hands the evaluation of the isogeny of degree 3 or 4 at points[0],...,points[npoints-1] to the workers and returns immediately.
+  // coeff holds the 5 coefficients computed by get_4_isog() for degree 4, or the 2 coefficients computed by get_3_isog() for degree 3.
+  // The points must not be accessed by the caller until the next call to thread_team_eval() or thread_team_release().
+    unsigned int i;
+
+    team_wait(team);
+    team->degree = degree;
+    for (i = 0; i < ((degree == 4) ? 5 : 2); i++) {
+        fp2copy751(coeff[i], team->coeff[i]);
+    }
+    for (i = 0; i < npoints; i++) {
+        team->points[i] = points[i];
+    }
+    team->npoints = npoints;
+    team->pending = 1;
+    team_publish(team);
+}
+
+
+void thread_team_release(PThreadTeam team)
+{ // Waits for the last job and gives up the ownership of the team
+    if (team != NULL) {
+        team_wait(team);
+        __atomic_store_n(&team->busy, 0, __ATOMIC_RELEASE);
+    }
+}
+
+#else
+
+CRYPTO_STATUS thread_team_create(unsigned int nthreads, PThreadTeam* pteam)
+{ // Thread teams are not supported in this build
+    UNREFERENCED_PARAMETER(nthreads);
+    *pteam = NULL;
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+}
+
+
+void thread_team_free(PThreadTeam team)
+{
+    UNREFERENCED_PARAMETER(team);
+}
+
+
+PThreadTeam thread_team_acquire(PCurveIsogenyStruct CurveIsogeny)
+{
+    UNREFERENCED_PARAMETER(CurveIsogeny);
+    return NULL;
+}
+
+
+void thread_team_eval(PThreadTeam team, unsigned int degree, f2elm_t* coeff, point_proj** points, unsigned int npoints)
+{
+    UNREFERENCED_PARAMETER(team);
+    UNREFERENCED_PARAMETER(degree);
+    UNREFERENCED_PARAMETER(coeff);
+    UNREFERENCED_PARAMETER(points);
+    UNREFERENCED_PARAMETER(npoints);
+}
+
+
+void thread_team_release(PThreadTeam team)
+{
+    UNREFERENCED_PARAMETER(team);
+}
+
+#endif
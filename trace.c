@@ -0,0 +1,86 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: trace points at the phase boundaries of the key exchange operations (TRACE_SUPPORT)
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#if defined(TRACE_SUPPORT)
+    #if (OS_TARGET == OS_WIN)
+        #include <intrin.h>
+    #elif !((TARGET == TARGET_AMD64) || (TARGET == TARGET_x86) || (TARGET == TARGET_ARM64))
+        #include <time.h>
+    #endif
+    #if (OS_TARGET == OS_LINUX) && defined(__has_include)
+        #if __has_include(<sys/sdt.h>)
+            #include <sys/sdt.h>                         // USDT probes, from SystemTap
+            #define TRACE_PROBE(point, arg, cycles)    DTRACE_PROBE3(sidh, trace, point, arg, cycles)
+        #endif
+    #endif
+    #if !defined(TRACE_PROBE)
+        #define TRACE_PROBE(point, arg, cycles)
+    #endif
+#endif
+
+
+#if defined(TRACE_SUPPORT)
+
+static __inline uint64_t trace_cycles(void)
+{ // Timestamp in processor cycles, or in nanoseconds on platforms without an accessible cycle counter
+#if (OS_TARGET == OS_WIN) && ((TARGET == TARGET_AMD64) || (TARGET == TARGET_x86))
+    return __rdtsc();
+#elif (TARGET == TARGET_AMD64) || (TARGET == TARGET_x86)
+    unsigned int hi, lo;
+
+    __asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+    return ((uint64_t)hi << 32) | lo;
+#elif (TARGET == TARGET_ARM64)
+    uint64_t t;
+
+    __asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (t));
+    return t;
+#elif (OS_TARGET == OS_LINUX)
+    struct timespec time;
+
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec*1000000000 + (uint64_t)time.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+
+void trace_point(PCurveIsogenyStruct CurveIsogeny, SIDH_TRACE_POINT point, unsigned int arg)
+{ // Fires the USDT probe of trace point "point" and calls the trace callback of CurveIsogeny, if any, with a cycle timestamp
+    uint64_t cycles = trace_cycles();
+
+    TRACE_PROBE((unsigned int)point, arg, cycles);
+    if (CurveIsogeny->TraceCallback != NULL) {
+        CurveIsogeny->TraceCallback(CurveIsogeny->TraceContext, point, arg, cycles);
+    }
+}
+
+#endif
+
+
+CRYPTO_STATUS SIDH_set_trace(PCurveIsogenyStruct pCurveIsogeny, SIDH_TraceCallback Callback, void* Context)
+{ // Registers the trace callback of pCurveIsogeny, or removes it if Callback is NULL
+
+    if (is_CurveIsogenyStruct_null(pCurveIsogeny)) {
+        return CRYPTO_ERROR_INVALID_PARAMETER;
+    }
+#if defined(TRACE_SUPPORT)
+    pCurveIsogeny->TraceCallback = Callback;
+    pCurveIsogeny->TraceContext = (Callback != NULL) ? Context : NULL;
+    return CRYPTO_SUCCESS;
+#else
+    UNREFERENCED_PARAMETER(Callback);
+    UNREFERENCED_PARAMETER(Context);
+    return CRYPTO_ERROR_NOT_IMPLEMENTED;
+#endif
+}
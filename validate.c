@@ -81,9 +81,10 @@ CRYPTO_STATUS random_fp2(f2elm_t f2value, PCurveIsogenyStruct pCurveIsogeny)
         if (ntry > 100) {
             return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
         }
-        Status = (pCurveIsogeny->RandomBytesFunction)(
+        Status = random_bytes(
             nbytes, 
-            (unsigned char*) &f2value[0]
+            (unsigned char*) &f2value[0],
+            pCurveIsogeny
         );
         if (Status != CRYPTO_SUCCESS) {
             return Status;
@@ -99,7 +100,7 @@ CRYPTO_STATUS random_fp2(f2elm_t f2value, PCurveIsogenyStruct pCurveIsogeny)
         if (ntry > 100) {
             return CRYPTO_ERROR_TOO_MANY_ITERATIONS;
         }
-        Status = (pCurveIsogeny->RandomBytesFunction)(nbytes, (unsigned char*)&f2value[1]);
+        Status = random_bytes(nbytes, (unsigned char*)&f2value[1], pCurveIsogeny);
         if (Status != CRYPTO_SUCCESS) {
             return Status;
         }
@@ -141,8 +142,8 @@ static bool test_curve(f2elm_t A, f2elm_t rvalue, PCurveIsogenyStruct CurveIsoge
     fp2copy751(one, C);
 
     xDBLe(rP, rP, A, C, 1);
-    xDBLe(rP, P1, A, C, 371);    
-    xTPLe(P1, P1, A, C, 239);    
+    xDBLe(rP, P1, A, C, OALICE_BITS-1);
+    xTPLe(P1, P1, A, C, OBOB_EXPON);
     fp2mul751_mont(rP->X, P1->Z, rP->X);               // X = X*Z1
     fp2mul751_mont(rP->Z, P1->X, rP->Z);               // Z = Z*X1
     fp2sub751(rP->X, rP->Z, rP->X);                    // X = X-Z
@@ -347,15 +348,14 @@ static void TPLline(
 }
 
 /**
- * Bob validating Alice's public key
+ * Bob validating Alice's public key PKA, given in Montgomery representation
  * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
  */
-CRYPTO_STATUS Validate_PKA(
-    unsigned char* pPublicKeyA,
+CRYPTO_STATUS validate_PKA_mont(
+    f2elm_t* PKA,
     bool* valid, 
     PCurveIsogenyStruct CurveIsogeny
 ) {
-    f2elm_t PKA[4];
     f2elm_t t0, t1, t2, t3, t4, t5, t6, t7, lambdaP, lambdaQ, lnQ, lnP, ldQ, ldP, uP = {0}, uQ = {0}, uPD = {0}, uQD = {0}, sqP, sqQ, sq;
     f2elm_t rvalue, alphan, betan, alphad, betad, alpha_numer = {0}, alpha_denom = {0}, beta_numer = {0}, beta_denom = {0}, one = {0}, zero = {0};
     point_proj_t P = {0}, Q = {0}, UP, UQ; 
@@ -368,24 +368,6 @@ CRYPTO_STATUS Validate_PKA(
         clear_words((void*)rvalue, 2*NWORDS_FIELD);
         return Status;
     }
-    
-    // Conversion of Alice's public key to Montgomery representation:                  
-    to_fp2mont(
-        ((f2elm_t*)pPublicKeyA)[0],
-         PKA[0]
-    );
-    to_fp2mont(
-        ((f2elm_t*)pPublicKeyA)[1],
-        PKA[1]
-    );
-    to_fp2mont(
-        ((f2elm_t*)pPublicKeyA)[2],
-        PKA[2]
-    );
-    to_fp2mont(
-        ((f2elm_t*)pPublicKeyA)[3],
-        PKA[3]
-     );
 
     fp2copy751(PKA[1], P->X);
     fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, P->Z[0]);
@@ -429,6 +411,7 @@ CRYPTO_STATUS Validate_PKA(
 
         line_indeterminant_TPL(alpha_numer, beta_numer, alphan, betan, sq);
         line_indeterminant_TPL(alpha_denom, beta_denom, alphad, betad, sq);
+        TRACE(CurveIsogeny, SIDH_TRACE_VALIDATION_STEP, j);
     }
 
     cube_indeterminant(alpha_numer, beta_numer, sq);
@@ -454,7 +437,7 @@ CRYPTO_STATUS Validate_PKA(
     fp2sqr751_mont(t3, t4);                            // t4 = t3^2
 
     *valid = is_equal_fp2(t2, t4);                     // Checks order P by
-    *valid = *valid & !is_equal_fp2(t2, zero);         // asserting that 3^238*P has order 3
+    *valid = *valid & !is_equal_fp2(t2, zero);         // asserting that 3^(eB-1)*P has order 3
         
     fp2mul751_mont(PKA[0], Q->Z, t5);                  // t5 = A*ZQ
     fp2add751(Q->X, Q->X, t6);                         // t6 = XQ+XQ
@@ -476,7 +459,7 @@ CRYPTO_STATUS Validate_PKA(
     fp2sqr751_mont(t7, t4);                            // t4 = t7^2
 
     *valid = *valid & is_equal_fp2(t2, t4);            // Checks order Q by
-    *valid = *valid & !is_equal_fp2(t2, zero);         // asserting that 3^238*Q has order 3
+    *valid = *valid & !is_equal_fp2(t2, zero);         // asserting that 3^(eB-1)*Q has order 3
 
     fp2mul751_mont(PKA[2], P->Z, lnQ);                 // lnQ = xQ*ZP
     fp2sub751(P->X, lnQ, lnQ);                         // lnQ = XP-lnQ
@@ -546,15 +529,14 @@ CRYPTO_STATUS Validate_PKA(
 }
 
 /**
- * Bob validating Alice's public key
+ * Alice validating Bob's public key PKB, given in Montgomery representation
  * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
  */
-CRYPTO_STATUS Validate_PKB(
-    unsigned char* pPublicKeyB,
+CRYPTO_STATUS validate_PKB_mont(
+    f2elm_t* PKB,
     bool* valid,
     PCurveIsogenyStruct CurveIsogeny
 ) {
-    f2elm_t PKB[4];
     f2elm_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9, t10, t11, fP = {0}, fQ = {0}, UP = {0}, UQ = {0}, VP = {0}, VQ = {0};
     f2elm_t rvalue, cP, cQ, alphaQi, betaPi, alphaPi, betaQi, alphaP = {0}, alphaQ = {0}, betaP = {0}, betaQ = {0}, one = {0}, zero = {0};
     point_proj_t P = {0}, Q = {0}; 
@@ -570,11 +552,6 @@ CRYPTO_STATUS Validate_PKB(
         );
         return Status;
     }
-                      
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[0], PKB[0]);    // Conversion of Bob's public key to Montgomery representation
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[1], PKB[1]);
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[2], PKB[2]);
-    to_fp2mont(((f2elm_t*)pPublicKeyB)[3], PKB[3]);
 
     fp2copy751(PKB[1], P->X);
     fpcopy751((digit_t*)CurveIsogeny->Montgomery_one, P->Z[0]);
@@ -713,6 +690,7 @@ CRYPTO_STATUS Validate_PKB(
         fp2mul751_mont(betaP, t2, betaP);              // betaP = betaP*t2
         fp2mul751_mont(alphaQ, t3, alphaQ);            // alphaQ = alphaQ*t3
         fp2mul751_mont(betaQ, t3, betaQ);              // betaQ = betaQ*t3
+        TRACE(CurveIsogeny, SIDH_TRACE_VALIDATION_STEP, i);
     }
 
     fp2mul751_mont(PKB[2], P->Z, t2);                  // t2 = xQ*ZP
@@ -775,4 +753,187 @@ CRYPTO_STATUS Validate_PKB(
     *valid = *valid & test_curve(PKB[0], rvalue, CurveIsogeny); 
 
     return CRYPTO_SUCCESS;
-}
\ No newline at end of file
+}
+
+
+/**
+ * Bob validating Alice's public key
+ * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+ */
+CRYPTO_STATUS Validate_PKA(
+    unsigned char* pPublicKeyA,
+    bool* valid, 
+    PCurveIsogenyStruct CurveIsogeny
+) {
+    f2elm_t PKA[4];
+    CRYPTO_STATUS Status;
+
+    FIELD_DISPATCH(CurveIsogeny->pbits, Validate_PKA_p503(pPublicKeyA, valid, CurveIsogeny));
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_A);
+
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[0], PKA[0]);    // Conversion of Alice's public key to Montgomery representation
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[1], PKA[1]);
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[2], PKA[2]);
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[3], PKA[3]);
+
+    Status = validate_PKA_mont(PKA, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_A);
+    return Status;
+}
+
+
+/**
+ * Bob validating Alice's public key as in Validate_PKA(), converting it to Montgomery representation in Workspace,
+ * or in the workspace of the calling thread if it is NULL
+ * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+ */
+CRYPTO_STATUS Validate_PKA_ws(
+    unsigned char* pPublicKeyA,
+    bool* valid,
+    void* Workspace,
+    PCurveIsogenyStruct CurveIsogeny
+) {
+    kex_workspace* ws = (kex_workspace*) ((Workspace != NULL) ? Workspace : workspace_thread());
+    CRYPTO_STATUS Status;
+
+    FIELD_DISPATCH(CurveIsogeny->pbits, Validate_PKA_ws_p503(pPublicKeyA, valid, Workspace, CurveIsogeny));
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_A);
+
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[0], ws->PK[0]);    // Conversion of Alice's public key to Montgomery representation
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[1], ws->PK[1]);
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[2], ws->PK[2]);
+    to_fp2mont(((f2elm_t*)pPublicKeyA)[3], ws->PK[3]);
+
+    Status = validate_PKA_mont(ws->PK, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_A);
+    return Status;
+}
+
+/**
+ * Alice validating Bob's public key
+ * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+ */
+CRYPTO_STATUS Validate_PKB(
+    unsigned char* pPublicKeyB,
+    bool* valid,
+    PCurveIsogenyStruct CurveIsogeny
+) {
+    f2elm_t PKB[4];
+    CRYPTO_STATUS Status;
+
+    FIELD_DISPATCH(CurveIsogeny->pbits, Validate_PKB_p503(pPublicKeyB, valid, CurveIsogeny));
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_B);
+
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[0], PKB[0]);    // Conversion of Bob's public key to Montgomery representation
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[1], PKB[1]);
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[2], PKB[2]);
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[3], PKB[3]);
+
+    Status = validate_PKB_mont(PKB, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_B);
+    return Status;
+}
+
+
+/**
+ * Alice validating Bob's public key as in Validate_PKB(), converting it to Montgomery representation in Workspace,
+ * or in the workspace of the calling thread if it is NULL
+ * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+ */
+CRYPTO_STATUS Validate_PKB_ws(
+    unsigned char* pPublicKeyB,
+    bool* valid,
+    void* Workspace,
+    PCurveIsogenyStruct CurveIsogeny
+) {
+    kex_workspace* ws = (kex_workspace*) ((Workspace != NULL) ? Workspace : workspace_thread());
+    CRYPTO_STATUS Status;
+
+    FIELD_DISPATCH(CurveIsogeny->pbits, Validate_PKB_ws_p503(pPublicKeyB, valid, Workspace, CurveIsogeny));
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_B);
+
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[0], ws->PK[0]);    // Conversion of Bob's public key to Montgomery representation
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[1], ws->PK[1]);
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[2], ws->PK[2]);
+    to_fp2mont(((f2elm_t*)pPublicKeyB)[3], ws->PK[3]);
+
+    Status = validate_PKB_mont(ws->PK, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_B);
+    return Status;
+}
+
+
+static CRYPTO_STATUS validate_PK_tagged(
+    unsigned char* pPublicKey,
+    bool* valid,
+    f2elm_t* PK,
+    PCurveIsogenyStruct CurveIsogeny
+) { // Loads the tagged public key pPublicKey, in any format, into PK in Montgomery representation
+    unsigned int i;
+    bool montgomery = false;
+    CRYPTO_STATUS Status;
+
+    *valid = false;
+    Status = tagged_pk_format(pPublicKey, &montgomery, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    for (i = 0; i < 4; i++) {
+        if (montgomery) {
+            fp2copy751(((f2elm_t*)pPublicKey)[i], PK[i]);    // Already in Montgomery representation, with elements in [0, p751-1]
+        } else {
+            to_fp2mont(((f2elm_t*)pPublicKey)[i], PK[i]);
+        }
+    }
+    return CRYPTO_SUCCESS;
+}
+
+
+/**
+ * Bob validating Alice's tagged public key as in Validate_PKA(), in any format
+ * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+ */
+CRYPTO_STATUS Validate_PKA_tagged(
+    unsigned char* pPublicKeyA,
+    bool* valid,
+    PCurveIsogenyStruct CurveIsogeny
+) {
+    f2elm_t PKA[4];
+    CRYPTO_STATUS Status;
+
+    FIELD_DISPATCH(CurveIsogeny->pbits, Validate_PKA_tagged_p503(pPublicKeyA, valid, CurveIsogeny));
+
+    Status = validate_PK_tagged(pPublicKeyA, valid, PKA, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_A);
+    Status = validate_PKA_mont(PKA, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_A);
+    return Status;
+}
+
+
+/**
+ * Alice validating Bob's tagged public key as in Validate_PKB(), in any format
+ * CurveIsogeny must be set up in advance using SIDH_curve_initialize().
+ */
+CRYPTO_STATUS Validate_PKB_tagged(
+    unsigned char* pPublicKeyB,
+    bool* valid,
+    PCurveIsogenyStruct CurveIsogeny
+) {
+    f2elm_t PKB[4];
+    CRYPTO_STATUS Status;
+
+    FIELD_DISPATCH(CurveIsogeny->pbits, Validate_PKB_tagged_p503(pPublicKeyB, valid, CurveIsogeny));
+
+    Status = validate_PK_tagged(pPublicKeyB, valid, PKB, CurveIsogeny);
+    if (Status != CRYPTO_SUCCESS) {
+        return Status;
+    }
+    TRACE(CurveIsogeny, SIDH_TRACE_BEGIN, SIDH_TRACE_VALIDATE_B);
+    Status = validate_PKB_mont(PKB, valid, CurveIsogeny);
+    TRACE(CurveIsogeny, SIDH_TRACE_END, SIDH_TRACE_VALIDATE_B);
+    return Status;
+}
@@ -0,0 +1,58 @@
+/********************************************************************************************
+* SIDH: an efficient supersingular isogeny-based cryptography library for Diffie-Hellman key
+*       exchange providing 128 bits of quantum security and 192 bits of classical security.
+*
+*    Copyright (c) Microsoft Corporation. All rights reserved.
+*
+*
+* Abstract: workspaces of the key exchange functions with the "_ws" suffix
+*
+*********************************************************************************************/
+
+#include "SIDH_internal.h"
+#include <stdlib.h>
+#if (OS_TARGET == OS_WIN)
+    #include <malloc.h>
+    #define CACHE_ALIGNED    __declspec(align(64))
+#else
+    #define CACHE_ALIGNED    __attribute__((aligned(64)))
+#endif
+
+#define WORKSPACE_ALIGNMENT    64                        // Cache line size
+
+static THREAD_LOCAL CACHE_ALIGNED digit_t workspace[NBYTES_TO_NWORDS(SIDH_WORKSPACE_BYTES)];
+
+
+void* workspace_thread(void)
+{ // Returns the workspace of the calling thread, SIDH_WORKSPACE_BYTES bytes aligned on a cache line
+    return (void*)workspace;
+}
+
+
+void* SIDH_workspace_allocate(void)
+{ // Allocates a workspace of SIDH_WORKSPACE_BYTES bytes aligned on a cache line
+    void* Workspace = NULL;
+
+#if (OS_TARGET == OS_WIN)
+    Workspace = _aligned_malloc(SIDH_WORKSPACE_BYTES, WORKSPACE_ALIGNMENT);
+#else
+    if (posix_memalign(&Workspace, WORKSPACE_ALIGNMENT, SIDH_WORKSPACE_BYTES) != 0) {
+        return NULL;
+    }
+#endif
+    return Workspace;
+}
+
+
+void SIDH_workspace_free(void* Workspace)
+{ // Wipes and frees a workspace
+
+    if (Workspace != NULL) {
+        clear_words(Workspace, NBYTES_TO_NWORDS(SIDH_WORKSPACE_BYTES));
+#if (OS_TARGET == OS_WIN)
+        _aligned_free(Workspace);
+#else
+        free(Workspace);
+#endif
+    }
+}